@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/Minko.hpp"
+#include "minko/MinkoSDL.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::math;
+
+// renders NUM_OBJECTS distinct surfaces and reports the average time spent submitting the draw calls
+// (the uniform storage alone is benchmarked against its previous per-type maps by UniformBenchmarkTest)
+const uint NUM_OBJECTS      = 10000;
+const uint NUM_SAMPLES      = 100;
+
+int
+main(int argc, char** argv)
+{
+	auto canvas = Canvas::create("Minko Example - Draw Calls", 800, 600);
+
+	auto sceneManager = SceneManager::create(canvas);
+
+	sceneManager->assets()->loader()->queue("effect/Basic.effect");
+
+	sceneManager->assets()->geometry("cube", geometry::CubeGeometry::create(sceneManager->assets()->context()));
+
+	auto root = scene::Node::create("root")
+		->addComponent(sceneManager);
+
+	auto meshes = scene::Node::create("meshes")
+		->addComponent(Transform::create());
+
+	auto camera = scene::Node::create("camera")
+		->addComponent(Renderer::create(0x7f7f7fff))
+		->addComponent(Transform::create(
+		Matrix4x4::create()->lookAt(Vector3::zero(), Vector3::create(0.f, 0.f, 120.f))
+		))
+		->addComponent(PerspectiveCamera::create(canvas->aspectRatio()));
+
+	root->addChild(camera);
+
+	auto _ = sceneManager->assets()->loader()->complete()->connect([=](file::Loader::Ptr loader)
+	{
+		const auto side = uint(std::ceil(std::sqrt(float(NUM_OBJECTS))));
+
+		for (uint i = 0; i < NUM_OBJECTS; ++i)
+		{
+			const auto x = float(i % side) - side * .5f;
+			const auto y = float(i / side) - side * .5f;
+
+			auto mesh = scene::Node::create("mesh")
+				->addComponent(Transform::create(
+					Matrix4x4::create()->appendScale(.5f)->appendTranslation(x, y, 0.f)
+				))
+				->addComponent(Surface::create(
+					sceneManager->assets()->geometry("cube"),
+					material::BasicMaterial::create()->diffuseColor(((i * 0x9e3779b1u) & 0xffffff00) | 0xff),
+					sceneManager->assets()->effect("effect/Basic.effect")
+				));
+
+			meshes->addChild(mesh);
+		}
+
+		root->addChild(meshes);
+	});
+
+	auto renderer        = camera->component<Renderer>();
+	auto submissionStart = std::chrono::high_resolution_clock::now();
+	auto submissionTime  = 0.;
+	auto numFrames       = 0u;
+
+	auto renderingBegin = renderer->renderingBegin()->connect([&](Renderer::Ptr renderer)
+	{
+		submissionStart = std::chrono::high_resolution_clock::now();
+	});
+
+	// stop before present() so that the swap/vsync is not accounted for
+	auto beforePresent = renderer->beforePresent()->connect([&](Renderer::Ptr renderer)
+	{
+		submissionTime += std::chrono::duration<double, std::milli>(
+			std::chrono::high_resolution_clock::now() - submissionStart
+		).count();
+
+		if (++numFrames == NUM_SAMPLES)
+		{
+			std::cout << renderer->numDrawCalls() << " draw calls: "
+				<< submissionTime / numFrames << "ms/frame" << std::endl;
+
+			submissionTime = 0.;
+			numFrames = 0;
+		}
+	});
+
+	auto resized = canvas->resized()->connect([&](AbstractCanvas::Ptr canvas, uint w, uint h)
+	{
+		camera->component<PerspectiveCamera>()->aspectRatio(float(w) / float(h));
+	});
+
+	auto enterFrame = canvas->enterFrame()->connect([&](Canvas::Ptr canvas, float time, float deltaTime)
+	{
+		meshes->component<Transform>()->matrix()->appendRotationZ(0.0001f * deltaTime);
+
+		sceneManager->nextFrame(time, deltaTime);
+	});
+
+	sceneManager->assets()->loader()->load();
+	canvas->run();
+
+	return 0;
+}
@@ -13,6 +13,14 @@
 attribute vec3 position;
 attribute vec2 uv;
 
+#if defined(INSTANCING) && !defined(NUM_BONES)
+	// rows of the model to world matrix of each instance, see DrawCallPool
+	attribute vec4 instanceModelToWorld0;
+	attribute vec4 instanceModelToWorld1;
+	attribute vec4 instanceModelToWorld2;
+	attribute vec4 instanceModelToWorld3;
+#endif // INSTANCING
+
 uniform mat4 modelToWorldMatrix;
 uniform mat4 worldToScreenMatrix;
 uniform vec2 uvScale;
@@ -37,7 +45,9 @@ void main(void)
 		pos = skinning_moveVertex(pos);
 	#endif // NUM_BONES
 	
-	#ifdef MODEL_TO_WORLD
+	#if defined(INSTANCING) && !defined(NUM_BONES)
+		pos = pos * mat4(instanceModelToWorld0, instanceModelToWorld1, instanceModelToWorld2, instanceModelToWorld3);
+	#elif defined(MODEL_TO_WORLD)
 		pos = modelToWorldMatrix * pos;
 	#endif
 	
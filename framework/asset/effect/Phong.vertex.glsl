@@ -15,6 +15,14 @@ attribute vec2 uv;
 attribute vec3 normal;
 attribute vec3 tangent;
 
+#if defined(INSTANCING) && !defined(NUM_BONES)
+	// rows of the model to world matrix of each instance, see DrawCallPool
+	attribute vec4 instanceModelToWorld0;
+	attribute vec4 instanceModelToWorld1;
+	attribute vec4 instanceModelToWorld2;
+	attribute vec4 instanceModelToWorld3;
+#endif // INSTANCING
+
 uniform mat4 modelToWorldMatrix;
 uniform mat4 worldToScreenMatrix;
 uniform vec2 uvScale;
@@ -33,11 +41,18 @@ void main(void)
 
 	vec4 worldPosition 	= vec4(position, 1.0);
 
+	#if defined(INSTANCING) && !defined(NUM_BONES)
+		// transposed: v * m == transpose(m) * v
+		mat4 instanceModelToWorldMatrix = mat4(instanceModelToWorld0, instanceModelToWorld1, instanceModelToWorld2, instanceModelToWorld3);
+	#endif // INSTANCING
+
 	#ifdef NUM_BONES
 		worldPosition	= skinning_moveVertex(worldPosition);
 	#endif // NUM_BONES
 
-	#ifdef MODEL_TO_WORLD
+	#if defined(INSTANCING) && !defined(NUM_BONES)
+		worldPosition 	= worldPosition * instanceModelToWorldMatrix;
+	#elif defined(MODEL_TO_WORLD)
 		worldPosition 	= modelToWorldMatrix * worldPosition;
 	#endif // MODEL_TO_WORLD
 
@@ -50,14 +65,18 @@ void main(void)
 			vertexNormal	= skinning_moveVertex(vec4(normal, 0.0)).xyz;
 		#endif // NUM_BONES
 
-		#ifdef MODEL_TO_WORLD
+		#if defined(INSTANCING) && !defined(NUM_BONES)
+			vertexNormal 	= vertexNormal * mat3(instanceModelToWorldMatrix);
+		#elif defined(MODEL_TO_WORLD)
 			vertexNormal 	= mat3(modelToWorldMatrix) * vertexNormal;
 		#endif // MODEL_TO_WORLD
 		vertexNormal 	= normalize(vertexNormal);
 
 		#ifdef NORMAL_MAP
 			vertexTangent = tangent;
-			#ifdef MODEL_TO_WORLD
+			#if defined(INSTANCING) && !defined(NUM_BONES)
+				vertexTangent = vertexTangent * mat3(instanceModelToWorldMatrix);
+			#elif defined(MODEL_TO_WORLD)
 				vertexTangent = mat3(modelToWorldMatrix) * vertexTangent;
 			#endif // MODEL_TO_WORLD
 			vertexTangent = normalize(vertexTangent);
@@ -68,8 +68,12 @@ namespace minko
     namespace render
     {
         class DrawCallPool;
+        class CommandBuffer;
+        class RenderGraph;
         class AbstractContext;
         class OpenGLES2Context;
+        class OpenGL3Context;
+        class NullContext;
         class Blending;
         enum class CompareMode;
         enum class TriangleCulling;
@@ -90,6 +94,8 @@ namespace minko
         class Shader;
         class Program;
         class ProgramSignature;
+        class ProgramCache;
+        class GLSLPreprocessor;
         class VertexFormat;
         class VertexBuffer;
         class IndexBuffer;
@@ -182,6 +188,7 @@ namespace minko
         class Culling;
         class Picking;
         class JobManager;
+        class ProgramWarmUpJob;
 
         class AbstractLight;
         class AmbientLight;
@@ -191,6 +198,8 @@ namespace minko
         class PointLight;
 
         class BoundingBox;
+        class StaticBatcher;
+        class LevelOfDetail;
 
         class MousePicking;
         class MouseManager;
@@ -206,11 +215,13 @@ namespace minko
     namespace data
     {
         class Provider;
+        class PropertyName;
         class ArrayProvider;
         class StructureProvider;
         class ValueBase;
         class Value;
         class Container;
+        class ContainerView;
         class AbstractFilter;
 
         enum class BindingSource
@@ -286,6 +297,7 @@ namespace minko
         class Box;
         class Frustum;
         class OctTree;
+        class OcclusionBuffer;
 
         inline
         bool
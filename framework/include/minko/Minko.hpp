@@ -29,14 +29,19 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/CloneOption.hpp"
 #include "minko/render/AbstractContext.hpp"
 #include "minko/render/OpenGLES2Context.hpp"
+#include "minko/render/OpenGL3Context.hpp"
+#include "minko/render/NullContext.hpp"
 #include "minko/render/ProgramInputs.hpp"
 #include "minko/render/Pass.hpp"
 #include "minko/render/Shader.hpp"
 #include "minko/render/Effect.hpp"
 #include "minko/render/Blending.hpp"
 #include "minko/render/ProgramSignature.hpp"
+#include "minko/render/ProgramCache.hpp"
+#include "minko/render/GLSLPreprocessor.hpp"
 #include "minko/render/CompareMode.hpp"
 #include "minko/render/StencilOperation.hpp"
+#include "minko/render/RenderGraph.hpp"
 #include "minko/math/Vector2.hpp"
 #include "minko/math/Vector3.hpp"
 #include "minko/math/Vector4.hpp"
@@ -45,14 +50,17 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/math/Box.hpp"
 #include "minko/math/Ray.hpp"
 #include "minko/math/Frustum.hpp"
+#include "minko/math/OcclusionBuffer.hpp"
 #include "minko/Signal.hpp"
 #include "minko/scene/Node.hpp"
 #include "minko/scene/NodeSet.hpp"
+#include "minko/data/PropertyName.hpp"
 #include "minko/data/Provider.hpp"
 #include "minko/data/ArrayProvider.hpp"
 #include "minko/data/StructureProvider.hpp"
 #include "minko/data/Value.hpp"
 #include "minko/data/Container.hpp"
+#include "minko/data/ContainerView.hpp"
 #include "minko/data/AbstractFilter.hpp"
 #include "minko/component/AbstractComponent.hpp"
 #include "minko/component/Transform.hpp"
@@ -72,6 +80,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/SkinningMethod.hpp"
 #include "minko/component/Culling.hpp"
 #include "minko/component/Picking.hpp"
+#include "minko/component/StaticBatcher.hpp"
+#include "minko/component/LevelOfDetail.hpp"
 #include "minko/component/AbstractAnimation.hpp"
 #include "minko/component/MasterAnimation.hpp"
 #include "minko/component/Animation.hpp"
@@ -79,6 +89,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/animation/AbstractTimeline.hpp"
 #include "minko/animation/Matrix4x4Timeline.hpp"
 #include "minko/component/JobManager.hpp"
+#include "minko/component/ProgramWarmUpJob.hpp"
 #include "minko/render/AbstractResource.hpp"
 #include "minko/render/Program.hpp"
 #include "minko/render/VertexBuffer.hpp"
@@ -87,6 +98,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/Texture.hpp"
 #include "minko/render/CubeTexture.hpp"
 #include "minko/render/Priority.hpp"
+#include "minko/render/CommandBuffer.hpp"
 #include "minko/geometry/Geometry.hpp"
 #include "minko/geometry/CubeGeometry.hpp"
 #include "minko/geometry/SphereGeometry.hpp"
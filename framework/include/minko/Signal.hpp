@@ -28,76 +28,139 @@ namespace minko
         public std::enable_shared_from_this<Signal<A...>>
     {
     private:
-        typedef std::function<void(A...)>                                        CallbackFunction;
-        typedef std::pair<float, CallbackFunction>                                Callback;
-        typedef typename std::list<Callback>::iterator                            CallbackIterator;
-        typedef typename std::list<std::pair<float, unsigned int>>::iterator    SlotIterator;
+        typedef std::function<void(A...)>                CallbackFunction;
 
         template <typename... B>
         class SignalSlot;
 
+        // callbacks are stored contiguously by decreasing priority; a slot record maps each connection
+        // to its callback and gets a new generation when it is disconnected, so that stale handles are ignored
+        struct Callback
+        {
+            CallbackFunction                            function;
+            float                                       priority;
+            uint                                        slotIndex;
+        };
+
+        struct SlotRecord
+        {
+            uint                                        generation;
+            uint                                        callbackIndex;
+            bool                                        pending;
+        };
+
+        static const uint                               NO_SLOT = 0xffffffff;
+
     public:
         typedef std::shared_ptr<Signal<A...>>            Ptr;
         typedef std::shared_ptr<SignalSlot<A...>>        Slot;
 
     private:
-        std::list<Callback>                                        _callbacks;
-        std::list<std::pair<float, unsigned int>>                _slotIds;
-        unsigned int                                             _nextSlotId;
-
-        bool                                                    _locked;
-        std::list<std::pair<Callback, uint>>                    _toAdd;
-        std::list<std::pair<CallbackIterator, SlotIterator>>    _toRemove;
-        std::list<unsigned int>                                    _toRemoveSlotId;
-        bool                                                    _signalListDirty;
+        std::vector<Callback>                           _callbacks;
+        std::vector<Callback>                           _pendingCallbacks;
+        std::vector<SlotRecord>                         _slots;
+        std::vector<uint>                               _freeSlots;
+        uint                                            _numCallbacks;
+        uint                                            _numDisconnected;
+        uint                                            _executionDepth;
 
     private:
         Signal() :
             std::enable_shared_from_this<Signal<A...>>(),
-            _nextSlotId(0),
-            _locked(false),
-            _signalListDirty(false)
+            _callbacks(),
+            _pendingCallbacks(),
+            _slots(),
+            _freeSlots(),
+            _numCallbacks(0),
+            _numDisconnected(0),
+            _executionDepth(0)
+        {
+        }
+
+        void
+        removeConnection(const uint slotIndex, const uint generation)
+        {
+            auto& slot = _slots[slotIndex];
+
+            if (slot.generation != generation)
+                return;
+
+            auto& callback = slot.pending
+                ? _pendingCallbacks[slot.callbackIndex]
+                : _callbacks[slot.callbackIndex];
+
+            callback.slotIndex = NO_SLOT;
+
+            // a callback disconnected while the signal executes still runs until the end of that execution
+            if (_executionDepth == 0 || slot.pending)
+                callback.function = nullptr;
+
+            if (!slot.pending)
+                ++_numDisconnected;
+
+            ++slot.generation;
+            _freeSlots.push_back(slotIndex);
+            --_numCallbacks;
+
+            if (_executionDepth == 0 && _numDisconnected * 2 > _callbacks.size())
+                removeDisconnectedCallbacks();
+        }
+
+        void
+        insertCallback(Callback&& callback)
         {
+            auto position = _callbacks.size();
+
+            while (position > 0 && _callbacks[position - 1].priority < callback.priority)
+                --position;
+
+            _callbacks.insert(_callbacks.begin() + position, std::move(callback));
+
+            for (auto callbackIndex = position; callbackIndex < _callbacks.size(); ++callbackIndex)
+                if (_callbacks[callbackIndex].slotIndex != NO_SLOT)
+                    _slots[_callbacks[callbackIndex].slotIndex].callbackIndex = callbackIndex;
         }
 
         void
-        removeConnectionById(const unsigned int connectionId)
+        removeDisconnectedCallbacks()
         {
-            auto connectionIdIt = _slotIds.begin();
-            auto callbackIt     = _callbacks.begin();
+            uint numCallbacks = 0;
 
-            while ((*connectionIdIt).second != connectionId)
+            for (uint callbackIndex = 0; callbackIndex < _callbacks.size(); ++callbackIndex)
             {
-                connectionIdIt++;
-                callbackIt++;
+                auto& callback = _callbacks[callbackIndex];
+
+                if (callback.slotIndex == NO_SLOT)
+                    continue;
+
+                if (callbackIndex != numCallbacks)
+                    _callbacks[numCallbacks] = std::move(callback);
+                _slots[_callbacks[numCallbacks].slotIndex].callbackIndex = numCallbacks;
+                ++numCallbacks;
             }
 
-            removeConnectionByIterator(connectionIdIt, callbackIt);
+            _callbacks.erase(_callbacks.begin() + numCallbacks, _callbacks.end());
+            _numDisconnected = 0;
         }
 
         void
-        removeConnectionByIterator(SlotIterator         connectionIdIt,
-                                   CallbackIterator     callbackIt)
+        endExecution()
         {
-            if (_locked)
+            if (_numDisconnected != 0)
+                removeDisconnectedCallbacks();
+
+            if (!_pendingCallbacks.empty())
             {
-                auto addIt = std::find_if(_toAdd.begin(), _toAdd.end(), [&](std::pair<Callback, unsigned int>& add)
+                for (auto& callback : _pendingCallbacks)
                 {
-                    return add.second == (*connectionIdIt).second;
-                });
+                    if (callback.slotIndex == NO_SLOT)
+                        continue;
 
-                if (addIt != _toAdd.end())
-                    _toAdd.erase(addIt);
-                else
-                {
-                    _toRemove.push_back(std::pair<CallbackIterator, SlotIterator>(callbackIt, connectionIdIt));
-                    _toRemoveSlotId.push_back(connectionIdIt->second);
+                    _slots[callback.slotIndex].pending = false;
+                    insertCallback(std::move(callback));
                 }
-            }
-            else
-            {
-                _callbacks.erase(callbackIt);
-                _slotIds.erase(connectionIdIt);
+
+                _pendingCallbacks.clear();
             }
         }
 
@@ -113,86 +176,69 @@ namespace minko
         uint
         numCallbacks() const
         {
-            return _callbacks.size();
-        }
-
-        void
-        sortSignals()
-        {
-            _callbacks.sort([&](const Callback& callback1, const Callback& callback2) -> bool
-            {
-                return callback1.first > callback2.first;
-            });
-
-            _slotIds.sort([&](const std::pair<float, unsigned int>& slot1, const std::pair<float, unsigned int>& slot2) -> bool
-            {
-                return slot1.first > slot2.first;
-            });
+            return _numCallbacks;
         }
 
         Slot
         connect(CallbackFunction callback, float priority = 0)
         {
-            auto connection = SignalSlot<A...>::create(Signal<A...>::shared_from_this(), _nextSlotId++);
+            uint slotIndex;
 
-            if (_locked)
-                _toAdd.push_back(std::pair<Callback, unsigned int>(std::pair<float, CallbackFunction>(priority, callback), connection->_id));
+            if (_freeSlots.empty())
+            {
+                slotIndex = _slots.size();
+                _slots.push_back(SlotRecord());
+                _slots.back().generation = 0;
+            }
             else
             {
+                slotIndex = _freeSlots.back();
+                _freeSlots.pop_back();
+            }
 
-                _callbacks.push_back(std::pair<float, CallbackFunction>(priority, callback));
-                _slotIds.push_back(std::pair<float, unsigned int>(priority, connection->_id));
+            Callback    newCallback = { std::move(callback), priority, slotIndex };
+            auto&       slot        = _slots[slotIndex];
 
-                if (_callbacks.size() >= 2)
-                {
-                    auto prec = std::prev(_callbacks.end(), 2);
+            ++_numCallbacks;
 
-                    if (priority > prec->first)
-                        sortSignals();
-                }
+            // callbacks connected while the signal executes are called from the next execution on
+            if (_executionDepth != 0)
+            {
+                slot.pending = true;
+                slot.callbackIndex = _pendingCallbacks.size();
+                _pendingCallbacks.push_back(std::move(newCallback));
+            }
+            else
+            {
+                slot.pending = false;
+                insertCallback(std::move(newCallback));
             }
 
-            return connection;
+            return SignalSlot<A...>::create(Signal<A...>::shared_from_this(), slotIndex, slot.generation);
         }
 
         void
         execute(A... arguments)
         {
+            // the callbacks vector is neither reallocated nor reordered until the outermost execution ends
+            const auto numCallbacks = _callbacks.size();
 
-            _locked = true;
-            for (auto& callback : _callbacks)
-                callback.second(arguments...);
-            _locked = false;
-
-            for (auto& callbackIt : _toRemove)
+            ++_executionDepth;
+            try
             {
-                _callbacks.erase(callbackIt.first);
-                _slotIds.erase(callbackIt.second);
+                for (uint callbackIndex = 0; callbackIndex < numCallbacks; ++callbackIndex)
+                    if (_callbacks[callbackIndex].function)
+                        _callbacks[callbackIndex].function(arguments...);
             }
-
-            for (auto& callbackAndConnectionId : _toAdd)
-            {
-
-                _callbacks.push_back(callbackAndConnectionId.first);
-                _slotIds.push_back(std::pair<float, unsigned int>(callbackAndConnectionId.first.first, callbackAndConnectionId.second));
-
-                if (_callbacks.size() >= 2)
-                {
-                    auto prec = std::prev(_callbacks.end(), 2);
-
-                    if (callbackAndConnectionId.first.first > prec->first)
-                        _signalListDirty = true;
-                }
-            }
-
-            if (_signalListDirty)
+            catch (...)
             {
-                _signalListDirty = false;
-                sortSignals();
+                --_executionDepth;
+                throw;
             }
+            --_executionDepth;
 
-            _toAdd.clear();
-            _toRemove.clear();
+            if (_executionDepth == 0 && (_numDisconnected != 0 || !_pendingCallbacks.empty()))
+                endExecution();
         }
 
     private:
@@ -217,7 +263,7 @@ namespace minko
             {
                 if (_signal != nullptr)
                 {
-                    _signal->removeConnectionById(_id);
+                    _signal->removeConnection(_index, _generation);
                     _signal = nullptr;
                 }
             }
@@ -229,19 +275,21 @@ namespace minko
 
         private:
             std::shared_ptr<Signal<T...>>    _signal;
-            const unsigned int                _id;
+            const uint                        _index;
+            const uint                        _generation;
 
         private:
             inline static
             Ptr
-            create(std::shared_ptr<Signal<T...>> signal, const unsigned int id)
+            create(std::shared_ptr<Signal<T...>> signal, const uint index, const uint generation)
             {
-                return std::shared_ptr<SignalSlot<T...>>(new SignalSlot(signal, id));
+                return std::shared_ptr<SignalSlot<T...>>(new SignalSlot(signal, index, generation));
             }
 
-            SignalSlot(std::shared_ptr<Signal<T...>> signal, const unsigned int id) :
+            SignalSlot(std::shared_ptr<Signal<T...>> signal, const uint index, const uint generation) :
                 _signal(signal),
-                _id(id)
+                _index(index),
+                _generation(generation)
             {
             }
         };
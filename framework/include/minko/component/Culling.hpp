@@ -37,6 +37,8 @@ namespace minko
         private:
             typedef std::shared_ptr<scene::Node>                                NodePtr;
             typedef std::shared_ptr<math::AbstractShape>                        ShapePtr;
+            typedef std::shared_ptr<math::OcclusionBuffer>                      OcclusionBufferPtr;
+            typedef std::shared_ptr<math::Matrix4x4>                            Matrix4x4Ptr;
 
         private:
             static std::shared_ptr<math::OctTree>                               _octTree;
@@ -46,12 +48,17 @@ namespace minko
             Signal<AbstractComponent::Ptr, NodePtr>::Slot                       _targetAddedSlot;
             Signal<AbstractComponent::Ptr, NodePtr>::Slot                       _targetRemovedSlot;
             Signal<NodePtr, NodePtr, NodePtr>::Slot                             _addedSlot;
+            Signal<NodePtr, NodePtr, NodePtr>::Slot                             _removedSlot;
             Signal<NodePtr, NodePtr, NodePtr>::Slot                             _addedToSceneSlot;
             Signal<NodePtr, NodePtr>::Slot                                      _layoutChangedSlot;
             Signal<std::shared_ptr<data::Container>, const std::string&>::Slot  _viewMatrixChangedSlot;
 
             std::string                                                         _bindProperty;
 
+            bool                                                                _occlusionCullingEnabled;
+            OcclusionBufferPtr                                                  _occlusionBuffer;
+            std::unordered_set<NodePtr>                                         _occluders;
+
         public:
             inline static
             Ptr
@@ -65,6 +72,32 @@ namespace minko
                 return CullingComponent;
             }
 
+            // when enabled, the nodes with the Layout::Group::OCCLUDER layout are rasterized in a low
+            // resolution depth buffer and the surfaces they entirely hide are not rendered
+            inline
+            bool
+            occlusionCullingEnabled() const
+            {
+                return _occlusionCullingEnabled;
+            }
+
+            void
+            occlusionCullingEnabled(bool value);
+
+            inline
+            OcclusionBufferPtr
+            occlusionBuffer() const
+            {
+                return _occlusionBuffer;
+            }
+
+            inline
+            void
+            occlusionBuffer(OcclusionBufferPtr value)
+            {
+                _occlusionBuffer = value;
+            }
+
         private:
             Culling(ShapePtr                shape,
                     const std::string&      bindProperty);
@@ -81,9 +114,15 @@ namespace minko
             void
             addedHandler(NodePtr node, NodePtr target, NodePtr ancestor);
 
+            void
+            removedHandler(NodePtr node, NodePtr target, NodePtr ancestor);
+
             void
             layoutChangedHandler(NodePtr node, NodePtr target);
 
+            void
+            rasterizeOccluders(Matrix4x4Ptr worldToScreen);
+
             void
             worldToScreenChangedHandler(std::shared_ptr<data::Container> data, const std::string& propertyName);
 
@@ -0,0 +1,187 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+#include "minko/component/AbstractComponent.hpp"
+#include "minko/Signal.hpp"
+
+namespace minko
+{
+    namespace component
+    {
+        // Selects, every frame, one of several versions of the geometry of its target's surfaces drawn
+        // with the finest level from the fraction of the viewport height its bounding box covers.
+        class LevelOfDetail :
+            public AbstractComponent
+        {
+        public:
+            typedef std::shared_ptr<LevelOfDetail>                                  Ptr;
+
+        private:
+            typedef std::shared_ptr<scene::Node>                                    NodePtr;
+            typedef std::shared_ptr<Surface>                                        SurfacePtr;
+            typedef std::shared_ptr<SceneManager>                                   SceneManagerPtr;
+            typedef std::shared_ptr<geometry::Geometry>                             GeometryPtr;
+
+            struct Level
+            {
+                GeometryPtr                         geometry;
+                float                               minScreenSize;
+            };
+
+        private:
+            std::vector<Level>                                                      _levels; // finest first
+            float                                                                   _hysteresis;
+            uint                                                                    _level;
+            float                                                                   _screenSize;
+            NodePtr                                                                 _camera;
+            bool                                                                    _autoCamera;
+
+            GeometryPtr                                                             _geometry;
+            std::unordered_map<SurfacePtr, GeometryPtr>                             _surfaceToGeometry;
+            SceneManagerPtr                                                         _sceneManager;
+
+            Signal<AbstractComponent::Ptr, NodePtr>::Slot                           _targetAddedSlot;
+            Signal<AbstractComponent::Ptr, NodePtr>::Slot                           _targetRemovedSlot;
+            Signal<NodePtr, NodePtr, NodePtr>::Slot                                 _addedSlot;
+            Signal<NodePtr, NodePtr, NodePtr>::Slot                                 _removedSlot;
+            Signal<SceneManagerPtr, float, float>::Slot                             _frameBeginSlot;
+
+        public:
+            // a level is used as long as the screen size is above its threshold, with a margin of
+            // hysteresis * threshold to go back to a finer level so that levels do not flicker
+            inline static
+            Ptr
+            create(float hysteresis = .1f)
+            {
+                Ptr lod = std::shared_ptr<LevelOfDetail>(new LevelOfDetail(hysteresis));
+
+                lod->initialize();
+
+                return lod;
+            }
+
+            // every level must have the same vertex attributes as the others
+            Ptr
+            addLevel(GeometryPtr geometry, float minScreenSize);
+
+            inline
+            uint
+            numLevels() const
+            {
+                return _levels.size();
+            }
+
+            inline
+            GeometryPtr
+            levelGeometry(uint level) const
+            {
+                return _levels.at(level).geometry;
+            }
+
+            inline
+            float
+            levelMinScreenSize(uint level) const
+            {
+                return _levels.at(level).minScreenSize;
+            }
+
+            inline
+            uint
+            level() const
+            {
+                return _level;
+            }
+
+            // fraction of the viewport height covered by the bounding box at the last update
+            inline
+            float
+            screenSize() const
+            {
+                return _screenSize;
+            }
+
+            inline
+            float
+            hysteresis() const
+            {
+                return _hysteresis;
+            }
+
+            inline
+            void
+            hysteresis(float value)
+            {
+                _hysteresis = value;
+            }
+
+            // the camera node the screen size is computed for, the first node with a PerspectiveCamera
+            // in the scene by default
+            inline
+            NodePtr
+            camera() const
+            {
+                return _camera;
+            }
+
+            inline
+            void
+            camera(NodePtr value)
+            {
+                _camera = value;
+                _autoCamera = value == nullptr;
+            }
+
+            void
+            update();
+
+        private:
+            LevelOfDetail(float hysteresis);
+
+            void
+            initialize();
+
+            void
+            targetAddedHandler(AbstractComponent::Ptr ctrl, NodePtr target);
+
+            void
+            targetRemovedHandler(AbstractComponent::Ptr ctrl, NodePtr target);
+
+            void
+            addedOrRemovedHandler(NodePtr node, NodePtr target, NodePtr ancestor);
+
+            void
+            frameBeginHandler(SceneManagerPtr sceneManager, float time, float deltaTime);
+
+            void
+            findSceneManager();
+
+            NodePtr
+            findCamera();
+
+            float
+            computeScreenSize();
+
+            void
+            useLevel(uint level);
+        };
+    }
+}
@@ -0,0 +1,111 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/component/JobManager.hpp"
+
+namespace minko
+{
+    namespace component
+    {
+        // compiles, a few surfaces per frame, the programs the surfaces of a scene will be drawn with
+        // so that they are not compiled in the middle of a frame once the scene is displayed
+        class ProgramWarmUpJob :
+            public JobManager::Job,
+            public std::enable_shared_from_this<ProgramWarmUpJob>
+        {
+        public:
+            typedef std::shared_ptr<ProgramWarmUpJob>                               Ptr;
+
+        private:
+            typedef std::shared_ptr<scene::Node>                                    NodePtr;
+            typedef std::shared_ptr<Renderer>                                       RendererPtr;
+            typedef std::shared_ptr<Surface>                                        SurfacePtr;
+            typedef std::shared_ptr<material::Material>                             MaterialPtr;
+            typedef std::tuple<RendererPtr, SurfacePtr, MaterialPtr>                Permutation;
+
+        private:
+            NodePtr                                                                 _target;
+            std::unordered_map<MaterialPtr, std::list<MaterialPtr>>                 _materialToVariants;
+
+            std::list<Permutation>                                                  _permutations;
+            uint                                                                    _numWarmedUp;
+            uint                                                                    _numFailed;
+
+        public:
+            inline static
+            Ptr
+            create(NodePtr target)
+            {
+                if (target == nullptr)
+                    throw std::invalid_argument("target");
+
+                return std::shared_ptr<ProgramWarmUpJob>(new ProgramWarmUpJob(target));
+            }
+
+            inline
+            NodePtr
+            target() const
+            {
+                return _target;
+            }
+
+            // the surfaces using the material are also warmed up as if they used the variant, ie. a copy
+            // of the material with the properties it will be assigned or lose at runtime
+            Ptr
+            addMaterialVariant(MaterialPtr material, MaterialPtr variant);
+
+            // surface, renderer and material combinations whose programs are ready
+            inline
+            uint
+            numWarmedUp() const
+            {
+                return _numWarmedUp;
+            }
+
+            inline
+            uint
+            numFailed() const
+            {
+                return _numFailed;
+            }
+
+            bool
+            complete();
+
+            void
+            beforeFirstStep();
+
+            void
+            step();
+
+            float
+            priority();
+
+            void
+            afterLastStep();
+
+        private:
+            ProgramWarmUpJob(NodePtr target);
+        };
+    }
+}
@@ -38,6 +38,23 @@ namespace minko
         public:
             typedef std::shared_ptr<Renderer>                                   Ptr;
 
+            // times are in milliseconds, a negative GPU time means it could not be measured
+            struct PassStats
+            {
+                std::string                                                     effect;
+                std::string                                                     pass;
+                uint                                                            numDrawCalls;
+                float                                                           cpuTime;
+                float                                                           gpuTime;
+            };
+
+            struct FrameStats
+            {
+                float                                                           cpuTime;
+                float                                                           gpuTime;
+                std::vector<PassStats>                                          passes;
+            };
+
         private:
             typedef std::shared_ptr<scene::Node>                                NodePtr;
             typedef std::shared_ptr<AbstractComponent>                          AbsCmpPtr;
@@ -53,11 +70,29 @@ namespace minko
             typedef Signal<SurfacePtr, const std::string&, bool>::Slot          SurfaceTechniqueChangedSlot;
             typedef Signal<AbsFilterPtr, SurfacePtr>::Slot                      FilterChangedSlot;
             typedef Signal<Ptr, AbsFilterPtr, data::BindingSource, SurfacePtr>  RendererFilterChangedSignal;
+            typedef std::shared_ptr<render::CommandBuffer>                      CommandBufferPtr;
+
+            // range of the command buffer recorded for one draw call
+            struct RecordedDrawCall
+            {
+                DrawCallPtr                                                     drawCall;
+                uint                                                            revision;
+                uint                                                            begin;
+                uint                                                            end;
+            };
+
+            // frame whose timer queries are still in flight, each query being stored with the
+            // index of the pass it measures
+            struct PendingFrameStats
+            {
+                FrameStats                                                      stats;
+                std::vector<std::pair<uint, uint>>                              queries;
+            };
 
         private:
             std::string                                                         _name;
 
-            DrawCallList                                                        _drawCalls;
+            uint                                                                _numDrawCalls;
             std::unordered_map<SurfacePtr, DrawCallList>                        _surfaceDrawCalls;
 
             unsigned int                                                        _backgroundColor;
@@ -74,6 +109,7 @@ namespace minko
             EffectPtr                                                           _effect;
             float                                                               _priority;
             bool                                                                _enabled;
+            bool                                                                _autoRender;
 
             Signal<AbsCmpPtr, NodePtr>::Slot                                    _targetAddedSlot;
             Signal<AbsCmpPtr, NodePtr>::Slot                                    _targetRemovedSlot;
@@ -99,7 +135,26 @@ namespace minko
 
             std::shared_ptr<RendererFilterChangedSignal>                        _filterChanged;
 
+            bool                                                                _commandBufferEnabled;
+            bool                                                                _commandBufferInvalid;
+            CommandBufferPtr                                                    _commandBuffer;
+            CommandBufferPtr                                                    _previousCommandBuffer;
+            std::vector<RecordedDrawCall>                                       _recordedDrawCalls;
+            uint                                                                _recordedPoolRevision;
+            Layouts                                                             _recordedLayoutMask;
+            AbsTexturePtr                                                       _recordedRenderTarget;
+            uint                                                                _numRecordedDrawCalls;
+
+            bool                                                                _depthPrePassEnabled;
+
+            bool                                                                _profilingEnabled;
+            FrameStats                                                          _frameStats;
+            std::list<PendingFrameStats>                                        _pendingFrameStats;
+            std::vector<uint>                                                   _timerQueries;
+            AbsContext                                                          _timerQueryContext;
+
             static const unsigned int                                           NUM_FALLBACK_ATTEMPTS;
+            static const unsigned int                                           MAX_NUM_PENDING_FRAMES;
 
         public:
             inline static
@@ -134,6 +189,7 @@ namespace minko
 
             ~Renderer()
             {
+                deleteTimerQueries();
             }
 
             inline
@@ -147,7 +203,7 @@ namespace minko
             unsigned int
             numDrawCalls()
             {
-                return _drawCalls.size();
+                return _numDrawCalls;
             }
 
             inline
@@ -199,6 +255,8 @@ namespace minko
                 _viewportBox.y            = y;
                 _viewportBox.width        = w;
                 _viewportBox.height        = h;
+
+                _commandBufferInvalid = true;
             }
 
             inline
@@ -252,6 +310,113 @@ namespace minko
                 _enabled = value;
             }
 
+            // when disabled, the renderer does not render anymore when the scene manager renders a frame
+            // and only renders when render() is called, ie. by a render::RenderGraph
+            inline
+            bool
+            autoRender()
+            {
+                return _autoRender;
+            }
+
+            inline
+            void
+            autoRender(bool value)
+            {
+                _autoRender = value;
+            }
+
+            // compiles ahead of time the programs the surface will be drawn with by this renderer, or
+            // would be drawn with if it used another material; false when none can be used
+            bool
+            warmUp(SurfacePtr surface, std::shared_ptr<material::Material> material = nullptr);
+
+            // whether draw calls are ordered with packed 64-bit keys and a radix sort (default)
+            // or with the legacy comparison-based sort
+            bool
+            sortDrawCallsByKey();
+
+            void
+            sortDrawCallsByKey(bool value);
+
+            // whether the draw calls sharing the same pass, program, geometry and material are merged
+            // in a single instanced draw call when the context supports it (disabled by default)
+            bool
+            instancingEnabled();
+
+            void
+            instancingEnabled(bool value);
+
+            // when enabled, draw calls are recorded in a command buffer that is replayed as long as
+            // they do not change, and only the draw calls that did change are recorded again
+            inline
+            bool
+            commandBufferEnabled()
+            {
+                return _commandBufferEnabled;
+            }
+
+            void
+            commandBufferEnabled(bool value);
+
+            // number of draw calls recorded during the last frame rendered with the command buffer, the
+            // others were copied as they were from the previous frame
+            inline
+            uint
+            numRecordedDrawCalls() const
+            {
+                return _numRecordedDrawCalls;
+            }
+
+            // when enabled, opaque draw calls first fill the depth buffer with a trivial fragment shader
+            // and are then shaded with an EQUAL depth test, so that each pixel is shaded only once
+            inline
+            bool
+            depthPrePassEnabled()
+            {
+                return _depthPrePassEnabled;
+            }
+
+            inline
+            void
+            depthPrePassEnabled(bool value)
+            {
+                if (value == _depthPrePassEnabled)
+                    return;
+
+                _depthPrePassEnabled = value;
+                _commandBufferInvalid = true;
+            }
+
+            // forces the next frame to be recorded again, for instance after changing the textures
+            // or the buffers of an effect
+            inline
+            void
+            invalidateCommandBuffer()
+            {
+                _commandBufferInvalid = true;
+            }
+
+            // when enabled, the CPU and GPU time spent in each pass is measured at every frame
+            inline
+            bool
+            profilingEnabled()
+            {
+                return _profilingEnabled;
+            }
+
+            void
+            profilingEnabled(bool value);
+
+            // statistics of the last frame whose GPU timings are known: since timer queries are
+            // never waited for, they lag a few frames behind
+            inline
+            const FrameStats&
+            frameStats() const
+            {
+                return _frameStats;
+            }
+
             void
             render(std::shared_ptr<render::AbstractContext> context,
                    AbsTexturePtr renderTarget = nullptr);
@@ -355,6 +520,21 @@ namespace minko
                                               uint                             frameId,
                                               AbsTexturePtr                    renderTarget);
 
+            void
+            updateCommandBuffer(const std::vector<render::DrawCall*>& drawCalls, AbsTexturePtr renderTarget);
+
+            void
+            renderDepthPrePass(AbsContext context, const std::vector<render::DrawCall*>& drawCalls, AbsTexturePtr renderTarget);
+
+            void
+            renderProfiled(AbsContext context, const std::vector<render::DrawCall*>& drawCalls, AbsTexturePtr renderTarget);
+
+            void
+            collectFrameStats();
+
+            void
+            deleteTimerQueries();
+
             void
             findSceneManager();
 
@@ -0,0 +1,153 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+#include "minko/component/AbstractComponent.hpp"
+#include "minko/Signal.hpp"
+
+namespace minko
+{
+    namespace component
+    {
+        // Merges the static (scene::Layout::Group::STATIC) surfaces below its target into a few large
+        // geometries sharing the same material, effect and technique.
+        class StaticBatcher :
+            public AbstractComponent
+        {
+        public:
+            typedef std::shared_ptr<StaticBatcher>                                  Ptr;
+
+        private:
+            typedef std::shared_ptr<scene::Node>                                    NodePtr;
+            typedef std::shared_ptr<Surface>                                        SurfacePtr;
+            typedef std::shared_ptr<math::Matrix4x4>                                MatrixPtr;
+            typedef Signal<SurfacePtr, std::shared_ptr<Renderer>, bool>             VisibilityChangedSignal;
+            typedef std::vector<std::pair<std::string, uint>>                       VertexFormat;
+            typedef std::tuple<material::Material*, render::Effect*, std::string, std::string>
+                                                                                    BatchKey;
+
+            struct SurfaceRange
+            {
+                uint                                firstTriangle;
+                uint                                numTriangles;
+                SurfacePtr                          surface;
+                NodePtr                             node;
+            };
+
+            struct Batch
+            {
+                NodePtr                             node;
+                SurfacePtr                          surface;
+                std::vector<unsigned short>         indices;
+                std::vector<SurfaceRange>           ranges;
+            };
+
+            typedef std::shared_ptr<Batch>                                          BatchPtr;
+
+        public:
+            static const uint                                                       MAX_NUM_VERTICES;
+
+        private:
+            uint                                                                    _maxNumVertices;
+
+            std::vector<NodePtr>                                                    _batchNodes;
+            std::unordered_map<SurfacePtr, BatchPtr>                                _batchSurfaceToBatch;
+            std::unordered_map<SurfacePtr, std::pair<BatchPtr, uint>>               _surfaceToRange;
+            std::vector<NodePtr>                                                    _hiddenNodes;
+            std::unordered_map<SurfacePtr, VisibilityChangedSignal::Slot>           _surfaceToVisibilityChangedSlot;
+
+            Signal<AbstractComponent::Ptr, NodePtr>::Slot                           _targetAddedSlot;
+            Signal<AbstractComponent::Ptr, NodePtr>::Slot                           _targetRemovedSlot;
+
+        public:
+            inline static
+            Ptr
+            create(uint maxNumVertices = MAX_NUM_VERTICES)
+            {
+                Ptr batcher = std::shared_ptr<StaticBatcher>(new StaticBatcher(maxNumVertices));
+
+                batcher->initialize();
+
+                return batcher;
+            }
+
+            inline
+            const std::vector<NodePtr>&
+            batches() const
+            {
+                return _batchNodes;
+            }
+
+            inline
+            uint
+            numBatchedSurfaces() const
+            {
+                return _surfaceToRange.size();
+            }
+
+            void
+            batch();
+
+            void
+            unbatch();
+
+            SurfacePtr
+            originalSurface(SurfacePtr batchSurface, uint triangle) const;
+
+            NodePtr
+            originalNode(SurfacePtr batchSurface, uint triangle) const;
+
+        private:
+            StaticBatcher(uint maxNumVertices);
+
+            void
+            initialize();
+
+            void
+            targetAddedHandler(AbstractComponent::Ptr ctrl, NodePtr target);
+
+            void
+            targetRemovedHandler(AbstractComponent::Ptr ctrl, NodePtr target);
+
+            void
+            visibilityChangedHandler(SurfacePtr surface, std::shared_ptr<Renderer> renderer, bool visible);
+
+            bool
+            isStatic(NodePtr node, NodePtr target) const;
+
+            bool
+            vertexFormat(SurfacePtr surface, VertexFormat& format) const;
+
+            MatrixPtr
+            relativeMatrix(NodePtr node, NodePtr target) const;
+
+            BatchPtr
+            createBatch(const std::vector<std::pair<SurfacePtr, MatrixPtr>>&    surfaces,
+                        const VertexFormat&                                     format);
+
+            const SurfaceRange&
+            findRange(SurfacePtr batchSurface, uint triangle) const;
+
+            void
+            updateRange(BatchPtr batch, const SurfaceRange& range, bool visible);
+        };
+    }
+}
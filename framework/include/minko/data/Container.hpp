@@ -34,6 +34,35 @@ namespace minko
             typedef std::shared_ptr<Container>                              Ptr;
             typedef Signal<Ptr, const std::string&>                         PropertyChangedSignal;
 
+            // opens a batch on each added container; end() closes them all and rethrows the first
+            // listener exception, the destructor only closes the batches end() was not reached for
+            // (i.e. when an exception is thrown in between) and logs the listener exceptions
+            class ScopedBatch
+            {
+            private:
+                std::vector<Ptr>    _containers;
+
+            public:
+                ScopedBatch();
+
+                explicit
+                ScopedBatch(Ptr container);
+
+                ~ScopedBatch();
+
+                void
+                add(Ptr container);
+
+                void
+                end();
+
+            private:
+                ScopedBatch(const ScopedBatch&);
+
+                ScopedBatch&
+                operator=(const ScopedBatch&);
+            };
+
         private:
             typedef std::shared_ptr<PropertyChangedSignal>                  PropertyChangedSignalPtr;
 
@@ -41,9 +70,10 @@ namespace minko
             typedef std::shared_ptr<data::AbstractFilter>                   AbsFilterPtr;
             typedef Signal<ProviderPtr, const std::string&>                 ProviderPropertyChangedSignal;
             typedef ProviderPropertyChangedSignal::Slot                     ProviderPropertyChangedSlot;
+            typedef std::pair<ProviderPtr, PropertyName>                    ProviderAndKey;
 
             std::list<ProviderPtr>                                          _providers;
-            std::unordered_map<std::string, ProviderPtr>                    _propertyNameToProvider;
+            std::unordered_map<PropertyName, ProviderAndKey>                _propertyNameToProvider;
             std::unordered_map<ProviderPtr, uint>                           _providersToNumUse;
             std::unordered_map<ProviderPtr, uint>                           _providerToIndex;
 
@@ -51,8 +81,8 @@ namespace minko
 
             PropertyChangedSignalPtr                                        _propertyAdded;
             PropertyChangedSignalPtr                                        _propertyRemoved;
-            std::unordered_map<std::string, PropertyChangedSignalPtr>       _propValueChanged;
-            std::unordered_map<std::string, PropertyChangedSignalPtr>       _propReferenceChanged;
+            std::unordered_map<PropertyName, PropertyChangedSignalPtr>      _propValueChanged;
+            std::unordered_map<PropertyName, PropertyChangedSignalPtr>      _propReferenceChanged;
 
             std::unordered_map<ProviderPtr, std::list<Any>>                 _propertyAddedOrRemovedSlots;
             std::unordered_map<ProviderPtr, ProviderPropertyChangedSlot>    _providerValueChangedSlot;
@@ -61,6 +91,12 @@ namespace minko
             Signal<Ptr, ProviderPtr>::Ptr                                   _providerAdded;
             Signal<Ptr, ProviderPtr>::Ptr                                   _providerRemoved;
 
+            uint                                                            _batchDepth;
+            std::vector<PropertyName>                                       _pendingValueChanged;
+            std::vector<PropertyName>                                       _pendingReferenceChanged;
+            std::unordered_set<PropertyName>                                _pendingValueChangedSet;
+            std::unordered_set<PropertyName>                                _pendingReferenceChangedSet;
+
             static uint                                                     CONTAINER_ID;
 
 
@@ -95,8 +131,19 @@ namespace minko
             bool
             hasProvider(std::shared_ptr<Provider> provider) const;
 
+            inline
             bool
-            hasProperty(const std::string&) const;
+            hasProperty(const PropertyName& propertyName) const
+            {
+                return _propertyNameToProvider.count(propertyName) != 0;
+            }
+
+            inline
+            bool
+            hasProperty(const std::string& propertyName) const
+            {
+                return hasProperty(PropertyName(propertyName));
+            }
 
             bool
             isLengthProperty(const std::string&) const;
@@ -110,41 +157,65 @@ namespace minko
                 return foundIndexIt != _providerToIndex.end() ? foundIndexIt->second : -1;
             }
 
+            // provider holding the property, nullptr when none does
+            inline
+            ProviderPtr
+            propertyProvider(const PropertyName& propertyName) const
+            {
+                auto foundProviderIt = _propertyNameToProvider.find(propertyName);
+
+                return foundProviderIt != _propertyNameToProvider.end() ? foundProviderIt->second.first : nullptr;
+            }
+
             template <typename T>
             T
-            get(const std::string& propertyName) const
+            get(const PropertyName& propertyName) const
             {
-                assertPropertyExists(propertyName);
+                const auto& providerAndKey = findProvider(propertyName);
 
-                const auto& provider = _propertyNameToProvider.find(propertyName)->second;
-                auto unformatedPropertyName = unformatPropertyName(provider, propertyName);
+                return providerAndKey.first->get<T>(providerAndKey.second, true);
+            }
 
-                return provider->get<T>(unformatedPropertyName, true);
+            template <typename T>
+            inline
+            T
+            get(const std::string& propertyName) const
+            {
+                return get<T>(PropertyName(propertyName));
             }
 
             template <typename T>
             void
-            set(const std::string& propertyName, T value)
+            set(const PropertyName& propertyName, T value)
             {
-                assertPropertyExists(propertyName);
+                const auto& providerAndKey = findProvider(propertyName);
 
-                auto provider = _propertyNameToProvider[propertyName];
-                auto unformatedPropertyName = unformatPropertyName(provider, propertyName);
+                providerAndKey.first->set<T>(providerAndKey.second, value, true);
+            }
 
-                provider->set<T>(unformatedPropertyName, value);
+            template <typename T>
+            inline
+            void
+            set(const std::string& propertyName, T value)
+            {
+                set<T>(PropertyName(propertyName), value);
             }
 
             template <typename T>
             bool
-            propertyHasType(const std::string& propertyName, bool skipPropertyNameFormatting = false) const
+            propertyHasType(const PropertyName& propertyName) const
             {
-                assertPropertyExists(propertyName);
+                const auto& providerAndKey = findProvider(propertyName);
 
-                const auto& provider = _propertyNameToProvider.find(propertyName)->second;
-
-                auto unformatedPropertyName = unformatPropertyName(provider, propertyName);
+                return providerAndKey.first->propertyHasType<T>(providerAndKey.second, true);
+            }
 
-                return provider->propertyHasType<T>(unformatedPropertyName, skipPropertyNameFormatting);
+            template <typename T>
+            inline
+            bool
+            propertyHasType(const std::string& propertyName) const
+            {
+                return propertyHasType<T>(PropertyName(propertyName));
             }
 
             inline
@@ -162,10 +233,24 @@ namespace minko
             }
 
             PropertyChangedSignalPtr
-            propertyValueChanged(const std::string& propertyName);
+            propertyValueChanged(const PropertyName& propertyName);
+
+            inline
+            PropertyChangedSignalPtr
+            propertyValueChanged(const std::string& propertyName)
+            {
+                return propertyValueChanged(PropertyName(propertyName));
+            }
+
+            PropertyChangedSignalPtr
+            propertyReferenceChanged(const PropertyName& propertyName);
 
+            inline
             PropertyChangedSignalPtr
-            propertyReferenceChanged(const std::string& propertyName);
+            propertyReferenceChanged(const std::string& propertyName)
+            {
+                return propertyReferenceChanged(PropertyName(propertyName));
+            }
 
             inline
             Signal<Ptr, Provider::Ptr>::Ptr
@@ -195,7 +280,7 @@ namespace minko
                 std::vector<std::string> properties;
 
                 for (auto& kv : _propertyNameToProvider)
-                    properties.push_back(kv.first);
+                    properties.push_back(kv.first.str());
 
                 return properties;
             }
@@ -203,11 +288,26 @@ namespace minko
             Ptr
             filter(const std::set<AbsFilterPtr>&, Ptr = nullptr) const;
 
+            // until the matching endBatch(), value and reference changes are coalesced and then
+            // notified once per property; batches can be nested, prefer ScopedBatch to pair them
+            void
+            beginBatch();
+
+            void
+            endBatch();
+
+            inline
+            bool
+            batching() const
+            {
+                return _batchDepth != 0;
+            }
+
         private:
             Container();
 
-            void
-            assertPropertyExists(const std::string& propertyName) const;
+            const ProviderAndKey&
+            findProvider(const PropertyName& propertyName) const;
 
             void
             providerPropertyAddedHandler(ProviderPtr, const std::string& propertyName);
@@ -224,9 +324,6 @@ namespace minko
             std::string
             formatPropertyName(ProviderPtr  arrayProvider, const std::string&) const;
 
-            std::string
-            unformatPropertyName(ProviderPtr  arrayProvider, const std::string&) const;
-
             inline
             void
             assertProviderDoesNotExist(std::shared_ptr<Provider> provider) const
@@ -0,0 +1,144 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+#include "minko/Signal.hpp"
+
+namespace minko
+{
+    namespace data
+    {
+        // live filtered view over a container: the providers accepted by all the filters are kept in a
+        // persistent container, updated when providers are added to or removed from the source and
+        // when update() is called after the result of one of the filters may have changed
+        class ContainerView :
+            public std::enable_shared_from_this<ContainerView>
+        {
+        public:
+            typedef std::shared_ptr<ContainerView>                  Ptr;
+
+        private:
+            typedef std::shared_ptr<Container>                      ContainerPtr;
+            typedef std::shared_ptr<Provider>                       ProviderPtr;
+            typedef std::shared_ptr<AbstractFilter>                 AbsFilterPtr;
+            typedef std::shared_ptr<component::Surface>             SurfacePtr;
+            typedef Signal<ContainerPtr, ProviderPtr>               ProviderChangedSignal;
+
+        private:
+            ContainerPtr                                            _source;
+            std::set<AbsFilterPtr>                                  _filters;
+            SurfacePtr                                              _surface;
+            ContainerPtr                                            _container;
+
+            std::shared_ptr<Signal<Ptr>>                            _changed;
+
+            ProviderChangedSignal::Slot                             _providerAddedSlot;
+            ProviderChangedSignal::Slot                             _providerRemovedSlot;
+
+        public:
+            // the filters are evaluated for the specified surface, if any
+            inline static
+            Ptr
+            create(ContainerPtr                     source,
+                   const std::set<AbsFilterPtr>&    filters,
+                   SurfacePtr                       surface = nullptr)
+            {
+                Ptr ptr = std::shared_ptr<ContainerView>(new ContainerView(source, filters, surface));
+
+                ptr->initialize();
+
+                return ptr;
+            }
+
+            inline
+            ContainerPtr
+            source() const
+            {
+                return _source;
+            }
+
+            inline
+            SurfacePtr
+            surface() const
+            {
+                return _surface;
+            }
+
+            // filtered providers, the same container for the whole life of the view
+            inline
+            ContainerPtr
+            container() const
+            {
+                return _container;
+            }
+
+            inline
+            const std::set<AbsFilterPtr>&
+            filters() const
+            {
+                return _filters;
+            }
+
+            void
+            filters(const std::set<AbsFilterPtr>& value);
+
+            // executed when providers were added to or removed from the view
+            inline
+            std::shared_ptr<Signal<Ptr>>
+            changed() const
+            {
+                return _changed;
+            }
+
+            // evaluates the filters again for every provider of the source, returns true when providers
+            // were added to or removed from the view
+            bool
+            update();
+
+        private:
+            ContainerView(ContainerPtr                      source,
+                          const std::set<AbsFilterPtr>&     filters,
+                          SurfacePtr                        surface);
+
+            void
+            initialize();
+
+            bool
+            prepareFilters();
+
+            bool
+            accept(ProviderPtr provider);
+
+            void
+            addProvider(ProviderPtr provider);
+
+            void
+            removeProvider(ProviderPtr provider);
+
+            void
+            providerAddedHandler(ContainerPtr source, ProviderPtr provider);
+
+            void
+            providerRemovedHandler(ContainerPtr source, ProviderPtr provider);
+        };
+    }
+}
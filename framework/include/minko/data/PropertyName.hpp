@@ -0,0 +1,110 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+    namespace data
+    {
+        // interned property name: the string is hashed once when the atom is created and atoms are
+        // compared by address, so that lookups in providers and containers do not hash strings again;
+        // like the rest of the data model, atoms are meant to be created from the main thread
+        class PropertyName
+        {
+        private:
+            typedef std::pair<const std::string, std::size_t>   Entry;
+
+        private:
+            const Entry*                                        _entry;
+
+        public:
+            PropertyName();
+
+            // implicit on purpose: every function accepting an atom also accepts a string
+            PropertyName(const std::string& name);
+
+            inline
+            const std::string&
+            str() const
+            {
+                return _entry->first;
+            }
+
+            inline
+            operator const std::string&() const
+            {
+                return _entry->first;
+            }
+
+            inline
+            std::size_t
+            hash() const
+            {
+                return _entry->second;
+            }
+
+            inline
+            bool
+            empty() const
+            {
+                return _entry->first.empty();
+            }
+
+            inline
+            bool
+            operator==(const PropertyName& x) const
+            {
+                return _entry == x._entry;
+            }
+
+            inline
+            bool
+            operator!=(const PropertyName& x) const
+            {
+                return _entry != x._entry;
+            }
+
+            // number of distinct names interned so far
+            static
+            uint
+            numNames();
+
+        private:
+            static
+            const Entry*
+            intern(const std::string& name);
+        };
+    }
+}
+
+namespace std
+{
+    template<> struct hash<minko::data::PropertyName>
+    {
+        inline
+        size_t
+        operator()(const minko::data::PropertyName& x) const
+        {
+            return x.hash();
+        }
+    };
+}
@@ -23,6 +23,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Any.hpp"
 #include "minko/Signal.hpp"
 #include "minko/data/Value.hpp"
+#include "minko/data/PropertyName.hpp"
 
 namespace minko
 {
@@ -41,11 +42,48 @@ namespace minko
 
             typedef Signal<std::shared_ptr<Value>>::Slot ChangedSignalSlot;
 
+            static const uint                                       SLOT_SIZE = 16;
+            static const uint                                       MIN_NUM_SLOTS = 8;
+
+            // small values that need no destructor (numbers, integer tuples, enums...) are stored
+            // inline in their slot; everything else is boxed in an Any
+            template <typename T>
+            struct IsInlineValue :
+                public std::integral_constant<bool,
+                    std::is_trivially_destructible<T>::value
+                    && sizeof(T) <= SLOT_SIZE
+                    && std::alignment_of<T>::value <= std::alignment_of<double>::value
+                    && !std::is_convertible<T, Value::Ptr>::value
+                >
+            {
+            };
+
+            struct ValueSlot
+            {
+                bool                                                                        used;
+                PropertyName                                                                name;
+                const std::type_info*                                                       type;   // nullptr when boxed
+                Any                                                                         (*box)(const void*);
+                std::aligned_storage<SLOT_SIZE, std::alignment_of<double>::value>::type     data;
+                Any                                                                         boxed;
+
+                ValueSlot() :
+                    used(false),
+                    name(),
+                    type(nullptr),
+                    box(nullptr),
+                    boxed()
+                {
+                }
+            };
+
         private:
             std::vector<std::string>                                _names;
-            std::unordered_map<std::string, Any>                    _values;
-            std::unordered_map<std::string, ChangedSignalSlot>      _valueChangedSlots;
-            std::unordered_map<std::string, ChangedSignalSlot>      _referenceChangedSlots;
+            // open addressing table indexed by the hashes of the names, at most half full
+            std::vector<ValueSlot>                                  _slots;
+            uint                                                    _numValues;
+            std::unordered_map<PropertyName, ChangedSignalSlot>     _valueChangedSlots;
+            std::unordered_map<PropertyName, ChangedSignalSlot>     _referenceChangedSlots;
 
             std::shared_ptr<Signal<Ptr, const std::string&>>        _propertyAdded;
             std::shared_ptr<Signal<Ptr, const std::string&>>        _propValueChanged;
@@ -81,15 +119,19 @@ namespace minko
 
             virtual
             bool
-            hasProperty(const std::string&, bool skipPropertyNameFormatting = false) const;
+            hasProperty(const PropertyName&, bool skipPropertyNameFormatting = false) const;
 
             inline
-            const std::unordered_map<std::string, Any>&
-            values() const
+            bool
+            hasProperty(const std::string& propertyName, bool skipPropertyNameFormatting = false) const
             {
-                return _values;
+                return hasProperty(PropertyName(propertyName), skipPropertyNameFormatting);
             }
 
+            // inline values are boxed on the fly: prefer propertyNames() and get() on hot paths
+            std::unordered_map<PropertyName, Any>
+            values() const;
+
             inline
             const std::string&
             propertyName(const unsigned int propertyIndex) const
@@ -126,16 +168,30 @@ namespace minko
             }
 
             template <typename T>
+            inline
             T
-            get(const std::string& propertyName, bool skipPropertyNameFormatting) const
+            get(const PropertyName& propertyName, bool skipPropertyNameFormatting) const
             {
-                const std::string&    formattedName    = skipPropertyNameFormatting ? propertyName : formatPropertyName(propertyName);
-                auto                  foundIt          = values().find(formattedName);
+                return getValue<T>(
+                    skipPropertyNameFormatting ? propertyName : formatPropertyName(propertyName),
+                    IsInlineValue<T>()
+                );
+            }
 
-                if (foundIt == values().end())
-                    throw std::invalid_argument("propertyName");
+            template <typename T>
+            inline
+            T
+            get(const PropertyName& propertyName) const
+            {
+                return get<T>(propertyName, false);
+            }
 
-                return Any::unsafe_cast<T>(foundIt->second);
+            template <typename T>
+            inline
+            T
+            get(const std::string& propertyName, bool skipPropertyNameFormatting) const
+            {
+                return get<T>(PropertyName(propertyName), skipPropertyNameFormatting);
             }
 
             template <typename T>
@@ -143,33 +199,46 @@ namespace minko
             T
             get(const std::string& propertyName) const
             {
-                return get<T>(propertyName, false);
+                return get<T>(PropertyName(propertyName), false);
             }
 
             template <typename T>
             bool
-            propertyHasType(const std::string& propertyName, bool skipPropertyNameFormatting = false) const
+            propertyHasType(const PropertyName& propertyName, bool skipPropertyNameFormatting = false) const
             {
-                const std::string&    formattedName    = skipPropertyNameFormatting ? propertyName : formatPropertyName(propertyName);
-                const auto            foundIt          = _values.find(formattedName);
+                const auto slot = findSlot(skipPropertyNameFormatting ? propertyName : formatPropertyName(propertyName));
 
-                if (foundIt == _values.end())
+                if (slot == nullptr)
                     throw std::invalid_argument("propertyName");
 
-				return Any::cast<T>(&foundIt->second) != nullptr;
+                return slot->type != nullptr
+                    ? *slot->type == typeid(T)
+                    : Any::cast<T>(&slot->boxed) != nullptr;
+            }
 
+            template <typename T>
+            inline
+            bool
+            propertyHasType(const std::string& propertyName, bool skipPropertyNameFormatting = false) const
+            {
+                return propertyHasType<T>(PropertyName(propertyName), skipPropertyNameFormatting);
             }
 
             template <typename T>
-            typename std::enable_if<!std::is_convertible<T, Value::Ptr>::value, Provider::Ptr>::type
-            set(const std::string& propertyName, T value, bool skipPropertyNameFormatting)
+            typename std::enable_if<IsInlineValue<T>::value, Provider::Ptr>::type
+            set(const PropertyName& propertyName, T value, bool skipPropertyNameFormatting)
             {
-                auto          formattedName    = skipPropertyNameFormatting ? propertyName : formatPropertyName(propertyName);
+                const auto    formattedName    = skipPropertyNameFormatting ? propertyName : formatPropertyName(propertyName);
 
-                const auto    foundValueIt     = _values.find(formattedName);
-                const bool    isNewValue       = foundValueIt == _values.end();
+                bool          isNewValue;
+                auto&         slot             = createSlot(formattedName, isNewValue);
 
-                _values[formattedName] = value;
+                if (!isNewValue && slot.type == nullptr)
+                    unsetBoxedValue(formattedName, slot);
+
+                slot.type = &typeid(T);
+                slot.box = &boxValue<T>;
+                new (&slot.data) T(value);
 
                 if (isNewValue)
                 {
@@ -185,28 +254,58 @@ namespace minko
             }
 
             template <typename T>
-            typename std::enable_if<std::is_convertible<T, Value::Ptr>::value, Provider::Ptr>::type
-            set(const std::string& propertyName, T value, bool skipPropertyNameFormatting)
+            typename std::enable_if<!IsInlineValue<T>::value && !std::is_convertible<T, Value::Ptr>::value, Provider::Ptr>::type
+            set(const PropertyName& propertyName, T value, bool skipPropertyNameFormatting)
             {
-                auto          formattedName    = skipPropertyNameFormatting ? propertyName : formatPropertyName(propertyName);
+                const auto    formattedName    = skipPropertyNameFormatting ? propertyName : formatPropertyName(propertyName);
 
-                const auto    foundValueIt     = _values.find(formattedName);
-                const bool    isNewValue       = (foundValueIt == _values.end());
+                bool          isNewValue;
+                auto&         slot             = createSlot(formattedName, isNewValue);
 
-                _values[formattedName] = value;
+                slot.type = nullptr;
+                slot.boxed = value;
 
                 if (isNewValue)
+                {
+                    _names.push_back(formattedName);
+
+                    _propertyAdded->execute(shared_from_this(), formattedName);
+                }
+
+                _propReferenceChanged->execute(shared_from_this(), formattedName);
+                _propValueChanged->execute(shared_from_this(), formattedName);
+
+                return shared_from_this();
+            }
+
+            template <typename T>
+            typename std::enable_if<std::is_convertible<T, Value::Ptr>::value, Provider::Ptr>::type
+            set(const PropertyName& propertyName, T value, bool skipPropertyNameFormatting)
+            {
+                const auto    formattedName    = skipPropertyNameFormatting ? propertyName : formatPropertyName(propertyName);
+
+                bool          isNewValue;
+                auto&         slot             = createSlot(formattedName, isNewValue);
+                const bool    wasBoxed         = !isNewValue && slot.type == nullptr;
+
+                slot.type = nullptr;
+                slot.boxed = value;
+
+                if (!wasBoxed)
                 {
                     _valueChangedSlots[formattedName] = value->changed()->connect(std::bind(
                          &Signal<Provider::Ptr, const std::string&>::execute,
                          _propValueChanged,
                          shared_from_this(),
-                         formattedName
+                         formattedName.str()
                     ));
 
-                    _names.push_back(formattedName);
+                    if (isNewValue)
+                    {
+                        _names.push_back(formattedName);
 
-                    _propertyAdded->execute(shared_from_this(), formattedName);
+                        _propertyAdded->execute(shared_from_this(), formattedName);
+                    }
                 }
 
                 _propReferenceChanged->execute(shared_from_this(), formattedName);
@@ -218,14 +317,37 @@ namespace minko
             template <typename T>
             inline
             Ptr
-            set(const std::string& propertyName, T value)
+            set(const PropertyName& propertyName, T value)
             {
 				return Provider::set(propertyName, value, false);
             }
 
+            template <typename T>
+            inline
+            Ptr
+            set(const std::string& propertyName, T value, bool skipPropertyNameFormatting)
+            {
+                return Provider::set(PropertyName(propertyName), value, skipPropertyNameFormatting);
+            }
+
+            template <typename T>
+            inline
+            Ptr
+            set(const std::string& propertyName, T value)
+            {
+				return Provider::set(PropertyName(propertyName), value, false);
+            }
+
             virtual
             Ptr
-            unset(const std::string& propertyName);
+            unset(const PropertyName& propertyName);
+
+            inline
+            Ptr
+            unset(const std::string& propertyName)
+            {
+                return unset(PropertyName(propertyName));
+            }
 
             Ptr
             swap(const std::string& propertyName1, const std::string& propertyName2, bool skipPropertyNameFormatting = false);
@@ -242,8 +364,8 @@ namespace minko
 
 
             virtual
-            std::string
-            formatPropertyName(const std::string& propertyName) const
+            PropertyName
+            formatPropertyName(const PropertyName& propertyName) const
             {
                 return propertyName;
             }
@@ -254,6 +376,78 @@ namespace minko
             {
                 return propertyName;
             }
+
+        private:
+            template <typename T>
+            static
+            Any
+            boxValue(const void* data)
+            {
+                return Any(*reinterpret_cast<const T*>(data));
+            }
+
+            // linear probing from the hash of the name, that atoms compute once
+            inline
+            const ValueSlot*
+            findSlot(const PropertyName& formattedName) const
+            {
+                const auto mask = _slots.size() - 1;
+
+                for (auto i = formattedName.hash() & mask; _slots[i].used; i = (i + 1) & mask)
+                    if (_slots[i].name == formattedName)
+                        return &_slots[i];
+
+                return nullptr;
+            }
+
+            inline
+            ValueSlot*
+            findSlot(const PropertyName& formattedName)
+            {
+                return const_cast<ValueSlot*>(static_cast<const Provider*>(this)->findSlot(formattedName));
+            }
+
+            // values of a given type are always stored the same way: the storage is checked instead of the type
+            template <typename T>
+            T
+            getValue(const PropertyName& formattedName, std::true_type) const
+            {
+                const auto slot = findSlot(formattedName);
+
+                if (slot == nullptr || slot->type == nullptr)
+                    throw std::invalid_argument("propertyName");
+
+                return *reinterpret_cast<const T*>(&slot->data);
+            }
+
+            template <typename T>
+            T
+            getValue(const PropertyName& formattedName, std::false_type) const
+            {
+                const auto slot = findSlot(formattedName);
+
+                if (slot == nullptr || slot->type != nullptr)
+                    throw std::invalid_argument("propertyName");
+
+                return Any::unsafe_cast<T>(slot->boxed);
+            }
+
+            // the returned reference is valid until the next slot is created
+            ValueSlot&
+            createSlot(const PropertyName& formattedName, bool& isNewValue);
+
+            bool
+            eraseSlot(const PropertyName& formattedName);
+
+            void
+            unsetBoxedValue(const PropertyName& formattedName, ValueSlot& slot);
+
+            static
+            void
+            moveSlotValue(ValueSlot& source, ValueSlot& destination);
+
+            void
+            moveValue(const PropertyName& source, const PropertyName& destination);
         };
     }
 }
@@ -81,10 +81,10 @@ namespace minko
             }
 
             inline
-            std::string
-            formatPropertyName(const std::string& propertyName) const
+            PropertyName
+            formatPropertyName(const PropertyName& propertyName) const
             {
-                return _structureName + '.' + propertyName;
+                return _structureName + '.' + propertyName.str();
             }
 
             inline
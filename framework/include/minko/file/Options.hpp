@@ -76,6 +76,7 @@ namespace minko
             bool                                                _disposeVertexBufferAfterLoading;
             bool                                                _disposeTextureAfterLoading;
             bool                                                _storeDataIfNotParsed;
+            bool                                                _warmUpPrograms;
             unsigned int                                        _skinningFramerate;
             component::SkinningMethod                            _skinningMethod;
             std::shared_ptr<render::Effect>                     _effect;
@@ -146,6 +147,7 @@ namespace minko
                 opt->_uriFunction = options->_uriFunction;
                 opt->_nodeFunction = options->_nodeFunction;
                 opt->_loadAsynchronously = options->_loadAsynchronously;
+                opt->_warmUpPrograms = options->_warmUpPrograms;
 
                 return opt;
             }
@@ -347,6 +349,24 @@ namespace minko
                 return shared_from_this();
             }
 
+            // when enabled, loaded scenes compile the programs of their surfaces a few at a time
+            // once they are added to a scene with renderers, see component::ProgramWarmUpJob
+            inline
+            bool
+            warmUpPrograms() const
+            {
+                return _warmUpPrograms;
+            }
+
+            inline
+            Ptr
+            warmUpPrograms(bool value)
+            {
+                _warmUpPrograms = value;
+
+                return shared_from_this();
+            }
+
             inline
             unsigned int
             skinningFramerate() const
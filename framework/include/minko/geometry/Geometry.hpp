@@ -131,6 +131,12 @@ namespace minko
             void
             removeVertexBuffer(const std::string& vertexAttributeName);
 
+            // uses the buffers of a geometry with the very same vertex attributes and an index buffer:
+            // the properties keep their names, so draw calls rebind the new buffers instead of being
+            // built again
+            void
+            copyBuffers(Ptr geometry);
+
             inline
             unsigned int
             numVertices() const
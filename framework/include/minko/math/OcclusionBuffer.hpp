@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+    namespace math
+    {
+        // low resolution depth buffer the occluders are rasterized into on the CPU, with the farthest
+        // depth of each tile kept aside so that most occludees are rejected without reading pixels
+        class OcclusionBuffer
+        {
+        public:
+            typedef std::shared_ptr<OcclusionBuffer>    Ptr;
+
+        private:
+            typedef std::shared_ptr<Matrix4x4>          Matrix4x4Ptr;
+            typedef std::shared_ptr<Box>                BoxPtr;
+
+        private:
+            static const float                          MIN_W;
+
+            uint                                        _width;
+            uint                                        _height;
+            uint                                        _tileSize;
+            uint                                        _numTilesX;
+            uint                                        _numTilesY;
+
+            std::vector<float>                          _depth;
+            std::vector<float>                          _tileMaxDepth;
+            bool                                        _invalidTiles;
+
+            std::vector<float>                          _worldToScreen;
+            std::vector<float>                          _screenVertices; // x, y, z, w per vertex
+            uint                                        _numOccluderTriangles;
+
+        public:
+            inline static
+            Ptr
+            create(uint width = 256, uint height = 128, uint tileSize = 8)
+            {
+                return std::shared_ptr<OcclusionBuffer>(new OcclusionBuffer(width, height, tileSize));
+            }
+
+            inline
+            uint
+            width() const
+            {
+                return _width;
+            }
+
+            inline
+            uint
+            height() const
+            {
+                return _height;
+            }
+
+            inline
+            uint
+            numOccluderTriangles() const
+            {
+                return _numOccluderTriangles;
+            }
+
+            // depth of a pixel in [0, 1], 1 when no occluder covers it
+            inline
+            float
+            depth(uint x, uint y) const
+            {
+                return _depth[x + y * _width];
+            }
+
+            void
+            clear(Matrix4x4Ptr worldToScreen);
+
+            void
+            rasterize(const std::vector<float>&             vertices,
+                      uint                                  vertexSize,
+                      uint                                  positionOffset,
+                      const std::vector<unsigned short>&    indices,
+                      Matrix4x4Ptr                          modelToWorld = nullptr);
+
+            // world space box, as a hull for occluders without a CPU side geometry
+            void
+            rasterize(BoxPtr box);
+
+            // true when the world space box is entirely behind the occluders
+            bool
+            occluded(BoxPtr box);
+
+        private:
+            OcclusionBuffer(uint width, uint height, uint tileSize);
+
+            void
+            transform(const float* matrix, float x, float y, float z, float* output) const;
+
+            void
+            rasterizeTriangle(const float* v0, const float* v1, const float* v2);
+
+            void
+            updateTiles();
+        };
+    }
+}
@@ -92,6 +92,64 @@ namespace minko
             void
             drawTriangles(const uint indexBuffer, const int numTriangles) = 0;
 
+            // true when per-instance vertex attributes and instanced draws are available
+            virtual
+            bool
+            supportsInstancing() = 0;
+
+            virtual
+            void
+            drawInstancedTriangles(const uint indexBuffer, const int numTriangles, const int numInstances) = 0;
+
+            // true when the GPU time elapsed between two points of the command stream can be measured
+            virtual
+            bool
+            supportsTimerQueries() = 0;
+
+            virtual
+            uint
+            createTimerQuery() = 0;
+
+            virtual
+            void
+            deleteTimerQuery(uint query) = 0;
+
+            virtual
+            void
+            beginTimerQuery(uint query) = 0;
+
+            virtual
+            void
+            endTimerQuery() = 0;
+
+            // false as long as the GPU has not executed the commands measured by the query
+            virtual
+            bool
+            timerQueryAvailable(uint query) = 0;
+
+            // elapsed GPU time in milliseconds, negative when the measure was invalidated
+            virtual
+            float
+            timerQueryResult(uint query) = 0;
+
+            // true when the vertex attribute bindings can be stored in vertex array objects
+            virtual
+            bool
+            supportsVertexArrays() = 0;
+
+            virtual
+            uint
+            createVertexArray() = 0;
+
+            virtual
+            void
+            deleteVertexArray(uint vertexArray) = 0;
+
+            // while a vertex array is bound, setVertexBufferAt() modifies it: 0 restores the default one
+            virtual
+            void
+            setVertexArray(uint vertexArray) = 0;
+
             virtual
             const uint
             createVertexBuffer(const uint size) = 0;
@@ -102,7 +160,8 @@ namespace minko
                               const uint    vertexBuffer,
                               const uint    size,
                               const uint    stride,
-                              const uint    offset) = 0;
+                              const uint    offset,
+                              const uint    divisor = 0) = 0; // divisor > 0: advances once every divisor instances
 
             virtual
             void
@@ -251,6 +310,31 @@ namespace minko
             std::shared_ptr<ProgramInputs>
             getProgramInputs(const uint program) = 0;
 
+            // true when linked programs can be read back and loaded again in the driver's binary format
+            virtual
+            bool
+            supportsProgramBinaries() = 0;
+
+            // false when the program is not linked or its binary cannot be read back
+            virtual
+            bool
+            getProgramBinary(const uint program, uint& format, std::vector<unsigned char>& binary) = 0;
+
+            // false when the driver rejects the binary: the program must then be linked from its shaders
+            virtual
+            bool
+            loadProgramBinary(const uint program, const uint format, const std::vector<unsigned char>& binary) = 0;
+
+            // linked programs are looked up in and saved to this cache, if any, instead of being
+            // compiled every time
+            virtual
+            std::shared_ptr<ProgramCache>
+            programCache() = 0;
+
+            virtual
+            void
+            programCache(std::shared_ptr<ProgramCache> programCache) = 0;
+
             virtual
             void
             setUniform(uint location, int value) = 0;
@@ -0,0 +1,264 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/render/Blending.hpp"
+
+namespace minko
+{
+    namespace render
+    {
+        // Compact stream of context commands that can be recorded once and replayed on any
+        // AbstractContext. Uniforms and draw call render targets are referenced by pointer so
+        // that replaying a stream always reads their current values.
+        class CommandBuffer
+        {
+        public:
+            typedef std::shared_ptr<CommandBuffer>    Ptr;
+
+            enum class UniformType : unsigned char
+            {
+                FLOAT1, FLOAT2, FLOAT3, FLOAT4, FLOAT16,
+                INT1, INT2, INT3, INT4,
+                FLOATS1, FLOATS2, FLOATS3, FLOATS4, FLOATS16,
+                INTS1, INTS2, INTS3, INTS4
+            };
+
+            struct UniformValue
+            {
+                UniformType                             type;
+                int                                     location;
+                union
+                {
+                    float                               floatValue;
+                    int                                 intValues[4];
+                    math::Vector2*                      vector2;
+                    math::Vector3*                      vector3;
+                    math::Vector4*                      vector4;
+                    const float*                        matrix;
+                    const data::UniformArray<float>*    floatArray;
+                    const data::UniformArray<int>*      intArray;
+                };
+                std::shared_ptr<void>                   owner; // keeps referenced values alive
+            };
+
+            // renderer and root uniforms last uploaded to a program during the current frame
+            struct UniformBlock
+            {
+                const std::vector<UniformValue>*        uniforms;
+            };
+
+            // uniforms that are the same for all the draw calls of a frame sharing the same program and
+            // data: they are skipped when the very same values were the last ones uploaded to the program
+            struct SharedUniforms
+            {
+                std::vector<UniformValue>               uniforms;
+                std::shared_ptr<UniformBlock>           block;
+            };
+
+        private:
+            typedef std::shared_ptr<AbstractContext>    AbsContextPtr;
+
+            enum class Operation : unsigned char
+            {
+                SET_TARGET,
+                SET_RENDER_TO_TEXTURE,
+                SET_RENDER_TO_BACK_BUFFER,
+                CONFIGURE_VIEWPORT,
+                SET_PROGRAM,
+                SET_UNIFORM,
+                SET_SHARED_UNIFORMS,
+                SET_TEXTURE_AT,
+                SET_SAMPLER_STATE_AT,
+                SET_VERTEX_BUFFER_AT,
+                SET_VERTEX_ARRAY,
+                SET_COLOR_MASK,
+                SET_BLEND_MODE,
+                SET_DEPTH_TEST,
+                SET_STENCIL_TEST,
+                SET_SCISSOR_TEST,
+                SET_TRIANGLE_CULLING,
+                DRAW_TRIANGLES,
+                DRAW_INSTANCED_TRIANGLES
+            };
+
+            struct Command
+            {
+                Operation                               operation;
+                union
+                {
+                    int                                 args[6];
+                    const UniformValue*                 uniform;
+                    const SharedUniforms*               sharedUniforms;
+                    AbstractTexture*                    target;
+                };
+            };
+
+        private:
+            std::vector<Command>                        _commands;
+
+        public:
+            inline static
+            Ptr
+            create()
+            {
+                return std::shared_ptr<CommandBuffer>(new CommandBuffer());
+            }
+
+            inline
+            uint
+            size() const
+            {
+                return _commands.size();
+            }
+
+            inline
+            void
+            clear()
+            {
+                _commands.clear();
+            }
+
+            void
+            append(const CommandBuffer& buffer, uint begin, uint end);
+
+            inline
+            void
+            execute(const AbsContextPtr& context) const
+            {
+                execute(context, 0, _commands.size());
+            }
+
+            void
+            execute(const AbsContextPtr& context, uint begin, uint end) const;
+
+            // switches to the target and clears it unless it is already the current render target
+            void
+            setTarget(AbstractTexture* target);
+
+            void
+            setRenderToTexture(uint texture);
+
+            void
+            setRenderToBackBuffer();
+
+            void
+            configureViewport(int x, int y, int width, int height);
+
+            void
+            setProgram(uint program);
+
+            void
+            setUniform(const UniformValue* uniform);
+
+            void
+            setSharedUniforms(const SharedUniforms* sharedUniforms);
+
+            void
+            setTextureAt(uint position, int texture, int location);
+
+            void
+            setSamplerStateAt(uint position, WrapMode, TextureFilter, MipFilter);
+
+            void
+            setVertexBufferAt(uint position, uint vertexBuffer, uint size, uint stride, uint offset, uint divisor = 0);
+
+            void
+            setVertexArray(uint vertexArray);
+
+            void
+            setColorMask(bool colorMask);
+
+            void
+            setBlendMode(Blending::Mode blendMode);
+
+            void
+            setDepthTest(bool depthMask, CompareMode depthFunc);
+
+            void
+            setStencilTest(CompareMode      stencilFunc,
+                           int              stencilRef,
+                           uint             stencilMask,
+                           StencilOperation stencilFailOp,
+                           StencilOperation stencilZFailOp,
+                           StencilOperation stencilZPassOp);
+
+            void
+            setScissorTest(bool scissorTest, const ScissorBox& scissorBox);
+
+            void
+            setTriangleCulling(TriangleCulling triangleCulling);
+
+            void
+            drawTriangles(uint indexBuffer, int numTriangles);
+
+            void
+            drawInstancedTriangles(uint indexBuffer, int numTriangles, int numInstances);
+
+            static inline
+            void
+            setUniform(const AbsContextPtr& context, const UniformValue& uniform)
+            {
+                setUniform(context, uniform, uniform.location);
+            }
+
+            // uploads the value of the uniform at another location, ie. the one of the same uniform in
+            // another program
+            static
+            void
+            setUniform(const AbsContextPtr& context, const UniformValue& uniform, int location);
+
+            static
+            void
+            setSharedUniforms(const AbsContextPtr& context, const SharedUniforms& sharedUniforms);
+
+            // the value uploaded at location, appended to uniforms the first time: slots maps each location
+            // to the index of its value in uniforms, or -1, and is grown as needed
+            static
+            UniformValue&
+            uniformValue(std::vector<UniformValue>& uniforms, std::vector<int>& slots, int location);
+
+        private:
+            static
+            bool
+            sameUniformValue(const UniformValue& a, const UniformValue& b);
+
+            CommandBuffer() :
+                _commands()
+            {
+            }
+
+            inline
+            Command&
+            push(Operation operation)
+            {
+                _commands.emplace_back();
+
+                auto& command = _commands.back();
+
+                command.operation = operation;
+
+                return command;
+            }
+        };
+    }
+}
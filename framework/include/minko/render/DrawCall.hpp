@@ -29,6 +29,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/ProgramInputs.hpp"
 #include "minko/render/States.hpp"
 #include "minko/render/AbstractTexture.hpp"
+#include "minko/render/CommandBuffer.hpp"
 #include "minko/render/Priority.hpp"
 #include "minko/scene/Layout.hpp"
 
@@ -44,6 +45,15 @@ namespace minko
         public:
             typedef std::shared_ptr<DrawCall>                               Ptr;
 
+            // program drawing only the depth of the draw calls using another program, with the locations
+            // their uniforms and vertex attributes have in it, see DrawCallPool::depthProgram()
+            struct DepthProgram
+            {
+                std::shared_ptr<Program>                                    program;
+                std::unordered_map<int, int>                                uniformLocations;
+                std::unordered_map<int, int>                                attributeLocations;
+            };
+
         private:
             enum class ContainerId{ COMPLETE = 0, FILTERED };
 
@@ -53,6 +63,7 @@ namespace minko
             typedef std::shared_ptr<data::Provider>                         ProviderPtr;
             typedef std::shared_ptr<data::Container>                        ContainerPtr;
             typedef std::shared_ptr<Program>                                ProgramPtr;
+            typedef std::shared_ptr<VertexBuffer>                           VertexBufferPtr;
 
             typedef data::Container::PropertyChangedSignal::Slot            PropertyChangedSlot;
 
@@ -60,9 +71,16 @@ namespace minko
             typedef std::tuple<int, int, int>                               Int3;
             typedef std::tuple<int, int, int, int>                          Int4;
 
+            typedef CommandBuffer::UniformType                              UniformType;
+            typedef CommandBuffer::UniformValue                             UniformValue;
+            typedef std::shared_ptr<CommandBuffer::UniformBlock>            UniformBlockPtr;
+            typedef std::shared_ptr<DepthProgram>                           DepthProgramPtr;
+
         private:
             static const unsigned int                                       MAX_NUM_TEXTURES;
             static const unsigned int                                       MAX_NUM_VERTEXBUFFERS;
+            static const float                                              SORT_KEY_PRIORITY_OFFSET;
+            static const float                                              SORT_KEY_PRIORITY_SCALE;
 
             static SamplerState                                             _defaultSamplerState;
 
@@ -78,6 +96,8 @@ namespace minko
             std::shared_ptr<data::Container>                                _fullRootData;
 
             std::shared_ptr<Program>                                        _program;
+            DepthProgramPtr                                                 _depthProgram;
+            bool                                                            _depthProgramResolved; // even when none exists
 
             std::list<Signal<ContainerPtr, ProviderPtr>::Slot>              _containerUpdateSlots;
 
@@ -88,6 +108,7 @@ namespace minko
             std::vector<int>                                                _vertexSizes;
             std::vector<int>                                                _vertexAttributeSizes;
             std::vector<int>                                                _vertexAttributeOffsets;
+            std::vector<uint>                                               _vertexAttributeDivisors;
             std::vector<int>                                                _textureIds;
             std::vector<int>                                                _textureLocations;
             std::vector<WrapMode>                                           _textureWrapMode;
@@ -96,6 +117,11 @@ namespace minko
             std::vector<TextureType>                                        _textureTypes;
             uint                                                            _numIndices;
             uint                                                            _indexBuffer;
+            VertexBufferPtr                                                 _instanceBuffer;
+            uint                                                            _numInstances;
+            uint                                                            _vertexArray;
+            AbsCtxPtr                                                       _vertexArrayContext;
+            bool                                                            _vertexArrayInvalid;
             AbsTexturePtr                                                   _target;
             render::Blending::Mode                                          _blendMode;
             bool                                                            _colorMask;
@@ -113,24 +139,11 @@ namespace minko
             Layouts                                                         _layouts;
             float                                                           _priority;
             bool                                                            _zsorted;
-            std::unordered_map<uint, float>                                 _uniformFloat;
-            std::unordered_map<uint, std::shared_ptr<math::Vector2>>        _uniformFloat2;
-            std::unordered_map<uint, std::shared_ptr<math::Vector3>>        _uniformFloat3;
-            std::unordered_map<uint, std::shared_ptr<math::Vector4>>        _uniformFloat4;
-            std::unordered_map<uint, const float*>                          _uniformFloat16;
-            std::unordered_map<uint, int>                                   _uniformInt;
-            std::unordered_map<uint, Int2>                                  _uniformInt2;
-            std::unordered_map<uint, Int3>                                  _uniformInt3;
-            std::unordered_map<uint, Int4>                                  _uniformInt4;
-            std::unordered_map<uint, data::UniformArrayPtr<float>>          _uniformFloats;
-            std::unordered_map<uint, data::UniformArrayPtr<float>>          _uniformFloats2;
-            std::unordered_map<uint, data::UniformArrayPtr<float>>          _uniformFloats3;
-            std::unordered_map<uint, data::UniformArrayPtr<float>>          _uniformFloats4;
-            std::unordered_map<uint, data::UniformArrayPtr<float>>          _uniformFloats16;
-            std::unordered_map<uint, data::UniformArrayPtr<int>>            _uniformInts;
-            std::unordered_map<uint, data::UniformArrayPtr<int>>            _uniformInts2;
-            std::unordered_map<uint, data::UniformArrayPtr<int>>            _uniformInts3;
-            std::unordered_map<uint, data::UniformArrayPtr<int>>            _uniformInts4;
+            std::vector<UniformValue>                                       _uniforms;
+            CommandBuffer::SharedUniforms                                   _sharedUniforms;
+            std::vector<int>                                                _uniformSlots;          // location -> index in _uniforms
+            std::vector<int>                                                _sharedUniformSlots;    // location -> index in _sharedUniforms
+            uint                                                            _revision;
 
             std::unordered_map<std::string, std::list<Any>>                                           _referenceChangedSlots;        // Any = PropertyChangedSlot
             std::list<PropertyChangedSlot>                                                            _macroAddedOrRemovedSlots;
@@ -139,6 +152,8 @@ namespace minko
             Signal<ContainerPtr, const std::string&>::Slot                                            _layoutsPropertyChangedSlot;
 
             Signal<Ptr>::Ptr                                                _zsortNeeded;
+            Signal<Ptr>::Ptr                                                _layoutsChanged;
+            Signal<Ptr>::Ptr                                                _zSortedChanged;
             Signal<Ptr, ContainerPtr, const std::string&>::Ptr              _macroChanged;
 
             std::unordered_map<uint, std::set<std::string>>                 _containerMacroPNames;
@@ -158,6 +173,11 @@ namespace minko
                 return ptr;
             }
 
+            ~DrawCall()
+            {
+                deleteVertexArray();
+            }
+
             inline
             std::shared_ptr<Pass>
             pass() const
@@ -165,6 +185,13 @@ namespace minko
                 return _pass;
             }
 
+            inline
+            ProgramPtr
+            program() const
+            {
+                return _program;
+            }
+
             inline
             ContainerPtr
             targetData() const
@@ -223,6 +250,77 @@ namespace minko
                 return _layouts;
             }
 
+            // incremented each time the bindings change, see Renderer::commandBufferEnabled()
+            inline
+            uint
+            revision() const
+            {
+                return _revision;
+            }
+
+            // the renderer and root uniforms are uploaded through the block shared by the draw calls using
+            // the same program, see DrawCallPool::uniformBlock()
+            inline
+            UniformBlockPtr
+            uniformBlock() const
+            {
+                return _sharedUniforms.block;
+            }
+
+            inline
+            void
+            uniformBlock(UniformBlockPtr block)
+            {
+                _sharedUniforms.block = block;
+            }
+
+            inline
+            DepthProgramPtr
+            depthProgram() const
+            {
+                return _depthProgram;
+            }
+
+            inline
+            void
+            depthProgram(DepthProgramPtr depthProgram)
+            {
+                _depthProgram = depthProgram;
+                _depthProgramResolved = true;
+
+                ++_revision;
+            }
+
+            // whether the depth program, possibly nullptr, was set since the program last changed
+            inline
+            bool
+            depthProgramResolved() const
+            {
+                return _depthProgramResolved;
+            }
+
+            // whether the draw call can be drawn depth-only before the others by renderDepth(), its
+            // color then only being computed for the pixels where it is the nearest opaque surface
+            bool
+            depthPrePassCompatible() const;
+
+            inline
+            uint
+            numInstances() const
+            {
+                return _numInstances;
+            }
+
+            // draws the geometry numInstances times, the program attributes found in the instance buffer
+            // advancing once per instance: takes effect the next time the draw call is configured
+            inline
+            void
+            instances(VertexBufferPtr instanceBuffer, uint numInstances)
+            {
+                _instanceBuffer = instanceBuffer;
+                _numInstances   = instanceBuffer ? numInstances : 0;
+            }
+
             inline
             bool
             zSorted() const
@@ -244,10 +342,27 @@ namespace minko
             void
             unbind();
 
+            // when depthPrePass is true and the draw call is depth pre-pass compatible, only the pixels whose
+            // depth was written by renderDepth() are drawn
             void
             render(const std::shared_ptr<AbstractContext>&  context,
                    AbsTexturePtr                            renderTarget,
-                   const render::ScissorBox&                viewport);
+                   const render::ScissorBox&                viewport,
+                   bool                                     depthPrePass = false);
+
+            // encodes the same commands as render() in a buffer that can be replayed
+            // as long as revision() does not change
+            void
+            record(CommandBuffer&                           buffer,
+                   AbsTexturePtr                            renderTarget,
+                   const render::ScissorBox&                viewport,
+                   bool                                     depthPrePass = false);
+
+            // draws the depth of the draw call only, with its depth program
+            void
+            renderDepth(const std::shared_ptr<AbstractContext>& context,
+                        AbsTexturePtr                           renderTarget,
+                        const render::ScissorBox&               viewport);
 
             void
             initialize(ContainerPtr                                 data,
@@ -256,6 +371,10 @@ namespace minko
             std::shared_ptr<math::Vector3>
             getEyeSpacePosition(std::shared_ptr<math::Vector3> output = nullptr);
 
+            // packed key used to radix sort draw calls, see DrawCallPool::drawCalls()
+            uint64_t
+            sortKey();
+
             inline
             Signal<Ptr>::Ptr
             zsortNeeded() const
@@ -263,6 +382,21 @@ namespace minko
                 return _zsortNeeded;
             }
 
+            inline
+            Signal<Ptr>::Ptr
+            layoutsChanged() const
+            {
+                return _layoutsChanged;
+            }
+
+            // executed when a state binding change makes zSorted() flip
+            inline
+            Signal<Ptr>::Ptr
+            zSortedChanged() const
+            {
+                return _zSortedChanged;
+            }
+
             inline
             Signal<Ptr, ContainerPtr, const std::string&>::Ptr
             macroChanged() const
@@ -286,6 +420,9 @@ namespace minko
             void
             bind();
 
+            void
+            bindRenderTarget(const AbsCtxPtr& context, AbsTexturePtr renderTarget, const render::ScissorBox& viewport);
+
             void
             trackMacros();
 
@@ -310,17 +447,28 @@ namespace minko
             void
             bindTextureSampler(const std::string& propertyName, int location, uint textureIndex, const SamplerState&);
 
+            // (re)builds the vertex array holding the attribute bindings when the context supports them,
+            // returns false when the attributes have to be bound one by one instead
+            bool
+            updateVertexArray(const AbsCtxPtr& context);
+
+            void
+            deleteVertexArray();
+
             void
             bindUniform(const std::string& propertyName, ProgramInputs::Type, int location);
 
             void
-            bindUniformArray(const std::string& propertyName, ContainerPtr, ProgramInputs::Type, int location);
+            bindUniformArray(const std::string& propertyName, ContainerPtr, ProgramInputs::Type, int location, std::vector<UniformValue>& uniforms);
+
+            UniformValue&
+            setUniformValue(std::vector<UniformValue>& uniforms, int location, UniformType, std::shared_ptr<void> owner = nullptr);
 
             void
-            bindFloatUniformArray(const std::string& propertyName, ContainerPtr, ProgramInputs::Type, int location);
+            bindFloatUniformArray(const std::string& propertyName, ContainerPtr, ProgramInputs::Type, int location, std::vector<UniformValue>& uniforms);
 
             void
-            bindIntegerUniformArray(const std::string& propertyName, ContainerPtr, ProgramInputs::Type, int location);
+            bindIntegerUniformArray(const std::string& propertyName, ContainerPtr, ProgramInputs::Type, int location, std::vector<UniformValue>& uniforms);
 
             void
             watchUniformRefChange(ContainerPtr, const std::string& propertyName, ProgramInputs::Type, int location);
@@ -338,6 +486,7 @@ namespace minko
                 const auto&                stateBindings    = _pass->stateBindings();
                 data::Container::Ptr    container        = nullptr;
                 std::string                propertyName    = "";
+                const bool              wasZSorted      = zSorted();
 
                 if (stateBindings.count(stateName) > 0)
                 {
@@ -361,7 +510,7 @@ namespace minko
                             shared_from_this(),
                             stateName,
                             defaultValue,
-                            stateValue
+                            std::ref(stateValue)
                         )));
                     }
                 }
@@ -369,6 +518,11 @@ namespace minko
                     stateValue = defaultValue;
 
                 uploadIfTexture<T>(stateValue);
+
+                ++_revision;
+
+                if (zSorted() != wasZSorted)
+                    _zSortedChanged->execute(shared_from_this());
             }
 
 
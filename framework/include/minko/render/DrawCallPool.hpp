@@ -21,6 +21,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/Common.hpp"
 #include "minko/Signal.hpp"
+#include "minko/scene/Layout.hpp"
+#include "minko/render/CommandBuffer.hpp"
+#include "minko/render/DrawCall.hpp"
 
 namespace std
 {
@@ -51,6 +54,9 @@ namespace minko
         public:
             typedef std::shared_ptr<DrawCallPool>                                                       Ptr;
 
+            // non-owning view of the draw calls to render, valid until the next call to drawCalls()
+            typedef std::vector<DrawCall*>                                                              DrawCallView;
+
         private:
             typedef std::shared_ptr<DrawCall>                                                           DrawCallPtr;
             typedef std::shared_ptr<math::Vector3>                                                      Vector3Ptr;
@@ -61,6 +67,14 @@ namespace minko
             typedef std::shared_ptr<scene::Node>                                                        NodePtr;
             typedef std::shared_ptr<data::ArrayProvider>                                                ArrayProviderPtr;
             typedef std::shared_ptr<data::AbstractFilter>                                               AbstractFilterPtr;
+            typedef std::shared_ptr<data::ContainerView>                                                ContainerViewPtr;
+            typedef std::shared_ptr<Program>                                                            ProgramPtr;
+            typedef std::shared_ptr<VertexBuffer>                                                       VertexBufferPtr;
+            typedef std::shared_ptr<math::Matrix4x4>                                                    Matrix4x4Ptr;
+            typedef std::shared_ptr<CommandBuffer::UniformBlock>                                        UniformBlockPtr;
+            typedef std::shared_ptr<DrawCall::DepthProgram>                                             DepthProgramPtr;
+            typedef std::shared_ptr<Shader>                                                             ShaderPtr;
+            typedef std::shared_ptr<material::Material>                                                 MaterialPtr;
 
             typedef std::unordered_set<std::string>                                                     Techniques;
 
@@ -69,11 +83,36 @@ namespace minko
             typedef Signal<SurfacePtr, const std::string&, bool>                                        TechniqueChanged;
             typedef Signal<SurfacePtr, RendererPtr, bool>                                               VisibilityChanged;
             typedef Signal<DrawCallPtr>                                                                 ZSortNeeded;
+            typedef Signal<DrawCallPtr>                                                                 LayoutsChanged;
             typedef Signal<ArrayProviderPtr, uint>                                                      ArrayIndexChanged;
             typedef Signal<RendererPtr, AbstractFilterPtr, data::BindingSource, SurfacePtr>             RendererFilterChanged;
+            typedef Signal<ContainerViewPtr>                                                            ContainerViewChanged;
+            typedef Signal<data::Value::Ptr>::Slot                                                      ValueChangedSlot;
+
+            typedef std::pair<uint64_t, uint>                                                           SortKeyAndIndex;
+
+            // draw calls merged in a single instanced draw call: the first one draws all of them,
+            // streaming their model to world matrices in the instance buffer
+            struct InstanceGroup
+            {
+                ProgramPtr                      program; // program of the draw calls before instancing
+                std::vector<DrawCallPtr>        drawCalls;
+                std::vector<Matrix4x4Ptr>       modelToWorldMatrices;
+                std::vector<ValueChangedSlot>   modelToWorldChangedSlots;
+                VertexBufferPtr                 instanceBuffer;
+                uint                            firstChanged; // instances to stream again, none when > lastChanged
+                uint                            lastChanged;
+            };
+
+            typedef std::shared_ptr<InstanceGroup>                                                      InstanceGroupPtr;
+            // the providers of the other target properties bound to uniforms come last: draw calls reading
+            // them from different providers (ie. a per node picking color) are not merged
+            typedef std::tuple<Pass*, Program*, geometry::Geometry*, data::Provider*, AbstractTexture*, Layouts,
+                               std::vector<data::Provider*>>                                            InstanceKey;
 
         private:
             static const unsigned int                                                                   NUM_FALLBACK_ATTEMPTS;
+            static const unsigned int                                                                   MIN_NUM_INSTANCES;
             static std::unordered_map<std::string, std::pair<std::string, int>>                         _variablePropertyNameToPosition;
             static std::unordered_map<DrawCallPtr, Vector3Ptr>                                          _cachedDrawcallPositions; // in eye space
 
@@ -88,16 +127,50 @@ namespace minko
             std::unordered_map<DrawCallPtr, SurfacePtr>                                                 _drawcallToSurface;
             std::unordered_map<DrawCallPtr, DrawCallMacroChanged::Slot>                                 _drawcallToMacroChangedSlot;
             std::unordered_map<DrawCallPtr, ZSortNeeded::Slot>                                          _drawcallToZSortNeededSlot;
+            std::unordered_map<DrawCallPtr, LayoutsChanged::Slot>                                       _drawcallToLayoutsChangedSlot;
+            std::unordered_map<DrawCallPtr, ZSortNeeded::Slot>                                          _drawcallToZSortedChangedSlot;
             std::unordered_map<SurfacePtr, ContainerPtr>                                                _surfaceToRootContainer;
+
+            // filtered target, renderer and root data of each surface, indexed by binding source and
+            // shared by the draw calls of all its passes
+            std::unordered_map<SurfacePtr, std::vector<ContainerViewPtr>>                               _surfaceToContainerViews;
+            std::unordered_multimap<SurfacePtr, ContainerViewChanged::Slot>                             _surfaceToContainerViewChangedSlots;
             std::unordered_map<SurfacePtr, uint>                                                        _surfaceToMaterialProviderIndex;
             std::list<DrawCallPtr>                                                                      _drawCalls;
 
             std::set<DrawCallPtr>                                                                       _dirtyDrawCalls;
+            bool                                                                                        _mustSort; // forces sorting all the draw calls at next frame
             bool                                                                                        _mustZSort; // forces z-sorting at next frame
+            uint                                                                                        _revision; // incremented when the draw call list changes
+
+            // draw calls bucketed by layout mask, each bucket is rebuilt when its revision is outdated
+            std::unordered_map<Layouts, std::pair<uint, DrawCallView>>                                  _layoutMaskToDrawCalls;
+
+            bool                                                                                        _sortKeysEnabled;
+            std::vector<SortKeyAndIndex>                                                                _sortKeys;
+            std::vector<SortKeyAndIndex>                                                                _sortKeysBuffer;
+            std::vector<DrawCallPtr>                                                                    _sortedDrawCalls;
+
+            // opaque draw calls are sorted by key when the draw call list changes, z-sorted (transparent)
+            // draw calls are sorted by depth every time one of them moves
+            std::vector<DrawCallPtr>                                                                    _opaqueDrawCalls;
+            std::vector<DrawCallPtr>                                                                    _transparentDrawCalls;
+            std::vector<float>                                                                          _transparentDepths;
+
+            bool                                                                                        _instancingEnabled;
+            bool                                                                                        _mustUpdateInstanceGroups;
+            std::unordered_map<DrawCallPtr, InstanceGroupPtr>                                           _leaderToInstanceGroup;
+            std::unordered_set<DrawCallPtr>                                                             _instancedDrawCalls; // drawn by their group leader
+
+            std::unordered_map<ProgramPtr, UniformBlockPtr>                                             _programToUniformBlock;
+            std::unordered_map<ProgramPtr, DepthProgramPtr>                                             _programToDepthProgram;
+            ShaderPtr                                                                                   _depthFragmentShader;
 
             std::unordered_map<SurfacePtr, TechniqueChanged::Slot>                                      _surfaceToTechniqueChangedSlot;
             std::unordered_multimap<SurfacePtr, VisibilityChanged::Slot>                                _surfaceToVisibilityChangedSlots;
             std::unordered_multimap<SurfacePtr, ArrayIndexChanged::Slot>                                _surfaceToIndexChangedSlots;
+            // the target properties of instanced draw calls must come from the same providers
+            std::unordered_multimap<SurfacePtr, PropertyChanged::Slot>                                  _surfaceToTargetPropertySlots;
 
             std::unordered_map<SurfacePtr, std::unordered_map<std::string, Techniques>>                 _surfaceBadMacroToTechniques;
             std::unordered_map<SurfacePtr, std::unordered_map<std::string, PropertyChanged::Slot>>      _surfaceBadMacroToChangedSlot;
@@ -116,15 +189,88 @@ namespace minko
                 return ptr;
             }
 
+            ~DrawCallPool();
+
             const std::list<std::shared_ptr<DrawCall>>&
             drawCalls();
 
+            // draw calls matching the layout mask, in rendering order
+            const DrawCallView&
+            drawCalls(Layouts layoutMask);
+
+            // surface a draw call was generated for
+            SurfacePtr
+            surface(DrawCallPtr drawCall) const;
+
+            // block through which the draw calls using the program upload their renderer and root uniforms
+            UniformBlockPtr
+            uniformBlock(ProgramPtr program);
+
+            // the renderer and root uniforms may have changed since the last frame: the first draw call
+            // of each program has to upload them again
+            void
+            invalidateUniformBlocks();
+
+            // program sharing the vertex shader of another one but writing no color, nullptr when the
+            // program cannot be replaced in a depth pre-pass (ie. its fragment shader discards fragments)
+            DepthProgramPtr
+            depthProgram(ProgramPtr program);
+
+            inline
+            uint
+            numDrawCalls() const
+            {
+                return _drawCalls.size();
+            }
+
+            inline
+            uint
+            revision() const
+            {
+                return _revision;
+            }
+
             void
             addSurface(SurfacePtr);
 
             void
             removeSurface(SurfacePtr);
 
+            // compiles the programs the surface will be drawn with, or would be drawn with if it used
+            // another material, so that they are not compiled in the middle of a frame
+            bool
+            warmUp(SurfacePtr, MaterialPtr material = nullptr);
+
+            inline
+            bool
+            sortKeysEnabled() const
+            {
+                return _sortKeysEnabled;
+            }
+
+            inline
+            void
+            sortKeysEnabled(bool value)
+            {
+                _sortKeysEnabled    = value;
+                _mustSort           = true;
+            }
+
+            inline
+            bool
+            instancingEnabled() const
+            {
+                return _instancingEnabled;
+            }
+
+            inline
+            void
+            instancingEnabled(bool value)
+            {
+                _instancingEnabled          = value;
+                _mustUpdateInstanceGroups   = true;
+            }
+
         private:
             explicit
             DrawCallPool(RendererPtr renderer);
@@ -138,6 +284,15 @@ namespace minko
                                PassPtr,
                                DrawCallPtr = nullptr);
 
+            FormatNameFunction
+            formatNameFunction(SurfacePtr, MaterialPtr, ContainerPtr targetData);
+
+            const std::vector<ContainerViewPtr>&
+            containerViews(SurfacePtr);
+
+            void
+            deleteContainerViews(SurfacePtr);
+
             std::shared_ptr<Program>
             getWorkingProgram(SurfacePtr,
                               PassPtr,
@@ -179,12 +334,21 @@ namespace minko
             void
             drawcallZSortNeededHandler(DrawCallPtr);
 
+            void
+            drawcallLayoutsChangedHandler(DrawCallPtr);
+
+            void
+            drawcallZSortedChangedHandler(DrawCallPtr);
+
             void
             surfaceBadMacroChangedHandler(SurfacePtr, const std::string&);
 
             void
             rendererFilterChangedHandler(RendererPtr, AbstractFilterPtr, data::BindingSource, SurfacePtr);
 
+            void
+            containerViewChangedHandler(SurfacePtr);
+
             std::string
             formatPropertyName(const std::string&                               rawPropertyName,
                                std::unordered_map<std::string, std::string>&    variablesToValue);
@@ -196,6 +360,38 @@ namespace minko
             static
             bool
             compareDrawCalls(DrawCallPtr, DrawCallPtr);
+
+            static
+            bool
+            shaderMayDiscard(const std::string& source);
+
+            void
+            sortDrawCallsByKey();
+
+            void
+            sortTransparentDrawCalls();
+
+            void
+            mergeDrawCalls();
+
+            void
+            updateInstanceGroups();
+
+            void
+            updateInstanceBuffers();
+
+            void
+            instanceDrawCall(DrawCallPtr, VertexBufferPtr instanceBuffer, uint numInstances);
+
+            bool
+            canBeInstanced(PassPtr, ProgramPtr);
+
+            std::vector<data::Provider*>
+            targetUniformProviders(DrawCallPtr);
+
+            static
+            void
+            radixSort(std::vector<SortKeyAndIndex>& keys, std::vector<SortKeyAndIndex>& buffer);
         };
     }
 }
@@ -36,6 +36,8 @@ namespace minko
 
         private:
             typedef std::shared_ptr<Pass>                                       PassPtr;
+            typedef std::shared_ptr<Program>                                    ProgramPtr;
+            typedef std::function<void(PassPtr, ProgramPtr)>                    ProgramReadyFunction;
             typedef std::shared_ptr<VertexBuffer>                               VertexBufferPtr;
             typedef std::shared_ptr<std::function<void(PassPtr)>>               OnPassFunctionPtr;
             typedef std::list<std::function<void(PassPtr)>>                     OnPassFunctionList;
@@ -221,6 +223,17 @@ namespace minko
             void
             removeTechnique(const std::string& name);
 
+            // compiles the programs of every pass of the technique ahead of time, falling back to other
+            // techniques like draw calls do; false when no technique can be used, otherwise programReady
+            // is called for each pass of the technique eventually used
+            bool
+            warmUp(const std::string&                   techniqueName,
+                   FormatNameFunction                   formatNameFunc,
+                   std::shared_ptr<data::Container>     targetData,
+                   std::shared_ptr<data::Container>     rendererData,
+                   std::shared_ptr<data::Container>     rootData,
+                   const ProgramReadyFunction&          programReady = nullptr);
+
         private:
             Effect(const std::string& name);
 
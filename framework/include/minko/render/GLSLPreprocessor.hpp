@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+    namespace render
+    {
+        // resolves the conditional directives of a GLSL source without a driver, so that the code
+        // actually compiled can be inspected on the CPU
+        class GLSLPreprocessor
+        {
+        public:
+            typedef std::unordered_map<std::string, std::string>   Macros;
+
+        public:
+            static
+            std::vector<std::string>
+            tokenize(const std::string& source);
+
+            // keeps the lines enabled by the conditional directives and collects the macros
+            static
+            std::string
+            process(const std::string& source, Macros& macros);
+
+            static inline
+            std::string
+            process(const std::string& source)
+            {
+                Macros macros;
+
+                return process(source, macros);
+            }
+
+            // evaluates the integer expressions found in #if and #elif directives
+            static
+            long
+            evaluate(const std::vector<std::string>& tokens, const Macros& macros);
+
+        private:
+            static
+            std::string
+            stripComments(const std::string& source);
+        };
+    }
+}
@@ -80,10 +80,7 @@ namespace minko
                 return ptr;
             }
 
-            ~IndexBuffer()
-            {
-                dispose();
-            }
+            ~IndexBuffer();
 
             inline
             std::vector<unsigned short>&
@@ -0,0 +1,559 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/render/AbstractContext.hpp"
+#include "minko/render/ProgramInputs.hpp"
+#include "minko/render/Blending.hpp"
+
+namespace minko
+{
+    namespace render
+    {
+        // Context that does not render anything: resources get fake ids, program inputs are read from
+        // the GLSL declarations and each frame (ended by present()) reports what would have been sent
+        // to the GPU. Meant for CPU benchmarks and regression tests on machines without GL.
+        class NullContext :
+            public AbstractContext,
+            public std::enable_shared_from_this<NullContext>
+        {
+        public:
+            typedef std::shared_ptr<NullContext> Ptr;
+
+            struct FrameStats
+            {
+                uint    numDrawCalls;
+                uint    numTriangles;
+                uint    numStateChanges;
+                uint    numUniforms;
+                uint    numUploadedBytes;
+
+                FrameStats() :
+                    numDrawCalls(0),
+                    numTriangles(0),
+                    numStateChanges(0),
+                    numUniforms(0),
+                    numUploadedBytes(0)
+                {
+                }
+            };
+
+            struct Call
+            {
+                std::string             function;
+                std::vector<double>     arguments;
+            };
+
+        private:
+            typedef std::tuple<uint, uint, uint, uint, uint>                        VertexBufferState;
+            typedef std::tuple<CompareMode, int, uint, StencilOperation, StencilOperation, StencilOperation>
+                                                                                    StencilState;
+            typedef std::tuple<bool, int, int, int, int>                            ScissorState;
+
+            static const uint                                       PROGRAM_BINARY_FORMAT;
+
+        private:
+            bool                                                    _errorsEnabled;
+            std::string                                             _driverInfo;
+            uint                                                    _nextId;
+
+            bool                                                    _recordCalls;
+            std::vector<Call>                                       _calls;
+            uint                                                    _numFrames;
+            FrameStats                                              _frameStats;
+            FrameStats                                              _currentFrameStats;
+
+            std::unordered_map<uint, std::pair<uint, uint>>         _textureSizes;
+            std::unordered_map<uint, std::string>                   _shaderSources;
+            std::unordered_map<uint, std::vector<uint>>             _programShaders;
+            std::unordered_map<uint, std::shared_ptr<ProgramInputs>> _programInputs;
+            std::unordered_map<uint, std::vector<std::string>>      _programSources;
+            std::shared_ptr<ProgramCache>                           _programCache;
+
+            uint                                                    _viewportWidth;
+            uint                                                    _viewportHeight;
+            uint                                                    _backBufferViewportWidth;
+            uint                                                    _backBufferViewportHeight;
+            uint                                                    _currentTarget;
+            uint                                                    _currentProgram;
+            std::vector<int>                                        _currentTexture;
+            uint                                                    _currentVertexArray;
+            std::vector<VertexBufferState>                          _currentVertexBuffer;
+            uint                                                    _currentBlendMode;
+            bool                                                    _currentColorMask;
+            std::pair<bool, CompareMode>                            _currentDepthTest;
+            TriangleCulling                                         _currentTriangleCulling;
+            StencilState                                            _currentStencilTest;
+            ScissorState                                            _currentScissorTest;
+
+        public:
+            static
+            Ptr
+            create()
+            {
+                return std::shared_ptr<NullContext>(new NullContext());
+            }
+
+            inline
+            bool
+            errorsEnabled()
+            {
+                return _errorsEnabled;
+            }
+
+            inline
+            void
+            errorsEnabled(bool errorsEnabled)
+            {
+                _errorsEnabled = errorsEnabled;
+            }
+
+            inline
+            const std::string&
+            driverInfo()
+            {
+                return _driverInfo;
+            }
+
+            inline
+            uint
+            renderTarget()
+            {
+                return _currentTarget;
+            }
+
+            inline
+            uint
+            viewportWidth()
+            {
+                return _viewportWidth;
+            }
+
+            inline
+            uint
+            viewportHeight()
+            {
+                return _viewportHeight;
+            }
+
+            inline
+            uint
+            currentProgram()
+            {
+                return _currentProgram;
+            }
+
+            inline
+            bool
+            recordCalls() const
+            {
+                return _recordCalls;
+            }
+
+            inline
+            void
+            recordCalls(bool value)
+            {
+                _recordCalls = value;
+            }
+
+            inline
+            const std::vector<Call>&
+            calls() const
+            {
+                return _calls;
+            }
+
+            inline
+            void
+            clearCalls()
+            {
+                _calls.clear();
+            }
+
+            inline
+            uint
+            numFrames() const
+            {
+                return _numFrames;
+            }
+
+            // stats of the last frame ended by present()
+            inline
+            const FrameStats&
+            frameStats() const
+            {
+                return _frameStats;
+            }
+
+            inline
+            const FrameStats&
+            currentFrameStats() const
+            {
+                return _currentFrameStats;
+            }
+
+            void
+            configureViewport(const uint x,
+                              const uint y,
+                              const uint width,
+                              const uint height);
+
+            void
+            clear(float red             = 0.f,
+                  float green           = 0.f,
+                  float blue            = 0.f,
+                  float alpha           = 0.f,
+                  float depth           = 1.f,
+                  uint  stencil         = 0,
+                  uint  mask            = 0xffffffff);
+
+            void
+            present();
+
+            void
+            drawTriangles(const uint indexBuffer, const int numTriangles);
+
+            inline
+            bool
+            supportsInstancing()
+            {
+                return true;
+            }
+
+            void
+            drawInstancedTriangles(const uint indexBuffer, const int numTriangles, const int numInstances);
+
+            // timer queries are always available and measure nothing
+            inline
+            bool
+            supportsTimerQueries()
+            {
+                return true;
+            }
+
+            uint
+            createTimerQuery();
+
+            void
+            deleteTimerQuery(uint query);
+
+            void
+            beginTimerQuery(uint query);
+
+            void
+            endTimerQuery();
+
+            bool
+            timerQueryAvailable(uint query);
+
+            float
+            timerQueryResult(uint query);
+
+            inline
+            bool
+            supportsVertexArrays()
+            {
+                return true;
+            }
+
+            uint
+            createVertexArray();
+
+            void
+            deleteVertexArray(uint vertexArray);
+
+            void
+            setVertexArray(uint vertexArray);
+
+            const uint
+            createVertexBuffer(const uint size);
+
+            void
+            setVertexBufferAt(const uint    position,
+                              const uint    vertexBuffer,
+                              const uint    size,
+                              const uint    stride,
+                              const uint    offset,
+                              const uint    divisor = 0);
+
+            void
+            uploadVertexBufferData(const uint   vertexBuffer,
+                                   const uint   offset,
+                                   const uint   size,
+                                   void*        data);
+
+            void
+            deleteVertexBuffer(const uint vertexBuffer);
+
+            const uint
+            createIndexBuffer(const uint size);
+
+            void
+            uploaderIndexBufferData(const uint  indexBuffer,
+                                    const uint  offset,
+                                    const uint  size,
+                                    void*       data);
+
+            void
+            deleteIndexBuffer(const uint indexBuffer);
+
+            uint
+            createTexture(TextureType   type,
+                          unsigned int  width,
+                          unsigned int  height,
+                          bool          mipMapping,
+                          bool          optimizeForRenderToTexture = false);
+
+            uint
+            createCompressedTexture(TextureType     type,
+                                    TextureFormat   format,
+                                    unsigned int    width,
+                                    unsigned int    height,
+                                    bool            mipMapping);
+
+            void
+            uploadTexture2dData(uint            texture,
+                                unsigned int    width,
+                                unsigned int    height,
+                                unsigned int    mipLevel,
+                                void*           data);
+
+            void
+            uploadCubeTextureData(uint                texture,
+                                  CubeTexture::Face   face,
+                                  unsigned int        width,
+                                  unsigned int        height,
+                                  unsigned int        mipLevel,
+                                  void*               data);
+
+            void
+            uploadCompressedTexture2dData(uint          texture,
+                                          TextureFormat format,
+                                          unsigned int  width,
+                                          unsigned int  height,
+                                          unsigned int  size,
+                                          unsigned int  mipLevel,
+                                          void*         data);
+
+            void
+            uploadCompressedCubeTextureData(uint                texture,
+                                            CubeTexture::Face   face,
+                                            TextureFormat       format,
+                                            unsigned int        width,
+                                            unsigned int        height,
+                                            unsigned int        mipLevel,
+                                            void*               data);
+
+            void
+            activateMipMapping(uint texture);
+
+            void
+            deleteTexture(uint texture);
+
+            void
+            setTextureAt(uint   position,
+                         int    texture     = 0,
+                         int    location    = -1);
+
+            void
+            setSamplerStateAt(uint          position,
+                              WrapMode      wrapping,
+                              TextureFilter filtering,
+                              MipFilter     mipFiltering);
+
+            const uint
+            createProgram();
+
+            void
+            attachShader(const uint program, const uint shader);
+
+            void
+            linkProgram(const uint program);
+
+            void
+            deleteProgram(const uint program);
+
+            void
+            setProgram(const uint program);
+
+            void
+            compileShader(const uint shader);
+
+            void
+            setShaderSource(const uint shader, const std::string& source);
+
+            const uint
+            createVertexShader();
+
+            void
+            deleteVertexShader(const uint vertexShader);
+
+            const uint
+            createFragmentShader();
+
+            void
+            deleteFragmentShader(const uint fragmentShader);
+
+            std::shared_ptr<ProgramInputs>
+            getProgramInputs(const uint program);
+
+            // the binary of a program is the sources of its shaders
+            inline
+            bool
+            supportsProgramBinaries()
+            {
+                return true;
+            }
+
+            bool
+            getProgramBinary(const uint program, uint& format, std::vector<unsigned char>& binary);
+
+            bool
+            loadProgramBinary(const uint program, const uint format, const std::vector<unsigned char>& binary);
+
+            inline
+            std::shared_ptr<ProgramCache>
+            programCache()
+            {
+                return _programCache;
+            }
+
+            inline
+            void
+            programCache(std::shared_ptr<ProgramCache> programCache)
+            {
+                _programCache = programCache;
+            }
+
+            void
+            setUniform(uint location, int value);
+
+            void
+            setUniform(uint location, int v1, int v2);
+
+            void
+            setUniform(uint location, int v1, int v2, int v3);
+
+            void
+            setUniform(uint location, int v1, int v2, int v3, int v4);
+
+            void
+            setUniform(uint location, float value);
+
+            void
+            setUniform(uint location, float v1, float v2);
+
+            void
+            setUniform(uint location, float v1, float v2, float v3);
+
+            void
+            setUniform(uint location, float v1, float v2, float v3, float v4);
+
+            void
+            setUniform(const uint& location, const uint& size, bool transpose, const float* values);
+
+            void
+            setUniforms(uint location, uint size, const float* values);
+
+            void
+            setUniforms2(uint location, uint size, const float* values);
+
+            void
+            setUniforms3(uint location, uint size, const float* values);
+
+            void
+            setUniforms4(uint location, uint size, const float* values);
+
+            void
+            setUniforms(uint location, uint size, const int* values);
+
+            void
+            setUniforms2(uint location, uint size, const int* values);
+
+            void
+            setUniforms3(uint location, uint size, const int* values);
+
+            void
+            setUniforms4(uint location, uint size, const int* values);
+
+            void
+            setBlendMode(Blending::Source source, Blending::Destination destination);
+
+            void
+            setBlendMode(Blending::Mode blendMode);
+
+            void
+            setColorMask(bool colorMask);
+
+            void
+            setDepthTest(bool depthMask, CompareMode depthFunc);
+
+            void
+            setStencilTest(CompareMode      stencilFunc,
+                           int              stencilRef,
+                           uint             stencilMask,
+                           StencilOperation stencilFailOp,
+                           StencilOperation stencilZFailOp,
+                           StencilOperation stencilZPassOp);
+
+            void
+            setScissorTest(bool scissorTest, const render::ScissorBox& scissorBox);
+
+            void
+            readPixels(unsigned char* pixels);
+
+            void
+            readPixels(unsigned int x, unsigned int y, unsigned int width, unsigned int height, unsigned char* pixels);
+
+            void
+            setTriangleCulling(TriangleCulling triangleCulling);
+
+            void
+            setRenderToBackBuffer();
+
+            void
+            setRenderToTexture(unsigned int texture, bool enableDepthAndStencil = false);
+
+            void
+            generateMipmaps(unsigned int texture);
+
+        private:
+            NullContext();
+
+            void
+            record(const std::string& function, std::initializer_list<double> arguments = {});
+
+            void
+            uniform(const std::string& function, uint location, uint size);
+
+            void
+            link(const uint program, const std::vector<std::string>& sources);
+
+            void
+            fillProgramInputs(const std::string&                source,
+                              std::vector<std::string>&         names,
+                              std::vector<ProgramInputs::Type>& types,
+                              std::vector<uint>&                locations);
+        };
+    }
+}
@@ -0,0 +1,139 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/render/OpenGLES2Context.hpp"
+
+// OpenGL 3.3 core profiles are only available on desktop platforms, and offscreen through EGL only
+#if ((MINKO_PLATFORM & (MINKO_PLATFORM_LINUX | MINKO_PLATFORM_OSX)) \
+    || (MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS && !defined(MINKO_PLUGIN_ANGLE))) \
+    && (!defined(MINKO_PLUGIN_OFFSCREEN) || defined(MINKO_PLUGIN_OFFSCREEN_EGL))
+# define MINKO_OPENGL3_CONTEXT
+#endif
+
+#ifdef MINKO_OPENGL3_CONTEXT
+
+namespace minko
+{
+    namespace render
+    {
+        class OpenGL3Context :
+            public OpenGLES2Context
+        {
+        public:
+            typedef std::shared_ptr<OpenGL3Context> Ptr;
+
+        private:
+            // one sampler object per wrap mode, texture filter and mip filter combination
+            std::unordered_map<uint, uint>  _samplers;
+            std::vector<uint>               _currentSampler;
+            std::vector<uint>               _nextSampler;
+
+            // the core profile draws nothing without a vertex array: this one stands for the "0" vertex array
+            uint                            _defaultVertexArray;
+
+            // size in bytes of the data store of each vertex and index buffer, to orphan it on full uploads
+            std::unordered_map<uint, uint>  _bufferSizes;
+
+        public:
+            ~OpenGL3Context();
+
+            static
+            Ptr
+            create()
+            {
+                return std::shared_ptr<OpenGL3Context>(new OpenGL3Context());
+            }
+
+            void
+            drawTriangles(const uint indexBuffer, const int numTriangles);
+
+            void
+            drawInstancedTriangles(const uint indexBuffer, const int numTriangles, const int numInstances);
+
+            void
+            setVertexArray(uint vertexArray);
+
+            const uint
+            createVertexBuffer(const uint size);
+
+            void
+            setVertexBufferAt(const uint    position,
+                              const uint    vertexBuffer,
+                              const uint    size,
+                              const uint    stride,
+                              const uint    offset,
+                              const uint    divisor = 0);
+
+            void
+            uploadVertexBufferData(const uint   vertexBuffer,
+                                   const uint   offset,
+                                   const uint   size,
+                                   void*        data);
+
+            void
+            deleteVertexBuffer(const uint vertexBuffer);
+
+            const uint
+            createIndexBuffer(const uint size);
+
+            void
+            uploaderIndexBufferData(const uint  indexBuffer,
+                                    const uint  offset,
+                                    const uint  size,
+                                    void*       data);
+
+            void
+            deleteIndexBuffer(const uint indexBuffer);
+
+            void
+            setTextureAt(uint   position,
+                         int    texture     = 0,
+                         int    location    = -1);
+
+            void
+            setSamplerStateAt(uint          position,
+                              WrapMode      wrapping,
+                              TextureFilter filtering,
+                              MipFilter     mipFiltering);
+
+            void
+            setShaderSource(const uint shader, const std::string& source);
+
+            bool
+            supportsExtension(const std::string& extensionNameString);
+
+        protected:
+            OpenGL3Context();
+
+        private:
+            uint
+            createSampler(WrapMode wrapping, TextureFilter filtering, MipFilter mipFiltering);
+
+            void
+            bindSamplers();
+        };
+    }
+}
+
+#endif // MINKO_OPENGL3_CONTEXT
@@ -42,6 +42,7 @@ namespace minko
             typedef std::unordered_map<StencilOperation, unsigned int>    StencilOperationMap;
             typedef std::unordered_map<unsigned int, unsigned int>        TextureToBufferMap;
             typedef std::pair<uint, uint>                                TextureSize;
+            typedef std::unordered_map<uint, std::vector<int>>            UniformValues;
 
         protected:
             static BlendFactorsMap                    _blendingFactors;
@@ -84,6 +85,13 @@ namespace minko
             std::vector<int>                          _currentVertexSize;
             std::vector<int>                          _currentVertexStride;
             std::vector<int>                          _currentVertexOffset;
+            std::vector<uint>                         _currentVertexDivisor;
+            bool                                      _instancingSupported;
+            bool                                      _timerQueriesSupported;
+            bool                                      _vertexArraysSupported;
+            bool                                      _programBinariesSupported;
+            std::shared_ptr<ProgramCache>             _programCache;
+            uint                                      _currentVertexArray;
             uint                                      _currentBoundTexture;
             std::vector<int>                          _currentTexture;
             std::unordered_map<uint, WrapMode>        _currentWrapMode;
@@ -102,6 +110,12 @@ namespace minko
             StencilOperation                        _currentStencilZFailOp;
             StencilOperation                        _currentStencilZPassOp;
 
+            // shadow copy of the last uploaded uniform values, per program then per location
+            std::unordered_map<uint, UniformValues>   _uniformValues;
+            UniformValues*                            _currentUniformValues;
+            uint                                      _numIssuedUniformUploads;
+            uint                                      _numSkippedUniformUploads;
+
         public:
             ~OpenGLES2Context();
 
@@ -165,6 +179,28 @@ namespace minko
                 return _currentProgram;
             }
 
+            inline
+            uint
+            numIssuedUniformUploads()
+            {
+                return _numIssuedUniformUploads;
+            }
+
+            inline
+            uint
+            numSkippedUniformUploads()
+            {
+                return _numSkippedUniformUploads;
+            }
+
+            inline
+            void
+            resetUniformUploadCounters()
+            {
+                _numIssuedUniformUploads = 0;
+                _numSkippedUniformUploads = 0;
+            }
+
             void
             configureViewport(const uint x,
                               const uint y,
@@ -186,6 +222,57 @@ namespace minko
             void
             drawTriangles(const uint indexBuffer, const int numTriangles);
 
+            inline
+            bool
+            supportsInstancing()
+            {
+                return _instancingSupported;
+            }
+
+            void
+            drawInstancedTriangles(const uint indexBuffer, const int numTriangles, const int numInstances);
+
+            inline
+            bool
+            supportsTimerQueries()
+            {
+                return _timerQueriesSupported;
+            }
+
+            uint
+            createTimerQuery();
+
+            void
+            deleteTimerQuery(uint query);
+
+            void
+            beginTimerQuery(uint query);
+
+            void
+            endTimerQuery();
+
+            bool
+            timerQueryAvailable(uint query);
+
+            float
+            timerQueryResult(uint query);
+
+            inline
+            bool
+            supportsVertexArrays()
+            {
+                return _vertexArraysSupported;
+            }
+
+            uint
+            createVertexArray();
+
+            void
+            deleteVertexArray(uint vertexArray);
+
+            void
+            setVertexArray(uint vertexArray);
+
             const uint
             createVertexBuffer(const uint size);
 
@@ -194,7 +281,8 @@ namespace minko
                               const uint    vertexBuffer,
                               const uint    size,
                               const uint    stride,
-                              const uint    offset);
+                              const uint    offset,
+                              const uint    divisor = 0);
             void
             uploadVertexBufferData(const uint     vertexBuffer,
                                    const uint     offset,
@@ -318,6 +406,33 @@ namespace minko
             std::shared_ptr<ProgramInputs>
             getProgramInputs(const uint program);
 
+            inline
+            bool
+            supportsProgramBinaries()
+            {
+                return _programBinariesSupported;
+            }
+
+            bool
+            getProgramBinary(const uint program, uint& format, std::vector<unsigned char>& binary);
+
+            bool
+            loadProgramBinary(const uint program, const uint format, const std::vector<unsigned char>& binary);
+
+            inline
+            std::shared_ptr<ProgramCache>
+            programCache()
+            {
+                return _programCache;
+            }
+
+            inline
+            void
+            programCache(std::shared_ptr<ProgramCache> programCache)
+            {
+                _programCache = programCache;
+            }
+
             std::string
             getShaderCompilationLogs(const uint shader);
 
@@ -417,6 +532,7 @@ namespace minko
             void
             generateMipmaps(unsigned int texture);
 
+            virtual
             bool
             supportsExtension(const std::string& extensionNameString);
 
@@ -481,6 +597,15 @@ namespace minko
 
             TextureType
             getTextureType(uint textureId) const;
+
+            // compares the values with the shadow copy of the current program and updates it,
+            // returns false when the upload can be skipped
+            bool
+            uniformValuesChanged(uint location, const void* values, uint numValues, int tag = 0);
+
+            // forgets the cached attribute and index buffer bindings, ie. when another vertex array is bound
+            void
+            invalidateVertexState();
         };
     }
 }
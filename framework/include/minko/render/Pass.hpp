@@ -48,6 +48,7 @@ namespace minko
             typedef std::unordered_map<std::string, SamplerState>                        SamplerStatesMap;
             typedef std::shared_ptr<States>                                              StatesPtr;
             typedef std::unordered_map<ProgramSignature, ProgramPtr>                     SignatureProgramMap;
+            typedef std::unordered_map<ProgramPtr, ProgramPtr>                           ProgramToProgramMap;
             typedef std::shared_ptr<std::function<void(ProgramPtr)>>                     OnProgramFunctionPtr;
             typedef std::list<std::function<void(ProgramPtr)>>                           OnProgramFunctionList;
             typedef std::unordered_map<std::string, data::MacroBinding>                  MacroBindingsMap;
@@ -62,6 +63,7 @@ namespace minko
             StatesPtr                               _states;
             std::string                             _fallback;
             SignatureProgramMap                     _signatureToProgram;
+            ProgramToProgramMap                     _programToInstancedProgram;
 
             OnProgramFunctionList                   _uniformFunctions;
             OnProgramFunctionList                   _attributeFunctions;
@@ -193,6 +195,19 @@ namespace minko
                           std::list<std::string>&            integerMacros,
                           std::list<std::string>&            incorrectIntegerMacros);
 
+            // compiles ahead of time the program selectProgram() would return for these data,
+            // nullptr when none can be used
+            std::shared_ptr<Program>
+            warmUp(FormatNameFunction,
+                   std::shared_ptr<data::Container>  targetData,
+                   std::shared_ptr<data::Container>  rendererData,
+                   std::shared_ptr<data::Container>  rootData);
+
+            // variant of a program selected by this pass compiled with INSTANCING defined,
+            // nullptr if it does not compile
+            std::shared_ptr<Program>
+            instancedProgram(std::shared_ptr<Program> program);
+
             template <typename... T>
             void
             setUniform(const std::string& name, const T&... values)
@@ -205,6 +220,9 @@ namespace minko
                     _programTemplate->setUniform(name, values...);
                 for (auto signatureAndProgram : _signatureToProgram)
                     signatureAndProgram.second->setUniform(name, values...);
+                for (auto programAndInstancedProgram : _programToInstancedProgram)
+                    if (programAndInstancedProgram.second)
+                        programAndInstancedProgram.second->setUniform(name, values...);
             }
 
             inline
@@ -219,6 +237,9 @@ namespace minko
                     _programTemplate->setVertexAttribute(name, attributeSize, data);
                 for (auto signatureAndProgram : _signatureToProgram)
                     signatureAndProgram.second->setVertexAttribute(name, attributeSize, data);
+                for (auto programAndInstancedProgram : _programToInstancedProgram)
+                    if (programAndInstancedProgram.second)
+                        programAndInstancedProgram.second->setVertexAttribute(name, attributeSize, data);
             }
 
             inline
@@ -233,6 +254,9 @@ namespace minko
                     _programTemplate->setIndexBuffer(indices);
                 for (auto signatureAndProgram : _signatureToProgram)
                     signatureAndProgram.second->setIndexBuffer(indices);
+                for (auto programAndInstancedProgram : _programToInstancedProgram)
+                    if (programAndInstancedProgram.second)
+                        programAndInstancedProgram.second->setIndexBuffer(indices);
             }
 
             inline
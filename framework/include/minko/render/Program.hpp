@@ -179,6 +179,10 @@ namespace minko
             void
             upload();
 
+            // links the program from a binary read back from the context, false when it is rejected
+            bool
+            upload(uint binaryFormat, const std::vector<unsigned char>& binary);
+
             void
             dispose();
 
@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+    namespace render
+    {
+        // Keeps the binaries of the linked programs in a directory so that the next runs load them
+        // instead of compiling their shaders again. Entries are keyed by a hash of the driver and of
+        // the final sources, macro definitions included: a binary the driver rejects is deleted and the
+        // program falls back to being compiled.
+        class ProgramCache
+        {
+        public:
+            typedef std::shared_ptr<ProgramCache>   Ptr;
+
+        private:
+            typedef std::shared_ptr<Program>        ProgramPtr;
+
+        private:
+            static const uint                       MAGIC;
+            static const uint                       VERSION;
+            static const uint64_t                   KEY_SEED;
+            static const uint64_t                   CHECK_SEED; // tells apart two programs with the same key
+
+            std::string                             _directory;
+
+            uint                                    _numHits;
+            uint                                    _numMisses;
+            uint                                    _numRejected;
+
+        public:
+            // the directory must exist
+            inline static
+            Ptr
+            create(const std::string& directory)
+            {
+                return std::shared_ptr<ProgramCache>(new ProgramCache(directory));
+            }
+
+            inline
+            const std::string&
+            directory() const
+            {
+                return _directory;
+            }
+
+            // programs loaded from the cache
+            inline
+            uint
+            numHits() const
+            {
+                return _numHits;
+            }
+
+            // programs not found in the cache
+            inline
+            uint
+            numMisses() const
+            {
+                return _numMisses;
+            }
+
+            // programs found in the cache but whose binary was invalid or rejected by the driver
+            inline
+            uint
+            numRejected() const
+            {
+                return _numRejected;
+            }
+
+            // true when the program could be linked from a cached binary
+            bool
+            load(ProgramPtr program);
+
+            void
+            store(ProgramPtr program);
+
+            std::string
+            filename(ProgramPtr program) const;
+
+        private:
+            ProgramCache(const std::string& directory);
+
+            // 64 bits FNV-1a, stable from one run to the next unlike std::hash
+            static
+            uint64_t
+            hash(const unsigned char* data, uint size, uint64_t value);
+
+            uint64_t
+            key(ProgramPtr program, uint64_t seed) const;
+        };
+    }
+}
@@ -0,0 +1,157 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+#include "minko/Signal.hpp"
+
+namespace minko
+{
+    namespace render
+    {
+        // Orders render passes according to the render targets they read and write, drops the passes
+        // whose results are never used and shares the same textures between the transient render
+        // targets whose lifetimes do not overlap.
+        // The back buffer is the "" target: passes writing it are always executed. Readers of a target
+        // see what all the passes writing it drew, in declaration order.
+        class RenderGraph :
+            public std::enable_shared_from_this<RenderGraph>
+        {
+        public:
+            typedef std::shared_ptr<RenderGraph>                                    Ptr;
+
+            typedef std::function<void(std::shared_ptr<AbstractContext>,
+                                       std::shared_ptr<Texture>)>                  ExecuteFunction;
+
+        private:
+            typedef std::shared_ptr<AbstractContext>                                AbsContextPtr;
+            typedef std::shared_ptr<Texture>                                        TexturePtr;
+            typedef std::shared_ptr<component::Renderer>                            RendererPtr;
+
+            struct TargetDescription
+            {
+                uint                                                                width;
+                uint                                                                height;
+                TextureFormat                                                       format;
+                bool                                                                output;
+            };
+
+            struct PassDescription
+            {
+                std::string                                                         name;
+                std::vector<std::string>                                            reads;
+                std::string                                                         write;
+                ExecuteFunction                                                     execute;
+            };
+
+        private:
+            AbsContextPtr                                                           _context;
+
+            std::vector<PassDescription>                                            _passes;
+            std::unordered_map<std::string, TargetDescription>                      _targets;
+
+            bool                                                                    _invalid;
+            std::vector<uint>                                                       _schedule;
+            std::unordered_map<std::string, TexturePtr>                             _targetTextures;
+            std::vector<TexturePtr>                                                 _textures;
+
+            Signal<Ptr>::Ptr                                                        _compiled;
+
+        public:
+            inline static
+            Ptr
+            create(AbsContextPtr context)
+            {
+                return std::shared_ptr<RenderGraph>(new RenderGraph(context));
+            }
+
+            // declares a transient render target, its texture is only valid once the graph is compiled
+            Ptr
+            target(const std::string&  name,
+                   uint                width,
+                   uint                height,
+                   TextureFormat       format  = TextureFormat::RGBA);
+
+            // marks a target as a result of the graph: the passes writing it are executed even though
+            // no other pass reads it, and its texture is never shared
+            Ptr
+            output(const std::string& name);
+
+            Ptr
+            pass(const std::string&                name,
+                 const std::vector<std::string>&   reads,
+                 const std::string&                write,
+                 const ExecuteFunction&            execute);
+
+            // the renderer stops rendering by itself and is rendered by the graph instead
+            Ptr
+            pass(RendererPtr                       renderer,
+                 const std::vector<std::string>&   reads,
+                 const std::string&                write);
+
+            void
+            clear();
+
+            // the texture of a target, nullptr for the back buffer
+            TexturePtr
+            texture(const std::string& name);
+
+            // names of the passes to execute, in order
+            std::vector<std::string>
+            schedule();
+
+            // number of textures actually allocated for the transient render targets
+            inline
+            uint
+            numTextures() const
+            {
+                return _textures.size();
+            }
+
+            // executed every time the passes are ordered and the textures assigned again, ie. to bind
+            // the new textures of the targets to the effects reading them
+            inline
+            Signal<Ptr>::Ptr
+            compiled() const
+            {
+                return _compiled;
+            }
+
+            void
+            compile();
+
+            void
+            execute();
+
+        private:
+            RenderGraph(AbsContextPtr context);
+
+            std::vector<uint>
+            sortPasses();
+
+            std::vector<bool>
+            findLivePasses();
+
+            void
+            assignTextures();
+        };
+    }
+}
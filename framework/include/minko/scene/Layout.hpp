@@ -35,11 +35,12 @@ namespace minko
             {
             public:
                 static const Layouts DEFAULT;
-                // static const Layouts STATIC;
+                static const Layouts STATIC;
                 static const Layouts IGNORE_RAYCASTING;
                 static const Layouts CULLING;
                 static const Layouts PICKING;
                 static const Layouts REFLECTION;
+                static const Layouts OCCLUDER;
             };
 
             class Mask
@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/animation/AbstractTimeline.hpp"
 #include "minko/animation/Matrix4x4Timeline.hpp"
 #include "minko/scene/Node.hpp"
+#include "minko/data/Container.hpp"
 
 using namespace minko;
 using namespace minko::component;
@@ -75,12 +76,17 @@ Animation::update()
     {
         auto container = target->data();
 
+        // several timelines can animate the same property
+        data::Container::ScopedBatch batch(container);
+
         for (auto& timeline : _timelines)
         {
             const uint currentTime = _currentTime % (timeline->duration() + 1); // Warning: bounds!
 
-            timeline->update(currentTime, target->data());
+            timeline->update(currentTime, container);
         }
+
+        batch.end();
     }
 }
 
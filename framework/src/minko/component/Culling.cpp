@@ -23,11 +23,17 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/math/Frustum.hpp"
 #include "minko/scene/NodeSet.hpp"
 #include "minko/math/OctTree.hpp"
+#include "minko/math/OcclusionBuffer.hpp"
+#include "minko/math/Box.hpp"
 #include "minko/math/Vector3.hpp"
 #include "minko/component/PerspectiveCamera.hpp"
 #include "minko/component/SceneManager.hpp"
 #include "minko/component/Surface.hpp"
 #include "minko/component/Renderer.hpp"
+#include "minko/component/BoundingBox.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/render/VertexBuffer.hpp"
+#include "minko/render/IndexBuffer.hpp"
 
 using namespace minko;
 using namespace minko::component;
@@ -38,10 +44,21 @@ Culling::Culling(ShapePtr shape,
                  const std::string& bindProperty):
     AbstractComponent(scene::Layout::Group::CULLING),
     _frustum(shape),
-    _bindProperty(bindProperty)
+    _bindProperty(bindProperty),
+    _occlusionCullingEnabled(false),
+    _occlusionBuffer(nullptr)
 {
 }
 
+void
+Culling::occlusionCullingEnabled(bool value)
+{
+    _occlusionCullingEnabled = value;
+
+    if (value && !_occlusionBuffer)
+        _occlusionBuffer = math::OcclusionBuffer::create();
+}
+
 void
 Culling::initialize()
 {
@@ -95,7 +112,10 @@ void
 Culling::targetRemovedHandler(AbstractComponent::Ptr ctrl, NodePtr target)
 {
     _addedSlot            = nullptr;
+    _removedSlot          = nullptr;
     _layoutChangedSlot    = nullptr;
+
+    _occluders.clear();
 }
 
 void
@@ -119,6 +139,21 @@ Culling::targetAddedToSceneHandler(NodePtr node, NodePtr target, NodePtr ancesto
             std::placeholders::_2,
             std::placeholders::_3
         ));
+
+        _removedSlot = target->root()->removed()->connect(std::bind(
+            &Culling::removedHandler,
+            std::static_pointer_cast<Culling>(shared_from_this()),
+            std::placeholders::_1,
+            std::placeholders::_2,
+            std::placeholders::_3
+        ));
+
+        auto occluders = scene::NodeSet::create(target->root())->descendants(true)->where([](NodePtr descendant)
+        {
+            return (descendant->layouts() & scene::Layout::Group::OCCLUDER) != 0 && descendant->hasComponent<Surface>();
+        });
+
+        _occluders.insert(occluders->nodes().begin(), occluders->nodes().end());
     }
 }
 
@@ -133,6 +168,25 @@ Culling::addedHandler(NodePtr node, NodePtr target, NodePtr ancestor)
 
     for (auto n : nodeSet->nodes())
         _octTree->insert(n);
+
+    auto occluders = scene::NodeSet::create(target)->descendants(true)->where([](NodePtr descendant)
+    {
+        return (descendant->layouts() & scene::Layout::Group::OCCLUDER) != 0 && descendant->hasComponent<Surface>();
+    });
+
+    _occluders.insert(occluders->nodes().begin(), occluders->nodes().end());
+}
+
+void
+Culling::removedHandler(NodePtr node, NodePtr target, NodePtr ancestor)
+{
+    if (_occluders.empty())
+        return;
+
+    auto descendants = scene::NodeSet::create(target)->descendants(true);
+
+    for (auto descendant : descendants->nodes())
+        _occluders.erase(descendant);
 }
 
 void
@@ -142,23 +196,96 @@ Culling::layoutChangedHandler(NodePtr node, NodePtr target)
         _octTree->insert(target);
     else
         _octTree->remove(target);
+
+    if ((target->layouts() & scene::Layout::Group::OCCLUDER) != 0 && target->hasComponent<Surface>())
+        _occluders.insert(target);
+    else
+        _occluders.erase(target);
 }
 
 void
 Culling::worldToScreenChangedHandler(std::shared_ptr<data::Container> data, const std::string& propertyName)
 {
-    _frustum->updateFromMatrix(data->get<std::shared_ptr<math::Matrix4x4>>(propertyName));
+    auto worldToScreen = data->get<std::shared_ptr<math::Matrix4x4>>(propertyName);
+
+    _frustum->updateFromMatrix(worldToScreen);
 
     auto renderer = targets()[0]->component<Renderer>();
+    auto occlusionCulling = _occlusionCullingEnabled && !_occluders.empty();
+
+    if (occlusionCulling)
+        rasterizeOccluders(worldToScreen);
 
     _octTree->testFrustum(
         _frustum,
         [&](NodePtr node)
         {
-            node->component<Surface>()->computedVisibility(renderer, true);
+            auto visible = true;
+
+            // occluders are never tested against themselves
+            if (occlusionCulling && _occluders.count(node) == 0)
+            {
+                auto boundingBox = node->component<BoundingBox>();
+
+                visible = !boundingBox || !_occlusionBuffer->occluded(boundingBox->box());
+            }
+
+            node->component<Surface>()->computedVisibility(renderer, visible);
         },
         [&](NodePtr node)
         {
             node->component<Surface>()->computedVisibility(renderer, false);
         });
-}
\ No newline at end of file
+}
+
+void
+Culling::rasterizeOccluders(Matrix4x4Ptr worldToScreen)
+{
+    _occlusionBuffer->clear(worldToScreen);
+
+    for (auto occluder : _occluders)
+    {
+        auto boundingBox = occluder->component<BoundingBox>();
+
+        if (boundingBox)
+        {
+            auto position = _frustum->testBoundingBox(boundingBox->box());
+
+            if (position != math::ShapePosition::AROUND && position != math::ShapePosition::INSIDE)
+                continue;
+        }
+
+        auto modelToWorld = occluder->data()->hasProperty("transform.modelToWorldMatrix")
+            ? occluder->data()->get<Matrix4x4Ptr>("transform.modelToWorldMatrix")
+            : nullptr;
+
+        for (auto surface : occluder->components<Surface>())
+        {
+            auto geometry = surface->geometry();
+
+            if (geometry->hasVertexAttribute("position") && geometry->indices()
+                && !geometry->indices()->data().empty())
+            {
+                auto vertexBuffer   = geometry->vertexBuffer("position");
+                auto attribute      = vertexBuffer->attribute("position");
+
+                if (!vertexBuffer->data().empty() && std::get<1>(*attribute) >= 3)
+                {
+                    _occlusionBuffer->rasterize(
+                        vertexBuffer->data(),
+                        vertexBuffer->vertexSize(),
+                        std::get<2>(*attribute),
+                        geometry->indices()->data(),
+                        modelToWorld
+                    );
+
+                    continue;
+                }
+            }
+
+            // the geometry data is not kept on the CPU side: its bounding box is used as a hull
+            if (boundingBox)
+                _occlusionBuffer->rasterize(boundingBox->box());
+        }
+    }
+}
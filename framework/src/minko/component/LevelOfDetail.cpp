@@ -0,0 +1,270 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/component/LevelOfDetail.hpp"
+
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+#include "minko/data/Container.hpp"
+#include "minko/component/SceneManager.hpp"
+#include "minko/component/Surface.hpp"
+#include "minko/component/BoundingBox.hpp"
+#include "minko/component/PerspectiveCamera.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/render/VertexBuffer.hpp"
+#include "minko/math/Box.hpp"
+#include "minko/math/Vector3.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+LevelOfDetail::LevelOfDetail(float hysteresis) :
+    AbstractComponent(),
+    _hysteresis(hysteresis),
+    _level(0),
+    _screenSize(0.f),
+    _camera(nullptr),
+    _autoCamera(true),
+    _geometry(nullptr),
+    _sceneManager(nullptr)
+{
+}
+
+void
+LevelOfDetail::initialize()
+{
+    _targetAddedSlot = targetAdded()->connect(std::bind(
+        &LevelOfDetail::targetAddedHandler,
+        std::static_pointer_cast<LevelOfDetail>(shared_from_this()),
+        std::placeholders::_1,
+        std::placeholders::_2
+    ));
+
+    _targetRemovedSlot = targetRemoved()->connect(std::bind(
+        &LevelOfDetail::targetRemovedHandler,
+        std::static_pointer_cast<LevelOfDetail>(shared_from_this()),
+        std::placeholders::_1,
+        std::placeholders::_2
+    ));
+}
+
+LevelOfDetail::Ptr
+LevelOfDetail::addLevel(GeometryPtr geometry, float minScreenSize)
+{
+    if (geometry == nullptr || geometry->indices() == nullptr)
+        throw std::invalid_argument("geometry");
+
+    if (!_levels.empty())
+    {
+        auto reference = _levels.front().geometry;
+        uint numAttributes = 0;
+
+        for (auto vertexBuffer : geometry->vertexBuffers())
+            for (auto attribute : vertexBuffer->attributes())
+            {
+                if (!reference->hasVertexAttribute(std::get<0>(*attribute)))
+                    throw std::invalid_argument("geometry");
+                ++numAttributes;
+            }
+
+        for (auto vertexBuffer : reference->vertexBuffers())
+            numAttributes -= vertexBuffer->attributes().size();
+
+        if (numAttributes != 0)
+            throw std::invalid_argument("geometry");
+    }
+
+    auto levelIt = std::find_if(_levels.begin(), _levels.end(), [&](const Level& level)
+    {
+        return level.minScreenSize < minScreenSize;
+    });
+
+    Level level;
+
+    level.geometry = geometry;
+    level.minScreenSize = minScreenSize;
+
+    _levels.insert(levelIt, level);
+
+    if (_geometry)
+        useLevel(std::min(_level, numLevels() - 1));
+
+    return std::static_pointer_cast<LevelOfDetail>(shared_from_this());
+}
+
+void
+LevelOfDetail::targetAddedHandler(AbstractComponent::Ptr ctrl, NodePtr target)
+{
+    if (targets().size() > 1)
+        throw std::logic_error("LevelOfDetail cannot have more than one target.");
+    if (_levels.empty())
+        throw std::logic_error("LevelOfDetail requires at least one level.");
+
+    // the surfaces drawn with the finest level share a geometry whose buffers are replaced when the
+    // level changes, their draw calls are built only once; the other surfaces are left untouched
+    _level = 0;
+    _geometry = _levels.front().geometry->clone();
+
+    for (auto surface : target->components<Surface>())
+    {
+        if (surface->geometry() != _levels.front().geometry)
+            continue;
+
+        _surfaceToGeometry[surface] = surface->geometry();
+        surface->geometry(_geometry);
+    }
+
+    if (!target->hasComponent<BoundingBox>())
+        target->addComponent(BoundingBox::create());
+
+    _addedSlot = target->added()->connect(std::bind(
+        &LevelOfDetail::addedOrRemovedHandler,
+        std::static_pointer_cast<LevelOfDetail>(shared_from_this()),
+        std::placeholders::_1,
+        std::placeholders::_2,
+        std::placeholders::_3
+    ));
+
+    _removedSlot = target->removed()->connect(std::bind(
+        &LevelOfDetail::addedOrRemovedHandler,
+        std::static_pointer_cast<LevelOfDetail>(shared_from_this()),
+        std::placeholders::_1,
+        std::placeholders::_2,
+        std::placeholders::_3
+    ));
+
+    findSceneManager();
+}
+
+void
+LevelOfDetail::targetRemovedHandler(AbstractComponent::Ptr ctrl, NodePtr target)
+{
+    for (auto& surfaceAndGeometry : _surfaceToGeometry)
+        if (surfaceAndGeometry.first->geometry() == _geometry)
+            surfaceAndGeometry.first->geometry(surfaceAndGeometry.second);
+
+    _surfaceToGeometry.clear();
+    _geometry = nullptr;
+
+    _addedSlot = nullptr;
+    _removedSlot = nullptr;
+    _frameBeginSlot = nullptr;
+    _sceneManager = nullptr;
+
+    if (_autoCamera)
+        _camera = nullptr;
+}
+
+void
+LevelOfDetail::addedOrRemovedHandler(NodePtr node, NodePtr target, NodePtr ancestor)
+{
+    findSceneManager();
+
+    if (_autoCamera)
+        _camera = nullptr;
+}
+
+void
+LevelOfDetail::findSceneManager()
+{
+    auto root = targets()[0]->root();
+    auto sceneManager = root->hasComponent<SceneManager>() ? root->component<SceneManager>() : nullptr;
+
+    if (sceneManager == _sceneManager)
+        return;
+
+    _sceneManager = sceneManager;
+    _frameBeginSlot = sceneManager
+        ? sceneManager->frameBegin()->connect(std::bind(
+            &LevelOfDetail::frameBeginHandler,
+            std::static_pointer_cast<LevelOfDetail>(shared_from_this()),
+            std::placeholders::_1,
+            std::placeholders::_2,
+            std::placeholders::_3
+        ))
+        : nullptr;
+}
+
+void
+LevelOfDetail::frameBeginHandler(SceneManagerPtr sceneManager, float time, float deltaTime)
+{
+    update();
+}
+
+LevelOfDetail::NodePtr
+LevelOfDetail::findCamera()
+{
+    auto cameras = scene::NodeSet::create(targets()[0]->root())
+        ->descendants(true)
+        ->where([](NodePtr node)
+        {
+            return node->hasComponent<PerspectiveCamera>();
+        });
+
+    return cameras->nodes().empty() ? nullptr : cameras->nodes().front();
+}
+
+float
+LevelOfDetail::computeScreenSize()
+{
+    auto box        = targets()[0]->component<BoundingBox>()->box();
+    auto center     = math::Vector3::create(box->topRight())->add(box->bottomLeft())->scaleBy(.5f);
+    auto radius     = math::Vector3::create(box->topRight())->subtract(box->bottomLeft())->length() * .5f;
+    auto position   = _camera->data()->get<std::shared_ptr<math::Vector3>>("camera.position");
+    auto distance   = center->subtract(position)->length();
+
+    if (distance <= radius)
+        return std::numeric_limits<float>::max();
+
+    return radius / (distance * std::tan(_camera->component<PerspectiveCamera>()->fieldOfView() * .5f));
+}
+
+void
+LevelOfDetail::update()
+{
+    if (targets().empty() || _levels.empty())
+        return;
+
+    if (_autoCamera && (_camera == nullptr || _camera->root() != targets()[0]->root()))
+        _camera = findCamera();
+
+    if (_camera == nullptr || !_camera->hasComponent<PerspectiveCamera>())
+        return;
+
+    _screenSize = computeScreenSize();
+
+    auto level = std::min(_level, numLevels() - 1);
+
+    while (level > 0 && _screenSize >= _levels[level - 1].minScreenSize * (1.f + _hysteresis))
+        --level;
+    while (level + 1 < numLevels() && _screenSize < _levels[level].minScreenSize)
+        ++level;
+
+    useLevel(level);
+}
+
+void
+LevelOfDetail::useLevel(uint level)
+{
+    if (level == _level && _geometry->indices() == _levels[level].geometry->indices())
+        return;
+
+    _level = level;
+    _geometry->copyBuffers(_levels[level].geometry);
+}
@@ -0,0 +1,118 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/component/ProgramWarmUpJob.hpp"
+
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+#include "minko/component/Renderer.hpp"
+#include "minko/component/Surface.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+ProgramWarmUpJob::ProgramWarmUpJob(NodePtr target) :
+    JobManager::Job(),
+    _target(target),
+    _materialToVariants(),
+    _permutations(),
+    _numWarmedUp(0),
+    _numFailed(0)
+{
+}
+
+ProgramWarmUpJob::Ptr
+ProgramWarmUpJob::addMaterialVariant(MaterialPtr material, MaterialPtr variant)
+{
+    if (material == nullptr)
+        throw std::invalid_argument("material");
+    if (variant == nullptr)
+        throw std::invalid_argument("variant");
+
+    _materialToVariants[material].push_back(variant);
+
+    return shared_from_this();
+}
+
+bool
+ProgramWarmUpJob::complete()
+{
+    return _permutations.empty();
+}
+
+void
+ProgramWarmUpJob::beforeFirstStep()
+{
+    auto rendererNodes = scene::NodeSet::create(_target->root())->descendants(true)->where([](NodePtr descendant)
+    {
+        return descendant->hasComponent<Renderer>();
+    });
+    auto surfaceNodes = scene::NodeSet::create(_target)->descendants(true)->where([](NodePtr descendant)
+    {
+        return descendant->hasComponent<Surface>();
+    });
+
+    // a renderer draws the surfaces matching its layout mask, possibly with its own effect
+    for (auto& rendererNode : rendererNodes->nodes())
+        for (auto& renderer : rendererNode->components<Renderer>())
+            for (auto& surfaceNode : surfaceNodes->nodes())
+            {
+                if ((surfaceNode->layouts() & renderer->layoutMask()) == 0)
+                    continue;
+
+                for (auto& surface : surfaceNode->components<Surface>())
+                {
+                    _permutations.push_back(Permutation(renderer, surface, nullptr));
+
+                    auto variantsIt = _materialToVariants.find(surface->material());
+
+                    if (variantsIt != _materialToVariants.end())
+                        for (auto& variant : variantsIt->second)
+                            _permutations.push_back(Permutation(renderer, surface, variant));
+                }
+            }
+}
+
+void
+ProgramWarmUpJob::step()
+{
+    if (_permutations.empty())
+        return;
+
+    auto permutation = _permutations.front();
+
+    _permutations.pop_front();
+
+    if (std::get<0>(permutation)->warmUp(std::get<1>(permutation), std::get<2>(permutation)))
+        ++_numWarmedUp;
+    else
+        ++_numFailed;
+}
+
+float
+ProgramWarmUpJob::priority()
+{
+    // after the jobs that still load the scene
+    return 0.f;
+}
+
+void
+ProgramWarmUpJob::afterLastStep()
+{
+}
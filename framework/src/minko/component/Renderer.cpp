@@ -30,6 +30,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/SceneManager.hpp"
 #include "minko/file/AssetLibrary.hpp"
 #include "minko/render/DrawCallPool.hpp"
+#include "minko/render/CommandBuffer.hpp"
+#include "minko/math/Vector3.hpp"
 #include "minko/data/AbstractFilter.hpp"
 #include "minko/data/LightMaskFilter.hpp"
 
@@ -39,31 +41,49 @@ using namespace minko::scene;
 using namespace minko::render;
 
 const unsigned int Renderer::NUM_FALLBACK_ATTEMPTS = 32;
+const unsigned int Renderer::MAX_NUM_PENDING_FRAMES = 4;
 
 
 Renderer::Renderer(std::shared_ptr<render::AbstractTexture> renderTarget,
                    EffectPtr                                effect,
                    float                                    priority) :
+    _numDrawCalls(0),
+    _surfaceDrawCalls(),
     _backgroundColor(0),
     _viewportBox(),
     _scissorBox(),
-    _enabled(true),
     _renderingBegin(Signal<Ptr>::create()),
     _renderingEnd(Signal<Ptr>::create()),
     _beforePresent(Signal<Ptr>::create()),
-    _surfaceDrawCalls(),
-    _surfaceTechniqueChangedSlot(),
-    _effect(effect),
     _clearBeforeRender(true),
+    _effect(effect),
     _priority(priority),
+    _enabled(true),
+    _autoRender(true),
+    _surfaceTechniqueChangedSlot(),
     _targetDataFilters(),
     _rendererDataFilters(),
     _rootDataFilters(),
+    _lightMaskFilter(data::LightMaskFilter::create()),
     _targetDataFilterChangedSlots(),
     _rendererDataFilterChangedSlots(),
     _rootDataFilterChangedSlots(),
-    _lightMaskFilter(data::LightMaskFilter::create()),
-    _filterChanged(Signal<Ptr, data::AbstractFilter::Ptr, data::BindingSource, SurfacePtr>::create())
+    _filterChanged(Signal<Ptr, data::AbstractFilter::Ptr, data::BindingSource, SurfacePtr>::create()),
+    _commandBufferEnabled(false),
+    _commandBufferInvalid(true),
+    _commandBuffer(CommandBuffer::create()),
+    _previousCommandBuffer(CommandBuffer::create()),
+    _recordedDrawCalls(),
+    _recordedPoolRevision(0),
+    _recordedLayoutMask(0),
+    _recordedRenderTarget(nullptr),
+    _numRecordedDrawCalls(0),
+    _depthPrePassEnabled(false),
+    _profilingEnabled(false),
+    _frameStats(),
+    _pendingFrameStats(),
+    _timerQueries(),
+    _timerQueryContext(nullptr)
 {
     if (renderTarget)
     {
@@ -73,26 +93,43 @@ Renderer::Renderer(std::shared_ptr<render::AbstractTexture> renderTarget,
 }
 
 Renderer::Renderer(const Renderer& renderer, const CloneOption& option) :
+	_numDrawCalls(0),
+	_surfaceDrawCalls(),
 	_backgroundColor(renderer._backgroundColor),
 	_viewportBox(),
 	_scissorBox(),
-	_enabled(renderer._enabled),
 	_renderingBegin(Signal<Ptr>::create()),
 	_renderingEnd(Signal<Ptr>::create()),
 	_beforePresent(Signal<Ptr>::create()),
-	_surfaceDrawCalls(),
-	_surfaceTechniqueChangedSlot(),
+	_clearBeforeRender(true),
 	_effect(nullptr),
-    _clearBeforeRender(true),
 	_priority(renderer._priority),
+	_enabled(renderer._enabled),
+	_autoRender(renderer._autoRender),
+	_surfaceTechniqueChangedSlot(),
 	_targetDataFilters(),
 	_rendererDataFilters(),
 	_rootDataFilters(),
+	_lightMaskFilter(data::LightMaskFilter::create()),
 	_targetDataFilterChangedSlots(),
 	_rendererDataFilterChangedSlots(),
 	_rootDataFilterChangedSlots(),
-	_lightMaskFilter(data::LightMaskFilter::create()),
-	_filterChanged(Signal<Ptr, data::AbstractFilter::Ptr, data::BindingSource, SurfacePtr>::create())
+	_filterChanged(Signal<Ptr, data::AbstractFilter::Ptr, data::BindingSource, SurfacePtr>::create()),
+	_commandBufferEnabled(renderer._commandBufferEnabled),
+	_commandBufferInvalid(true),
+	_commandBuffer(CommandBuffer::create()),
+	_previousCommandBuffer(CommandBuffer::create()),
+	_recordedDrawCalls(),
+	_recordedPoolRevision(0),
+	_recordedLayoutMask(0),
+	_recordedRenderTarget(nullptr),
+	_numRecordedDrawCalls(0),
+	_depthPrePassEnabled(renderer._depthPrePassEnabled),
+	_profilingEnabled(renderer._profilingEnabled),
+	_frameStats(),
+	_pendingFrameStats(),
+	_timerQueries(),
+	_timerQueryContext(nullptr)
 {
 	if (renderer._renderTarget)
 	{
@@ -307,6 +344,133 @@ Renderer::removeSurface(Surface::Ptr surface)
     _drawCallPool->removeSurface(surface);
 }
 
+bool
+Renderer::warmUp(Surface::Ptr surface, std::shared_ptr<material::Material> material)
+{
+    return _drawCallPool->warmUp(surface, material);
+}
+
+bool
+Renderer::sortDrawCallsByKey()
+{
+    return _drawCallPool->sortKeysEnabled();
+}
+
+void
+Renderer::sortDrawCallsByKey(bool value)
+{
+    _drawCallPool->sortKeysEnabled(value);
+}
+
+bool
+Renderer::instancingEnabled()
+{
+    return _drawCallPool->instancingEnabled();
+}
+
+void
+Renderer::instancingEnabled(bool value)
+{
+    _drawCallPool->instancingEnabled(value);
+}
+
+void
+Renderer::commandBufferEnabled(bool value)
+{
+    _commandBufferEnabled = value;
+    _commandBufferInvalid = true;
+
+    if (!value)
+    {
+        _commandBuffer->clear();
+        _previousCommandBuffer->clear();
+        _recordedDrawCalls.clear();
+        _recordedRenderTarget = nullptr;
+        _numRecordedDrawCalls = 0;
+    }
+}
+
+void
+Renderer::updateCommandBuffer(const DrawCallPool::DrawCallView& drawCalls, AbsTexturePtr renderTarget)
+{
+    const bool mustRecordAll = _commandBufferInvalid || renderTarget != _recordedRenderTarget;
+
+    _numRecordedDrawCalls = 0;
+
+    if (!mustRecordAll
+        && _drawCallPool->revision() == _recordedPoolRevision
+        && layoutMask() == _recordedLayoutMask)
+    {
+        auto upToDate = true;
+
+        for (const auto& recorded : _recordedDrawCalls)
+            if (recorded.drawCall->revision() != recorded.revision)
+            {
+                upToDate = false;
+                break;
+            }
+
+        if (upToDate)
+            return;
+    }
+
+    // draw calls that did not change since the last frame are copied from the previous buffer
+    std::unordered_map<DrawCall*, uint> previousDrawCallToIndex;
+
+    if (!mustRecordAll)
+        for (uint i = 0; i < _recordedDrawCalls.size(); ++i)
+            previousDrawCallToIndex[_recordedDrawCalls[i].drawCall.get()] = i;
+
+    std::swap(_commandBuffer, _previousCommandBuffer);
+    _commandBuffer->clear();
+
+    std::vector<RecordedDrawCall> recordedDrawCalls;
+
+    recordedDrawCalls.reserve(drawCalls.size());
+
+    for (auto drawCall : drawCalls)
+    {
+        RecordedDrawCall recorded;
+
+        recorded.drawCall   = drawCall->shared_from_this();
+        recorded.revision   = drawCall->revision();
+        recorded.begin      = _commandBuffer->size();
+
+        auto previousIt = previousDrawCallToIndex.find(drawCall);
+
+        if (previousIt != previousDrawCallToIndex.end()
+            && _recordedDrawCalls[previousIt->second].revision == recorded.revision)
+        {
+            const auto& previous = _recordedDrawCalls[previousIt->second];
+
+            _commandBuffer->append(*_previousCommandBuffer, previous.begin, previous.end);
+        }
+        else
+        {
+            drawCall->record(*_commandBuffer, renderTarget, _viewportBox, _depthPrePassEnabled);
+            ++_numRecordedDrawCalls;
+        }
+
+        recorded.end = _commandBuffer->size();
+        recordedDrawCalls.push_back(recorded);
+    }
+
+    _recordedDrawCalls.swap(recordedDrawCalls);
+    _recordedPoolRevision   = _drawCallPool->revision();
+    _recordedLayoutMask     = layoutMask();
+    _recordedRenderTarget   = renderTarget;
+    _commandBufferInvalid   = false;
+}
+
+void
+Renderer::profilingEnabled(bool value)
+{
+    _profilingEnabled = value;
+
+    if (!value)
+        deleteTimerQueries();
+}
+
 void
 Renderer::render(render::AbstractContext::Ptr    context,
                  render::AbstractTexture::Ptr    renderTarget)
@@ -314,10 +478,16 @@ Renderer::render(render::AbstractContext::Ptr    context,
     if (!_enabled)
         return;
 
-    _drawCalls = _drawCallPool->drawCalls();
+    const auto startTime = std::chrono::high_resolution_clock::now();
 
     _renderingBegin->execute(std::static_pointer_cast<Renderer>(shared_from_this()));
 
+    // non-owning view: fetched after renderingBegin() so that its listeners cannot invalidate it
+    const auto& drawCalls = _drawCallPool->drawCalls(layoutMask());
+
+    _numDrawCalls = drawCalls.size();
+    _drawCallPool->invalidateUniformBlocks();
+
     auto rt = _renderTarget ? _renderTarget : renderTarget;
 
     if (_scissorBox.width >= 0 && _scissorBox.height >= 0)
@@ -341,15 +511,246 @@ Renderer::render(render::AbstractContext::Ptr    context,
            (_backgroundColor & 0xff) / 255.f
        );
 
-    for (auto& drawCall : _drawCalls)
-        if ((drawCall->layouts() & layoutMask()) != 0)
-            drawCall->render(context, rt, _viewportBox);
+    if (_depthPrePassEnabled)
+        renderDepthPrePass(context, drawCalls, rt);
+
+    const auto profiling = _profilingEnabled;
+
+    if (profiling)
+        renderProfiled(context, drawCalls, rt);
+    else if (_commandBufferEnabled)
+    {
+        updateCommandBuffer(drawCalls, rt);
+
+        _commandBuffer->execute(context);
+    }
+    else
+        for (auto drawCall : drawCalls)
+            drawCall->render(context, rt, _viewportBox, _depthPrePassEnabled);
 
     _beforePresent->execute(std::static_pointer_cast<Renderer>(shared_from_this()));
 
     context->present();
 
     _renderingEnd->execute(std::static_pointer_cast<Renderer>(shared_from_this()));
+
+    // profiling might have been disabled by a listener in the meantime
+    if (profiling && _profilingEnabled && !_pendingFrameStats.empty())
+    {
+        const std::chrono::duration<float, std::milli> cpuTime = std::chrono::high_resolution_clock::now() - startTime;
+
+        _pendingFrameStats.back().stats.cpuTime = cpuTime.count();
+
+        collectFrameStats();
+    }
+}
+
+void
+Renderer::renderDepthPrePass(AbsContext                         context,
+                             const DrawCallPool::DrawCallView&  drawCalls,
+                             AbsTexturePtr                      renderTarget)
+{
+    std::vector<std::pair<float, DrawCall*>> depthDrawCalls;
+    auto eyePosition = math::Vector3::create();
+
+    depthDrawCalls.reserve(drawCalls.size());
+
+    for (auto drawCall : drawCalls)
+    {
+        // programs without a depth only version get a null one, so that they are looked up only once
+        if (!drawCall->depthProgramResolved() && drawCall->program())
+            drawCall->depthProgram(_drawCallPool->depthProgram(drawCall->program()));
+
+        if (drawCall->depthPrePassCompatible())
+            depthDrawCalls.push_back(std::make_pair(drawCall->getEyeSpacePosition(eyePosition)->z(), drawCall));
+    }
+
+    // front to back, so that the early depth test rejects as many fragments as possible
+    std::stable_sort(
+        depthDrawCalls.begin(),
+        depthDrawCalls.end(),
+        [](const std::pair<float, DrawCall*>& a, const std::pair<float, DrawCall*>& b)
+        {
+            return a.first < b.first;
+        }
+    );
+
+    for (const auto& depthDrawCall : depthDrawCalls)
+        depthDrawCall.second->renderDepth(context, renderTarget, _viewportBox);
+}
+
+void
+Renderer::renderProfiled(AbsContext                         context,
+                         const DrawCallPool::DrawCallView&  drawCalls,
+                         AbsTexturePtr                      renderTarget)
+{
+    if (context != _timerQueryContext)
+    {
+        deleteTimerQueries();
+        _timerQueryContext = context;
+    }
+
+    if (_commandBufferEnabled)
+        updateCommandBuffer(drawCalls, renderTarget);
+
+    const auto useTimerQueries = context->supportsTimerQueries();
+    PendingFrameStats frame;
+    std::unordered_map<Pass*, uint> passToIndex;
+
+    frame.stats.cpuTime = 0.f;
+    frame.stats.gpuTime = useTimerQueries ? 0.f : -1.f;
+
+    // each run of consecutive draw calls sharing the same pass is measured on its own
+    uint begin = 0;
+
+    while (begin < drawCalls.size())
+    {
+        auto pass   = drawCalls[begin]->pass().get();
+        uint end    = begin + 1;
+
+        while (end < drawCalls.size() && drawCalls[end]->pass().get() == pass)
+            ++end;
+
+        auto passIt = passToIndex.find(pass);
+
+        if (passIt == passToIndex.end())
+        {
+            auto        effect      = _effect;
+            PassStats   passStats;
+
+            if (!effect)
+            {
+                auto surface = _drawCallPool->surface(drawCalls[begin]->shared_from_this());
+
+                if (surface)
+                    effect = surface->effect();
+            }
+
+            passStats.effect        = effect ? effect->name() : "";
+            passStats.pass          = pass ? pass->name() : "";
+            passStats.numDrawCalls  = 0;
+            passStats.cpuTime       = 0.f;
+            passStats.gpuTime       = useTimerQueries ? 0.f : -1.f;
+
+            passIt = passToIndex.insert(std::make_pair(pass, frame.stats.passes.size())).first;
+            frame.stats.passes.push_back(passStats);
+        }
+
+        if (useTimerQueries)
+        {
+            uint query;
+
+            if (_timerQueries.empty())
+                query = context->createTimerQuery();
+            else
+            {
+                query = _timerQueries.back();
+                _timerQueries.pop_back();
+            }
+
+            frame.queries.push_back(std::make_pair(query, passIt->second));
+            context->beginTimerQuery(query);
+        }
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        if (_commandBufferEnabled)
+            _commandBuffer->execute(context, _recordedDrawCalls[begin].begin, _recordedDrawCalls[end - 1].end);
+        else
+            for (auto i = begin; i < end; ++i)
+                drawCalls[i]->render(context, renderTarget, _viewportBox, _depthPrePassEnabled);
+
+        const std::chrono::duration<float, std::milli> cpuTime = std::chrono::high_resolution_clock::now() - startTime;
+
+        if (useTimerQueries)
+            context->endTimerQuery();
+
+        auto& passStats = frame.stats.passes[passIt->second];
+
+        passStats.cpuTime += cpuTime.count();
+        passStats.numDrawCalls += end - begin;
+
+        begin = end;
+    }
+
+    _pendingFrameStats.push_back(frame);
+}
+
+void
+Renderer::collectFrameStats()
+{
+    while (!_pendingFrameStats.empty())
+    {
+        auto& frame     = _pendingFrameStats.front();
+        auto available  = true;
+
+        for (const auto& query : frame.queries)
+            if (!_timerQueryContext->timerQueryAvailable(query.first))
+            {
+                available = false;
+                break;
+            }
+
+        if (!available)
+        {
+            if (_pendingFrameStats.size() <= MAX_NUM_PENDING_FRAMES)
+                break;
+
+            // never wait for the GPU: the oldest frame is dropped instead
+            for (const auto& query : frame.queries)
+                _timerQueries.push_back(query.first);
+
+            _pendingFrameStats.pop_front();
+
+            continue;
+        }
+
+        for (const auto& query : frame.queries)
+        {
+            auto& passStats = frame.stats.passes[query.second];
+            auto  gpuTime   = _timerQueryContext->timerQueryResult(query.first);
+
+            if (gpuTime < 0.f || passStats.gpuTime < 0.f)
+                passStats.gpuTime = -1.f;
+            else
+                passStats.gpuTime += gpuTime;
+
+            _timerQueries.push_back(query.first);
+        }
+
+        if (frame.stats.gpuTime >= 0.f)
+            for (const auto& passStats : frame.stats.passes)
+            {
+                if (passStats.gpuTime < 0.f)
+                {
+                    frame.stats.gpuTime = -1.f;
+                    break;
+                }
+
+                frame.stats.gpuTime += passStats.gpuTime;
+            }
+
+        _frameStats = std::move(frame.stats);
+        _pendingFrameStats.pop_front();
+    }
+}
+
+void
+Renderer::deleteTimerQueries()
+{
+    if (_timerQueryContext)
+    {
+        for (auto query : _timerQueries)
+            _timerQueryContext->deleteTimerQuery(query);
+
+        for (const auto& frame : _pendingFrameStats)
+            for (const auto& query : frame.queries)
+                _timerQueryContext->deleteTimerQuery(query.first);
+    }
+
+    _timerQueries.clear();
+    _pendingFrameStats.clear();
+    _timerQueryContext = nullptr;
 }
 
 void
@@ -399,7 +800,8 @@ Renderer::sceneManagerRenderingBeginHandler(std::shared_ptr<SceneManager>    sce
                                             uint                            frameId,
                                             AbstractTexture::Ptr            renderTarget)
 {
-    render(sceneManager->assets()->context(), renderTarget);
+    if (_autoRender)
+        render(sceneManager->assets()->context(), renderTarget);
 }
 
 Renderer::Ptr
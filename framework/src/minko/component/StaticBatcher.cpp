@@ -0,0 +1,427 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/component/StaticBatcher.hpp"
+
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+#include "minko/scene/Layout.hpp"
+#include "minko/component/Surface.hpp"
+#include "minko/component/Transform.hpp"
+#include "minko/component/Renderer.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/material/Material.hpp"
+#include "minko/render/Effect.hpp"
+#include "minko/render/VertexBuffer.hpp"
+#include "minko/render/IndexBuffer.hpp"
+#include "minko/math/Matrix4x4.hpp"
+#include "minko/math/Vector3.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+/*static*/ const uint StaticBatcher::MAX_NUM_VERTICES = 65536;
+
+StaticBatcher::StaticBatcher(uint maxNumVertices) :
+    AbstractComponent(),
+    _maxNumVertices(std::min(maxNumVertices, MAX_NUM_VERTICES))
+{
+}
+
+void
+StaticBatcher::initialize()
+{
+    _targetAddedSlot = targetAdded()->connect(std::bind(
+        &StaticBatcher::targetAddedHandler,
+        std::static_pointer_cast<StaticBatcher>(shared_from_this()),
+        std::placeholders::_1,
+        std::placeholders::_2
+    ));
+
+    _targetRemovedSlot = targetRemoved()->connect(std::bind(
+        &StaticBatcher::targetRemovedHandler,
+        std::static_pointer_cast<StaticBatcher>(shared_from_this()),
+        std::placeholders::_1,
+        std::placeholders::_2
+    ));
+}
+
+void
+StaticBatcher::targetAddedHandler(AbstractComponent::Ptr ctrl, NodePtr target)
+{
+    if (targets().size() > 1)
+        throw std::logic_error("The same StaticBatcher cannot have 2 different targets");
+
+    batch();
+}
+
+void
+StaticBatcher::targetRemovedHandler(AbstractComponent::Ptr ctrl, NodePtr target)
+{
+    unbatch();
+}
+
+void
+StaticBatcher::batch()
+{
+    if (targets().empty())
+        throw std::logic_error("The StaticBatcher must have a target.");
+
+    unbatch();
+
+    auto target = targets()[0];
+    auto nodes  = scene::NodeSet::create(target)
+        ->descendants(false)
+        ->where([&](NodePtr node)
+        {
+            return node->hasComponent<Surface>() && isStatic(node, target);
+        });
+
+    std::map<BatchKey, std::vector<std::pair<SurfacePtr, MatrixPtr>>>   keyToSurfaces;
+    std::map<BatchKey, VertexFormat>                                    keyToFormat;
+    std::vector<NodePtr>                                                batchedNodes;
+
+    for (auto& node : nodes->nodes())
+    {
+        auto                                    surfaces = node->components<Surface>();
+        std::vector<std::pair<BatchKey, VertexFormat>> formats;
+
+        for (auto& surface : surfaces)
+        {
+            VertexFormat format;
+
+            if (!vertexFormat(surface, format))
+                break;
+
+            std::string formatName;
+
+            for (auto& attribute : format)
+                formatName += attribute.first + ":" + std::to_string(attribute.second) + ";";
+
+            formats.push_back(std::make_pair(
+                BatchKey(surface->material().get(), surface->effect().get(), surface->technique(), formatName),
+                format
+            ));
+        }
+
+        // a node is batched only if all of its surfaces can be batched
+        if (formats.size() != surfaces.size())
+            continue;
+
+        auto matrix = relativeMatrix(node, target);
+
+        for (uint i = 0; i < surfaces.size(); ++i)
+        {
+            keyToSurfaces[formats[i].first].push_back(std::make_pair(surfaces[i], matrix));
+            keyToFormat[formats[i].first] = formats[i].second;
+        }
+
+        batchedNodes.push_back(node);
+    }
+
+    for (auto& keyAndSurfaces : keyToSurfaces)
+    {
+        auto&                                           format      = keyToFormat[keyAndSurfaces.first];
+        std::vector<std::pair<SurfacePtr, MatrixPtr>>   surfaces;
+        uint                                            numVertices = 0;
+
+        for (auto& surfaceAndMatrix : keyAndSurfaces.second)
+        {
+            auto surfaceNumVertices = surfaceAndMatrix.first->geometry()->numVertices();
+
+            if (numVertices + surfaceNumVertices > _maxNumVertices && !surfaces.empty())
+            {
+                createBatch(surfaces, format);
+                surfaces.clear();
+                numVertices = 0;
+            }
+
+            surfaces.push_back(surfaceAndMatrix);
+            numVertices += surfaceNumVertices;
+        }
+
+        if (!surfaces.empty())
+            createBatch(surfaces, format);
+    }
+
+    // original nodes are kept in the scene for picking/ray casting and to watch their visibility:
+    // only their render layout is removed so that they keep every other layout (picking, culling...)
+    for (auto& node : batchedNodes)
+    {
+        if ((node->layouts() & scene::Layout::Group::DEFAULT) == 0)
+            continue;
+
+        node->layouts(node->layouts() & ~scene::Layout::Group::DEFAULT);
+        _hiddenNodes.push_back(node);
+    }
+
+    for (auto& batchNode : _batchNodes)
+        target->addChild(batchNode);
+}
+
+void
+StaticBatcher::unbatch()
+{
+    for (auto& batchNode : _batchNodes)
+        if (batchNode->parent())
+            batchNode->parent()->removeChild(batchNode);
+
+    // the layouts might have changed since batch(): only give the render layout back
+    for (auto& node : _hiddenNodes)
+        node->layouts(node->layouts() | scene::Layout::Group::DEFAULT);
+
+    _batchNodes.clear();
+    _batchSurfaceToBatch.clear();
+    _surfaceToRange.clear();
+    _hiddenNodes.clear();
+    _surfaceToVisibilityChangedSlot.clear();
+}
+
+StaticBatcher::SurfacePtr
+StaticBatcher::originalSurface(SurfacePtr batchSurface, uint triangle) const
+{
+    return findRange(batchSurface, triangle).surface;
+}
+
+StaticBatcher::NodePtr
+StaticBatcher::originalNode(SurfacePtr batchSurface, uint triangle) const
+{
+    return findRange(batchSurface, triangle).node;
+}
+
+const StaticBatcher::SurfaceRange&
+StaticBatcher::findRange(SurfacePtr batchSurface, uint triangle) const
+{
+    auto batchIt = _batchSurfaceToBatch.find(batchSurface);
+
+    if (batchIt == _batchSurfaceToBatch.end())
+        throw std::invalid_argument("batchSurface");
+
+    auto& ranges    = batchIt->second->ranges;
+    auto rangeIt    = std::upper_bound(
+        ranges.begin(),
+        ranges.end(),
+        triangle,
+        [](uint triangle, const SurfaceRange& range) { return triangle < range.firstTriangle; }
+    );
+
+    if (rangeIt == ranges.begin() || triangle >= (rangeIt - 1)->firstTriangle + (rangeIt - 1)->numTriangles)
+        throw std::invalid_argument("triangle");
+
+    return *(rangeIt - 1);
+}
+
+bool
+StaticBatcher::isStatic(NodePtr node, NodePtr target) const
+{
+    for (; node != nullptr; node = node->parent())
+    {
+        if ((node->layouts() & scene::Layout::Group::STATIC) != 0)
+            return true;
+        if (node == target)
+            break;
+    }
+
+    return false;
+}
+
+bool
+StaticBatcher::vertexFormat(SurfacePtr surface, VertexFormat& format) const
+{
+    auto geometry = surface->geometry();
+
+    if (!geometry || !geometry->indices() || geometry->indices()->data().empty()
+        || !geometry->hasVertexAttribute("position") || geometry->numVertices() > _maxNumVertices)
+        return false;
+
+    for (auto& vertexBuffer : geometry->vertexBuffers())
+    {
+        // the vertex data has to be available on the CPU side
+        if (vertexBuffer->numVertices() != geometry->numVertices())
+            return false;
+
+        for (auto& attribute : vertexBuffer->attributes())
+            format.push_back(std::make_pair(std::get<0>(*attribute), std::get<1>(*attribute)));
+    }
+
+    std::sort(format.begin(), format.end());
+
+    for (auto& attribute : format)
+        if ((attribute.first == "position" || attribute.first == "normal" || attribute.first == "tangent")
+            && attribute.second < 3)
+            return false;
+
+    return true;
+}
+
+StaticBatcher::MatrixPtr
+StaticBatcher::relativeMatrix(NodePtr node, NodePtr target) const
+{
+    auto matrix = math::Matrix4x4::create();
+
+    for (; node != target && node != nullptr; node = node->parent())
+        if (node->hasComponent<Transform>())
+            matrix->append(node->component<Transform>()->matrix());
+
+    return matrix;
+}
+
+StaticBatcher::BatchPtr
+StaticBatcher::createBatch(const std::vector<std::pair<SurfacePtr, MatrixPtr>>&   surfaces,
+                           const VertexFormat&                                    format)
+{
+    std::unordered_map<std::string, uint>   attributeOffsets;
+    uint                                    vertexSize          = 0;
+    auto                                    batch               = std::make_shared<Batch>();
+    std::vector<float>                      vertexData;
+    auto                                    vector              = math::Vector3::create();
+    auto                                    normalMatrix        = math::Matrix4x4::create();
+
+    for (auto& attribute : format)
+    {
+        attributeOffsets[attribute.first] = vertexSize;
+        vertexSize += attribute.second;
+    }
+
+    for (auto& surfaceAndMatrix : surfaces)
+    {
+        auto surface    = surfaceAndMatrix.first;
+        auto matrix     = surfaceAndMatrix.second;
+        auto geometry   = surface->geometry();
+        auto baseVertex = vertexData.size() / vertexSize;
+
+        normalMatrix->copyFrom(matrix)->invert()->transpose();
+        vertexData.resize(vertexData.size() + geometry->numVertices() * vertexSize);
+
+        for (auto& vertexBuffer : geometry->vertexBuffers())
+        {
+            auto& data              = vertexBuffer->data();
+            auto  srcVertexSize     = vertexBuffer->vertexSize();
+
+            for (auto& attribute : vertexBuffer->attributes())
+            {
+                auto& name          = std::get<0>(*attribute);
+                auto  size          = std::get<1>(*attribute);
+                auto  srcOffset     = std::get<2>(*attribute);
+                auto  dstOffset     = attributeOffsets[name];
+                auto  isPosition    = name == "position";
+                auto  isDirection   = name == "normal" || name == "tangent";
+
+                for (uint i = 0; i < geometry->numVertices(); ++i)
+                {
+                    auto src = &data[i * srcVertexSize + srcOffset];
+                    auto dst = &vertexData[(baseVertex + i) * vertexSize + dstOffset];
+
+                    std::copy(src, src + size, dst);
+
+                    if (isPosition || isDirection)
+                    {
+                        vector->setTo(src[0], src[1], src[2]);
+                        if (isPosition)
+                            matrix->transform(vector, vector);
+                        else
+                            normalMatrix->deltaTransform(vector, vector)->normalize();
+
+                        dst[0] = vector->x();
+                        dst[1] = vector->y();
+                        dst[2] = vector->z();
+                    }
+                }
+            }
+        }
+
+        auto& indices       = geometry->indices()->data();
+        auto  firstTriangle = uint(batch->indices.size() / 3);
+
+        for (auto index : indices)
+            batch->indices.push_back(baseVertex + index);
+
+        _surfaceToRange[surface] = std::make_pair(batch, batch->ranges.size());
+        batch->ranges.push_back({ firstTriangle, uint(indices.size() / 3), surface, surface->targets()[0] });
+    }
+
+    auto context        = surfaces.front().first->geometry()->vertexBuffers().front()->context();
+    auto vertexBuffer   = render::VertexBuffer::create(context, vertexData);
+    auto geometry       = geometry::Geometry::create();
+
+    for (auto& attribute : format)
+        vertexBuffer->addAttribute(attribute.first, attribute.second, attributeOffsets[attribute.first]);
+    geometry->addVertexBuffer(vertexBuffer);
+    geometry->indices(render::IndexBuffer::create(context, batch->indices));
+
+    auto original   = surfaces.front().first;
+
+    batch->surface  = Surface::create(
+        original->name(),
+        geometry,
+        original->material(),
+        original->effect(),
+        original->technique()
+    );
+    batch->node     = scene::Node::create("staticBatch" + std::to_string(_batchNodes.size()))
+        ->addComponent(Transform::create())
+        ->addComponent(batch->surface);
+
+    _batchNodes.push_back(batch->node);
+    _batchSurfaceToBatch[batch->surface] = batch;
+
+    for (auto& range : batch->ranges)
+    {
+        if (!range.surface->visible())
+            updateRange(batch, range, false);
+
+        _surfaceToVisibilityChangedSlot[range.surface] = range.surface->visibilityChanged()->connect(std::bind(
+            &StaticBatcher::visibilityChangedHandler,
+            std::static_pointer_cast<StaticBatcher>(shared_from_this()),
+            std::placeholders::_1,
+            std::placeholders::_2,
+            std::placeholders::_3
+        ));
+    }
+
+    return batch;
+}
+
+void
+StaticBatcher::visibilityChangedHandler(SurfacePtr surface, std::shared_ptr<Renderer> renderer, bool visible)
+{
+    // per-renderer visibility cannot be honored by a geometry shared by all renderers
+    if (renderer != nullptr)
+        return;
+
+    auto& batchAndRange = _surfaceToRange[surface];
+    auto  batch         = batchAndRange.first;
+
+    updateRange(batch, batch->ranges[batchAndRange.second], visible);
+}
+
+void
+StaticBatcher::updateRange(BatchPtr batch, const SurfaceRange& range, bool visible)
+{
+    auto  indexBuffer   = batch->surface->geometry()->indices();
+    auto& data          = indexBuffer->data();
+    auto  begin         = range.firstTriangle * 3;
+    auto  end           = begin + range.numTriangles * 3;
+
+    // hidden surfaces are collapsed into degenerate triangles
+    for (auto i = begin; i < end; ++i)
+        data[i] = visible ? batch->indices[i] : batch->indices[begin];
+
+    indexBuffer->upload();
+}
@@ -339,6 +339,12 @@ Transform::RootTransform::updateTransforms()
     unsigned int numNodes     = _transforms.size();
     unsigned int nodeId     = 0;
 
+    // listeners are notified once the whole hierarchy is up to date
+    data::Container::ScopedBatch batch;
+
+    for (auto& node : _idToNode)
+        batch.add(node->data());
+
     while (nodeId < numNodes)
     {
         auto parentModelToWorldMatrix     = _modelToWorld[nodeId];
@@ -377,6 +383,8 @@ Transform::RootTransform::updateTransforms()
 
         ++nodeId;
     }
+
+    batch.end();
 }
 
 void
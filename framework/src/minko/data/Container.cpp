@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/data/ArrayProvider.hpp"
 #include "minko/data/Provider.hpp"
 #include "minko/data/AbstractFilter.hpp"
+#include "minko/log/Logger.hpp"
 
 using namespace minko;
 using namespace minko::data;
@@ -42,6 +43,11 @@ Container::Container() :
     _providerReferenceChangedSlot(),
     _providerAdded(Signal<Ptr, Provider::Ptr>::create()),
     _providerRemoved(Signal<Ptr, Provider::Ptr>::create()),
+    _batchDepth(0),
+    _pendingValueChanged(),
+    _pendingReferenceChanged(),
+    _pendingValueChangedSet(),
+    _pendingReferenceChangedSet(),
     _containerId(CONTAINER_ID++)
 {
 }
@@ -84,8 +90,8 @@ Container::addProvider(Provider::Ptr provider)
             std::placeholders::_2
         ));
 
-        for (auto property : provider->values())
-            providerPropertyAddedHandler(provider, property.first);
+        for (auto propertyName : provider->propertyNames())
+            providerPropertyAddedHandler(provider, propertyName);
 
         _providerAdded->execute(shared_from_this(), provider);
     }
@@ -102,8 +108,8 @@ Container::removeProvider(Provider::Ptr provider)
     _providersToNumUse[provider]--;
     if (_providersToNumUse[provider] == 0)
     {
-        for (auto property : provider->values())
-            providerPropertyRemovedHandler(provider, property.first);
+        for (auto propertyName : provider->propertyNames())
+            providerPropertyRemovedHandler(provider, propertyName);
 
         _propertyAddedOrRemovedSlots.erase(provider);
         _providerValueChangedSlot.erase(provider);
@@ -210,14 +216,8 @@ Container::hasProvider(std::shared_ptr<Provider> provider) const
     return std::find(_providers.begin(), _providers.end(), provider) != _providers.end();
 }
 
-bool
-Container::hasProperty(const std::string& propertyName) const
-{
-    return _propertyNameToProvider.count(propertyName) != 0;
-}
-
 Container::PropertyChangedSignalPtr
-Container::propertyValueChanged(const std::string& propertyName)
+Container::propertyValueChanged(const PropertyName& propertyName)
 {
     //assertPropertyExists(propertyName);
 
@@ -225,9 +225,11 @@ Container::propertyValueChanged(const std::string& propertyName)
     {
         _propValueChanged[propertyName] = Signal<Container::Ptr, const std::string&>::create();
 
-        if (_propertyNameToProvider.count(propertyName) != 0)
+        const auto foundProviderIt = _propertyNameToProvider.find(propertyName);
+
+        if (foundProviderIt != _propertyNameToProvider.end())
         {
-            Provider::Ptr provider = _propertyNameToProvider[propertyName];
+            Provider::Ptr provider = foundProviderIt->second.first;
 
             if (_providerValueChangedSlot.count(provider) == 0)
                 _providerValueChangedSlot[provider] = provider->propertyValueChanged()->connect(std::bind(
@@ -243,15 +245,17 @@ Container::propertyValueChanged(const std::string& propertyName)
 }
 
 Container::PropertyChangedSignalPtr
-Container::propertyReferenceChanged(const std::string& propertyName)
+Container::propertyReferenceChanged(const PropertyName& propertyName)
 {
     if (_propReferenceChanged.count(propertyName) == 0)
     {
         _propReferenceChanged[propertyName] = Signal<Container::Ptr, const std::string&>::create();
 
-        if (_propertyNameToProvider.count(propertyName) != 0)
+        const auto foundProviderIt = _propertyNameToProvider.find(propertyName);
+
+        if (foundProviderIt != _propertyNameToProvider.end())
         {
-            Provider::Ptr provider = _propertyNameToProvider[propertyName];
+            Provider::Ptr provider = foundProviderIt->second.first;
 
             if (_providerReferenceChangedSlot.count(provider) == 0)
             {
@@ -268,43 +272,73 @@ Container::propertyReferenceChanged(const std::string& propertyName)
     return _propReferenceChanged[propertyName];
 }
 
-void
-Container::assertPropertyExists(const std::string& propertyName) const
+const Container::ProviderAndKey&
+Container::findProvider(const PropertyName& propertyName) const
 {
-    if (!hasProperty(propertyName))
-        throw std::invalid_argument(propertyName);
+    const auto foundProviderIt = _propertyNameToProvider.find(propertyName);
+
+    if (foundProviderIt == _propertyNameToProvider.end())
+        throw std::invalid_argument(propertyName.str());
+
+    return foundProviderIt->second;
 }
 
 void
 Container::providerValueChangedHandler(Provider::Ptr        provider,
                                        const std::string&     propertyName)
 {
-    auto formatedPropertyName = formatPropertyName(provider, propertyName);
+    const PropertyName formatedPropertyName = formatPropertyName(provider, propertyName);
+    const auto foundSignalIt = _propValueChanged.find(formatedPropertyName);
 
-    if (_propValueChanged.count(formatedPropertyName) != 0)
-        propertyValueChanged(formatedPropertyName)->execute(shared_from_this(), formatedPropertyName);
+    if (foundSignalIt == _propValueChanged.end())
+        return;
+
+    if (_batchDepth != 0)
+    {
+        if (_pendingValueChangedSet.insert(formatedPropertyName).second)
+            _pendingValueChanged.push_back(formatedPropertyName);
+    }
+    else
+    {
+        auto signal = foundSignalIt->second;
+
+        signal->execute(shared_from_this(), formatedPropertyName);
+    }
 }
 
 void
 Container::providerReferenceChangedHandler(Provider::Ptr        provider,
                                            const std::string&    propertyName)
 {
-    auto formatedPropertyName = formatPropertyName(provider, propertyName);
+    const PropertyName formatedPropertyName = formatPropertyName(provider, propertyName);
+    const auto foundSignalIt = _propReferenceChanged.find(formatedPropertyName);
 
-    if (_propReferenceChanged.count(formatedPropertyName))
-        propertyReferenceChanged(formatedPropertyName)->execute(shared_from_this(), formatedPropertyName);
+    if (foundSignalIt == _propReferenceChanged.end())
+        return;
+
+    if (_batchDepth != 0)
+    {
+        if (_pendingReferenceChangedSet.insert(formatedPropertyName).second)
+            _pendingReferenceChanged.push_back(formatedPropertyName);
+    }
+    else
+    {
+        auto signal = foundSignalIt->second;
+
+        signal->execute(shared_from_this(), formatedPropertyName);
+    }
 }
 
 void
 Container::providerPropertyAddedHandler(std::shared_ptr<Provider>     provider,
                                         const std::string&             propertyName)
 {
-    auto formatedPropertyName = formatPropertyName(provider, propertyName);
+    const PropertyName formatedPropertyName = formatPropertyName(provider, propertyName);
 
     if (_propertyNameToProvider.count(formatedPropertyName) != 0)
-        throw std::logic_error("duplicate property name: " + formatedPropertyName);
+        throw std::logic_error("duplicate property name: " + formatedPropertyName.str());
 
-    _propertyNameToProvider[formatedPropertyName] = provider;
+    _propertyNameToProvider[formatedPropertyName] = ProviderAndKey(provider, propertyName);
 
     if (_propValueChanged.count(formatedPropertyName) != 0)
         _providerValueChangedSlot[provider] = provider->propertyValueChanged()->connect(std::bind(
@@ -324,7 +358,7 @@ Container::providerPropertyRemovedHandler(std::shared_ptr<Provider> provider,
                                           const std::string&        propertyName)
 {
 
-    auto formatedPropertyName = formatPropertyName(provider, propertyName);
+    const PropertyName formatedPropertyName = formatPropertyName(provider, propertyName);
 
     if (_propertyNameToProvider.count(formatedPropertyName) != 0)
     {
@@ -374,42 +408,6 @@ Container::formatPropertyName(ProviderPtr provider, const std::string& propertyN
 #endif // MINKO_NO_GLSL_STRUCT
 }
 
-std::string
-Container::unformatPropertyName(ProviderPtr provider, const std::string& formattedPropertyName) const
-{
-
-    auto arrayProvider = std::dynamic_pointer_cast<ArrayProvider>(provider);
-
-    if (arrayProvider == nullptr)
-        return formattedPropertyName;
-
-    if (formattedPropertyName.substr(0, arrayProvider->arrayName().size()) != arrayProvider->arrayName())
-        return unformatPropertyName(provider, formattedPropertyName);
-
-#ifndef MINKO_NO_GLSL_STRUCT
-
-    std::size_t pos = formattedPropertyName.rfind("].");
-
-    if (pos == std::string::npos)
-        return unformatPropertyName(provider, formattedPropertyName);
-
-    return formattedPropertyName.substr(pos + 2);
-
-#else
-
-    std::size_t pos1 = formattedPropertyName.find_first_of(NO_STRUCT_SEP);
-    std::size_t pos2 = formattedPropertyName.find_first_of('[');
-
-    if (pos1 == std::string::npos || pos2 == std::string::npos)
-        return unformatPropertyName(provider, formattedPropertyName);
-
-    pos1 += NO_STRUCT_SEP.size();
-
-    return formattedPropertyName.substr(pos1, pos2 - pos1);
-
-#endif // MINKO_NO_GLSL_STRUCT
-}
-
 Container::Ptr
 Container::filter(const std::set<data::AbstractFilter::Ptr>&    filters,
                   Container::Ptr                                output) const
@@ -451,6 +449,121 @@ Container::filter(const std::set<data::AbstractFilter::Ptr>&    filters,
     return output;
 }
 
+void
+Container::beginBatch()
+{
+    ++_batchDepth;
+}
+
+void
+Container::endBatch()
+{
+    if (_batchDepth == 0)
+        throw std::logic_error("endBatch() called without a matching beginBatch()");
+
+    if (--_batchDepth != 0)
+        return;
+
+    // the listeners may change properties again, so the pending lists are released before notifying
+    auto self                   = shared_from_this();
+    auto referenceChanged       = std::move(_pendingReferenceChanged);
+    auto valueChanged           = std::move(_pendingValueChanged);
+
+    _pendingReferenceChanged.clear();
+    _pendingValueChanged.clear();
+    _pendingReferenceChangedSet.clear();
+    _pendingValueChangedSet.clear();
+
+    for (const auto& propertyName : referenceChanged)
+    {
+        const auto foundSignalIt = _propReferenceChanged.find(propertyName);
+
+        if (foundSignalIt != _propReferenceChanged.end())
+        {
+            auto signal = foundSignalIt->second;
+
+            signal->execute(self, propertyName);
+        }
+    }
+
+    for (const auto& propertyName : valueChanged)
+    {
+        const auto foundSignalIt = _propValueChanged.find(propertyName);
+
+        if (foundSignalIt != _propValueChanged.end())
+        {
+            auto signal = foundSignalIt->second;
+
+            signal->execute(self, propertyName);
+        }
+    }
+}
+
+Container::ScopedBatch::ScopedBatch() :
+    _containers()
+{
+}
+
+Container::ScopedBatch::ScopedBatch(Ptr container) :
+    _containers()
+{
+    add(container);
+}
+
+Container::ScopedBatch::~ScopedBatch()
+{
+    // a destructor cannot let a listener exception escape, it would abort the program or hide
+    // the exception being unwound: callers that want them rethrown must call end()
+    for (auto& container : _containers)
+    {
+        try
+        {
+            container->endBatch();
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR("exception thrown while closing a container batch: " << e.what());
+        }
+        catch (...)
+        {
+            LOG_ERROR("exception thrown while closing a container batch");
+        }
+    }
+}
+
+void
+Container::ScopedBatch::add(Ptr container)
+{
+    container->beginBatch();
+    _containers.push_back(container);
+}
+
+void
+Container::ScopedBatch::end()
+{
+    // the remaining batches are closed before the first listener exception is rethrown
+    auto                containers  = std::move(_containers);
+    std::exception_ptr  exception;
+
+    _containers.clear();
+
+    for (auto& container : containers)
+    {
+        try
+        {
+            container->endBatch();
+        }
+        catch (...)
+        {
+            if (!exception)
+                exception = std::current_exception();
+        }
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
 bool
 Container::isLengthProperty(const std::string& propertyName) const
 {
@@ -458,5 +571,5 @@ Container::isLengthProperty(const std::string& propertyName) const
 
     return foundProviderIt == _propertyNameToProvider.end()
         ? false
-        : foundProviderIt->second.get() == _arrayLengths.get();
+        : foundProviderIt->second.first.get() == _arrayLengths.get();
 }
\ No newline at end of file
@@ -0,0 +1,156 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/data/ContainerView.hpp"
+
+#include "minko/data/Container.hpp"
+#include "minko/data/ArrayProvider.hpp"
+#include "minko/data/AbstractFilter.hpp"
+#include "minko/component/Surface.hpp"
+
+using namespace minko;
+using namespace minko::data;
+
+ContainerView::ContainerView(ContainerPtr                   source,
+                             const std::set<AbsFilterPtr>&  filters,
+                             SurfacePtr                     surface) :
+    _source(source),
+    _filters(filters),
+    _surface(surface),
+    _container(Container::create()),
+    _changed(Signal<Ptr>::create()),
+    _providerAddedSlot(nullptr),
+    _providerRemovedSlot(nullptr)
+{
+    if (_source == nullptr)
+        throw std::invalid_argument("source");
+}
+
+void
+ContainerView::initialize()
+{
+    _providerAddedSlot = _source->providerAdded()->connect([=](ContainerPtr c, ProviderPtr p){
+        providerAddedHandler(c, p);
+    });
+    _providerRemovedSlot = _source->providerRemoved()->connect([=](ContainerPtr c, ProviderPtr p){
+        providerRemovedHandler(c, p);
+    });
+
+    if (prepareFilters())
+        _source->filter(_filters, _container);
+}
+
+void
+ContainerView::filters(const std::set<AbsFilterPtr>& value)
+{
+    if (value == _filters)
+        return;
+
+    _filters = value;
+    update();
+}
+
+bool
+ContainerView::update()
+{
+    if (!prepareFilters())
+        return false;
+
+    // a provider can be swapped for another one, so comparing the sizes is not enough
+    const auto providers = _container->providers();
+
+    _source->filter(_filters, _container);
+
+    if (providers == _container->providers())
+        return false;
+
+    _changed->execute(shared_from_this());
+
+    return true;
+}
+
+bool
+ContainerView::prepareFilters()
+{
+    if (_surface == nullptr)
+        return true;
+
+    // the surface is being removed from the scene
+    if (_surface->targets().empty())
+        return false;
+
+    for (auto& filter : _filters)
+        if (filter->currentSurface() != _surface)
+            filter->currentSurface(_surface);
+
+    return true;
+}
+
+bool
+ContainerView::accept(ProviderPtr provider)
+{
+    for (auto& filter : _filters)
+        if (!(*filter)(provider))
+            return false;
+
+    return true;
+}
+
+void
+ContainerView::addProvider(ProviderPtr provider)
+{
+    auto arrayProvider = std::dynamic_pointer_cast<ArrayProvider>(provider);
+
+    if (arrayProvider)
+        _container->addProvider(arrayProvider);
+    else
+        _container->addProvider(provider);
+}
+
+void
+ContainerView::removeProvider(ProviderPtr provider)
+{
+    auto arrayProvider = std::dynamic_pointer_cast<ArrayProvider>(provider);
+
+    if (arrayProvider)
+        _container->removeProvider(arrayProvider);
+    else
+        _container->removeProvider(provider);
+}
+
+void
+ContainerView::providerAddedHandler(ContainerPtr source, ProviderPtr provider)
+{
+    if (_container->hasProvider(provider) || !prepareFilters() || !accept(provider))
+        return;
+
+    addProvider(provider);
+    _changed->execute(shared_from_this());
+}
+
+void
+ContainerView::providerRemovedHandler(ContainerPtr source, ProviderPtr provider)
+{
+    if (!_container->hasProvider(provider))
+        return;
+
+    removeProvider(provider);
+    _changed->execute(shared_from_this());
+}
@@ -119,11 +119,15 @@ LightMaskFilter::lightsChangedHandler()
 
         _providerToLight[light->data()] = light;
 
-        _layoutMaskChangedSlots.push_back(light->data()->propertyValueChanged()->connect([=](Provider::Ptr provider, const std::string& lightProperty)
+        // the other light properties do not change the result of the filter
+        _layoutMaskChangedSlots.push_back(light->layoutMaskChanged()->connect([=](AbsCmpPtr)
         {
             changed()->execute(shared_from_this(), nullptr);
         }));
     }
+
+    // lights added before the filter knew about them were accepted whatever their layout mask
+    changed()->execute(shared_from_this(), nullptr);
 }
 
 /*static*/
@@ -39,9 +39,10 @@ namespace minko
             typedef std::shared_ptr<Container>                    ContainerPtr;
             typedef std::shared_ptr<Provider>                    ProviderPtr;
             typedef std::shared_ptr<component::AbstractLight>    AbsLightPtr;
+            typedef std::shared_ptr<component::AbstractComponent> AbsCmpPtr;
 
             typedef Signal<ContainerPtr, const std::string&>    ContainerPropertyChangedSignal;
-            typedef Signal<ProviderPtr, const std::string&>        ProviderPropertyChangedSignal;
+            typedef Signal<AbsCmpPtr>                            LayoutMaskChangedSignal;
 
         private:
             static std::vector<std::string>                        _numLightPropertyNames;
@@ -52,7 +53,7 @@ namespace minko
 
             std::list<ContainerPropertyChangedSignal::Slot>        _rootPropertyChangedSlots;
 
-            std::list<ProviderPropertyChangedSignal::Slot>        _layoutMaskChangedSlots;
+            std::list<LayoutMaskChangedSignal::Slot>            _layoutMaskChangedSlots;
 
         public:
             inline static
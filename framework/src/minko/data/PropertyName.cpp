@@ -0,0 +1,66 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/data/PropertyName.hpp"
+
+using namespace minko;
+using namespace minko::data;
+
+static
+std::unordered_map<std::string, std::size_t>&
+names()
+{
+    // the nodes of an unordered_map are never moved, so atoms can keep pointers to them
+    static std::unordered_map<std::string, std::size_t> names;
+
+    return names;
+}
+
+PropertyName::PropertyName() :
+    _entry(nullptr)
+{
+    static const Entry* emptyEntry = intern("");
+
+    _entry = emptyEntry;
+}
+
+PropertyName::PropertyName(const std::string& name) :
+    _entry(intern(name))
+{
+}
+
+/*static*/
+uint
+PropertyName::numNames()
+{
+    return names().size();
+}
+
+/*static*/
+const PropertyName::Entry*
+PropertyName::intern(const std::string& name)
+{
+    auto& names     = ::names();
+    auto  nameIt    = names.find(name);
+
+    if (nameIt == names.end())
+        nameIt = names.insert(std::make_pair(name, std::hash<std::string>()(name))).first;
+
+    return &*nameIt;
+}
@@ -27,7 +27,8 @@ using namespace minko::data;
 Provider::Provider() :
     enable_shared_from_this(),
     _names(),
-    _values(),
+    _slots(MIN_NUM_SLOTS),
+    _numValues(0),
     _valueChangedSlots(),
     _referenceChangedSlots(),
     _propertyAdded(Signal<Ptr, const std::string&>::create()),
@@ -38,17 +39,17 @@ Provider::Provider() :
 }
 
 Provider::Ptr
-Provider::unset(const std::string& propertyName)
+Provider::unset(const PropertyName& propertyName)
 {
-    const auto& formattedPropertyName = formatPropertyName(propertyName);
+    const auto formattedPropertyName = formatPropertyName(propertyName);
 
-    if (_values.count(formattedPropertyName) != 0)
+    if (eraseSlot(formattedPropertyName))
     {
-        _names.erase(std::find(_names.begin(), _names.end(), formattedPropertyName));
-        _values.erase(formattedPropertyName);
         _valueChangedSlots.erase(formattedPropertyName);
         _referenceChangedSlots.erase(formattedPropertyName);
 
+        _names.erase(std::find(_names.begin(), _names.end(), formattedPropertyName.str()));
+
         _propertyRemoved->execute(shared_from_this(), formattedPropertyName);
     }
 
@@ -58,8 +59,8 @@ Provider::unset(const std::string& propertyName)
 Provider::Ptr
 Provider::swap(const std::string& propertyName1, const std::string& propertyName2, bool skipPropertyNameFormatting)
 {
-    auto formattedPropertyName1    = skipPropertyNameFormatting ? propertyName1 : formatPropertyName(propertyName1);
-    auto formattedPropertyName2    = skipPropertyNameFormatting ? propertyName2 : formatPropertyName(propertyName2);
+    auto formattedPropertyName1    = skipPropertyNameFormatting ? PropertyName(propertyName1) : formatPropertyName(propertyName1);
+    auto formattedPropertyName2    = skipPropertyNameFormatting ? PropertyName(propertyName2) : formatPropertyName(propertyName2);
     auto hasProperty1            = hasProperty(formattedPropertyName1, true);
     auto hasProperty2            = hasProperty(formattedPropertyName2, true);
 
@@ -70,27 +71,37 @@ Provider::swap(const std::string& propertyName1, const std::string& propertyName
     {
         auto source = hasProperty1 ? formattedPropertyName1 : formattedPropertyName2;
         auto destination = hasProperty1 ? formattedPropertyName2 : formattedPropertyName1;
-        auto namesIt = std::find(_names.begin(), _names.end(), source);
-
-        *namesIt = destination;
+        auto namesIt = std::find(_names.begin(), _names.end(), source.str());
 
-        _values[destination] = _values[source];
-        _values.erase(source);
+        *namesIt = destination.str();
 
-        _valueChangedSlots[destination] = _valueChangedSlots[source];
-        _valueChangedSlots.erase(source);
+        moveValue(source, destination);
 
         _propertyRemoved->execute(shared_from_this(), source);
         _propertyAdded->execute(shared_from_this(), destination);
     }
     else
     {
-        const auto    value1    = _values[formattedPropertyName1];
-        const auto    value2    = _values[formattedPropertyName2];
+        auto          slot1     = findSlot(formattedPropertyName1);
+        auto          slot2     = findSlot(formattedPropertyName2);
+        const bool    isInline1 = slot1->type != nullptr;
+        const bool    isInline2 = slot2->type != nullptr;
         const bool    changed = true;//!( (*value1) == (*value2) );
+        ValueSlot     tmp;
 
-        _values[formattedPropertyName1] = value2;
-        _values[formattedPropertyName2] = value1;
+        moveSlotValue(*slot1, tmp);
+        moveSlotValue(*slot2, *slot1);
+        moveSlotValue(tmp, *slot2);
+
+        // the change listener of a boxed value follows it when it takes the place of an inline one
+        if (isInline1 != isInline2)
+        {
+            const auto    inlineName    = isInline1 ? formattedPropertyName1 : formattedPropertyName2;
+            const auto    boxedName     = isInline1 ? formattedPropertyName2 : formattedPropertyName1;
+
+            _valueChangedSlots[inlineName] = _valueChangedSlots[boxedName];
+            _valueChangedSlots.erase(boxedName);
+        }
 
         _propValueChanged->execute(shared_from_this(), formattedPropertyName1);
         _propValueChanged->execute(shared_from_this(), formattedPropertyName2);
@@ -106,15 +117,23 @@ Provider::swap(const std::string& propertyName1, const std::string& propertyName
 }
 
 bool
-Provider::hasProperty(const std::string& name, bool skipPropertyNameFormatting) const
+Provider::hasProperty(const PropertyName& name, bool skipPropertyNameFormatting) const
 {
-    auto it = std::find(
-        _names.begin(),
-        _names.end(),
-        skipPropertyNameFormatting ? name : formatPropertyName(name)
-    );
+    const auto formattedName = skipPropertyNameFormatting ? name : formatPropertyName(name);
 
-    return it != _names.end();
+    return findSlot(formattedName) != nullptr;
+}
+
+std::unordered_map<PropertyName, Any>
+Provider::values() const
+{
+    std::unordered_map<PropertyName, Any> values;
+
+    for (const auto& slot : _slots)
+        if (slot.used)
+            values.insert(std::make_pair(slot.name, slot.type != nullptr ? slot.box(&slot.data) : slot.boxed));
+
+    return values;
 }
 
 /*virtual*/
@@ -132,8 +151,113 @@ Provider::clone()
 Provider::Ptr
 Provider::copyFrom(Provider::Ptr source)
 {
-    _names    = source->_names;
-    _values = source->_values;
+    _names          = source->_names;
+    _slots          = source->_slots;
+    _numValues      = source->_numValues;
 
     return shared_from_this();
 }
+
+Provider::ValueSlot&
+Provider::createSlot(const PropertyName& formattedName, bool& isNewValue)
+{
+    auto slot = findSlot(formattedName);
+
+    isNewValue = slot == nullptr;
+    if (!isNewValue)
+        return *slot;
+
+    if (2 * (_numValues + 1) > _slots.size())
+    {
+        std::vector<ValueSlot> slots(2 * _slots.size());
+
+        slots.swap(_slots);
+        _numValues = 0;
+
+        for (auto& oldSlot : slots)
+            if (oldSlot.used)
+            {
+                bool isNewSlot;
+
+                moveSlotValue(oldSlot, createSlot(oldSlot.name, isNewSlot));
+            }
+    }
+
+    const auto mask = _slots.size() - 1;
+    auto i = formattedName.hash() & mask;
+
+    while (_slots[i].used)
+        i = (i + 1) & mask;
+
+    _slots[i].used = true;
+    _slots[i].name = formattedName;
+    ++_numValues;
+
+    return _slots[i];
+}
+
+bool
+Provider::eraseSlot(const PropertyName& formattedName)
+{
+    auto slot = findSlot(formattedName);
+
+    if (slot == nullptr)
+        return false;
+
+    // the following slots of the same cluster are shifted back, so that probing never stops early
+    const auto mask = _slots.size() - 1;
+    auto i = static_cast<std::size_t>(slot - &_slots[0]);
+
+    for (auto j = (i + 1) & mask; _slots[j].used; j = (j + 1) & mask)
+    {
+        const auto home = _slots[j].name.hash() & mask;
+
+        if (i <= j ? (home <= i || home > j) : (home <= i && home > j))
+        {
+            _slots[i].name = _slots[j].name;
+            moveSlotValue(_slots[j], _slots[i]);
+            i = j;
+        }
+    }
+
+    _slots[i] = ValueSlot();
+    --_numValues;
+
+    return true;
+}
+
+/*static*/
+void
+Provider::moveSlotValue(ValueSlot& source, ValueSlot& destination)
+{
+    destination.type = source.type;
+    destination.box = source.box;
+    destination.data = source.data;
+    destination.boxed.swap(source.boxed);
+}
+
+void
+Provider::unsetBoxedValue(const PropertyName& formattedName, ValueSlot& slot)
+{
+    slot.boxed = Any();
+
+    _valueChangedSlots.erase(formattedName);
+    _referenceChangedSlots.erase(formattedName);
+}
+
+void
+Provider::moveValue(const PropertyName& source, const PropertyName& destination)
+{
+    bool        isNewValue;
+    ValueSlot   value;
+
+    moveSlotValue(*findSlot(source), value);
+    eraseSlot(source);
+    moveSlotValue(value, createSlot(destination, isNewValue));
+
+    if (value.type == nullptr)
+    {
+        _valueChangedSlots[destination] = _valueChangedSlots[source];
+        _valueChangedSlots.erase(source);
+    }
+}
@@ -47,6 +47,7 @@ Options::Options() :
     _disposeVertexBufferAfterLoading(false),
     _disposeTextureAfterLoading(false),
     _storeDataIfNotParsed(true),
+    _warmUpPrograms(false),
     _skinningFramerate(30),
     _skinningMethod(component::SkinningMethod::HARDWARE),
     _material(nullptr),
@@ -82,6 +83,7 @@ Options::Options(const Options& copy) :
     _disposeVertexBufferAfterLoading(copy._disposeVertexBufferAfterLoading),
     _disposeTextureAfterLoading(copy._disposeTextureAfterLoading),
     _storeDataIfNotParsed(copy._storeDataIfNotParsed),
+    _warmUpPrograms(copy._warmUpPrograms),
     _skinningFramerate(copy._skinningFramerate),
     _skinningMethod(copy._skinningMethod),
     _effect(copy._effect),
@@ -128,6 +128,49 @@ Geometry::removeVertexBuffer(const std::string& attributeName)
     removeVertexBuffer(vertexBufferIt);
 }
 
+void
+Geometry::copyBuffers(Ptr geometry)
+{
+    if (geometry->_indexBuffer == nullptr)
+        throw std::invalid_argument("geometry");
+
+    for (auto vertexBuffer : geometry->_vertexBuffers)
+        for (auto attribute : vertexBuffer->attributes())
+            if (!_data->hasProperty(std::get<0>(*attribute)))
+                throw std::invalid_argument("geometry");
+
+    for (auto vertexBuffer : _vertexBuffers)
+        for (auto attribute : vertexBuffer->attributes())
+            if (!geometry->_data->hasProperty(std::get<0>(*attribute)))
+                throw std::invalid_argument("geometry");
+
+    _vbToVertexSizeChangedSlot.clear();
+    _vertexBuffers = geometry->_vertexBuffers;
+
+    for (auto vertexBuffer : _vertexBuffers)
+    {
+        for (auto attribute : vertexBuffer->attributes())
+            _data->set(std::get<0>(*attribute), vertexBuffer);
+
+        _vbToVertexSizeChangedSlot[vertexBuffer] = vertexBuffer->vertexSizeChanged()->connect(std::bind(
+            &Geometry::vertexSizeChanged,
+            shared_from_this(),
+            std::placeholders::_1,
+            std::placeholders::_2
+        ));
+    }
+
+    _numVertices = geometry->_numVertices;
+
+    if (_vertexSize != geometry->_vertexSize)
+    {
+        _vertexSize = geometry->_vertexSize;
+        _data->set("vertex.size", _vertexSize);
+    }
+
+    indices(geometry->_indexBuffer);
+}
+
 Geometry::Ptr
 Geometry::computeNormals()
 {
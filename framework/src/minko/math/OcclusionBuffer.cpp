@@ -0,0 +1,347 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/math/OcclusionBuffer.hpp"
+
+#include "minko/math/Matrix4x4.hpp"
+#include "minko/math/Box.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define MINKO_OCCLUSION_BUFFER_SSE2
+# include <emmintrin.h>
+#endif
+
+using namespace minko;
+using namespace minko::math;
+
+// vertices closer to the eye are not projected and their triangles are simply not rasterized,
+// which can only make the occluders smaller
+/*static*/ const float OcclusionBuffer::MIN_W = 1e-5f;
+
+OcclusionBuffer::OcclusionBuffer(uint width, uint height, uint tileSize) :
+    _width(width),
+    _height(height),
+    _tileSize(tileSize),
+    _numTilesX(0),
+    _numTilesY(0),
+    _depth(width * height, 1.f),
+    _tileMaxDepth(),
+    _invalidTiles(false),
+    _worldToScreen(Matrix4x4::create()->values()),
+    _screenVertices(),
+    _numOccluderTriangles(0)
+{
+    if (width == 0 || height == 0)
+        throw std::invalid_argument("width, height");
+    if (tileSize == 0 || width % tileSize != 0 || height % tileSize != 0)
+        throw std::invalid_argument("tileSize");
+
+    _numTilesX = width / tileSize;
+    _numTilesY = height / tileSize;
+    _tileMaxDepth.resize(_numTilesX * _numTilesY, 1.f);
+}
+
+void
+OcclusionBuffer::clear(Matrix4x4Ptr worldToScreen)
+{
+    _worldToScreen = worldToScreen->values();
+
+    std::fill(_depth.begin(), _depth.end(), 1.f);
+    std::fill(_tileMaxDepth.begin(), _tileMaxDepth.end(), 1.f);
+
+    _invalidTiles = false;
+    _numOccluderTriangles = 0;
+}
+
+void
+OcclusionBuffer::transform(const float* m, float x, float y, float z, float* output) const
+{
+    const float w = m[12] * x + m[13] * y + m[14] * z + m[15];
+
+    output[3] = w;
+
+    if (w < MIN_W)
+        return;
+
+    const float invW = 1.f / w;
+
+    output[0] = ((m[0] * x + m[1] * y + m[2] * z + m[3]) * invW * .5f + .5f) * _width;
+    output[1] = ((m[4] * x + m[5] * y + m[6] * z + m[7]) * invW * .5f + .5f) * _height;
+    output[2] = (m[8] * x + m[9] * y + m[10] * z + m[11]) * invW * .5f + .5f;
+}
+
+void
+OcclusionBuffer::rasterize(const std::vector<float>&            vertices,
+                           uint                                 vertexSize,
+                           uint                                 positionOffset,
+                           const std::vector<unsigned short>&   indices,
+                           Matrix4x4Ptr                         modelToWorld)
+{
+    if (vertexSize < positionOffset + 3)
+        throw std::invalid_argument("vertexSize");
+
+    float modelToScreen[16];
+
+    if (modelToWorld)
+    {
+        const auto& m = modelToWorld->values();
+
+        for (uint i = 0; i < 4; ++i)
+            for (uint j = 0; j < 4; ++j)
+                modelToScreen[i * 4 + j] = _worldToScreen[i * 4] * m[j]
+                    + _worldToScreen[i * 4 + 1] * m[4 + j]
+                    + _worldToScreen[i * 4 + 2] * m[8 + j]
+                    + _worldToScreen[i * 4 + 3] * m[12 + j];
+    }
+    else
+        std::copy(_worldToScreen.begin(), _worldToScreen.end(), modelToScreen);
+
+    const uint numVertices = vertices.size() / vertexSize;
+
+    _screenVertices.resize(numVertices * 4);
+
+    for (uint i = 0; i < numVertices; ++i)
+    {
+        const float* position = &vertices[i * vertexSize + positionOffset];
+
+        transform(modelToScreen, position[0], position[1], position[2], &_screenVertices[i * 4]);
+    }
+
+    for (uint i = 0; i + 2 < indices.size(); i += 3)
+    {
+        if (indices[i] >= numVertices || indices[i + 1] >= numVertices || indices[i + 2] >= numVertices)
+            throw std::invalid_argument("indices");
+
+        const float* v0 = &_screenVertices[indices[i] * 4];
+        const float* v1 = &_screenVertices[indices[i + 1] * 4];
+        const float* v2 = &_screenVertices[indices[i + 2] * 4];
+
+        if (v0[3] >= MIN_W && v1[3] >= MIN_W && v2[3] >= MIN_W)
+            rasterizeTriangle(v0, v1, v2);
+    }
+}
+
+void
+OcclusionBuffer::rasterize(BoxPtr box)
+{
+    // corner i takes the top right coordinates for each of its x (1), y (2) and z (4) bits
+    static const unsigned short boxIndices[] = {
+        0, 2, 6, 0, 6, 4,   1, 3, 7, 1, 7, 5,
+        0, 1, 5, 0, 5, 4,   2, 3, 7, 2, 7, 6,
+        0, 1, 3, 0, 3, 2,   4, 5, 7, 4, 7, 6
+    };
+
+    float corners[32];
+
+    for (uint i = 0; i < 8; ++i)
+        transform(
+            &_worldToScreen[0],
+            (i & 1) ? box->topRight()->x() : box->bottomLeft()->x(),
+            (i & 2) ? box->topRight()->y() : box->bottomLeft()->y(),
+            (i & 4) ? box->topRight()->z() : box->bottomLeft()->z(),
+            corners + i * 4
+        );
+
+    for (uint i = 0; i < 36; i += 3)
+    {
+        const float* v0 = corners + boxIndices[i] * 4;
+        const float* v1 = corners + boxIndices[i + 1] * 4;
+        const float* v2 = corners + boxIndices[i + 2] * 4;
+
+        if (v0[3] >= MIN_W && v1[3] >= MIN_W && v2[3] >= MIN_W)
+            rasterizeTriangle(v0, v1, v2);
+    }
+}
+
+void
+OcclusionBuffer::rasterizeTriangle(const float* v0, const float* v1, const float* v2)
+{
+    float area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v1[1] - v0[1]) * (v2[0] - v0[0]);
+
+    if (std::abs(area) < 1e-6f)
+        return;
+
+    // occluders are not back face culled, both windings are made counter clockwise
+    if (area < 0.f)
+    {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    // pixels are covered when their center is inside the triangle
+    const int minX = std::max(0, (int)std::ceil(std::min(v0[0], std::min(v1[0], v2[0])) - .5f));
+    const int maxX = std::min((int)_width - 1, (int)std::floor(std::max(v0[0], std::max(v1[0], v2[0])) - .5f));
+    const int minY = std::max(0, (int)std::ceil(std::min(v0[1], std::min(v1[1], v2[1])) - .5f));
+    const int maxY = std::min((int)_height - 1, (int)std::floor(std::max(v0[1], std::max(v1[1], v2[1])) - .5f));
+
+    if (minX > maxX || minY > maxY)
+        return;
+
+    ++_numOccluderTriangles;
+    _invalidTiles = true;
+
+    // edge functions, each one is the (unnormalized) barycentric weight of the opposite vertex
+    const float dx0 = v1[1] - v2[1];
+    const float dy0 = v2[0] - v1[0];
+    const float dx1 = v2[1] - v0[1];
+    const float dy1 = v0[0] - v2[0];
+    const float dx2 = v0[1] - v1[1];
+    const float dy2 = v1[0] - v0[0];
+
+    const float invArea = 1.f / area;
+    const float dzdx    = (dx1 * (v1[2] - v0[2]) + dx2 * (v2[2] - v0[2])) * invArea;
+
+    const float startX  = minX + .5f;
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        const float py  = y + .5f;
+        const float e0  = (startX - v1[0]) * dx0 + (py - v1[1]) * dy0;
+        const float e1  = (startX - v2[0]) * dx1 + (py - v2[1]) * dy1;
+        const float e2  = (startX - v0[0]) * dx2 + (py - v0[1]) * dy2;
+        const float z   = v0[2] + (e1 * (v1[2] - v0[2]) + e2 * (v2[2] - v0[2])) * invArea;
+
+        float*      row         = &_depth[y * _width + minX];
+        const int   numPixels   = maxX - minX + 1;
+        int         i           = 0;
+
+#ifdef MINKO_OCCLUSION_BUFFER_SSE2
+        // 4 pixels at a time, computed exactly as the scalar loop below does
+        const __m128 zero       = _mm_setzero_ps();
+        const __m128 offsets    = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+
+        for (; i + 4 <= numPixels; i += 4)
+        {
+            const __m128 fi         = _mm_add_ps(_mm_set1_ps((float)i), offsets);
+            const __m128 depth      = _mm_add_ps(_mm_set1_ps(z), _mm_mul_ps(_mm_set1_ps(dzdx), fi));
+            const __m128 edge0      = _mm_add_ps(_mm_set1_ps(e0), _mm_mul_ps(_mm_set1_ps(dx0), fi));
+            const __m128 edge1      = _mm_add_ps(_mm_set1_ps(e1), _mm_mul_ps(_mm_set1_ps(dx1), fi));
+            const __m128 edge2      = _mm_add_ps(_mm_set1_ps(e2), _mm_mul_ps(_mm_set1_ps(dx2), fi));
+            const __m128 stored     = _mm_loadu_ps(row + i);
+            const __m128 write      = _mm_and_ps(
+                _mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)),
+                _mm_and_ps(_mm_cmpge_ps(edge2, zero), _mm_cmplt_ps(depth, stored))
+            );
+
+            _mm_storeu_ps(row + i, _mm_or_ps(_mm_and_ps(write, depth), _mm_andnot_ps(write, stored)));
+        }
+#endif
+
+        // the remaining pixels, or all of them without SSE2: the loop body is a single select
+        for (; i < numPixels; ++i)
+        {
+            const float fi      = (float)i;
+            const float depth   = z + dzdx * fi;
+            const float stored  = row[i];
+            const bool  write   = (e0 + dx0 * fi >= 0.f) & (e1 + dx1 * fi >= 0.f) & (e2 + dx2 * fi >= 0.f)
+                & (depth < stored);
+
+            row[i] = write ? depth : stored;
+        }
+    }
+}
+
+void
+OcclusionBuffer::updateTiles()
+{
+    for (uint tileY = 0; tileY < _numTilesY; ++tileY)
+        for (uint tileX = 0; tileX < _numTilesX; ++tileX)
+        {
+            float maxDepth = 0.f;
+
+            for (uint y = tileY * _tileSize; y < (tileY + 1) * _tileSize; ++y)
+            {
+                const float* row = &_depth[y * _width + tileX * _tileSize];
+
+                for (uint x = 0; x < _tileSize; ++x)
+                    maxDepth = std::max(maxDepth, row[x]);
+            }
+
+            _tileMaxDepth[tileX + tileY * _numTilesX] = maxDepth;
+        }
+
+    _invalidTiles = false;
+}
+
+bool
+OcclusionBuffer::occluded(BoxPtr box)
+{
+    if (_numOccluderTriangles == 0)
+        return false;
+
+    if (_invalidTiles)
+        updateTiles();
+
+    float minX      = std::numeric_limits<float>::max();
+    float maxX      = -std::numeric_limits<float>::max();
+    float minY      = std::numeric_limits<float>::max();
+    float maxY      = -std::numeric_limits<float>::max();
+    float minDepth  = std::numeric_limits<float>::max();
+
+    for (uint i = 0; i < 8; ++i)
+    {
+        float corner[4];
+
+        transform(
+            &_worldToScreen[0],
+            (i & 1) ? box->topRight()->x() : box->bottomLeft()->x(),
+            (i & 2) ? box->topRight()->y() : box->bottomLeft()->y(),
+            (i & 4) ? box->topRight()->z() : box->bottomLeft()->z(),
+            corner
+        );
+
+        // the box crosses the near plane
+        if (corner[3] < MIN_W)
+            return false;
+
+        minX = std::min(minX, corner[0]);
+        maxX = std::max(maxX, corner[0]);
+        minY = std::min(minY, corner[1]);
+        maxY = std::max(maxY, corner[1]);
+        minDepth = std::min(minDepth, corner[2]);
+    }
+
+    if (maxX < 0.f || maxY < 0.f || minX >= _width || minY >= _height)
+        return false;
+
+    // every pixel the screen space rectangle of the box touches
+    const uint x0 = (uint)std::max(0, (int)std::floor(minX));
+    const uint x1 = (uint)std::min((int)_width - 1, (int)std::floor(maxX));
+    const uint y0 = (uint)std::max(0, (int)std::floor(minY));
+    const uint y1 = (uint)std::min((int)_height - 1, (int)std::floor(maxY));
+
+    for (uint tileY = y0 / _tileSize; tileY <= y1 / _tileSize; ++tileY)
+        for (uint tileX = x0 / _tileSize; tileX <= x1 / _tileSize; ++tileX)
+        {
+            if (_tileMaxDepth[tileX + tileY * _numTilesX] < minDepth)
+                continue;
+
+            const uint fromX    = std::max(x0, tileX * _tileSize);
+            const uint toX      = std::min(x1, (tileX + 1) * _tileSize - 1);
+            const uint fromY    = std::max(y0, tileY * _tileSize);
+            const uint toY      = std::min(y1, (tileY + 1) * _tileSize - 1);
+
+            for (uint y = fromY; y <= toY; ++y)
+                for (uint x = fromX; x <= toX; ++x)
+                    if (_depth[x + y * _width] >= minDepth)
+                        return false;
+        }
+
+    return true;
+}
@@ -0,0 +1,453 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/render/CommandBuffer.hpp"
+
+#include "minko/render/AbstractContext.hpp"
+#include "minko/render/AbstractTexture.hpp"
+#include "minko/render/CompareMode.hpp"
+#include "minko/render/StencilOperation.hpp"
+#include "minko/render/TriangleCulling.hpp"
+#include "minko/render/WrapMode.hpp"
+#include "minko/render/TextureFilter.hpp"
+#include "minko/render/MipFilter.hpp"
+#include "minko/math/Vector2.hpp"
+#include "minko/math/Vector3.hpp"
+#include "minko/math/Vector4.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+void
+CommandBuffer::append(const CommandBuffer& buffer, uint begin, uint end)
+{
+    _commands.insert(_commands.end(), buffer._commands.begin() + begin, buffer._commands.begin() + end);
+}
+
+void
+CommandBuffer::execute(const AbsContextPtr& context, uint begin, uint end) const
+{
+    for (auto i = begin; i < end; ++i)
+    {
+        const auto& command = _commands[i];
+        const auto& args    = command.args;
+
+        switch (command.operation)
+        {
+        case Operation::SET_TARGET:
+            if (static_cast<uint>(command.target->id()) != context->renderTarget())
+            {
+                context->setRenderToTexture(command.target->id(), true);
+                context->clear();
+            }
+            break;
+        case Operation::SET_RENDER_TO_TEXTURE:
+            context->setRenderToTexture(args[0], true);
+            break;
+        case Operation::SET_RENDER_TO_BACK_BUFFER:
+            context->setRenderToBackBuffer();
+            break;
+        case Operation::CONFIGURE_VIEWPORT:
+            context->configureViewport(args[0], args[1], args[2], args[3]);
+            break;
+        case Operation::SET_PROGRAM:
+            context->setProgram(args[0]);
+            break;
+        case Operation::SET_UNIFORM:
+            setUniform(context, *command.uniform);
+            break;
+        case Operation::SET_SHARED_UNIFORMS:
+            setSharedUniforms(context, *command.sharedUniforms);
+            break;
+        case Operation::SET_TEXTURE_AT:
+            context->setTextureAt(args[0], args[1], args[2]);
+            break;
+        case Operation::SET_SAMPLER_STATE_AT:
+            context->setSamplerStateAt(
+                args[0],
+                static_cast<WrapMode>(args[1]),
+                static_cast<TextureFilter>(args[2]),
+                static_cast<MipFilter>(args[3])
+            );
+            break;
+        case Operation::SET_VERTEX_BUFFER_AT:
+            context->setVertexBufferAt(args[0], args[1], args[2], args[3], args[4], args[5]);
+            break;
+        case Operation::SET_VERTEX_ARRAY:
+            context->setVertexArray(args[0]);
+            break;
+        case Operation::SET_COLOR_MASK:
+            context->setColorMask(args[0] != 0);
+            break;
+        case Operation::SET_BLEND_MODE:
+            context->setBlendMode(static_cast<Blending::Mode>(args[0]));
+            break;
+        case Operation::SET_DEPTH_TEST:
+            context->setDepthTest(args[0] != 0, static_cast<CompareMode>(args[1]));
+            break;
+        case Operation::SET_STENCIL_TEST:
+            context->setStencilTest(
+                static_cast<CompareMode>(args[0]),
+                args[1],
+                args[2],
+                static_cast<StencilOperation>(args[3]),
+                static_cast<StencilOperation>(args[4]),
+                static_cast<StencilOperation>(args[5])
+            );
+            break;
+        case Operation::SET_SCISSOR_TEST:
+            {
+                ScissorBox scissorBox;
+
+                scissorBox.x        = args[1];
+                scissorBox.y        = args[2];
+                scissorBox.width    = args[3];
+                scissorBox.height   = args[4];
+
+                context->setScissorTest(args[0] != 0, scissorBox);
+                break;
+            }
+        case Operation::SET_TRIANGLE_CULLING:
+            context->setTriangleCulling(static_cast<TriangleCulling>(args[0]));
+            break;
+        case Operation::DRAW_TRIANGLES:
+            context->drawTriangles(args[0], args[1]);
+            break;
+        case Operation::DRAW_INSTANCED_TRIANGLES:
+            context->drawInstancedTriangles(args[0], args[1], args[2]);
+            break;
+        }
+    }
+}
+
+void
+CommandBuffer::setTarget(AbstractTexture* target)
+{
+    push(Operation::SET_TARGET).target = target;
+}
+
+void
+CommandBuffer::setRenderToTexture(uint texture)
+{
+    push(Operation::SET_RENDER_TO_TEXTURE).args[0] = texture;
+}
+
+void
+CommandBuffer::setRenderToBackBuffer()
+{
+    push(Operation::SET_RENDER_TO_BACK_BUFFER);
+}
+
+void
+CommandBuffer::configureViewport(int x, int y, int width, int height)
+{
+    auto& args = push(Operation::CONFIGURE_VIEWPORT).args;
+
+    args[0] = x;
+    args[1] = y;
+    args[2] = width;
+    args[3] = height;
+}
+
+void
+CommandBuffer::setProgram(uint program)
+{
+    push(Operation::SET_PROGRAM).args[0] = program;
+}
+
+void
+CommandBuffer::setUniform(const UniformValue* uniform)
+{
+    push(Operation::SET_UNIFORM).uniform = uniform;
+}
+
+void
+CommandBuffer::setSharedUniforms(const SharedUniforms* sharedUniforms)
+{
+    push(Operation::SET_SHARED_UNIFORMS).sharedUniforms = sharedUniforms;
+}
+
+void
+CommandBuffer::setTextureAt(uint position, int texture, int location)
+{
+    auto& args = push(Operation::SET_TEXTURE_AT).args;
+
+    args[0] = position;
+    args[1] = texture;
+    args[2] = location;
+}
+
+void
+CommandBuffer::setSamplerStateAt(uint           position,
+                                 WrapMode       wrapping,
+                                 TextureFilter  filtering,
+                                 MipFilter      mipFiltering)
+{
+    auto& args = push(Operation::SET_SAMPLER_STATE_AT).args;
+
+    args[0] = position;
+    args[1] = static_cast<int>(wrapping);
+    args[2] = static_cast<int>(filtering);
+    args[3] = static_cast<int>(mipFiltering);
+}
+
+void
+CommandBuffer::setVertexBufferAt(uint position, uint vertexBuffer, uint size, uint stride, uint offset, uint divisor)
+{
+    auto& args = push(Operation::SET_VERTEX_BUFFER_AT).args;
+
+    args[0] = position;
+    args[1] = vertexBuffer;
+    args[2] = size;
+    args[3] = stride;
+    args[4] = offset;
+    args[5] = divisor;
+}
+
+void
+CommandBuffer::setVertexArray(uint vertexArray)
+{
+    push(Operation::SET_VERTEX_ARRAY).args[0] = vertexArray;
+}
+
+void
+CommandBuffer::setColorMask(bool colorMask)
+{
+    push(Operation::SET_COLOR_MASK).args[0] = colorMask;
+}
+
+void
+CommandBuffer::setBlendMode(Blending::Mode blendMode)
+{
+    push(Operation::SET_BLEND_MODE).args[0] = static_cast<int>(blendMode);
+}
+
+void
+CommandBuffer::setDepthTest(bool depthMask, CompareMode depthFunc)
+{
+    auto& args = push(Operation::SET_DEPTH_TEST).args;
+
+    args[0] = depthMask;
+    args[1] = static_cast<int>(depthFunc);
+}
+
+void
+CommandBuffer::setStencilTest(CompareMode       stencilFunc,
+                              int               stencilRef,
+                              uint              stencilMask,
+                              StencilOperation  stencilFailOp,
+                              StencilOperation  stencilZFailOp,
+                              StencilOperation  stencilZPassOp)
+{
+    auto& args = push(Operation::SET_STENCIL_TEST).args;
+
+    args[0] = static_cast<int>(stencilFunc);
+    args[1] = stencilRef;
+    args[2] = stencilMask;
+    args[3] = static_cast<int>(stencilFailOp);
+    args[4] = static_cast<int>(stencilZFailOp);
+    args[5] = static_cast<int>(stencilZPassOp);
+}
+
+void
+CommandBuffer::setScissorTest(bool scissorTest, const ScissorBox& scissorBox)
+{
+    auto& args = push(Operation::SET_SCISSOR_TEST).args;
+
+    args[0] = scissorTest;
+    args[1] = scissorBox.x;
+    args[2] = scissorBox.y;
+    args[3] = scissorBox.width;
+    args[4] = scissorBox.height;
+}
+
+void
+CommandBuffer::setTriangleCulling(TriangleCulling triangleCulling)
+{
+    push(Operation::SET_TRIANGLE_CULLING).args[0] = static_cast<int>(triangleCulling);
+}
+
+void
+CommandBuffer::drawTriangles(uint indexBuffer, int numTriangles)
+{
+    auto& args = push(Operation::DRAW_TRIANGLES).args;
+
+    args[0] = indexBuffer;
+    args[1] = numTriangles;
+}
+
+void
+CommandBuffer::drawInstancedTriangles(uint indexBuffer, int numTriangles, int numInstances)
+{
+    auto& args = push(Operation::DRAW_INSTANCED_TRIANGLES).args;
+
+    args[0] = indexBuffer;
+    args[1] = numTriangles;
+    args[2] = numInstances;
+}
+
+/*static*/
+void
+CommandBuffer::setUniform(const AbsContextPtr& context, const UniformValue& uniform, int location)
+{
+    switch (uniform.type)
+    {
+    // float uniforms
+    case UniformType::FLOAT1:
+        context->setUniform(location, uniform.floatValue);
+        break;
+    case UniformType::FLOAT2:
+        context->setUniform(location, uniform.vector2->x(), uniform.vector2->y());
+        break;
+    case UniformType::FLOAT3:
+        context->setUniform(location, uniform.vector3->x(), uniform.vector3->y(), uniform.vector3->z());
+        break;
+    case UniformType::FLOAT4:
+        context->setUniform(location, uniform.vector4->x(), uniform.vector4->y(), uniform.vector4->z(), uniform.vector4->w());
+        break;
+    case UniformType::FLOAT16:
+        context->setUniform(location, 1, true, uniform.matrix);
+        break;
+
+    // integer uniforms
+    case UniformType::INT1:
+        context->setUniform(location, uniform.intValues[0]);
+        break;
+    case UniformType::INT2:
+        context->setUniform(location, uniform.intValues[0], uniform.intValues[1]);
+        break;
+    case UniformType::INT3:
+        context->setUniform(location, uniform.intValues[0], uniform.intValues[1], uniform.intValues[2]);
+        break;
+    case UniformType::INT4:
+        context->setUniform(location, uniform.intValues[0], uniform.intValues[1], uniform.intValues[2], uniform.intValues[3]);
+        break;
+
+    // arrays of float uniforms
+    case UniformType::FLOATS1:
+        context->setUniforms    (location,    uniform.floatArray->first,            uniform.floatArray->second);
+        break;
+    case UniformType::FLOATS2:
+        context->setUniforms2    (location,    uniform.floatArray->first,            uniform.floatArray->second);
+        break;
+    case UniformType::FLOATS3:
+        context->setUniforms3    (location,    uniform.floatArray->first,            uniform.floatArray->second);
+        break;
+    case UniformType::FLOATS4:
+        context->setUniforms4    (location,    uniform.floatArray->first,            uniform.floatArray->second);
+        break;
+    case UniformType::FLOATS16:
+        context->setUniform        (location,    uniform.floatArray->first, false,    uniform.floatArray->second);
+        break;
+
+    // arrays of integer uniforms
+    case UniformType::INTS1:
+        context->setUniforms    (location,    uniform.intArray->first,            uniform.intArray->second);
+        break;
+    case UniformType::INTS2:
+        context->setUniforms2    (location,    uniform.intArray->first,            uniform.intArray->second);
+        break;
+    case UniformType::INTS3:
+        context->setUniforms3    (location,    uniform.intArray->first,            uniform.intArray->second);
+        break;
+    case UniformType::INTS4:
+        context->setUniforms4    (location,    uniform.intArray->first,            uniform.intArray->second);
+        break;
+    }
+}
+
+/*static*/
+void
+CommandBuffer::setSharedUniforms(const AbsContextPtr& context, const SharedUniforms& sharedUniforms)
+{
+    const auto& uniforms    = sharedUniforms.uniforms;
+    auto        block       = sharedUniforms.block.get();
+
+    // values are referenced by pointer and do not change during a frame: comparing the pointers is enough
+    if (block != nullptr && block->uniforms != nullptr && block->uniforms->size() == uniforms.size())
+    {
+        auto same = true;
+
+        for (uint i = 0; i < uniforms.size() && same; ++i)
+            same = sameUniformValue((*block->uniforms)[i], uniforms[i]);
+
+        if (same)
+            return;
+    }
+
+    for (const auto& uniform : uniforms)
+        setUniform(context, uniform);
+
+    if (block != nullptr)
+        block->uniforms = &uniforms;
+}
+
+/*static*/
+CommandBuffer::UniformValue&
+CommandBuffer::uniformValue(std::vector<UniformValue>& uniforms, std::vector<int>& slots, int location)
+{
+    if (location >= static_cast<int>(slots.size()))
+        slots.resize(location + 1, -1);
+
+    auto& slot = slots[location];
+
+    if (slot < 0)
+    {
+        slot = uniforms.size();
+        uniforms.push_back(UniformValue());
+        uniforms.back().location = location;
+    }
+
+    return uniforms[slot];
+}
+
+/*static*/
+bool
+CommandBuffer::sameUniformValue(const UniformValue& a, const UniformValue& b)
+{
+    if (a.type != b.type || a.location != b.location)
+        return false;
+
+    switch (a.type)
+    {
+    case UniformType::FLOAT1:
+        return a.floatValue == b.floatValue;
+    case UniformType::FLOAT2:
+        return a.vector2 == b.vector2;
+    case UniformType::FLOAT3:
+        return a.vector3 == b.vector3;
+    case UniformType::FLOAT4:
+        return a.vector4 == b.vector4;
+    case UniformType::FLOAT16:
+        return a.matrix == b.matrix;
+    case UniformType::INT1:
+    case UniformType::INT2:
+    case UniformType::INT3:
+    case UniformType::INT4:
+        return std::equal(a.intValues, a.intValues + 4, b.intValues);
+    case UniformType::FLOATS1:
+    case UniformType::FLOATS2:
+    case UniformType::FLOATS3:
+    case UniformType::FLOATS4:
+    case UniformType::FLOATS16:
+        return a.floatArray == b.floatArray;
+    default:
+        return a.intArray == b.intArray;
+    }
+}
@@ -50,35 +50,49 @@ using namespace minko::render;
 SamplerState DrawCall::_defaultSamplerState = SamplerState(WrapMode::CLAMP, TextureFilter::NEAREST, MipFilter::NONE);
 /*static*/ const unsigned int    DrawCall::MAX_NUM_TEXTURES        = 8;
 /*static*/ const unsigned int    DrawCall::MAX_NUM_VERTEXBUFFERS    = 8;
+/*static*/ const float            DrawCall::SORT_KEY_PRIORITY_OFFSET    = 16384.f;
+/*static*/ const float            DrawCall::SORT_KEY_PRIORITY_SCALE     = 16.f;
 
 
 DrawCall::DrawCall(Pass::Ptr pass) :
     _pass(pass),
-    _program(nullptr),
     _targetData(nullptr),
     _rendererData(nullptr),
     _rootData(nullptr),
-    _fullRootData(nullptr),
-    _fullRendererData(nullptr),
     _fullTargetData(nullptr),
+    _fullRendererData(nullptr),
+    _fullRootData(nullptr),
+    _program(nullptr),
+    _depthProgram(nullptr),
+    _depthProgramResolved(false),
     _formatFunction(nullptr),
-    _textureIds(MAX_NUM_TEXTURES, 0),
-    _textureLocations(MAX_NUM_TEXTURES, -1),
-    _textureWrapMode(MAX_NUM_TEXTURES, WrapMode::CLAMP),
-    _textureFilters(MAX_NUM_TEXTURES, TextureFilter::NEAREST),
-    _textureMipFilters(MAX_NUM_TEXTURES, MipFilter::NONE),
     _vertexBufferIds(MAX_NUM_VERTEXBUFFERS, 0),
     _vertexBufferLocations(MAX_NUM_VERTEXBUFFERS, -1),
     _vertexSizes(MAX_NUM_VERTEXBUFFERS, -1),
     _vertexAttributeSizes(MAX_NUM_VERTEXBUFFERS, -1),
     _vertexAttributeOffsets(MAX_NUM_VERTEXBUFFERS, -1),
+    _vertexAttributeDivisors(MAX_NUM_VERTEXBUFFERS, 0),
+    _textureIds(MAX_NUM_TEXTURES, 0),
+    _textureLocations(MAX_NUM_TEXTURES, -1),
+    _textureWrapMode(MAX_NUM_TEXTURES, WrapMode::CLAMP),
+    _textureFilters(MAX_NUM_TEXTURES, TextureFilter::NEAREST),
+    _textureMipFilters(MAX_NUM_TEXTURES, MipFilter::NONE),
+    _instanceBuffer(nullptr),
+    _numInstances(0),
+    _vertexArray(0),
+    _vertexArrayContext(nullptr),
+    _vertexArrayInvalid(true),
     _target(nullptr),
+    _layouts(scene::Layout::Group::DEFAULT),
+    _revision(0),
     _referenceChangedSlots(),
-    _macroChangedSlots(),
     _macroAddedOrRemovedSlots(),
+    _macroChangedSlots(),
     _indicesChangedSlot(nullptr),
     _layoutsPropertyChangedSlot(nullptr),
     _zsortNeeded(Signal<Ptr>::create()),
+    _layoutsChanged(Signal<Ptr>::create()),
+    _zSortedChanged(Signal<Ptr>::create()),
     _macroChanged(Signal<Ptr, ContainerPtr, const std::string&>::create()),
     _containerMacroPNames(),
     _containerMacroRegex(),
@@ -106,6 +120,8 @@ DrawCall::configure(Program::Ptr                program,
                     Container::Ptr                rootData)
 {
     _program            = program;
+    _depthProgram        = nullptr;
+    _depthProgramResolved = false;
 
     _formatFunction        = formatNameFunc;
 
@@ -170,13 +186,30 @@ DrawCall::bindProgramDefaultUniforms()
         return;
 
     for (auto& uniform : _program->uniformFloat())
-        _uniformFloat[uniform.first] = uniform.second;
+        setUniformValue(_uniforms, uniform.first, UniformType::FLOAT1).floatValue = uniform.second;
     for (auto& uniform : _program->uniformFloat2())
-        _uniformFloat2[uniform.first] = uniform.second;
+        setUniformValue(_uniforms, uniform.first, UniformType::FLOAT2, uniform.second).vector2 = uniform.second.get();
     for (auto& uniform : _program->uniformFloat3())
-        _uniformFloat3[uniform.first] = uniform.second;
+        setUniformValue(_uniforms, uniform.first, UniformType::FLOAT3, uniform.second).vector3 = uniform.second.get();
     for (auto& uniform : _program->uniformFloat4())
-        _uniformFloat4[uniform.first] = uniform.second;
+        setUniformValue(_uniforms, uniform.first, UniformType::FLOAT4, uniform.second).vector4 = uniform.second.get();
+}
+
+DrawCall::UniformValue&
+DrawCall::setUniformValue(std::vector<UniformValue>&    uniforms,
+                          int                           location,
+                          UniformType                   type,
+                          std::shared_ptr<void>         owner)
+{
+    auto& slots     = &uniforms == &_sharedUniforms.uniforms ? _sharedUniformSlots : _uniformSlots;
+    auto& uniform   = CommandBuffer::uniformValue(uniforms, slots, location);
+
+    uniform.type    = type;
+    uniform.owner   = std::move(owner);
+
+    ++_revision;
+
+    return uniform;
 }
 
 void
@@ -214,9 +247,12 @@ DrawCall::bindIndexBuffer()
                 _indexBuffer = indices->id();
                 _numIndices = indices->numIndices();
             }
+            ++_revision;
         });
     }
 
+    ++_revision;
+
     if (_referenceChangedSlots.count(propertyName) == 0)
     {
         _referenceChangedSlots[propertyName].push_back(
@@ -232,6 +268,7 @@ void
 DrawCall::bindTargetLayouts()
 {
     const std::string propertyName = _formatFunction("node.layouts");
+    const auto        previousLayouts = _layouts;
 
     _layouts = scene::Layout::Group::DEFAULT;
 
@@ -239,6 +276,9 @@ DrawCall::bindTargetLayouts()
     if (_targetData->hasProperty(propertyName))
         _layouts = _targetData->get<Layouts>(propertyName);
 
+    if (_layouts != previousLayouts)
+        _layoutsChanged->execute(shared_from_this());
+
     if (_referenceChangedSlots.count(propertyName) == 0)
     {
         _referenceChangedSlots[propertyName].push_back(
@@ -315,6 +355,22 @@ DrawCall::bindVertexAttribute(const std::string&    inputName,
         throw std::invalid_argument("vertexBufferIndex");
 #endif // DEBUG
 
+    if (_instanceBuffer && _instanceBuffer->hasAttribute(inputName))
+    {
+        auto attribute = _instanceBuffer->attribute(inputName);
+
+        _vertexBufferIds[vertexBufferIndex] = _instanceBuffer->id();
+        _vertexBufferLocations[vertexBufferIndex] = location;
+        _vertexAttributeSizes[vertexBufferIndex] = std::get<1>(*attribute);
+        _vertexSizes[vertexBufferIndex] = _instanceBuffer->vertexSize();
+        _vertexAttributeOffsets[vertexBufferIndex] = std::get<2>(*attribute);
+        _vertexAttributeDivisors[vertexBufferIndex] = 1;
+        _vertexArrayInvalid = true;
+        ++_revision;
+
+        return;
+    }
+
     const auto& attributeBindings    = _pass->attributeBindings();
     auto        index                = vertexBufferIndex;
 
@@ -341,6 +397,8 @@ DrawCall::bindVertexAttribute(const std::string&    inputName,
             _vertexAttributeSizes[vertexBufferIndex] = std::get<1>(*attribute);
             _vertexSizes[vertexBufferIndex] = vertexBuffer->vertexSize();
             _vertexAttributeOffsets[vertexBufferIndex] = std::get<2>(*attribute);
+            _vertexArrayInvalid = true;
+            ++_revision;
         }
 
 
@@ -389,6 +447,7 @@ DrawCall::bindTextureSampler(const std::string&        inputName,
             _textureWrapMode    [textureIndex] = std::get<0>(samplerState);
             _textureFilters        [textureIndex] = std::get<1>(samplerState);
             _textureMipFilters    [textureIndex] = std::get<2>(samplerState);
+            ++_revision;
         }
 
         if (_referenceChangedSlots.count(propertyName) == 0)
@@ -433,34 +492,79 @@ DrawCall::bindUniform(const std::string&    inputName,
         std::string    propertyName    = _formatFunction(std::get<0>(uniformBindings.at(bindingName)));
         auto        source            = std::get<1>(uniformBindings.at(bindingName));
         const auto& container        = getContainer(ContainerId::FILTERED, source);
+        // renderer and root properties are the same for every draw call unless they depend on the target
+        auto&       uniforms        = source != data::BindingSource::TARGET
+            && std::get<0>(uniformBindings.at(bindingName)).find("${") == std::string::npos
+            ? _sharedUniforms.uniforms
+            : _uniforms;
 
         if (container)
         {
             if (isArray)
                 propertyName += inputName.substr(pos); // way to handle array of GLSL structs
 
-            if (container->hasProperty(propertyName))
+            // interned once so that the typed lookups below compare atoms
+            const data::PropertyName boundPropertyName = propertyName;
+
+            if (container->hasProperty(boundPropertyName))
             {
                 // This case corresponds to base types uniforms or individual members of an GLSL struct array.
 
                 if (type == ProgramInputs::Type::float1)
-                    _uniformFloat[location]        = container->get<float>(propertyName);
+                    setUniformValue(uniforms, location, UniformType::FLOAT1).floatValue = container->get<float>(boundPropertyName);
                 else if (type == ProgramInputs::Type::float2)
-                    _uniformFloat2[location]    = container->get<Vector2::Ptr>(propertyName);
+                {
+                    auto vector2 = container->get<Vector2::Ptr>(boundPropertyName);
+
+                    setUniformValue(uniforms, location, UniformType::FLOAT2, vector2).vector2 = vector2.get();
+                }
                 else if (type == ProgramInputs::Type::float3)
-                    _uniformFloat3[location]    = container->get<Vector3::Ptr>(propertyName);
+                {
+                    auto vector3 = container->get<Vector3::Ptr>(boundPropertyName);
+
+                    setUniformValue(uniforms, location, UniformType::FLOAT3, vector3).vector3 = vector3.get();
+                }
                 else if (type == ProgramInputs::Type::float4)
-                    _uniformFloat4[location]    = container->get<Vector4::Ptr>(propertyName);
+                {
+                    auto vector4 = container->get<Vector4::Ptr>(boundPropertyName);
+
+                    setUniformValue(uniforms, location, UniformType::FLOAT4, vector4).vector4 = vector4.get();
+                }
                 else if (type == ProgramInputs::Type::float16)
-                    _uniformFloat16[location]    = &(container->get<Matrix4x4::Ptr>(propertyName)->data()[0]);
+                {
+                    auto matrix = container->get<Matrix4x4::Ptr>(boundPropertyName);
+
+                    setUniformValue(uniforms, location, UniformType::FLOAT16, matrix).matrix = &(matrix->data()[0]);
+                }
                 else if (type == ProgramInputs::Type::int1)
-                    _uniformInt[location]        = container->get<int>(propertyName);
+                    setUniformValue(uniforms, location, UniformType::INT1).intValues[0] = container->get<int>(boundPropertyName);
                 else if (type == ProgramInputs::Type::int2)
-                    _uniformInt2[location]        = container->get<Int2>(propertyName);
+                {
+                    const auto  int2    = container->get<Int2>(boundPropertyName);
+                    auto&       uniform = setUniformValue(uniforms, location, UniformType::INT2);
+
+                    uniform.intValues[0] = std::get<0>(int2);
+                    uniform.intValues[1] = std::get<1>(int2);
+                }
                 else if (type == ProgramInputs::Type::int3)
-                    _uniformInt3[location]        = container->get<Int3>(propertyName);
+                {
+                    const auto  int3    = container->get<Int3>(boundPropertyName);
+                    auto&       uniform = setUniformValue(uniforms, location, UniformType::INT3);
+
+                    uniform.intValues[0] = std::get<0>(int3);
+                    uniform.intValues[1] = std::get<1>(int3);
+                    uniform.intValues[2] = std::get<2>(int3);
+                }
                 else if (type == ProgramInputs::Type::int4)
-                    _uniformInt4[location]        = container->get<Int4>(propertyName);
+                {
+                    const auto  int4    = container->get<Int4>(boundPropertyName);
+                    auto&       uniform = setUniformValue(uniforms, location, UniformType::INT4);
+
+                    uniform.intValues[0] = std::get<0>(int4);
+                    uniform.intValues[1] = std::get<1>(int4);
+                    uniform.intValues[2] = std::get<2>(int4);
+                    uniform.intValues[3] = std::get<3>(int4);
+                }
                 else
                     throw std::logic_error("unsupported uniform type.");
             }
@@ -469,7 +573,7 @@ DrawCall::bindUniform(const std::string&    inputName,
                 // This case corresponds to continuous base type arrays that are stored in data providers as std::vector<float>.
                 propertyName = _formatFunction(std::get<0>(uniformBindings.at(bindingName)));
 
-                bindUniformArray(propertyName, container, type, location);
+                bindUniformArray(propertyName, container, type, location, uniforms);
             }
         }
 
@@ -486,7 +590,8 @@ void
 DrawCall::bindUniformArray(const std::string&    propertyName,
                            Container::Ptr        container,
                            ProgramInputs::Type    type,
-                           int                    location)
+                           int                    location,
+                           std::vector<UniformValue>&    uniforms)
 {
     if (!container || !container->hasProperty(propertyName))
         return;
@@ -495,61 +600,71 @@ DrawCall::bindUniformArray(const std::string&    propertyName,
         type == ProgramInputs::Type::int2 ||
         type == ProgramInputs::Type::int3 ||
         type == ProgramInputs::Type::int4)
-        bindIntegerUniformArray(propertyName, container, type, location);
+        bindIntegerUniformArray(propertyName, container, type, location, uniforms);
     else
-        bindFloatUniformArray(propertyName, container, type, location);
+        bindFloatUniformArray(propertyName, container, type, location, uniforms);
 }
 
 void
 DrawCall::bindFloatUniformArray(const std::string&    propertyName,
                                 Container::Ptr        container,
                                 ProgramInputs::Type    type,
-                                int                    location)
+                                int                    location,
+                                std::vector<UniformValue>&    uniforms)
 {
-    if (!container->propertyHasType<UniformArrayPtr<float>>(propertyName, true))
+    if (!container->propertyHasType<UniformArrayPtr<float>>(propertyName))
         return;
 
     const auto& uniformArray = container->get<UniformArrayPtr<float>>(propertyName);
     if (uniformArray->first == 0 || uniformArray->second == nullptr)
         return;
 
+    auto uniformType = UniformType::FLOATS1;
+
     if (type == ProgramInputs::Type::float1)
-        _uniformFloats[location] = uniformArray;
+        uniformType = UniformType::FLOATS1;
     else if (type == ProgramInputs::Type::float2)
-        _uniformFloats2[location] = uniformArray;
+        uniformType = UniformType::FLOATS2;
     else if (type == ProgramInputs::Type::float3)
-        _uniformFloats3[location] = uniformArray;
+        uniformType = UniformType::FLOATS3;
     else if (type == ProgramInputs::Type::float4)
-        _uniformFloats4[location] = uniformArray;
+        uniformType = UniformType::FLOATS4;
     else if (type == ProgramInputs::Type::float16)
-        _uniformFloats16[location] = uniformArray;
+        uniformType = UniformType::FLOATS16;
     else
         throw std::logic_error("unsupported uniform type.");
+
+    setUniformValue(uniforms, location, uniformType, uniformArray).floatArray = uniformArray.get();
 }
 
 void
 DrawCall::bindIntegerUniformArray(const std::string&    propertyName,
                                   Container::Ptr        container,
                                    ProgramInputs::Type    type,
-                                  int                    location)
+                                  int                    location,
+                                  std::vector<UniformValue>&    uniforms)
 {
-    if (!container->propertyHasType<UniformArrayPtr<int>>(propertyName, true))
+    if (!container->propertyHasType<UniformArrayPtr<int>>(propertyName))
         return;
 
     const auto& uniformArray = container->get<UniformArrayPtr<int>>(propertyName);
     if (uniformArray->first == 0 || uniformArray->second == nullptr)
         return;
 
+    auto uniformType = UniformType::INTS1;
+
     if (type == ProgramInputs::Type::int1)
-        _uniformInts[location] = uniformArray;
+        uniformType = UniformType::INTS1;
     else if (type == ProgramInputs::Type::int2)
-        _uniformInts2[location] = uniformArray;
+        uniformType = UniformType::INTS2;
     else if (type == ProgramInputs::Type::int3)
-        _uniformInts3[location] = uniformArray;
+        uniformType = UniformType::INTS3;
     else if (type == ProgramInputs::Type::int4)
-        _uniformInts4[location] = uniformArray;
+        uniformType = UniformType::INTS4;
     else
         throw std::logic_error("unsupported uniform type.");
+
+    setUniformValue(uniforms, location, uniformType, uniformArray).intArray = uniformArray.get();
 }
 
 void
@@ -567,27 +682,11 @@ DrawCall::reset()
 {
     _target = nullptr;
 
-    _uniformFloat.clear();
-    _uniformFloat2.clear();
-    _uniformFloat3.clear();
-    _uniformFloat4.clear();
-    _uniformFloat16.clear();
-
-    _uniformInt.clear();
-    _uniformInt2.clear();
-    _uniformInt3.clear();
-    _uniformInt4.clear();
-
-    _uniformFloats.clear();
-    _uniformFloats2.clear();
-    _uniformFloats3.clear();
-    _uniformFloats4.clear();
-    _uniformFloats16.clear();
-
-    _uniformInts.clear();
-    _uniformInts2.clear();
-    _uniformInts3.clear();
-    _uniformInts4.clear();
+    _uniforms.clear();
+    _sharedUniforms.uniforms.clear();
+    // the capacity is kept so that rebinding the same program does not allocate again
+    _uniformSlots.assign(_uniformSlots.size(), -1);
+    _sharedUniformSlots.assign(_sharedUniformSlots.size(), -1);
 
     _textureIds            .clear();
     _textureLocations    .clear();
@@ -606,12 +705,15 @@ DrawCall::reset()
     _vertexSizes            .clear();
     _vertexAttributeSizes    .clear();
     _vertexAttributeOffsets    .clear();
+    _vertexAttributeDivisors    .clear();
 
     _vertexBufferIds            .resize(MAX_NUM_VERTEXBUFFERS, 0);
     _vertexBufferLocations    .resize(MAX_NUM_VERTEXBUFFERS, -1);
     _vertexSizes            .resize(MAX_NUM_VERTEXBUFFERS, -1);
     _vertexAttributeSizes    .resize(MAX_NUM_VERTEXBUFFERS, -1);
     _vertexAttributeOffsets    .resize(MAX_NUM_VERTEXBUFFERS, -1);
+    _vertexAttributeDivisors    .resize(MAX_NUM_VERTEXBUFFERS, 0);
+    _vertexArrayInvalid = true;
 
     _indicesChangedSlot            = nullptr;
     _layoutsPropertyChangedSlot    = nullptr;
@@ -626,6 +728,8 @@ DrawCall::reset()
     _containerUpdateSlots.clear();
 
     _zSorter->clear();
+
+    ++_revision;
 }
 
 void
@@ -655,9 +759,9 @@ DrawCall::bindStates()
 }
 
 void
-DrawCall::render(const AbstractContext::Ptr&    context,
-                 AbstractTexture::Ptr           renderTarget,
-                 const render::ScissorBox&      viewport)
+DrawCall::bindRenderTarget(const AbstractContext::Ptr&    context,
+                           AbstractTexture::Ptr           renderTarget,
+                           const render::ScissorBox&      viewport)
 {
     if (_target)
     {
@@ -677,77 +781,164 @@ DrawCall::render(const AbstractContext::Ptr&    context,
         if (viewport.width >= 0 && viewport.height >= 0)
             context->configureViewport(viewport.x, viewport.y, viewport.width, viewport.height);
     }
+}
+
+bool
+DrawCall::depthPrePassCompatible() const
+{
+    // opaque draw calls writing the depth buffer only: the pre-pass would not write the same depths
+    // for blended, z-sorted or stencil tested draw calls
+    return _depthProgram
+        && !_target
+        && _colorMask
+        && _depthMask
+        && (_depthFunc == CompareMode::LESS || _depthFunc == CompareMode::LESS_EQUAL)
+        && _blendMode == Blending::Mode::DEFAULT
+        && (_stencilFunc == CompareMode::ALWAYS || _stencilFunc == CompareMode::UNSET)
+        && !zSorted();
+}
+
+void
+DrawCall::render(const AbstractContext::Ptr&    context,
+                 AbstractTexture::Ptr           renderTarget,
+                 const render::ScissorBox&      viewport,
+                 bool                           depthPrePass)
+{
+    bindRenderTarget(context, renderTarget, viewport);
 
     context->setProgram(_program->id());
 
-    // float uniforms
-    for (auto& uniformFloat : _uniformFloat)
-        context->setUniform(uniformFloat.first, uniformFloat.second);
-    for (auto& uniformFloat2 : _uniformFloat2)
-    {
-        auto& float2 = uniformFloat2.second;
+    for (const auto& uniform : _uniforms)
+        CommandBuffer::setUniform(context, uniform);
+    CommandBuffer::setSharedUniforms(context, _sharedUniforms);
 
-        context->setUniform(uniformFloat2.first, float2->x(), float2->y());
-    }
-    for (auto& uniformFloat3 : _uniformFloat3)
-    {
-        auto& float3 = uniformFloat3.second;
+    auto textureOffset = 0;
+    for (auto textureLocationAndPtr : _program->textures())
+        context->setTextureAt(
+            textureOffset++,
+            textureLocationAndPtr.second->id(),
+            textureLocationAndPtr.first
+        );
 
-        context->setUniform(uniformFloat3.first, float3->x(), float3->y(), float3->z());
-    }
-    for (auto& uniformFloat4 : _uniformFloat4)
+    for (uint i = 0; i < _textureIds.size() - textureOffset; ++i)
     {
-        auto& float4 = uniformFloat4.second;
+        auto textureId = _textureIds[i];
 
-        context->setUniform(uniformFloat4.first, float4->x(), float4->y(), float4->z(), float4->w());
+        context->setTextureAt(
+            textureOffset + i,
+            textureId,
+            _textureLocations[i]
+        );
+        if (textureId > 0)
+            context->setSamplerStateAt(
+                textureOffset + i,
+                _textureWrapMode[i],
+                _textureFilters[i],
+                _textureMipFilters[i]
+            );
     }
-    for (auto& uniformFloat16 : _uniformFloat16)
-        context->setUniform(uniformFloat16.first, 1, true, uniformFloat16.second);
 
-    // integer uniforms
-    for (auto& uniformInt : _uniformInt)
-        context->setUniform(uniformInt.first, uniformInt.second);
-    for (auto& uniformInt2 : _uniformInt2)
-    {
-        const auto& int2 = uniformInt2.second;
-        context->setUniform(uniformInt2.first, std::get<0>(int2), std::get<1>(int2));
-    }
-    for (auto& uniformInt3 : _uniformInt3)
+    if (updateVertexArray(context))
+        context->setVertexArray(_vertexArray);
+    else
     {
-        const auto& int3 = uniformInt3.second;
-        context->setUniform(uniformInt3.first, std::get<0>(int3), std::get<1>(int3), std::get<2>(int3));
+        if (context->supportsVertexArrays())
+            context->setVertexArray(0);
+
+        // first, hand over to the context bound vertex attributes
+        for (uint i = 0; i < _vertexBufferIds.size(); ++i)
+        {
+            auto vertexBufferId = _vertexBufferIds[i];
+
+            if (vertexBufferId > 0 &&
+                !_program->hasVertexBufferLocation(_vertexBufferLocations[i]))
+                context->setVertexBufferAt(
+                     _vertexBufferLocations[i],
+                     vertexBufferId,
+                     _vertexAttributeSizes[i],
+                     _vertexSizes[i],
+                     _vertexAttributeOffsets[i],
+                     _vertexAttributeDivisors[i]
+                );
+        }
+        // second, hand over explicitly user defined vertex attributes (possible replacement of )
+        for (auto vertexBufferLocationAndPtr : _program->vertexBuffers())
+        {
+            const int    location        = vertexBufferLocationAndPtr.first;
+            auto&        vertexBuffer    = vertexBufferLocationAndPtr.second;
+
+            if (vertexBuffer->isReady())
+            {
+                assert(vertexBuffer->attributes().size() == 1);
+
+                const auto& vertexAttribute = vertexBuffer->attributes().front();
+
+                context->setVertexBufferAt(
+                    location,
+                    vertexBuffer->id(),
+                    std::get<1>(*vertexAttribute),
+                    vertexBuffer->vertexSize(),
+                    std::get<2>(*vertexAttribute)
+                );
+            }
+        }
     }
-    for (auto& uniformInt4 : _uniformInt4)
+
+    context->setColorMask(_colorMask);
+    context->setBlendMode(_blendMode);
+    if (depthPrePass && depthPrePassCompatible())
+        context->setDepthTest(false, CompareMode::EQUAL);
+    else
+        context->setDepthTest(_depthMask, _depthFunc);
+    context->setStencilTest(_stencilFunc, _stencilRef, _stencilMask, _stencilFailOp, _stencilZFailOp, _stencilZPassOp);
+    context->setScissorTest(_scissorTest, _scissorBox);
+    context->setTriangleCulling(_triangleCulling);
+
+    const int  indexBuffer  = _program->indexBuffer() && _program->indexBuffer()->isReady()
+        ? _program->indexBuffer()->id()
+        : _indexBuffer;
+    const auto numIndices   = _program->indexBuffer() && _program->indexBuffer()->isReady()
+        ? _program->indexBuffer()->data().size()
+        : _numIndices;
+
+    if (indexBuffer == -1)
+        return;
+
+    if (_numInstances > 0)
+        context->drawInstancedTriangles(indexBuffer, numIndices / 3, _numInstances);
+    else
+        context->drawTriangles(indexBuffer, numIndices / 3);
+}
+
+void
+DrawCall::record(CommandBuffer&                 buffer,
+                 AbstractTexture::Ptr           renderTarget,
+                 const render::ScissorBox&      viewport,
+                 bool                           depthPrePass)
+{
+    if (_target)
+        buffer.setTarget(_target.get());
+    else
     {
-        const auto& int4 = uniformInt4.second;
-        context->setUniform(uniformInt4.first, std::get<0>(int4), std::get<1>(int4), std::get<2>(int4), std::get<3>(int4));
+        if (renderTarget)
+            buffer.setRenderToTexture(renderTarget->id());
+        else
+            buffer.setRenderToBackBuffer();
+
+        if (viewport.width >= 0 && viewport.height >= 0)
+            buffer.configureViewport(viewport.x, viewport.y, viewport.width, viewport.height);
     }
 
-    // arrays of float uniforms
-    for (auto& uniformFloats : _uniformFloats)
-        context->setUniforms    (uniformFloats.first,    uniformFloats.second->first,            uniformFloats.second->second);
-    for (auto& uniformFloats2 : _uniformFloats2)
-        context->setUniforms2    (uniformFloats2.first,    uniformFloats2.second->first,            uniformFloats2.second->second);
-    for (auto& uniformFloats3 : _uniformFloats3)
-        context->setUniforms3    (uniformFloats3.first,    uniformFloats3.second->first,            uniformFloats3.second->second);
-    for (auto& uniformFloats4 : _uniformFloats4)
-        context->setUniforms4    (uniformFloats4.first,    uniformFloats4.second->first,            uniformFloats4.second->second);
-    for (auto& uniformFloats16 : _uniformFloats16)
-        context->setUniform        (uniformFloats16.first,    uniformFloats16.second->first, false,    uniformFloats16.second->second);
-
-    // arrays of integer uniforms
-    for (auto& uniformInts: _uniformInts)
-        context->setUniforms    (uniformInts.first,        uniformInts.second->first,            uniformInts.second->second);
-    for (auto& uniformInts2 : _uniformInts2)
-        context->setUniforms2    (uniformInts2.first,    uniformInts2.second->first,            uniformInts2.second->second);
-    for (auto& uniformInts3 : _uniformInts3)
-        context->setUniforms3    (uniformInts3.first,    uniformInts3.second->first,            uniformInts3.second->second);
-    for (auto& uniformInts4 : _uniformInts4)
-        context->setUniforms4    (uniformInts4.first,    uniformInts4.second->first,            uniformInts4.second->second);
+    buffer.setProgram(_program->id());
+
+    for (const auto& uniform : _uniforms)
+        buffer.setUniform(&uniform);
+    buffer.setSharedUniforms(&_sharedUniforms);
 
+    // effect level textures and vertex buffers are captured as they are when recording
     auto textureOffset = 0;
     for (auto textureLocationAndPtr : _program->textures())
-        context->setTextureAt(
+        buffer.setTextureAt(
             textureOffset++,
             textureLocationAndPtr.second->id(),
             textureLocationAndPtr.first
@@ -757,13 +948,9 @@ DrawCall::render(const AbstractContext::Ptr&    context,
     {
         auto textureId = _textureIds[i];
 
-        context->setTextureAt(
-            textureOffset + i,
-            textureId,
-            _textureLocations[i]
-        );
+        buffer.setTextureAt(textureOffset + i, textureId, _textureLocations[i]);
         if (textureId > 0)
-            context->setSamplerStateAt(
+            buffer.setSamplerStateAt(
                 textureOffset + i,
                 _textureWrapMode[i],
                 _textureFilters[i],
@@ -771,56 +958,186 @@ DrawCall::render(const AbstractContext::Ptr&    context,
             );
     }
 
-    // first, hand over to the context bound vertex attributes
-    for (uint i = 0; i < _vertexBufferIds.size(); ++i)
+    // the vertex array is built right away so that the buffer only has to bind it
+    const auto& context = _program->context();
+
+    if (updateVertexArray(context))
+        buffer.setVertexArray(_vertexArray);
+    else
     {
-        auto vertexBufferId = _vertexBufferIds[i];
+        if (context->supportsVertexArrays())
+            buffer.setVertexArray(0);
 
-        if (vertexBufferId > 0 &&
-            !_program->hasVertexBufferLocation(_vertexBufferLocations[i]))
-            context->setVertexBufferAt(
-                 _vertexBufferLocations[i],
-                 vertexBufferId,
-                 _vertexAttributeSizes[i],
-                 _vertexSizes[i],
-                 _vertexAttributeOffsets[i]
-            );
+        for (uint i = 0; i < _vertexBufferIds.size(); ++i)
+        {
+            auto vertexBufferId = _vertexBufferIds[i];
+
+            if (vertexBufferId > 0 &&
+                !_program->hasVertexBufferLocation(_vertexBufferLocations[i]))
+                buffer.setVertexBufferAt(
+                     _vertexBufferLocations[i],
+                     vertexBufferId,
+                     _vertexAttributeSizes[i],
+                     _vertexSizes[i],
+                     _vertexAttributeOffsets[i],
+                     _vertexAttributeDivisors[i]
+                );
+        }
+        for (auto vertexBufferLocationAndPtr : _program->vertexBuffers())
+        {
+            auto& vertexBuffer = vertexBufferLocationAndPtr.second;
+
+            if (vertexBuffer->isReady())
+            {
+                const auto& vertexAttribute = vertexBuffer->attributes().front();
+
+                buffer.setVertexBufferAt(
+                    vertexBufferLocationAndPtr.first,
+                    vertexBuffer->id(),
+                    std::get<1>(*vertexAttribute),
+                    vertexBuffer->vertexSize(),
+                    std::get<2>(*vertexAttribute)
+                );
+            }
+        }
+    }
+
+    buffer.setColorMask(_colorMask);
+    buffer.setBlendMode(_blendMode);
+    if (depthPrePass && depthPrePassCompatible())
+        buffer.setDepthTest(false, CompareMode::EQUAL);
+    else
+        buffer.setDepthTest(_depthMask, _depthFunc);
+    buffer.setStencilTest(_stencilFunc, _stencilRef, _stencilMask, _stencilFailOp, _stencilZFailOp, _stencilZPassOp);
+    buffer.setScissorTest(_scissorTest, _scissorBox);
+    buffer.setTriangleCulling(_triangleCulling);
+
+    const int  indexBuffer  = _program->indexBuffer() && _program->indexBuffer()->isReady()
+        ? _program->indexBuffer()->id()
+        : _indexBuffer;
+    const auto numIndices   = _program->indexBuffer() && _program->indexBuffer()->isReady()
+        ? _program->indexBuffer()->data().size()
+        : _numIndices;
+
+    if (indexBuffer == -1)
+        return;
+
+    if (_numInstances > 0)
+        buffer.drawInstancedTriangles(indexBuffer, numIndices / 3, _numInstances);
+    else
+        buffer.drawTriangles(indexBuffer, numIndices / 3);
+}
+
+void
+DrawCall::renderDepth(const AbstractContext::Ptr&   context,
+                      AbstractTexture::Ptr          renderTarget,
+                      const render::ScissorBox&     viewport)
+{
+    if (!_depthProgram || static_cast<int>(_indexBuffer) == -1)
+        return;
+
+    bindRenderTarget(context, renderTarget, viewport);
+
+    context->setProgram(_depthProgram->program->id());
+
+    const auto& uniformLocations = _depthProgram->uniformLocations;
+
+    for (const auto& uniform : _uniforms)
+    {
+        auto locationIt = uniformLocations.find(uniform.location);
+
+        if (locationIt != uniformLocations.end())
+            CommandBuffer::setUniform(context, uniform, locationIt->second);
     }
-    // second, hand over explicitly user defined vertex attributes (possible replacement of )
-    for (auto vertexBufferLocationAndPtr : _program->vertexBuffers())
+    for (const auto& uniform : _sharedUniforms.uniforms)
     {
-        const int    location        = vertexBufferLocationAndPtr.first;
-        auto&        vertexBuffer    = vertexBufferLocationAndPtr.second;
+        auto locationIt = uniformLocations.find(uniform.location);
 
-        if (vertexBuffer->isReady())
-        {
-            assert(vertexBuffer->attributes().size() == 1);
+        if (locationIt != uniformLocations.end())
+            CommandBuffer::setUniform(context, uniform, locationIt->second);
+    }
+
+    // the vertex array of the draw call holds the attribute locations of its own program
+    if (context->supportsVertexArrays())
+        context->setVertexArray(0);
+
+    const auto& attributeLocations = _depthProgram->attributeLocations;
 
-            const auto& vertexAttribute = vertexBuffer->attributes().front();
+    for (uint i = 0; i < _vertexBufferIds.size(); ++i)
+    {
+        auto locationIt = attributeLocations.find(_vertexBufferLocations[i]);
 
+        if (_vertexBufferIds[i] > 0 && locationIt != attributeLocations.end())
             context->setVertexBufferAt(
-                location,
-                vertexBuffer->id(),
-                std::get<1>(*vertexAttribute),
-                vertexBuffer->vertexSize(),
-                std::get<2>(*vertexAttribute)
+                locationIt->second,
+                _vertexBufferIds[i],
+                _vertexAttributeSizes[i],
+                _vertexSizes[i],
+                _vertexAttributeOffsets[i],
+                _vertexAttributeDivisors[i]
             );
-        }
     }
 
-    context->setColorMask(_colorMask);
-    context->setBlendMode(_blendMode);
-    context->setDepthTest(_depthMask, _depthFunc);
-    context->setStencilTest(_stencilFunc, _stencilRef, _stencilMask, _stencilFailOp, _stencilZFailOp, _stencilZPassOp);
+    context->setColorMask(false);
+    context->setBlendMode(Blending::Mode::DEFAULT);
+    context->setDepthTest(true, _depthFunc);
+    context->setStencilTest(CompareMode::ALWAYS, 0, 0x1, StencilOperation::KEEP, StencilOperation::KEEP, StencilOperation::KEEP);
     context->setScissorTest(_scissorTest, _scissorBox);
     context->setTriangleCulling(_triangleCulling);
 
-    if (_program->indexBuffer() && _program->indexBuffer()->isReady())
-        context->drawTriangles(_program->indexBuffer()->id(), _program->indexBuffer()->data().size() / 3);
-    else if (_indexBuffer != -1)
+    if (_numInstances > 0)
+        context->drawInstancedTriangles(_indexBuffer, _numIndices / 3, _numInstances);
+    else
         context->drawTriangles(_indexBuffer, _numIndices / 3);
 }
 
+bool
+DrawCall::updateVertexArray(const AbstractContext::Ptr& context)
+{
+    // effect level vertex buffers can become ready at any time: they keep being bound one by one
+    if (!context->supportsVertexArrays() || !_program->vertexBuffers().empty())
+    {
+        deleteVertexArray();
+
+        return false;
+    }
+
+    if (_vertexArray != 0 && (_vertexArrayInvalid || context != _vertexArrayContext))
+        deleteVertexArray();
+
+    if (_vertexArray == 0)
+    {
+        _vertexArray = context->createVertexArray();
+        _vertexArrayContext = context;
+        _vertexArrayInvalid = false;
+
+        context->setVertexArray(_vertexArray);
+
+        for (uint i = 0; i < _vertexBufferIds.size(); ++i)
+            if (_vertexBufferIds[i] > 0)
+                context->setVertexBufferAt(
+                     _vertexBufferLocations[i],
+                     _vertexBufferIds[i],
+                     _vertexAttributeSizes[i],
+                     _vertexSizes[i],
+                     _vertexAttributeOffsets[i],
+                     _vertexAttributeDivisors[i]
+                );
+    }
+
+    return true;
+}
+
+void
+DrawCall::deleteVertexArray()
+{
+    if (_vertexArray != 0)
+        _vertexArrayContext->deleteVertexArray(_vertexArray);
+
+    _vertexArray = 0;
+    _vertexArrayContext = nullptr;
+}
+
 Container::Ptr
 DrawCall::getContainer(ContainerId id, data::BindingSource source) const
 {
@@ -840,6 +1157,57 @@ DrawCall::getEyeSpacePosition(Vector3::Ptr output)
     return _zSorter->getEyeSpacePosition(output);
 }
 
+uint64_t
+DrawCall::sortKey()
+{
+    // [63..44] priority, highest priority first
+    // [43]     z-sorted flag, z-sorted draw calls come after the others of the same priority
+    //
+    // z-sorted draw calls:
+    // [42..11] eye space depth, farthest first
+    //
+    // other draw calls:
+    // [42]     no render target flag, draw calls with a render target come first
+    // [41..26] render target id, highest id first
+    // [25..12] program id
+    // [11..0]  first texture id
+    auto priority = (int64_t)floorf((_priority + SORT_KEY_PRIORITY_OFFSET) * SORT_KEY_PRIORITY_SCALE + 0.5f);
+
+    priority = std::max<int64_t>(0, std::min<int64_t>(0xfffff, priority));
+
+    uint64_t key = uint64_t(0xfffff - priority) << 44;
+
+    if (zSorted())
+    {
+        static auto eyePosition = Vector3::create();
+
+        const float depth       = getEyeSpacePosition(eyePosition)->z();
+        uint        depthBits   = 0;
+
+        std::memcpy(&depthBits, &depth, sizeof(float));
+
+        // flip the IEEE 754 representation so that it sorts like an unsigned integer
+        depthBits = (depthBits & 0x80000000u) ? ~depthBits : (depthBits | 0x80000000u);
+
+        key |= uint64_t(1) << 43;
+        key |= uint64_t(~depthBits & 0xffffffffu) << 11;
+    }
+    else
+    {
+        if (_target)
+            key |= uint64_t(0xffff - (_target->id() & 0xffff)) << 26;
+        else
+            key |= uint64_t(1) << 42;
+
+        if (_program)
+            key |= uint64_t(_program->id() & 0x3fff) << 12;
+
+        key |= uint64_t(_textureIds[0] & 0xfff);
+    }
+
+    return key;
+}
+
 void
 DrawCall::trackMacros()
 {
@@ -23,12 +23,18 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/Surface.hpp"
 #include "minko/render/Effect.hpp"
 #include "minko/render/Program.hpp"
+#include "minko/render/Shader.hpp"
 #include "minko/data/Container.hpp"
+#include "minko/data/ContainerView.hpp"
 #include "minko/scene/Node.hpp"
 #include "minko/render/Blending.hpp"
 #include "minko/geometry/Geometry.hpp"
 #include "minko/data/ArrayProvider.hpp"
 #include "minko/material/Material.hpp"
+#include "minko/render/AbstractContext.hpp"
+#include "minko/render/VertexBuffer.hpp"
+#include "minko/render/GLSLPreprocessor.hpp"
+#include "minko/math/Matrix4x4.hpp"
 
 using namespace minko;
 using namespace minko::math;
@@ -37,6 +43,7 @@ using namespace minko::component;
 using namespace minko::data;
 
 /*static*/ const unsigned int                                    DrawCallPool::NUM_FALLBACK_ATTEMPTS        = 32;
+/*static*/ const unsigned int                                    DrawCallPool::MIN_NUM_INSTANCES            = 2;
 /*static*/ std::unordered_map<DrawCall::Ptr, Vector3::Ptr>        DrawCallPool::_cachedDrawcallPositions;
 
 std::unordered_map<std::string, std::pair<std::string, int>>    DrawCallPool::_variablePropertyNameToPosition;
@@ -51,12 +58,34 @@ DrawCallPool::DrawCallPool(Renderer::Ptr renderer):
     _drawcallToSurface(),
     _drawcallToMacroChangedSlot(),
     _drawcallToZSortNeededSlot(),
+    _drawcallToLayoutsChangedSlot(),
+    _drawcallToZSortedChangedSlot(),
+    _surfaceToContainerViews(),
+    _surfaceToContainerViewChangedSlots(),
     _drawCalls(),
     _dirtyDrawCalls(),
+    _mustSort(true),
     _mustZSort(true),
+    _revision(0),
+    _layoutMaskToDrawCalls(),
+    _sortKeysEnabled(true),
+    _sortKeys(),
+    _sortKeysBuffer(),
+    _sortedDrawCalls(),
+    _opaqueDrawCalls(),
+    _transparentDrawCalls(),
+    _transparentDepths(),
+    _instancingEnabled(false),
+    _mustUpdateInstanceGroups(false),
+    _leaderToInstanceGroup(),
+    _instancedDrawCalls(),
+    _programToUniformBlock(),
+    _programToDepthProgram(),
+    _depthFragmentShader(nullptr),
     _surfaceToTechniqueChangedSlot(),
     _surfaceToVisibilityChangedSlots(),
     _surfaceToIndexChangedSlots(),
+    _surfaceToTargetPropertySlots(),
     _surfaceBadMacroToTechniques(),
     _surfaceBadMacroToChangedSlot(),
     _rendererFilterChangedSlot(nullptr)
@@ -73,11 +102,19 @@ DrawCallPool::initialize()
     });
 }
 
+DrawCallPool::~DrawCallPool()
+{
+    for (auto& programAndDepthProgram : _programToDepthProgram)
+        if (programAndDepthProgram.second)
+            programAndDepthProgram.second->program->dispose();
+
+    if (_depthFragmentShader)
+        _depthFragmentShader->dispose();
+}
+
 const std::list<DrawCall::Ptr>&
 DrawCallPool::drawCalls()
 {
-    const bool doZSort = _mustZSort || !_toCollect.empty();
-
     for (auto& surface : _toRemove)
         cleanSurface(surface);
     _toRemove.clear();
@@ -86,26 +123,197 @@ DrawCallPool::drawCalls()
     _dirtyDrawCalls.clear();
 
     for (auto& d : dirtyDrawCalls)
+    {
+        auto program = d->program();
+
         refreshDrawCall(d);
 
+        // instance groups are made of draw calls sharing the same program
+        if (d->program() != program)
+            _mustUpdateInstanceGroups = true;
+    }
+
+    // refreshed draw calls might use another program now
+    if (!dirtyDrawCalls.empty())
+        _mustSort = true;
+
     for (auto& surface : _toCollect)
     {
         auto& newDrawCalls = generateDrawCall(surface, NUM_FALLBACK_ATTEMPTS);
 
         _drawCalls.insert(_drawCalls.end(), newDrawCalls.begin(), newDrawCalls.end());
+        _mustSort = true;
+        _mustUpdateInstanceGroups = true;
     }
     _toCollect.clear();
 
-    if (doZSort)
+    // removed draw calls have already set _mustSort and _mustUpdateInstanceGroups
+    const bool doSort       = _mustSort;
+    const bool doZSort      = _mustZSort;
+    const bool doRegroup    = _mustUpdateInstanceGroups && (_instancingEnabled || !_leaderToInstanceGroup.empty());
+
+    if (doSort || doZSort || doRegroup)
+        ++_revision;
+
+    // groups only depend on the draw calls, their program and their layouts: sorting alone does not
+    // change them
+    _mustUpdateInstanceGroups = false;
+    if (doRegroup)
+        updateInstanceGroups();
+    updateInstanceBuffers();
+
+    if (_sortKeysEnabled)
+    {
+        if (doSort)
+            sortDrawCallsByKey();
+        else if (doZSort)
+        {
+            sortTransparentDrawCalls();
+            mergeDrawCalls();
+        }
+    }
+    else if (doSort || doZSort)
     {
         _cachedDrawcallPositions.clear();
         _drawCalls.sort(&DrawCallPool::compareDrawCalls);
     }
+    _mustSort = false;
     _mustZSort = false;
 
     return _drawCalls;
 }
 
+DrawCallPool::SurfacePtr
+DrawCallPool::surface(DrawCallPtr drawCall) const
+{
+    const auto surfaceIt = _drawcallToSurface.find(drawCall);
+
+    return surfaceIt != _drawcallToSurface.end() ? surfaceIt->second : nullptr;
+}
+
+DrawCallPool::UniformBlockPtr
+DrawCallPool::uniformBlock(ProgramPtr program)
+{
+    auto& block = _programToUniformBlock[program];
+
+    if (block == nullptr)
+    {
+        block = std::make_shared<CommandBuffer::UniformBlock>();
+        block->uniforms = nullptr;
+    }
+
+    return block;
+}
+
+void
+DrawCallPool::invalidateUniformBlocks()
+{
+    for (auto& programAndBlock : _programToUniformBlock)
+        programAndBlock.second->uniforms = nullptr;
+}
+
+DrawCallPool::DepthProgramPtr
+DrawCallPool::depthProgram(ProgramPtr program)
+{
+    auto depthProgramIt = _programToDepthProgram.find(program);
+
+    if (depthProgramIt != _programToDepthProgram.end())
+        return depthProgramIt->second;
+
+    auto& depthProgram = _programToDepthProgram[program];
+
+    // effect level vertex and index buffers are bound with the locations of the program itself
+    if (!program->vertexBuffers().empty()
+        || program->indexBuffer()
+        || shaderMayDiscard(program->fragmentShader()->source()))
+        return nullptr;
+
+    if (!_depthFragmentShader)
+    {
+        _depthFragmentShader = Shader::create(
+            program->context(),
+            Shader::Type::FRAGMENT_SHADER,
+            "#ifdef GL_ES\n"
+            "precision mediump float;\n"
+            "#endif\n"
+            "void main(void)\n"
+            "{\n"
+            "    gl_FragColor = vec4(0.0);\n"
+            "}\n"
+        );
+        _depthFragmentShader->upload();
+    }
+
+    // a program linked from a cached binary did not compile its shaders
+    if (!program->vertexShader()->isReady())
+        program->vertexShader()->upload();
+
+    // both programs share the compiled vertex shader, but GLSL only guarantees identical depths across
+    // programs when gl_Position is declared invariant: vertex shaders used with the depth pre-pass should
+    // declare it, or the EQUAL depth test of the main pass may reject some fragments
+    auto depthOnlyProgram = Program::create(program->context(), program->vertexShader(), _depthFragmentShader);
+
+    depthOnlyProgram->upload();
+
+    const auto& inputs      = program->inputs();
+    const auto& depthInputs = depthOnlyProgram->inputs();
+    auto        result      = std::make_shared<DrawCall::DepthProgram>();
+
+    result->program = depthOnlyProgram;
+
+    for (uint i = 0; i < depthInputs->names().size(); ++i)
+    {
+        const auto& name = depthInputs->names()[i];
+        const auto  type = depthInputs->types()[i];
+
+        // textures sampled by the vertex shader are not bound by DrawCall::renderDepth()
+        if (type == ProgramInputs::Type::sampler2d || type == ProgramInputs::Type::samplerCube || !inputs->hasName(name))
+        {
+            depthOnlyProgram->dispose();
+
+            return nullptr;
+        }
+
+        if (type == ProgramInputs::Type::attribute)
+            result->attributeLocations[inputs->location(name)] = depthInputs->locations()[i];
+        else
+            result->uniformLocations[inputs->location(name)] = depthInputs->locations()[i];
+    }
+
+    depthProgram = result;
+
+    return depthProgram;
+}
+
+/*static*/
+bool
+DrawCallPool::shaderMayDiscard(const std::string& source)
+{
+    // the macros of the program are prepended to its source, only the code actually compiled counts
+    const auto tokens = GLSLPreprocessor::tokenize(GLSLPreprocessor::process(source));
+
+    return std::find(tokens.begin(), tokens.end(), "discard") != tokens.end();
+}
+
+const DrawCallPool::DrawCallView&
+DrawCallPool::drawCalls(Layouts layoutMask)
+{
+    const auto& drawCalls   = this->drawCalls();
+    auto&       bucket      = _layoutMaskToDrawCalls[layoutMask];
+
+    if (bucket.first != _revision)
+    {
+        bucket.first = _revision;
+        bucket.second.clear();
+
+        for (const auto& drawCall : drawCalls)
+            if ((drawCall->layouts() & layoutMask) != 0 && _instancedDrawCalls.count(drawCall) == 0)
+                bucket.second.push_back(drawCall.get());
+    }
+
+    return bucket.second;
+}
+
 /*static*/
 bool
 DrawCallPool::compareDrawCalls(DrawCall::Ptr a,
@@ -135,6 +343,374 @@ DrawCallPool::compareDrawCalls(DrawCall::Ptr a,
     }
 }
 
+void
+DrawCallPool::sortDrawCallsByKey()
+{
+    _opaqueDrawCalls.clear();
+    _transparentDrawCalls.clear();
+
+    // the previous order is kept so that the transparent queue remains almost sorted
+    for (const auto& drawCall : _drawCalls)
+        if (drawCall->zSorted())
+            _transparentDrawCalls.push_back(drawCall);
+        else
+            _opaqueDrawCalls.push_back(drawCall);
+
+    _sortKeys.clear();
+
+    for (uint i = 0; i < _opaqueDrawCalls.size(); ++i)
+        _sortKeys.push_back(SortKeyAndIndex(_opaqueDrawCalls[i]->sortKey(), i));
+
+    radixSort(_sortKeys, _sortKeysBuffer);
+
+    _sortedDrawCalls.clear();
+
+    for (const auto& keyAndIndex : _sortKeys)
+        _sortedDrawCalls.push_back(_opaqueDrawCalls[keyAndIndex.second]);
+
+    _opaqueDrawCalls.swap(_sortedDrawCalls);
+    _sortedDrawCalls.clear();
+
+    sortTransparentDrawCalls();
+    mergeDrawCalls();
+}
+
+void
+DrawCallPool::sortTransparentDrawCalls()
+{
+    static auto eyePosition = Vector3::create();
+
+    const uint numDrawCalls = _transparentDrawCalls.size();
+
+    _transparentDepths.resize(numDrawCalls);
+    for (uint i = 0; i < numDrawCalls; ++i)
+        _transparentDepths[i] = _transparentDrawCalls[i]->getEyeSpacePosition(eyePosition)->z();
+
+    // insertion sort: from one frame to the next, the queue is almost sorted already
+    for (uint i = 1; i < numDrawCalls; ++i)
+    {
+        auto        drawCall    = _transparentDrawCalls[i];
+        const auto  depth       = _transparentDepths[i];
+        const auto  priority    = drawCall->priority();
+        auto        j           = i;
+
+        for (; j > 0; --j)
+        {
+            const auto previousPriority     = _transparentDrawCalls[j - 1]->priority();
+            const bool arePrioritiesEqual   = fabsf(previousPriority - priority) < 1e-3f;
+
+            // highest priority first, then farthest first, with the same tolerance as compareDrawCalls()
+            if (arePrioritiesEqual ? _transparentDepths[j - 1] >= depth : previousPriority > priority)
+                break;
+
+            _transparentDrawCalls[j]    = _transparentDrawCalls[j - 1];
+            _transparentDepths[j]       = _transparentDepths[j - 1];
+        }
+
+        _transparentDrawCalls[j]    = drawCall;
+        _transparentDepths[j]       = depth;
+    }
+}
+
+void
+DrawCallPool::mergeDrawCalls()
+{
+    const uint  numOpaqueDrawCalls      = _opaqueDrawCalls.size();
+    const uint  numTransparentDrawCalls = _transparentDrawCalls.size();
+    uint        opaqueIndex             = 0;
+    uint        transparentIndex        = 0;
+
+    // both queues are ordered by priority, at equal priority opaque draw calls come first
+    for (auto& drawCall : _drawCalls)
+    {
+        if (transparentIndex == numTransparentDrawCalls
+            || (opaqueIndex < numOpaqueDrawCalls
+                && _opaqueDrawCalls[opaqueIndex]->priority() >= _transparentDrawCalls[transparentIndex]->priority()))
+            drawCall = _opaqueDrawCalls[opaqueIndex++];
+        else
+            drawCall = _transparentDrawCalls[transparentIndex++];
+    }
+}
+
+void
+DrawCallPool::updateInstanceGroups()
+{
+    // draw calls sharing the same pass, program, geometry, material, target and other target uniforms
+    // can be drawn at once
+    std::map<InstanceKey, InstanceGroupPtr> keyToInstanceGroup;
+
+    if (_instancingEnabled)
+        for (const auto& drawCall : _drawCalls)
+        {
+            const auto surfaceIt = _drawcallToSurface.find(drawCall);
+
+            if (surfaceIt == _drawcallToSurface.end() || drawCall->zSorted()
+                || !drawCall->targetData()->hasProperty("transform.modelToWorldMatrix"))
+                continue;
+
+            const auto  leaderIt    = _leaderToInstanceGroup.find(drawCall);
+            auto        program     = leaderIt != _leaderToInstanceGroup.end() ? leaderIt->second->program : drawCall->program();
+
+            if (program == nullptr || !program->context()->supportsInstancing())
+                continue;
+
+            const auto& surface = surfaceIt->second;
+            auto&       group   = keyToInstanceGroup[InstanceKey(
+                drawCall->pass().get(),
+                program.get(),
+                surface->geometry().get(),
+                surface->material().get(),
+                drawCall->target().get(),
+                drawCall->layouts(),
+                targetUniformProviders(drawCall)
+            )];
+
+            if (group == nullptr)
+            {
+                group = std::make_shared<InstanceGroup>();
+                group->program = program;
+                group->firstChanged = 1;
+                group->lastChanged = 0;
+            }
+            group->drawCalls.push_back(drawCall);
+        }
+
+    auto                            previousLeaderToInstanceGroup = _leaderToInstanceGroup;
+    std::vector<InstanceGroupPtr>   newGroups;
+
+    _leaderToInstanceGroup.clear();
+    _instancedDrawCalls.clear();
+
+    for (auto& keyAndGroup : keyToInstanceGroup)
+    {
+        auto        group       = keyAndGroup.second;
+        auto&       drawCalls   = group->drawCalls;
+
+        if (drawCalls.size() < MIN_NUM_INSTANCES || !canBeInstanced(drawCalls.front()->pass(), group->program))
+            continue;
+
+        // the leader comes first and the other draw calls are kept in a stable order, so that
+        // the previous group (and its instance buffer) can be kept when nothing changed
+        std::sort(drawCalls.begin(), drawCalls.end());
+
+        auto leaderIt = std::find_if(drawCalls.begin(), drawCalls.end(), [&](const DrawCallPtr& d)
+        {
+            return previousLeaderToInstanceGroup.count(d) != 0;
+        });
+
+        if (leaderIt != drawCalls.end())
+            std::rotate(drawCalls.begin(), leaderIt, leaderIt + 1);
+
+        auto leader             = drawCalls.front();
+        auto previousGroupIt    = previousLeaderToInstanceGroup.find(leader);
+
+        if (previousGroupIt != previousLeaderToInstanceGroup.end()
+            && previousGroupIt->second->drawCalls == drawCalls
+            && previousGroupIt->second->program == group->program
+            && leader->numInstances() == drawCalls.size())
+        {
+            group = previousGroupIt->second;
+            previousLeaderToInstanceGroup.erase(previousGroupIt);
+            _leaderToInstanceGroup[leader] = group;
+            _instancedDrawCalls.insert(drawCalls.begin() + 1, drawCalls.end());
+        }
+        else
+            newGroups.push_back(group);
+    }
+
+    // the instance buffers of the groups that changed are recycled, they are large enough as long as
+    // the groups do not grow
+    std::vector<VertexBufferPtr> freeInstanceBuffers;
+
+    for (auto& leaderAndGroup : previousLeaderToInstanceGroup)
+        freeInstanceBuffers.push_back(leaderAndGroup.second->instanceBuffer);
+
+    for (auto& group : newGroups)
+    {
+        auto&       drawCalls       = group->drawCalls;
+        auto        leader          = drawCalls.front();
+        const uint  numInstances    = drawCalls.size();
+        auto        bufferIt        = std::find_if(freeInstanceBuffers.begin(), freeInstanceBuffers.end(), [&](const VertexBufferPtr& b)
+        {
+            return b->numVertices() >= numInstances;
+        });
+
+        if (bufferIt != freeInstanceBuffers.end())
+        {
+            group->instanceBuffer = *bufferIt;
+            freeInstanceBuffers.erase(bufferIt);
+        }
+        else
+        {
+            // room for the group to grow a bit before a new buffer is needed
+            uint capacity = MIN_NUM_INSTANCES;
+
+            while (capacity < numInstances)
+                capacity <<= 1;
+
+            group->instanceBuffer = VertexBuffer::create(group->program->context());
+            group->instanceBuffer->data().resize(capacity * 16);
+            group->instanceBuffer->addAttribute("instanceModelToWorld0", 4);
+            group->instanceBuffer->addAttribute("instanceModelToWorld1", 4);
+            group->instanceBuffer->addAttribute("instanceModelToWorld2", 4);
+            group->instanceBuffer->addAttribute("instanceModelToWorld3", 4);
+        }
+
+        auto& instances = group->instanceBuffer->data();
+        auto  groupPtr  = group.get();
+
+        for (uint i = 0; i < numInstances; ++i)
+        {
+            auto modelToWorldMatrix = drawCalls[i]->targetData()->get<Matrix4x4::Ptr>("transform.modelToWorldMatrix");
+
+            group->modelToWorldMatrices.push_back(modelToWorldMatrix);
+            group->modelToWorldChangedSlots.push_back(modelToWorldMatrix->changed()->connect([=](data::Value::Ptr)
+            {
+                if (groupPtr->firstChanged > groupPtr->lastChanged)
+                {
+                    groupPtr->firstChanged = i;
+                    groupPtr->lastChanged = i;
+                }
+                else
+                {
+                    groupPtr->firstChanged = std::min(groupPtr->firstChanged, i);
+                    groupPtr->lastChanged = std::max(groupPtr->lastChanged, i);
+                }
+            }));
+            std::copy(modelToWorldMatrix->data().begin(), modelToWorldMatrix->data().end(), instances.begin() + i * 16);
+        }
+
+        group->instanceBuffer->upload(0, numInstances);
+
+        _leaderToInstanceGroup[leader] = group;
+
+        leader->instances(group->instanceBuffer, numInstances);
+        refreshDrawCall(leader);
+
+        if (leader->numInstances() == 0)
+        {
+            _leaderToInstanceGroup.erase(leader);
+            continue;
+        }
+
+        _instancedDrawCalls.insert(drawCalls.begin() + 1, drawCalls.end());
+    }
+
+    // leaders of groups that do not exist anymore are drawn on their own again
+    for (auto& leaderAndGroup : previousLeaderToInstanceGroup)
+    {
+        auto leader = leaderAndGroup.first;
+
+        if (_leaderToInstanceGroup.count(leader) == 0 && _drawcallToSurface.count(leader) != 0)
+        {
+            leader->instances(nullptr, 0);
+            refreshDrawCall(leader);
+        }
+    }
+}
+
+void
+DrawCallPool::updateInstanceBuffers()
+{
+    // stream the model to world matrices that changed since the last frame
+    for (auto& leaderAndGroup : _leaderToInstanceGroup)
+    {
+        auto& group = leaderAndGroup.second;
+
+        if (group->firstChanged > group->lastChanged)
+            continue;
+
+        auto& instances = group->instanceBuffer->data();
+
+        for (auto i = group->firstChanged; i <= group->lastChanged; ++i)
+        {
+            const auto& modelToWorld = group->modelToWorldMatrices[i]->data();
+
+            std::copy(modelToWorld.begin(), modelToWorld.end(), instances.begin() + i * 16);
+        }
+
+        group->instanceBuffer->upload(group->firstChanged, group->lastChanged - group->firstChanged + 1);
+        group->firstChanged = 1;
+        group->lastChanged = 0;
+    }
+}
+
+std::vector<data::Provider*>
+DrawCallPool::targetUniformProviders(DrawCall::Ptr drawCall)
+{
+    std::vector<data::Provider*> providers;
+
+    for (const auto& uniformNameAndBinding : drawCall->pass()->uniformBindings())
+    {
+        const auto& propertyName = std::get<0>(uniformNameAndBinding.second);
+
+        if (std::get<1>(uniformNameAndBinding.second) != data::BindingSource::TARGET
+            || propertyName == "transform.modelToWorldMatrix")
+            continue;
+
+        providers.push_back(drawCall->targetData()->propertyProvider(drawCall->formatPropertyName(propertyName)).get());
+    }
+
+    return providers;
+}
+
+bool
+DrawCallPool::canBeInstanced(Pass::Ptr pass, Program::Ptr program)
+{
+    // the effect must read the instance attributes when INSTANCING is defined
+    if (program->vertexShader()->source().find("instanceModelToWorld0") == std::string::npos)
+        return false;
+
+    auto instancedProgram = pass->instancedProgram(program);
+
+    return instancedProgram != nullptr
+        && instancedProgram->inputs()
+        && instancedProgram->inputs()->hasName("instanceModelToWorld0");
+}
+
+/*static*/
+void
+DrawCallPool::radixSort(std::vector<SortKeyAndIndex>&    keys,
+                        std::vector<SortKeyAndIndex>&    buffer)
+{
+    // least significant digit first, 8 bits at a time: stable, so equal keys keep their insertion order
+    const auto numKeys = keys.size();
+
+    if (numKeys < 2)
+        return;
+
+    uint counts[256];
+
+    buffer.resize(numKeys);
+
+    for (uint shift = 0; shift < 64; shift += 8)
+    {
+        std::memset(counts, 0, sizeof(counts));
+
+        for (const auto& keyAndIndex : keys)
+            ++counts[(keyAndIndex.first >> shift) & 0xff];
+
+        // skip the digits shared by all the keys
+        if (counts[(keys[0].first >> shift) & 0xff] == numKeys)
+            continue;
+
+        uint offset = 0;
+
+        for (uint i = 0; i < 256; ++i)
+        {
+            const auto count = counts[i];
+
+            counts[i] = offset;
+            offset += count;
+        }
+
+        for (const auto& keyAndIndex : keys)
+            buffer[counts[(keyAndIndex.first >> shift) & 0xff]++] = keyAndIndex;
+
+        keys.swap(buffer);
+    }
+}
+
 /*static*/
 Vector3::Ptr
 DrawCallPool::getDrawcallEyePosition(DrawCall::Ptr drawcall,
@@ -208,6 +784,14 @@ DrawCallPool::addSurface(Surface::Ptr surface)
         _surfaceToIndexChangedSlots.insert(std::pair<Surface::Ptr, ArrayIndexChanged::Slot>(surface, materialSlot));
     }
 
+    auto targetData = surface->targets()[0]->data();
+
+    for (auto signal : { targetData->propertyAdded(), targetData->propertyRemoved() })
+        _surfaceToTargetPropertySlots.insert(std::make_pair(surface, signal->connect([=](Container::Ptr, const std::string&)
+        {
+            _mustUpdateInstanceGroups = true;
+        })));
+
     //if (std::find(_toCollect.begin(), _toCollect.end(), surface) == _toCollect.end())
     if (surface->visible(_renderer))
         _toCollect.insert(surface);
@@ -225,6 +809,8 @@ DrawCallPool::removeSurface(Surface::Ptr surface)
         _toRemove.insert(surface);
     else
         _toCollect.erase(foundSurfaceIt);
+
+    deleteContainerViews(surface);
 }
 
 void
@@ -236,6 +822,8 @@ DrawCallPool::cleanSurface(Surface::Ptr    surface)
     _surfaceToTechniqueChangedSlot.erase(surface);
     //_surfaceToVisibilityChangedSlots.erase(surface);
     _surfaceToIndexChangedSlots.erase(surface);
+    _surfaceToTargetPropertySlots.erase(surface);
+    deleteContainerViews(surface);
 
     if (_surfaceBadMacroToTechniques.count(surface))
         _surfaceBadMacroToTechniques.erase(surface);
@@ -324,6 +912,14 @@ DrawCallPool::generateDrawCall(Surface::Ptr    surface,
             _drawcallToZSortNeededSlot[drawCall] = drawCall->zsortNeeded()->connect([=](DrawCall::Ptr d){
                 drawcallZSortNeededHandler(d);
             });
+
+            _drawcallToLayoutsChangedSlot[drawCall] = drawCall->layoutsChanged()->connect([=](DrawCall::Ptr d){
+                drawcallLayoutsChangedHandler(d);
+            });
+
+            _drawcallToZSortedChangedSlot[drawCall] = drawCall->zSortedChanged()->connect([=](DrawCall::Ptr d){
+                drawcallZSortedChangedHandler(d);
+            });
         }
         else
         {
@@ -362,44 +958,15 @@ DrawCallPool::initializeDrawCall(Surface::Ptr    surface,
     std::shared_ptr<data::Container>    fullRendererData    = _renderer->targets()[0]->data();
     std::shared_ptr<data::Container>    fullRootData        = target->root()->data();
 
-    ContainerPtr targetData        = nullptr;
-    ContainerPtr rendererData    = nullptr;
-    ContainerPtr rootData        = nullptr;
-
-    if (drawCall)
-    {
-        targetData        = drawCall->targetData();
-        rendererData    = drawCall->rendererData();
-        rootData        = drawCall->rootData();
-
-        //drawCall->unbind();
-    }
-
-    _renderer->setFilterSurface(surface);
-
-    const auto&    targetFilters    = _renderer->filters(data::BindingSource::TARGET);
-    const auto&    rendererFilters    = _renderer->filters(data::BindingSource::RENDERER);
-    const auto&    rootFilters        = _renderer->filters(data::BindingSource::ROOT);
+    // the filtered containers are kept up to date by the views instead of being filtered again
+    const auto& views = containerViews(surface);
 
-    targetData        = fullTargetData->filter(targetFilters);
-    rendererData    = fullRendererData->filter(rendererFilters);
-    rootData        = fullRootData->filter(rootFilters);
+    ContainerPtr targetData        = views[static_cast<int>(data::BindingSource::TARGET)]->container();
+    ContainerPtr rendererData    = views[static_cast<int>(data::BindingSource::RENDERER)]->container();
+    ContainerPtr rootData        = views[static_cast<int>(data::BindingSource::ROOT)]->container();
 
     // get drawcall's property name formatting function (dependent on filters!)
-    auto geometryId    = targetData->getProviderIndex(surface->geometry()->data());
-    auto materialId    = targetData->getProviderIndex(surface->material());
-
-    std::unordered_map<std::string, std::string> drawCallVariables;
-
-    drawCallVariables["geometryId"] = std::to_string(geometryId);
-    drawCallVariables["materialId"] = std::to_string(materialId);
-
-    FormatNameFunction formatNameFunc = std::bind(
-        &DrawCallPool::formatPropertyName,
-        shared_from_this(),
-        std::placeholders::_1,
-        drawCallVariables
-    );
+    auto formatNameFunc = formatNameFunction(surface, surface->material(), targetData);
 
     auto program = getWorkingProgram(
         surface,
@@ -416,6 +983,24 @@ DrawCallPool::initializeDrawCall(Surface::Ptr    surface,
     if (!program)
         return nullptr;
 
+    if (drawCall && drawCall->numInstances() > 0)
+    {
+        const auto groupIt = _leaderToInstanceGroup.find(drawCall);
+
+        if (groupIt != _leaderToInstanceGroup.end())
+            groupIt->second->program = program;
+
+        if (canBeInstanced(pass, program))
+            program = pass->instancedProgram(program);
+        else
+        {
+            // the instances will be drawn on their own again
+            drawCall->instances(nullptr, 0);
+            _mustSort = true;
+            _mustUpdateInstanceGroups = true;
+        }
+    }
+
     if (drawCall == nullptr)
         drawCall = DrawCall::create(pass);
 
@@ -429,9 +1014,133 @@ DrawCallPool::initializeDrawCall(Surface::Ptr    surface,
         rendererData,
         rootData
     );
+    drawCall->uniformBlock(uniformBlock(program));
+
     return drawCall;
 }
 
+FormatNameFunction
+DrawCallPool::formatNameFunction(Surface::Ptr       surface,
+                                 MaterialPtr        material,
+                                 ContainerPtr       targetData)
+{
+    auto geometryId    = targetData->getProviderIndex(surface->geometry()->data());
+    auto materialId    = targetData->getProviderIndex(material);
+
+    std::unordered_map<std::string, std::string> drawCallVariables;
+
+    drawCallVariables["geometryId"] = std::to_string(geometryId);
+    drawCallVariables["materialId"] = std::to_string(materialId);
+
+    return std::bind(
+        &DrawCallPool::formatPropertyName,
+        shared_from_this(),
+        std::placeholders::_1,
+        drawCallVariables
+    );
+}
+
+const std::vector<DrawCallPool::ContainerViewPtr>&
+DrawCallPool::containerViews(Surface::Ptr surface)
+{
+    const auto      target          = surface->targets()[0];
+    ContainerPtr    sources[]       = {
+        target->data(),
+        _renderer->targets()[0]->data(),
+        target->root()->data()
+    };
+    const auto&     views           = _surfaceToContainerViews[surface];
+
+    if (!views.empty()
+        && views[0]->source() == sources[0]
+        && views[1]->source() == sources[1]
+        && views[2]->source() == sources[2])
+    {
+        // filters might have been added to or removed from the renderer since the views were created
+        for (uint i = 0; i < views.size(); ++i)
+            views[i]->filters(_renderer->filters(static_cast<data::BindingSource>(i)));
+
+        return views;
+    }
+
+    deleteContainerViews(surface);
+
+    auto& newViews = _surfaceToContainerViews[surface];
+
+    for (uint i = 0; i < 3; ++i)
+    {
+        auto view = ContainerView::create(sources[i], _renderer->filters(static_cast<data::BindingSource>(i)), surface);
+
+        newViews.push_back(view);
+        _surfaceToContainerViewChangedSlots.insert(std::pair<SurfacePtr, ContainerViewChanged::Slot>(
+            surface,
+            view->changed()->connect([=](ContainerViewPtr){ containerViewChangedHandler(surface); })
+        ));
+    }
+
+    return newViews;
+}
+
+void
+DrawCallPool::deleteContainerViews(Surface::Ptr surface)
+{
+    _surfaceToContainerViews.erase(surface);
+    _surfaceToContainerViewChangedSlots.erase(surface);
+}
+
+bool
+DrawCallPool::warmUp(Surface::Ptr surface, MaterialPtr material)
+{
+    if (surface->targets().empty() || _renderer->targets().empty())
+        return false;
+
+    const auto  target      = surface->targets()[0];
+    auto        effect      = surface->effect();
+    auto        technique   = surface->technique();
+
+    if (_renderer->effect())
+    {
+        effect      = _renderer->effect();
+        technique   = effect->techniques().begin()->first;
+    }
+
+    _renderer->setFilterSurface(surface);
+
+    auto targetData     = target->data()->filter(_renderer->filters(data::BindingSource::TARGET));
+    auto rendererData   = _renderer->targets()[0]->data()->filter(_renderer->filters(data::BindingSource::RENDERER));
+    auto rootData       = target->root()->data()->filter(_renderer->filters(data::BindingSource::ROOT));
+
+    if (material == nullptr)
+        material = surface->material();
+    else if (targetData->hasProvider(surface->material()))
+    {
+        // the filtered container is a copy: it can hold the other material instead
+        targetData->removeProvider(std::static_pointer_cast<data::ArrayProvider>(surface->material()));
+        targetData->addProvider(std::static_pointer_cast<data::ArrayProvider>(material));
+    }
+
+    // the variants draw calls would switch to on the first frame are compiled as well
+    return effect->warmUp(
+        technique,
+        formatNameFunction(surface, material, targetData),
+        targetData,
+        rendererData,
+        rootData,
+        [&](Pass::Ptr pass, Program::Ptr program)
+        {
+            const auto instancing = _instancingEnabled
+                && program->context()->supportsInstancing()
+                && canBeInstanced(pass, program);
+
+            if (_renderer->depthPrePassEnabled())
+            {
+                depthProgram(program);
+                if (instancing)
+                    depthProgram(pass->instancedProgram(program));
+            }
+        }
+    );
+}
 
 std::shared_ptr<Program>
 DrawCallPool::getWorkingProgram(Surface::Ptr            surface,
@@ -547,9 +1256,15 @@ DrawCallPool::deleteDrawCalls(Surface::Ptr surface)
         _drawcallToSurface.erase(drawCall);
         _drawcallToMacroChangedSlot.erase(drawCall);
         _drawcallToZSortNeededSlot.erase(drawCall);
+        _drawcallToLayoutsChangedSlot.erase(drawCall);
+        _drawcallToZSortedChangedSlot.erase(drawCall);
 
         _drawCalls.remove(drawCall);
         _dirtyDrawCalls.erase(drawCall);
+
+        ++_revision;
+        _mustSort = true;
+        _mustUpdateInstanceGroups = true;
     }
 }
 
@@ -568,6 +1283,63 @@ DrawCallPool::drawcallZSortNeededHandler(DrawCall::Ptr)
     _mustZSort = true;
 }
 
+void
+DrawCallPool::drawcallLayoutsChangedHandler(DrawCall::Ptr)
+{
+    // layout buckets must be rebuilt, and instance groups are split by layouts
+    ++_revision;
+    _mustUpdateInstanceGroups = true;
+}
+
+void
+DrawCallPool::drawcallZSortedChangedHandler(DrawCall::Ptr drawCall)
+{
+    // instance groups only hold opaque draw calls
+    _mustUpdateInstanceGroups = true;
+
+    // without sort keys the whole list is sorted again anyway
+    if (!_sortKeysEnabled)
+    {
+        _mustZSort = true;
+
+        return;
+    }
+
+    if (_leaderToInstanceGroup.count(drawCall) != 0 || _instancedDrawCalls.count(drawCall) != 0)
+    {
+        _mustSort = true;
+
+        return;
+    }
+
+    auto& source        = drawCall->zSorted() ? _opaqueDrawCalls : _transparentDrawCalls;
+    auto  drawCallIt    = std::find(source.begin(), source.end(), drawCall);
+
+    // not queued yet: the next full sort will put it in the right queue
+    if (drawCallIt == source.end())
+        return;
+
+    source.erase(drawCallIt);
+
+    if (drawCall->zSorted())
+        _transparentDrawCalls.push_back(drawCall);
+    else
+    {
+        const auto sortKey = drawCall->sortKey();
+
+        _opaqueDrawCalls.insert(
+            std::upper_bound(_opaqueDrawCalls.begin(), _opaqueDrawCalls.end(), sortKey, [](uint64_t key, const DrawCallPtr& d)
+            {
+                return key < d->sortKey();
+            }),
+            drawCall
+        );
+    }
+
+    // queues are merged again, after the transparent one is z-sorted
+    _mustZSort = true;
+}
+
 void
 DrawCallPool::surfaceBadMacroChangedHandler(Surface::Ptr        surface,
                                             const std::string&    macroName)
@@ -597,20 +1369,35 @@ DrawCallPool::rendererFilterChangedHandler(Renderer::Ptr                    rend
                                            data::BindingSource                source,
                                            SurfacePtr                        surface)
 {
+    // only the draw calls whose filtered data actually changed are refreshed, by
+    // containerViewChangedHandler()
+    const auto sourceIndex = static_cast<int>(source);
+
     if (surface != nullptr)
     {
-        auto drawCalls = _surfaceToDrawCalls[surface];
+        auto viewsIt = _surfaceToContainerViews.find(surface);
 
-        for (auto drawCall : drawCalls)
-            _dirtyDrawCalls.insert(drawCall);
+        if (viewsIt != _surfaceToContainerViews.end() && viewsIt->second[sourceIndex]->filters().count(filter))
+            viewsIt->second[sourceIndex]->update();
     }
     else
     {
-        for (auto drawCallList : _surfaceToDrawCalls)
-            _dirtyDrawCalls.insert(drawCallList.second.begin(), drawCallList.second.end());
+        for (auto& surfaceAndViews : _surfaceToContainerViews)
+            if (surfaceAndViews.second[sourceIndex]->filters().count(filter))
+                surfaceAndViews.second[sourceIndex]->update();
     }
+}
 
-    _mustZSort = true;
+void
+DrawCallPool::containerViewChangedHandler(Surface::Ptr surface)
+{
+    auto drawCallsIt = _surfaceToDrawCalls.find(surface);
+
+    if (drawCallsIt == _surfaceToDrawCalls.end() || drawCallsIt->second.empty())
+        return;
+
+    _dirtyDrawCalls.insert(drawCallsIt->second.begin(), drawCallsIt->second.end());
+    _mustSort = true;
 }
 
 void
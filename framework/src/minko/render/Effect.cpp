@@ -21,6 +21,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/render/Pass.hpp"
 #include "minko/data/Provider.hpp"
+#include "minko/data/Container.hpp"
 
 using namespace minko;
 using namespace minko::render;
@@ -75,3 +76,45 @@ Effect::removeTechnique(const std::string& name)
     _techniques.erase(name);
     _fallback.erase(name);
 }
+
+bool
+Effect::warmUp(const std::string&             techniqueName,
+               FormatNameFunction             formatNameFunc,
+               data::Container::Ptr           targetData,
+               data::Container::Ptr           rendererData,
+               data::Container::Ptr           rootData,
+               const ProgramReadyFunction&    programReady)
+{
+    auto technique = techniqueName;
+
+    // bounded in case fallbacks form a cycle
+    for (uint i = 0; i <= _techniques.size(); ++i)
+    {
+        std::vector<std::pair<PassPtr, ProgramPtr>> programs;
+
+        for (auto& pass : this->technique(technique))
+        {
+            auto program = pass->warmUp(formatNameFunc, targetData, rendererData, rootData);
+
+            if (program == nullptr)
+                break;
+
+            programs.push_back(std::make_pair(pass, program));
+        }
+
+        if (programs.size() == this->technique(technique).size())
+        {
+            if (programReady)
+                for (auto& passAndProgram : programs)
+                    programReady(passAndProgram.first, passAndProgram.second);
+
+            return true;
+        }
+        if (!hasFallback(technique))
+            return false;
+
+        technique = fallback(technique);
+    }
+
+    return false;
+}
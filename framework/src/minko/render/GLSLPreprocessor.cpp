@@ -0,0 +1,369 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/render/GLSLPreprocessor.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+    class ExpressionEvaluator
+    {
+    private:
+        const std::vector<std::string>& _tokens;
+        const GLSLPreprocessor::Macros& _macros;
+        uint                            _depth;
+        uint                            _position;
+
+    public:
+        ExpressionEvaluator(const std::vector<std::string>& tokens, const GLSLPreprocessor::Macros& macros, uint depth = 0) :
+            _tokens(tokens),
+            _macros(macros),
+            _depth(depth),
+            _position(0)
+        {
+        }
+
+        long
+        evaluate()
+        {
+            return logicalOr();
+        }
+
+    private:
+        bool
+        accept(const std::string& token)
+        {
+            if (_position < _tokens.size() && _tokens[_position] == token)
+            {
+                ++_position;
+                return true;
+            }
+
+            return false;
+        }
+
+        long
+        logicalOr()
+        {
+            auto value = logicalAnd();
+
+            while (accept("||"))
+                value = logicalAnd() || value;
+
+            return value;
+        }
+
+        long
+        logicalAnd()
+        {
+            auto value = equality();
+
+            while (accept("&&"))
+                value = equality() && value;
+
+            return value;
+        }
+
+        long
+        equality()
+        {
+            auto value = relational();
+
+            while (true)
+            {
+                if (accept("=="))
+                    value = value == relational();
+                else if (accept("!="))
+                    value = value != relational();
+                else
+                    return value;
+            }
+        }
+
+        long
+        relational()
+        {
+            auto value = additive();
+
+            while (true)
+            {
+                if (accept("<="))
+                    value = value <= additive();
+                else if (accept(">="))
+                    value = value >= additive();
+                else if (accept("<"))
+                    value = value < additive();
+                else if (accept(">"))
+                    value = value > additive();
+                else
+                    return value;
+            }
+        }
+
+        long
+        additive()
+        {
+            auto value = multiplicative();
+
+            while (true)
+            {
+                if (accept("+"))
+                    value += multiplicative();
+                else if (accept("-"))
+                    value -= multiplicative();
+                else
+                    return value;
+            }
+        }
+
+        long
+        multiplicative()
+        {
+            auto value = unary();
+
+            while (true)
+            {
+                if (accept("*"))
+                    value *= unary();
+                else if (accept("/"))
+                {
+                    auto divisor = unary();
+
+                    value = divisor != 0 ? value / divisor : 0;
+                }
+                else
+                    return value;
+            }
+        }
+
+        long
+        unary()
+        {
+            if (accept("!"))
+                return !unary();
+            if (accept("-"))
+                return -unary();
+            if (accept("+"))
+                return unary();
+
+            return primary();
+        }
+
+        long
+        primary()
+        {
+            if (_position >= _tokens.size())
+                return 0;
+
+            if (accept("("))
+            {
+                auto value = logicalOr();
+
+                accept(")");
+
+                return value;
+            }
+
+            const auto& token = _tokens[_position++];
+
+            if (token == "defined")
+            {
+                auto parenthesis    = accept("(");
+                auto defined        = _position < _tokens.size() && _macros.count(_tokens[_position]) != 0;
+
+                ++_position;
+                if (parenthesis)
+                    accept(")");
+
+                return defined;
+            }
+
+            if (std::isdigit(token[0]))
+                return std::strtol(token.c_str(), nullptr, 0);
+
+            // undefined identifiers evaluate to 0, as with the C preprocessor
+            auto macroIt = _macros.find(token);
+
+            if (macroIt == _macros.end() || _depth > 16)
+                return 0;
+
+            auto tokens = GLSLPreprocessor::tokenize(macroIt->second);
+
+            return ExpressionEvaluator(tokens, _macros, _depth + 1).evaluate();
+        }
+    };
+}
+
+std::vector<std::string>
+GLSLPreprocessor::tokenize(const std::string& source)
+{
+    static const std::string operators[] = { "&&", "||", "==", "!=", "<=", ">=" };
+
+    std::vector<std::string> tokens;
+
+    for (uint i = 0; i < source.size();)
+    {
+        auto c = source[i];
+
+        if (std::isalpha(c) || c == '_')
+        {
+            auto j = i;
+
+            while (j < source.size() && (std::isalnum(source[j]) || source[j] == '_'))
+                ++j;
+            tokens.push_back(source.substr(i, j - i));
+            i = j;
+        }
+        else if (std::isdigit(c))
+        {
+            auto j = i;
+
+            while (j < source.size() && (std::isalnum(source[j]) || source[j] == '.'))
+                ++j;
+            tokens.push_back(source.substr(i, j - i));
+            i = j;
+        }
+        else if (std::isspace(c))
+            ++i;
+        else
+        {
+            auto length = 1;
+
+            for (auto& op : operators)
+                if (source.compare(i, 2, op) == 0)
+                    length = 2;
+            tokens.push_back(source.substr(i, length));
+            i += length;
+        }
+    }
+
+    return tokens;
+}
+
+long
+GLSLPreprocessor::evaluate(const std::vector<std::string>& tokens, const Macros& macros)
+{
+    return ExpressionEvaluator(tokens, macros).evaluate();
+}
+
+std::string
+GLSLPreprocessor::stripComments(const std::string& source)
+{
+    std::string result;
+
+    for (uint i = 0; i < source.size(); ++i)
+    {
+        if (source.compare(i, 2, "//") == 0)
+        {
+            while (i < source.size() && source[i] != '\n')
+                ++i;
+            result += '\n';
+        }
+        else if (source.compare(i, 2, "/*") == 0)
+        {
+            auto end = source.find("*/", i + 2);
+
+            i = end == std::string::npos ? source.size() : end + 1;
+            result += ' ';
+        }
+        else
+            result += source[i];
+    }
+
+    return result;
+}
+
+std::string
+GLSLPreprocessor::process(const std::string& source, Macros& macros)
+{
+    struct Conditional
+    {
+        bool    parentActive;
+        bool    active;
+        bool    taken;
+    };
+
+    std::vector<Conditional>    conditionals;
+    std::stringstream           input(stripComments(source));
+    std::string                 output;
+    std::string                 line;
+
+    while (std::getline(input, line))
+    {
+        auto active = conditionals.empty() || conditionals.back().active;
+        auto start  = line.find_first_not_of(" \t");
+
+        if (start == std::string::npos || line[start] != '#')
+        {
+            if (active)
+                output += line + '\n';
+            continue;
+        }
+
+        auto tokens     = tokenize(line.substr(start + 1));
+        auto directive  = tokens.empty() ? std::string() : tokens[0];
+        auto arguments  = std::vector<std::string>(tokens.begin() + std::min<size_t>(1, tokens.size()), tokens.end());
+        auto name       = arguments.empty() ? std::string() : arguments[0];
+
+        if (directive == "if" || directive == "ifdef" || directive == "ifndef")
+        {
+            bool value = false;
+
+            if (directive == "if")
+                value = evaluate(arguments, macros) != 0;
+            else
+                value = (macros.count(name) != 0) == (directive == "ifdef");
+
+            conditionals.push_back({ active, active && value, value });
+        }
+        else if (directive == "elif" && !conditionals.empty())
+        {
+            auto& conditional = conditionals.back();
+
+            conditional.active = false;
+            if (!conditional.taken && evaluate(arguments, macros) != 0)
+            {
+                conditional.active  = conditional.parentActive;
+                conditional.taken   = true;
+            }
+        }
+        else if (directive == "else" && !conditionals.empty())
+        {
+            auto& conditional = conditionals.back();
+
+            conditional.active  = conditional.parentActive && !conditional.taken;
+            conditional.taken   = true;
+        }
+        else if (directive == "endif" && !conditionals.empty())
+            conditionals.pop_back();
+        else if (active && directive == "define" && !name.empty())
+        {
+            auto value  = line.substr(line.find(name, line.find("define")) + name.size());
+            auto first  = value.find_first_not_of(" \t");
+
+            macros[name] = first == std::string::npos ? std::string() : value.substr(first);
+        }
+        else if (active && directive == "undef")
+            macros.erase(name);
+    }
+
+    return output;
+}
@@ -24,7 +24,12 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 using namespace minko;
 using namespace minko::render;
 
-
+IndexBuffer::~IndexBuffer()
+{
+    // unlike dispose(), does not notify changed(): shared_from_this() throws once destruction began
+    if (_id != -1)
+        _context->deleteIndexBuffer(_id);
+}
 
 void
 IndexBuffer::upload(uint    offset,
@@ -0,0 +1,1010 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/render/NullContext.hpp"
+
+#include "minko/render/CompareMode.hpp"
+#include "minko/render/GLSLPreprocessor.hpp"
+#include "minko/render/StencilOperation.hpp"
+#include "minko/render/TriangleCulling.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+    ProgramInputs::Type
+    inputType(const std::string& glslType)
+    {
+        static const std::unordered_map<std::string, ProgramInputs::Type> types = {
+            { "float",          ProgramInputs::Type::float1 },
+            { "vec2",           ProgramInputs::Type::float2 },
+            { "vec3",           ProgramInputs::Type::float3 },
+            { "vec4",           ProgramInputs::Type::float4 },
+            { "int",            ProgramInputs::Type::int1 },
+            { "ivec2",          ProgramInputs::Type::int2 },
+            { "ivec3",          ProgramInputs::Type::int3 },
+            { "ivec4",          ProgramInputs::Type::int4 },
+            { "bool",           ProgramInputs::Type::bool1 },
+            { "bvec2",          ProgramInputs::Type::bool2 },
+            { "bvec3",          ProgramInputs::Type::bool3 },
+            { "bvec4",          ProgramInputs::Type::bool4 },
+            { "mat3",           ProgramInputs::Type::float9 },
+            { "mat4",           ProgramInputs::Type::float16 },
+            { "sampler2D",      ProgramInputs::Type::sampler2d },
+            { "samplerCube",    ProgramInputs::Type::samplerCube }
+        };
+
+        auto typeIt = types.find(glslType);
+
+        return typeIt != types.end() ? typeIt->second : ProgramInputs::Type::unknown;
+    }
+
+    bool
+    isQualifier(const std::string& token)
+    {
+        return token == "lowp" || token == "mediump" || token == "highp" || token == "const";
+    }
+}
+
+NullContext::NullContext() :
+    _errorsEnabled(false),
+    _driverInfo("NullContext"),
+    _nextId(1),
+    _recordCalls(false),
+    _numFrames(0),
+    _viewportWidth(0),
+    _viewportHeight(0),
+    _backBufferViewportWidth(0),
+    _backBufferViewportHeight(0),
+    _currentTarget(0),
+    _currentProgram(0),
+    _currentTexture(8, 0),
+    _currentVertexArray(0),
+    _currentVertexBuffer(8, VertexBufferState(0, 0, 0, 0, 0)),
+    _currentBlendMode(-1),
+    _currentColorMask(true),
+    _currentDepthTest(true, CompareMode::LESS),
+    _currentTriangleCulling(TriangleCulling::BACK),
+    _currentStencilTest(CompareMode::ALWAYS, 0, 1, StencilOperation::KEEP, StencilOperation::KEEP, StencilOperation::KEEP),
+    _currentScissorTest(false, 0, 0, -1, -1)
+{
+}
+
+/*static*/ const uint NullContext::PROGRAM_BINARY_FORMAT = 0x4e554c4c;
+
+void
+NullContext::record(const std::string& function, std::initializer_list<double> arguments)
+{
+    if (!_recordCalls)
+        return;
+
+    Call call;
+
+    call.function   = function;
+    call.arguments  = arguments;
+    _calls.push_back(call);
+}
+
+void
+NullContext::configureViewport(const uint x,
+                               const uint y,
+                               const uint width,
+                               const uint height)
+{
+    record("configureViewport", { double(x), double(y), double(width), double(height) });
+
+    if (_currentTarget == 0)
+    {
+        _backBufferViewportWidth    = width;
+        _backBufferViewportHeight   = height;
+    }
+    _viewportWidth  = width;
+    _viewportHeight = height;
+}
+
+void
+NullContext::clear(float    red,
+                   float    green,
+                   float    blue,
+                   float    alpha,
+                   float    depth,
+                   uint     stencil,
+                   uint     mask)
+{
+    record("clear", { red, green, blue, alpha, depth, double(stencil), double(mask) });
+}
+
+void
+NullContext::present()
+{
+    record("present");
+
+    _frameStats         = _currentFrameStats;
+    _currentFrameStats  = FrameStats();
+    ++_numFrames;
+}
+
+void
+NullContext::drawTriangles(const uint indexBuffer, const int numTriangles)
+{
+    record("drawTriangles", { double(indexBuffer), double(numTriangles) });
+
+    ++_currentFrameStats.numDrawCalls;
+    _currentFrameStats.numTriangles += numTriangles;
+}
+
+void
+NullContext::drawInstancedTriangles(const uint indexBuffer, const int numTriangles, const int numInstances)
+{
+    record("drawInstancedTriangles", { double(indexBuffer), double(numTriangles), double(numInstances) });
+
+    ++_currentFrameStats.numDrawCalls;
+    _currentFrameStats.numTriangles += numTriangles * numInstances;
+}
+
+uint
+NullContext::createTimerQuery()
+{
+    record("createTimerQuery");
+
+    return _nextId++;
+}
+
+void
+NullContext::deleteTimerQuery(uint query)
+{
+    record("deleteTimerQuery", { double(query) });
+}
+
+void
+NullContext::beginTimerQuery(uint query)
+{
+    record("beginTimerQuery", { double(query) });
+}
+
+void
+NullContext::endTimerQuery()
+{
+    record("endTimerQuery");
+}
+
+bool
+NullContext::timerQueryAvailable(uint query)
+{
+    return true;
+}
+
+float
+NullContext::timerQueryResult(uint query)
+{
+    return 0.f;
+}
+
+uint
+NullContext::createVertexArray()
+{
+    record("createVertexArray");
+
+    return _nextId++;
+}
+
+void
+NullContext::deleteVertexArray(uint vertexArray)
+{
+    record("deleteVertexArray", { double(vertexArray) });
+
+    if (_currentVertexArray == vertexArray)
+        setVertexArray(0);
+}
+
+void
+NullContext::setVertexArray(uint vertexArray)
+{
+    record("setVertexArray", { double(vertexArray) });
+
+    if (_currentVertexArray != vertexArray)
+    {
+        // the vertex buffer bindings belong to the vertex array
+        _currentVertexArray = vertexArray;
+        _currentVertexBuffer.assign(8, VertexBufferState(0, 0, 0, 0, 0));
+        ++_currentFrameStats.numStateChanges;
+    }
+}
+
+const uint
+NullContext::createVertexBuffer(const uint size)
+{
+    record("createVertexBuffer", { double(size) });
+
+    return _nextId++;
+}
+
+void
+NullContext::setVertexBufferAt(const uint   position,
+                               const uint   vertexBuffer,
+                               const uint   size,
+                               const uint   stride,
+                               const uint   offset,
+                               const uint   divisor)
+{
+    record("setVertexBufferAt", {
+        double(position), double(vertexBuffer), double(size), double(stride), double(offset), double(divisor)
+    });
+
+    if (position >= _currentVertexBuffer.size())
+        _currentVertexBuffer.resize(position + 1, VertexBufferState(0, 0, 0, 0, 0));
+
+    VertexBufferState state(vertexBuffer, size, stride, offset, divisor);
+
+    if (_currentVertexBuffer[position] != state)
+    {
+        _currentVertexBuffer[position] = state;
+        ++_currentFrameStats.numStateChanges;
+    }
+}
+
+void
+NullContext::uploadVertexBufferData(const uint  vertexBuffer,
+                                    const uint  offset,
+                                    const uint  size,
+                                    void*       data)
+{
+    record("uploadVertexBufferData", { double(vertexBuffer), double(offset), double(size) });
+
+    _currentFrameStats.numUploadedBytes += size * sizeof(float);
+}
+
+void
+NullContext::deleteVertexBuffer(const uint vertexBuffer)
+{
+    record("deleteVertexBuffer", { double(vertexBuffer) });
+}
+
+const uint
+NullContext::createIndexBuffer(const uint size)
+{
+    record("createIndexBuffer", { double(size) });
+
+    return _nextId++;
+}
+
+void
+NullContext::uploaderIndexBufferData(const uint indexBuffer,
+                                     const uint offset,
+                                     const uint size,
+                                     void*      data)
+{
+    record("uploaderIndexBufferData", { double(indexBuffer), double(offset), double(size) });
+
+    _currentFrameStats.numUploadedBytes += size * sizeof(unsigned short);
+}
+
+void
+NullContext::deleteIndexBuffer(const uint indexBuffer)
+{
+    record("deleteIndexBuffer", { double(indexBuffer) });
+}
+
+uint
+NullContext::createTexture(TextureType  type,
+                           unsigned int width,
+                           unsigned int height,
+                           bool         mipMapping,
+                           bool         optimizeForRenderToTexture)
+{
+    record("createTexture", {
+        double(static_cast<int>(type)), double(width), double(height), double(mipMapping), double(optimizeForRenderToTexture)
+    });
+
+    auto texture = _nextId++;
+
+    _textureSizes[texture] = std::make_pair(width, height);
+
+    return texture;
+}
+
+uint
+NullContext::createCompressedTexture(TextureType    type,
+                                     TextureFormat  format,
+                                     unsigned int   width,
+                                     unsigned int   height,
+                                     bool           mipMapping)
+{
+    record("createCompressedTexture", {
+        double(static_cast<int>(type)), double(static_cast<int>(format)), double(width), double(height), double(mipMapping)
+    });
+
+    auto texture = _nextId++;
+
+    _textureSizes[texture] = std::make_pair(width, height);
+
+    return texture;
+}
+
+void
+NullContext::uploadTexture2dData(uint           texture,
+                                 unsigned int   width,
+                                 unsigned int   height,
+                                 unsigned int   mipLevel,
+                                 void*          data)
+{
+    record("uploadTexture2dData", { double(texture), double(width), double(height), double(mipLevel) });
+
+    _currentFrameStats.numUploadedBytes += width * height * 4;
+}
+
+void
+NullContext::uploadCubeTextureData(uint                 texture,
+                                   CubeTexture::Face    face,
+                                   unsigned int         width,
+                                   unsigned int         height,
+                                   unsigned int         mipLevel,
+                                   void*                data)
+{
+    record("uploadCubeTextureData", {
+        double(texture), double(static_cast<int>(face)), double(width), double(height), double(mipLevel)
+    });
+
+    _currentFrameStats.numUploadedBytes += width * height * 4;
+}
+
+void
+NullContext::uploadCompressedTexture2dData(uint             texture,
+                                           TextureFormat    format,
+                                           unsigned int     width,
+                                           unsigned int     height,
+                                           unsigned int     size,
+                                           unsigned int     mipLevel,
+                                           void*            data)
+{
+    record("uploadCompressedTexture2dData", {
+        double(texture), double(static_cast<int>(format)), double(width), double(height), double(size), double(mipLevel)
+    });
+
+    _currentFrameStats.numUploadedBytes += size;
+}
+
+void
+NullContext::uploadCompressedCubeTextureData(uint               texture,
+                                             CubeTexture::Face  face,
+                                             TextureFormat      format,
+                                             unsigned int       width,
+                                             unsigned int       height,
+                                             unsigned int       mipLevel,
+                                             void*              data)
+{
+    record("uploadCompressedCubeTextureData", {
+        double(texture), double(static_cast<int>(face)), double(static_cast<int>(format)), double(width), double(height), double(mipLevel)
+    });
+
+    // the size of compressed cube faces is not provided: count them as 4 bits per pixel
+    _currentFrameStats.numUploadedBytes += width * height / 2;
+}
+
+void
+NullContext::activateMipMapping(uint texture)
+{
+    record("activateMipMapping", { double(texture) });
+}
+
+void
+NullContext::deleteTexture(uint texture)
+{
+    record("deleteTexture", { double(texture) });
+
+    _textureSizes.erase(texture);
+}
+
+void
+NullContext::setTextureAt(uint  position,
+                          int   texture,
+                          int   location)
+{
+    record("setTextureAt", { double(position), double(texture), double(location) });
+
+    if (position >= _currentTexture.size())
+        _currentTexture.resize(position + 1, 0);
+
+    if (_currentTexture[position] != texture)
+    {
+        _currentTexture[position] = texture;
+        ++_currentFrameStats.numStateChanges;
+    }
+    if (texture > 0 && location >= 0)
+        ++_currentFrameStats.numUniforms;
+}
+
+void
+NullContext::setSamplerStateAt(uint             position,
+                               WrapMode         wrapping,
+                               TextureFilter    filtering,
+                               MipFilter        mipFiltering)
+{
+    record("setSamplerStateAt", { double(position), double(static_cast<int>(wrapping)), double(static_cast<int>(filtering)), double(static_cast<int>(mipFiltering)) });
+}
+
+const uint
+NullContext::createProgram()
+{
+    record("createProgram");
+
+    return _nextId++;
+}
+
+void
+NullContext::attachShader(const uint program, const uint shader)
+{
+    record("attachShader", { double(program), double(shader) });
+
+    _programShaders[program].push_back(shader);
+}
+
+void
+NullContext::linkProgram(const uint program)
+{
+    record("linkProgram", { double(program) });
+
+    std::vector<std::string> sources;
+
+    for (auto shader : _programShaders[program])
+        sources.push_back(_shaderSources[shader]);
+
+    link(program, sources);
+}
+
+void
+NullContext::link(const uint program, const std::vector<std::string>& sources)
+{
+    std::vector<std::string>            names;
+    std::vector<ProgramInputs::Type>    types;
+    std::vector<uint>                   locations;
+
+    for (const auto& source : sources)
+        fillProgramInputs(source, names, types, locations);
+
+    _programSources[program] = sources;
+    _programInputs[program] = ProgramInputs::create(shared_from_this(), program, names, types, locations);
+}
+
+bool
+NullContext::getProgramBinary(const uint program, uint& format, std::vector<unsigned char>& binary)
+{
+    auto sourcesIt = _programSources.find(program);
+
+    if (sourcesIt == _programSources.end())
+        return false;
+
+    // each source is preceded by its size on 4 bytes
+    binary.clear();
+    for (const auto& source : sourcesIt->second)
+    {
+        uint size = source.size();
+
+        binary.insert(binary.end(), reinterpret_cast<unsigned char*>(&size), reinterpret_cast<unsigned char*>(&size) + 4);
+        binary.insert(binary.end(), source.begin(), source.end());
+    }
+
+    format = PROGRAM_BINARY_FORMAT;
+
+    return true;
+}
+
+bool
+NullContext::loadProgramBinary(const uint program, const uint format, const std::vector<unsigned char>& binary)
+{
+    record("loadProgramBinary", { double(program), double(format) });
+
+    if (format != PROGRAM_BINARY_FORMAT)
+        return false;
+
+    std::vector<std::string> sources;
+
+    for (uint offset = 0; offset < binary.size(); )
+    {
+        uint size = 0;
+
+        if (offset + 4 > binary.size())
+            return false;
+
+        std::memcpy(&size, &binary[offset], 4);
+        offset += 4;
+
+        if (offset + size > binary.size())
+            return false;
+
+        sources.push_back(std::string(binary.begin() + offset, binary.begin() + offset + size));
+        offset += size;
+    }
+
+    link(program, sources);
+
+    return true;
+}
+
+void
+NullContext::deleteProgram(const uint program)
+{
+    record("deleteProgram", { double(program) });
+
+    _programShaders.erase(program);
+    _programInputs.erase(program);
+    _programSources.erase(program);
+}
+
+void
+NullContext::setProgram(const uint program)
+{
+    record("setProgram", { double(program) });
+
+    if (_currentProgram != program)
+    {
+        _currentProgram = program;
+        ++_currentFrameStats.numStateChanges;
+    }
+}
+
+void
+NullContext::compileShader(const uint shader)
+{
+    record("compileShader", { double(shader) });
+}
+
+void
+NullContext::setShaderSource(const uint shader, const std::string& source)
+{
+    record("setShaderSource", { double(shader) });
+
+    _shaderSources[shader] = source;
+}
+
+const uint
+NullContext::createVertexShader()
+{
+    record("createVertexShader");
+
+    return _nextId++;
+}
+
+void
+NullContext::deleteVertexShader(const uint vertexShader)
+{
+    record("deleteVertexShader", { double(vertexShader) });
+
+    _shaderSources.erase(vertexShader);
+}
+
+const uint
+NullContext::createFragmentShader()
+{
+    record("createFragmentShader");
+
+    return _nextId++;
+}
+
+void
+NullContext::deleteFragmentShader(const uint fragmentShader)
+{
+    record("deleteFragmentShader", { double(fragmentShader) });
+
+    _shaderSources.erase(fragmentShader);
+}
+
+std::shared_ptr<ProgramInputs>
+NullContext::getProgramInputs(const uint program)
+{
+    auto inputsIt = _programInputs.find(program);
+
+    if (inputsIt == _programInputs.end())
+        throw std::invalid_argument("program");
+
+    return inputsIt->second;
+}
+
+void
+NullContext::fillProgramInputs(const std::string&                   source,
+                               std::vector<std::string>&            names,
+                               std::vector<ProgramInputs::Type>&    types,
+                               std::vector<uint>&                   locations)
+{
+    struct Declaration
+    {
+        std::string type;
+        std::string name;
+        int         arraySize;
+    };
+
+    GLSLPreprocessor::Macros                                macros;
+    auto                                                    tokens      = GLSLPreprocessor::tokenize(GLSLPreprocessor::process(source, macros));
+    std::unordered_map<std::string, std::vector<Declaration>> structs;
+    uint                                                    numAttributes = 0;
+    uint                                                    numUniforms   = 0;
+    int                                                     depth       = 0;
+
+    for (auto i = 0u; i < names.size(); ++i)
+        if (types[i] == ProgramInputs::Type::attribute)
+            ++numAttributes;
+        else
+            ++numUniforms;
+
+    auto arraySize = [&](const std::string& token) -> int
+    {
+        return GLSLPreprocessor::evaluate(GLSLPreprocessor::tokenize(token), macros);
+    };
+
+    // reads "type name[size], name..." declarations ending with a ';'
+    auto readDeclarations = [&](uint& i, std::vector<Declaration>& declarations)
+    {
+        while (i < tokens.size() && isQualifier(tokens[i]))
+            ++i;
+        if (i >= tokens.size())
+            return;
+
+        auto type = tokens[i++];
+
+        while (i < tokens.size() && tokens[i] != ";" && tokens[i] != "}")
+        {
+            if (tokens[i] == ",")
+            {
+                ++i;
+                continue;
+            }
+
+            Declaration declaration = { type, tokens[i++], 0 };
+
+            if (i + 2 < tokens.size() && tokens[i] == "[")
+            {
+                declaration.arraySize = arraySize(tokens[i + 1]);
+                i += 3;
+            }
+            declarations.push_back(declaration);
+        }
+        if (i < tokens.size() && tokens[i] == ";")
+            ++i;
+    };
+
+    std::function<void(const std::string&, const Declaration&)> addUniform;
+
+    addUniform = [&](const std::string& name, const Declaration& declaration)
+    {
+        auto structIt = structs.find(declaration.type);
+
+        if (structIt != structs.end())
+        {
+            for (int j = 0; j < std::max(1, declaration.arraySize); ++j)
+            {
+                auto prefix = declaration.arraySize > 0 ? name + "[" + std::to_string(j) + "]" : name;
+
+                for (auto& member : structIt->second)
+                    addUniform(prefix + "." + member.name, member);
+            }
+
+            return;
+        }
+
+        auto type       = inputType(declaration.type);
+        auto inputName  = declaration.arraySize > 0 ? name + "[0]" : name;
+
+        if (type == ProgramInputs::Type::unknown
+            || std::find(names.begin(), names.end(), inputName) != names.end())
+            return;
+
+        names.push_back(inputName);
+        types.push_back(type);
+        locations.push_back(numUniforms++);
+    };
+
+    for (uint i = 0; i < tokens.size();)
+    {
+        const auto& token = tokens[i];
+
+        if (depth == 0 && token == "struct" && i + 2 < tokens.size() && tokens[i + 2] == "{")
+        {
+            auto& members = structs[tokens[i + 1]];
+
+            i += 3;
+            while (i < tokens.size() && tokens[i] != "}")
+                readDeclarations(i, members);
+            i += 2;
+        }
+        else if (depth == 0 && (token == "uniform" || token == "attribute"))
+        {
+            std::vector<Declaration> declarations;
+
+            readDeclarations(++i, declarations);
+
+            for (auto& declaration : declarations)
+            {
+                if (token == "uniform")
+                    addUniform(declaration.name, declaration);
+                else if (std::find(names.begin(), names.end(), declaration.name) == names.end())
+                {
+                    names.push_back(declaration.name);
+                    types.push_back(ProgramInputs::Type::attribute);
+                    locations.push_back(numAttributes++);
+                }
+            }
+        }
+        else
+        {
+            if (token == "{")
+                ++depth;
+            else if (token == "}")
+                --depth;
+            ++i;
+        }
+    }
+}
+
+void
+NullContext::uniform(const std::string& function, uint location, uint size)
+{
+    record(function, { double(location), double(size) });
+
+    ++_currentFrameStats.numUniforms;
+}
+
+void
+NullContext::setUniform(uint location, int value)
+{
+    uniform("setUniform", location, 1);
+}
+
+void
+NullContext::setUniform(uint location, int v1, int v2)
+{
+    uniform("setUniform", location, 1);
+}
+
+void
+NullContext::setUniform(uint location, int v1, int v2, int v3)
+{
+    uniform("setUniform", location, 1);
+}
+
+void
+NullContext::setUniform(uint location, int v1, int v2, int v3, int v4)
+{
+    uniform("setUniform", location, 1);
+}
+
+void
+NullContext::setUniform(uint location, float value)
+{
+    uniform("setUniform", location, 1);
+}
+
+void
+NullContext::setUniform(uint location, float v1, float v2)
+{
+    uniform("setUniform", location, 1);
+}
+
+void
+NullContext::setUniform(uint location, float v1, float v2, float v3)
+{
+    uniform("setUniform", location, 1);
+}
+
+void
+NullContext::setUniform(uint location, float v1, float v2, float v3, float v4)
+{
+    uniform("setUniform", location, 1);
+}
+
+void
+NullContext::setUniform(const uint& location, const uint& size, bool transpose, const float* values)
+{
+    uniform("setUniformMatrix", location, size);
+}
+
+void
+NullContext::setUniforms(uint location, uint size, const float* values)
+{
+    uniform("setUniforms", location, size);
+}
+
+void
+NullContext::setUniforms2(uint location, uint size, const float* values)
+{
+    uniform("setUniforms2", location, size);
+}
+
+void
+NullContext::setUniforms3(uint location, uint size, const float* values)
+{
+    uniform("setUniforms3", location, size);
+}
+
+void
+NullContext::setUniforms4(uint location, uint size, const float* values)
+{
+    uniform("setUniforms4", location, size);
+}
+
+void
+NullContext::setUniforms(uint location, uint size, const int* values)
+{
+    uniform("setUniforms", location, size);
+}
+
+void
+NullContext::setUniforms2(uint location, uint size, const int* values)
+{
+    uniform("setUniforms2", location, size);
+}
+
+void
+NullContext::setUniforms3(uint location, uint size, const int* values)
+{
+    uniform("setUniforms3", location, size);
+}
+
+void
+NullContext::setUniforms4(uint location, uint size, const int* values)
+{
+    uniform("setUniforms4", location, size);
+}
+
+void
+NullContext::setBlendMode(Blending::Source source, Blending::Destination destination)
+{
+    setBlendMode(static_cast<Blending::Mode>(static_cast<uint>(source) | static_cast<uint>(destination)));
+}
+
+void
+NullContext::setBlendMode(Blending::Mode blendMode)
+{
+    record("setBlendMode", { double(static_cast<int>(blendMode)) });
+
+    if (_currentBlendMode != static_cast<uint>(blendMode))
+    {
+        _currentBlendMode = static_cast<uint>(blendMode);
+        ++_currentFrameStats.numStateChanges;
+    }
+}
+
+void
+NullContext::setColorMask(bool colorMask)
+{
+    record("setColorMask", { double(colorMask) });
+
+    if (_currentColorMask != colorMask)
+    {
+        _currentColorMask = colorMask;
+        ++_currentFrameStats.numStateChanges;
+    }
+}
+
+void
+NullContext::setDepthTest(bool depthMask, CompareMode depthFunc)
+{
+    record("setDepthTest", { double(depthMask), double(static_cast<int>(depthFunc)) });
+
+    auto depthTest = std::make_pair(depthMask, depthFunc);
+
+    if (_currentDepthTest != depthTest)
+    {
+        _currentDepthTest = depthTest;
+        ++_currentFrameStats.numStateChanges;
+    }
+}
+
+void
+NullContext::setStencilTest(CompareMode         stencilFunc,
+                            int                 stencilRef,
+                            uint                stencilMask,
+                            StencilOperation    stencilFailOp,
+                            StencilOperation    stencilZFailOp,
+                            StencilOperation    stencilZPassOp)
+{
+    record("setStencilTest", {
+        double(static_cast<int>(stencilFunc)), double(stencilRef), double(stencilMask),
+        double(static_cast<int>(stencilFailOp)), double(static_cast<int>(stencilZFailOp)), double(static_cast<int>(stencilZPassOp))
+    });
+
+    StencilState stencilTest(stencilFunc, stencilRef, stencilMask, stencilFailOp, stencilZFailOp, stencilZPassOp);
+
+    if (_currentStencilTest != stencilTest)
+    {
+        _currentStencilTest = stencilTest;
+        ++_currentFrameStats.numStateChanges;
+    }
+}
+
+void
+NullContext::setScissorTest(bool scissorTest, const render::ScissorBox& scissorBox)
+{
+    record("setScissorTest", {
+        double(scissorTest), double(scissorBox.x), double(scissorBox.y), double(scissorBox.width), double(scissorBox.height)
+    });
+
+    ScissorState state(scissorTest, scissorBox.x, scissorBox.y, scissorBox.width, scissorBox.height);
+
+    if (_currentScissorTest != state)
+    {
+        _currentScissorTest = state;
+        ++_currentFrameStats.numStateChanges;
+    }
+}
+
+void
+NullContext::readPixels(unsigned char* pixels)
+{
+    readPixels(0, 0, _viewportWidth, _viewportHeight, pixels);
+}
+
+void
+NullContext::readPixels(unsigned int x, unsigned int y, unsigned int width, unsigned int height, unsigned char* pixels)
+{
+    record("readPixels", { double(x), double(y), double(width), double(height) });
+
+    std::fill(pixels, pixels + width * height * 4, 0);
+}
+
+void
+NullContext::setTriangleCulling(TriangleCulling triangleCulling)
+{
+    record("setTriangleCulling", { double(static_cast<int>(triangleCulling)) });
+
+    if (_currentTriangleCulling != triangleCulling)
+    {
+        _currentTriangleCulling = triangleCulling;
+        ++_currentFrameStats.numStateChanges;
+    }
+}
+
+void
+NullContext::setRenderToBackBuffer()
+{
+    record("setRenderToBackBuffer");
+
+    if (_currentTarget == 0)
+        return;
+
+    _currentTarget  = 0;
+    _viewportWidth  = _backBufferViewportWidth;
+    _viewportHeight = _backBufferViewportHeight;
+    ++_currentFrameStats.numStateChanges;
+}
+
+void
+NullContext::setRenderToTexture(unsigned int texture, bool enableDepthAndStencil)
+{
+    record("setRenderToTexture", { double(texture), double(enableDepthAndStencil) });
+
+    if (_currentTarget == texture)
+        return;
+
+    auto textureSizeIt = _textureSizes.find(texture);
+
+    if (textureSizeIt == _textureSizes.end())
+        throw std::invalid_argument("texture");
+
+    _currentTarget  = texture;
+    _viewportWidth  = textureSizeIt->second.first;
+    _viewportHeight = textureSizeIt->second.second;
+    ++_currentFrameStats.numStateChanges;
+}
+
+void
+NullContext::generateMipmaps(unsigned int texture)
+{
+    record("generateMipmaps", { double(texture) });
+}
@@ -0,0 +1,395 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/OpenGL3Context.hpp"
+
+#ifdef MINKO_OPENGL3_CONTEXT
+
+#include "minko/render/WrapMode.hpp"
+#include "minko/render/TextureFilter.hpp"
+#include "minko/render/MipFilter.hpp"
+
+#ifndef GL_GLEXT_PROTOTYPES
+# define GL_GLEXT_PROTOTYPES
+#endif
+
+#if MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS
+# include "GL/glew.h"
+#elif MINKO_PLATFORM == MINKO_PLATFORM_OSX
+# include <OpenGL/gl3.h>
+# include <OpenGL/gl3ext.h>
+#elif MINKO_PLATFORM == MINKO_PLATFORM_LINUX
+# include <GL/gl.h>
+# include <GL/glext.h>
+#endif
+
+using namespace minko;
+using namespace minko::render;
+
+OpenGL3Context::OpenGL3Context() :
+    OpenGLES2Context(),
+    _samplers(),
+    _currentSampler(8, 0),
+    _nextSampler(8, 0),
+    _defaultVertexArray(0),
+    _bufferSizes()
+{
+    // glGetString(GL_EXTENSIONS) is not part of the core profile: drop the error it raised
+    while (glGetError() != GL_NO_ERROR)
+        ;
+
+    // instanced arrays, timer queries and vertex arrays are core features since OpenGL 3.3
+    _instancingSupported = true;
+    _timerQueriesSupported = true;
+    _vertexArraysSupported = true;
+
+    // program binaries are core since OpenGL 4.1 only
+    if (supportsExtension("GL_ARB_get_program_binary"))
+    {
+        auto numFormats = GLint();
+
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        _programBinariesSupported = numFormats > 0;
+    }
+
+    glGenVertexArrays(1, &_defaultVertexArray);
+    glBindVertexArray(_defaultVertexArray);
+
+    checkForErrors();
+}
+
+OpenGL3Context::~OpenGL3Context()
+{
+    for (auto& sampler : _samplers)
+        glDeleteSamplers(1, &sampler.second);
+
+    glBindVertexArray(0);
+    glDeleteVertexArrays(1, &_defaultVertexArray);
+}
+
+void
+OpenGL3Context::drawTriangles(const uint indexBuffer, const int numTriangles)
+{
+    bindSamplers();
+
+    OpenGLES2Context::drawTriangles(indexBuffer, numTriangles);
+}
+
+void
+OpenGL3Context::drawInstancedTriangles(const uint indexBuffer, const int numTriangles, const int numInstances)
+{
+    bindSamplers();
+
+    if (_currentIndexBuffer != static_cast<int>(indexBuffer))
+    {
+        _currentIndexBuffer = indexBuffer;
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    }
+
+    glDrawElementsInstanced(GL_TRIANGLES, numTriangles * 3, GL_UNSIGNED_SHORT, (void*)0, numInstances);
+
+    checkForErrors();
+}
+
+void
+OpenGL3Context::setVertexArray(uint vertexArray)
+{
+    if (_currentVertexArray == vertexArray)
+        return;
+
+    _currentVertexArray = vertexArray;
+
+    glBindVertexArray(vertexArray != 0 ? vertexArray : _defaultVertexArray);
+
+    checkForErrors();
+
+    invalidateVertexState();
+}
+
+const uint
+OpenGL3Context::createVertexBuffer(const uint size)
+{
+    auto vertexBuffer = OpenGLES2Context::createVertexBuffer(size);
+
+    _bufferSizes[vertexBuffer] = size * sizeof(GLfloat);
+
+    return vertexBuffer;
+}
+
+void
+OpenGL3Context::setVertexBufferAt(const uint    position,
+                                  const uint    vertexBuffer,
+                                  const uint    size,
+                                  const uint    stride,
+                                  const uint    offset,
+                                  const uint    divisor)
+{
+    if (_currentVertexBuffer[position] == static_cast<int>(vertexBuffer)
+        && _currentVertexSize[position] == static_cast<int>(size)
+        && _currentVertexStride[position] == static_cast<int>(stride)
+        && _currentVertexOffset[position] == static_cast<int>(offset)
+        && _currentVertexDivisor[position] == divisor)
+        return;
+
+    _currentVertexBuffer[position] = vertexBuffer;
+    _currentVertexSize[position] = size;
+    _currentVertexStride[position] = stride;
+    _currentVertexOffset[position] = offset;
+
+    if (_currentVertexDivisor[position] != divisor)
+    {
+        _currentVertexDivisor[position] = divisor;
+
+        glVertexAttribDivisor(position, divisor);
+    }
+
+    if (vertexBuffer > 0)
+        glEnableVertexAttribArray(position);
+    else
+    {
+        glDisableVertexAttribArray(position);
+
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glVertexAttribPointer(
+        position,
+        size,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(GLfloat) * stride,
+        (void*)(sizeof(GLfloat) * offset)
+    );
+
+    checkForErrors();
+}
+
+void
+OpenGL3Context::uploadVertexBufferData(const uint   vertexBuffer,
+                                       const uint   offset,
+                                       const uint   size,
+                                       void*        data)
+{
+    const auto numBytes = size * sizeof(GLfloat);
+
+    if (offset != 0 || _bufferSizes[vertexBuffer] != numBytes)
+    {
+        OpenGLES2Context::uploadVertexBufferData(vertexBuffer, offset, size, data);
+
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+
+    // re-specifying the whole data store orphans the previous one: the driver does not have to wait
+    // for the draw calls still reading it to complete before the upload
+    glBufferData(GL_ARRAY_BUFFER, numBytes, data, GL_STATIC_DRAW);
+
+    checkForErrors();
+}
+
+void
+OpenGL3Context::deleteVertexBuffer(const uint vertexBuffer)
+{
+    _bufferSizes.erase(vertexBuffer);
+
+    OpenGLES2Context::deleteVertexBuffer(vertexBuffer);
+}
+
+const uint
+OpenGL3Context::createIndexBuffer(const uint size)
+{
+    auto indexBuffer = OpenGLES2Context::createIndexBuffer(size);
+
+    _bufferSizes[indexBuffer] = size * sizeof(GLushort);
+
+    return indexBuffer;
+}
+
+void
+OpenGL3Context::uploaderIndexBufferData(const uint  indexBuffer,
+                                        const uint  offset,
+                                        const uint  size,
+                                        void*       data)
+{
+    const auto numBytes = size * sizeof(GLushort);
+
+    if (offset != 0 || _bufferSizes[indexBuffer] != numBytes)
+    {
+        OpenGLES2Context::uploaderIndexBufferData(indexBuffer, offset, size, data);
+
+        return;
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    _currentIndexBuffer = indexBuffer;
+
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, numBytes, data, GL_STATIC_DRAW);
+
+    checkForErrors();
+}
+
+void
+OpenGL3Context::deleteIndexBuffer(const uint indexBuffer)
+{
+    _bufferSizes.erase(indexBuffer);
+
+    OpenGLES2Context::deleteIndexBuffer(indexBuffer);
+}
+
+void
+OpenGL3Context::setTextureAt(uint   position,
+                             int    texture,
+                             int    location)
+{
+    OpenGLES2Context::setTextureAt(position, texture, location);
+
+    // textures bound without a sampler state fall back on their own parameters, as with OpenGL ES 2.0
+    if (texture > 0 && position < _nextSampler.size())
+        _nextSampler[position] = 0;
+}
+
+void
+OpenGL3Context::setSamplerStateAt(uint          position,
+                                  WrapMode      wrapping,
+                                  TextureFilter filtering,
+                                  MipFilter     mipFiltering)
+{
+    const auto texture = _currentTexture[position];
+
+    // disable mip mapping if mip maps are not available
+    if (!_textureHasMipmaps[texture])
+        mipFiltering = MipFilter::NONE;
+
+    const auto key = (static_cast<uint>(wrapping) << 16)
+        | (static_cast<uint>(filtering) << 8)
+        | static_cast<uint>(mipFiltering);
+    auto samplerIt = _samplers.find(key);
+
+    if (samplerIt == _samplers.end())
+        samplerIt = _samplers.insert(std::make_pair(key, createSampler(wrapping, filtering, mipFiltering))).first;
+
+    _nextSampler[position] = samplerIt->second;
+}
+
+void
+OpenGL3Context::setShaderSource(const uint          shader,
+                                const std::string&  source)
+{
+    auto shaderType = GLint();
+
+    glGetShaderiv(shader, GL_SHADER_TYPE, &shaderType);
+
+    // effects are written in GLSL 1.00/1.20: map the few keywords and built-ins removed from GLSL 3.30
+    std::string src = "#version 330 core\n"
+        "#define texture2D texture\n"
+        "#define textureCube texture\n";
+
+    if (shaderType == GL_VERTEX_SHADER)
+        src += "#define attribute in\n"
+            "#define varying out\n";
+    else
+        src += "#define varying in\n"
+            "out vec4 minkoFragColor;\n"
+            "#define gl_FragColor minkoFragColor\n";
+
+    src += source;
+
+    const char* sourceString = src.c_str();
+
+    glShaderSource(shader, 1, &sourceString, 0);
+
+    checkForErrors();
+}
+
+bool
+OpenGL3Context::supportsExtension(const std::string& extensionNameString)
+{
+    auto numExtensions = GLint();
+
+    glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+
+    for (auto i = 0; i < numExtensions; ++i)
+    {
+        const auto extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+
+        if (extension != nullptr && extensionNameString == extension)
+            return true;
+    }
+
+    return false;
+}
+
+uint
+OpenGL3Context::createSampler(WrapMode      wrapping,
+                              TextureFilter filtering,
+                              MipFilter     mipFiltering)
+{
+    uint sampler;
+
+    glGenSamplers(1, &sampler);
+
+    const auto glWrap = wrapping == WrapMode::REPEAT ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, glWrap);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, glWrap);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, glWrap);
+
+    auto minFilter = GLint();
+
+    switch (mipFiltering)
+    {
+    case MipFilter::NONE :
+        minFilter = filtering == TextureFilter::NEAREST ? GL_NEAREST : GL_LINEAR;
+        break;
+    case MipFilter::NEAREST :
+        minFilter = filtering == TextureFilter::NEAREST ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_NEAREST;
+        break;
+    case MipFilter::LINEAR :
+        minFilter = filtering == TextureFilter::NEAREST ? GL_NEAREST_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_LINEAR;
+        break;
+    }
+
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, minFilter);
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, filtering == TextureFilter::NEAREST ? GL_NEAREST : GL_LINEAR);
+
+    checkForErrors();
+
+    return sampler;
+}
+
+void
+OpenGL3Context::bindSamplers()
+{
+    // sampler bindings are resolved right before drawing, so that a texture unit switching from
+    // one texture to another with the same sampler state does not rebind anything
+    for (uint position = 0; position < _nextSampler.size(); ++position)
+        if (_currentSampler[position] != _nextSampler[position])
+        {
+            _currentSampler[position] = _nextSampler[position];
+
+            glBindSampler(position, _nextSampler[position]);
+        }
+}
+
+#endif // MINKO_OPENGL3_CONTEXT
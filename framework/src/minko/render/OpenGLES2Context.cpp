@@ -69,6 +69,99 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 # include <EGL/egl.h>
 #endif
 
+// instanced arrays are an extension in OpenGL ES 2.0/WebGL and OpenGL 2.x
+#if MINKO_PLATFORM == MINKO_PLATFORM_HTML5 || (MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS && defined(MINKO_PLUGIN_ANGLE))
+# define MINKO_INSTANCED_ARRAYS_EXTENSION   "GL_ANGLE_instanced_arrays"
+# define MINKO_DRAW_INSTANCED_EXTENSION     "GL_ANGLE_instanced_arrays"
+# define glVertexAttribDivisorInstanced     glVertexAttribDivisorANGLE
+# define glDrawElementsInstancedInstanced   glDrawElementsInstancedANGLE
+#elif MINKO_PLATFORM == MINKO_PLATFORM_IOS
+# define MINKO_INSTANCED_ARRAYS_EXTENSION   "GL_EXT_instanced_arrays"
+# define MINKO_DRAW_INSTANCED_EXTENSION     "GL_EXT_instanced_arrays"
+# define glVertexAttribDivisorInstanced     glVertexAttribDivisorEXT
+# define glDrawElementsInstancedInstanced   glDrawElementsInstancedEXT
+#elif MINKO_PLATFORM == MINKO_PLATFORM_LINUX || MINKO_PLATFORM == MINKO_PLATFORM_OSX || (MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS && !defined(MINKO_PLUGIN_OFFSCREEN))
+# define MINKO_INSTANCED_ARRAYS_EXTENSION   "GL_ARB_instanced_arrays"
+# define MINKO_DRAW_INSTANCED_EXTENSION     "GL_ARB_draw_instanced"
+# define glVertexAttribDivisorInstanced     glVertexAttribDivisorARB
+# define glDrawElementsInstancedInstanced   glDrawElementsInstancedARB
+#endif
+// otherwise (Android, Windows offscreen) instancing is not supported and draw calls are never merged
+
+// GPU timer queries: ARB_timer_query on desktop OpenGL, EXT_disjoint_timer_query on OpenGL ES 2.0/WebGL
+#if MINKO_PLATFORM == MINKO_PLATFORM_LINUX || (MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS && !defined(MINKO_PLUGIN_ANGLE) && !defined(MINKO_PLUGIN_OFFSCREEN))
+# define MINKO_TIMER_QUERY_EXTENSION        "GL_ARB_timer_query"
+# define glGenQueriesTimer                  glGenQueries
+# define glDeleteQueriesTimer               glDeleteQueries
+# define glBeginQueryTimer                  glBeginQuery
+# define glEndQueryTimer                    glEndQuery
+# define glGetQueryObjectuivTimer           glGetQueryObjectuiv
+# define glGetQueryObjectui64vTimer         glGetQueryObjectui64v
+# define MINKO_GL_TIME_ELAPSED              GL_TIME_ELAPSED
+# define MINKO_GL_QUERY_RESULT_AVAILABLE    GL_QUERY_RESULT_AVAILABLE
+# define MINKO_GL_QUERY_RESULT              GL_QUERY_RESULT
+#elif MINKO_PLATFORM == MINKO_PLATFORM_OSX
+# define MINKO_TIMER_QUERY_EXTENSION        "GL_EXT_timer_query"
+# define glGenQueriesTimer                  glGenQueries
+# define glDeleteQueriesTimer               glDeleteQueries
+# define glBeginQueryTimer                  glBeginQuery
+# define glEndQueryTimer                    glEndQuery
+# define glGetQueryObjectuivTimer           glGetQueryObjectuiv
+# define glGetQueryObjectui64vTimer         glGetQueryObjectui64vEXT
+# define MINKO_GL_TIME_ELAPSED              GL_TIME_ELAPSED_EXT
+# define MINKO_GL_QUERY_RESULT_AVAILABLE    GL_QUERY_RESULT_AVAILABLE
+# define MINKO_GL_QUERY_RESULT              GL_QUERY_RESULT
+#elif defined(GL_EXT_disjoint_timer_query)
+# define MINKO_TIMER_QUERY_EXTENSION        "GL_EXT_disjoint_timer_query"
+# define MINKO_TIMER_QUERY_DISJOINT
+# define glGenQueriesTimer                  glGenQueriesEXT
+# define glDeleteQueriesTimer               glDeleteQueriesEXT
+# define glBeginQueryTimer                  glBeginQueryEXT
+# define glEndQueryTimer                    glEndQueryEXT
+# define glGetQueryObjectuivTimer           glGetQueryObjectuivEXT
+# define glGetQueryObjectui64vTimer         glGetQueryObjectui64vEXT
+# define MINKO_GL_TIME_ELAPSED              GL_TIME_ELAPSED_EXT
+# define MINKO_GL_QUERY_RESULT_AVAILABLE    GL_QUERY_RESULT_AVAILABLE_EXT
+# define MINKO_GL_QUERY_RESULT              GL_QUERY_RESULT_EXT
+#endif
+// otherwise (iOS, Windows offscreen) GPU times are not measured
+
+// vertex array objects: core in OpenGL 3.0, an extension in OpenGL 2.x, OpenGL ES 2.0 and WebGL
+#if MINKO_PLATFORM == MINKO_PLATFORM_LINUX || (MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS && !defined(MINKO_PLUGIN_ANGLE) && !defined(MINKO_PLUGIN_OFFSCREEN))
+# define MINKO_VERTEX_ARRAY_EXTENSION       "GL_ARB_vertex_array_object"
+# define glGenVertexArraysObject            glGenVertexArrays
+# define glDeleteVertexArraysObject         glDeleteVertexArrays
+# define glBindVertexArrayObject            glBindVertexArray
+#elif MINKO_PLATFORM == MINKO_PLATFORM_OSX
+# define MINKO_VERTEX_ARRAY_EXTENSION       "GL_APPLE_vertex_array_object"
+# define glGenVertexArraysObject            glGenVertexArraysAPPLE
+# define glDeleteVertexArraysObject         glDeleteVertexArraysAPPLE
+# define glBindVertexArrayObject            glBindVertexArrayAPPLE
+#elif defined(GL_OES_vertex_array_object)
+# define MINKO_VERTEX_ARRAY_EXTENSION       "GL_OES_vertex_array_object"
+# define glGenVertexArraysObject            glGenVertexArraysOES
+# define glDeleteVertexArraysObject         glDeleteVertexArraysOES
+# define glBindVertexArrayObject            glBindVertexArrayOES
+#endif
+// otherwise (Windows offscreen) vertex attributes are bound one by one for each draw call
+
+// program binaries: ARB_get_program_binary on desktop OpenGL, OES_get_program_binary on OpenGL ES 2.0
+#if MINKO_PLATFORM == MINKO_PLATFORM_LINUX || (MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS && !defined(MINKO_PLUGIN_ANGLE) && !defined(MINKO_PLUGIN_OFFSCREEN))
+# define MINKO_PROGRAM_BINARY_EXTENSION         "GL_ARB_get_program_binary"
+# define MINKO_PROGRAM_BINARY_RETRIEVABLE_HINT
+# define glGetProgramBinaryProgram              glGetProgramBinary
+# define glProgramBinaryProgram                 glProgramBinary
+# define MINKO_GL_PROGRAM_BINARY_LENGTH         GL_PROGRAM_BINARY_LENGTH
+# define MINKO_GL_NUM_PROGRAM_BINARY_FORMATS    GL_NUM_PROGRAM_BINARY_FORMATS
+#elif MINKO_PLATFORM != MINKO_PLATFORM_HTML5 && defined(GL_OES_get_program_binary)
+# define MINKO_PROGRAM_BINARY_EXTENSION         "GL_OES_get_program_binary"
+# define glGetProgramBinaryProgram              glGetProgramBinaryOES
+# define glProgramBinaryProgram                 glProgramBinaryOES
+# define MINKO_GL_PROGRAM_BINARY_LENGTH         GL_PROGRAM_BINARY_LENGTH_OES
+# define MINKO_GL_NUM_PROGRAM_BINARY_FORMATS    GL_NUM_PROGRAM_BINARY_FORMATS_OES
+#endif
+// otherwise (OS X, WebGL, Windows offscreen) programs are always compiled from their sources
+
 using namespace minko;
 using namespace minko::render;
 
@@ -152,6 +245,13 @@ OpenGLES2Context::OpenGLES2Context() :
     _currentVertexSize(8, -1),
     _currentVertexStride(8, -1),
     _currentVertexOffset(8, -1),
+    _currentVertexDivisor(8, 0),
+    _instancingSupported(false),
+    _timerQueriesSupported(false),
+    _vertexArraysSupported(false),
+    _programBinariesSupported(false),
+    _programCache(nullptr),
+    _currentVertexArray(0),
     _currentBoundTexture(0),
     _currentTexture(8, 0),
     _currentProgram(0),
@@ -168,7 +268,11 @@ OpenGLES2Context::OpenGLES2Context() :
     _currentStencilMask(0x1),
     _currentStencilFailOp(StencilOperation::UNSET),
     _currentStencilZFailOp(StencilOperation::UNSET),
-    _currentStencilZPassOp(StencilOperation::UNSET)
+    _currentStencilZPassOp(StencilOperation::UNSET),
+    _uniformValues(),
+    _currentUniformValues(nullptr),
+    _numIssuedUniformUploads(0),
+    _numSkippedUniformUploads(0)
 {
 #if (MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS) && !defined(MINKO_PLUGIN_ANGLE) && !defined(MINKO_PLUGIN_OFFSCREEN)
     glewInit();
@@ -192,6 +296,29 @@ OpenGLES2Context::OpenGLES2Context() :
         + " " + std::string(glRenderer ? glRenderer : "(unknown renderer)")
         + " " + std::string(glVersion ? glVersion : "(unknown version)");
 
+#ifdef MINKO_INSTANCED_ARRAYS_EXTENSION
+    _instancingSupported = supportsExtension(MINKO_INSTANCED_ARRAYS_EXTENSION)
+        && supportsExtension(MINKO_DRAW_INSTANCED_EXTENSION);
+#endif
+
+#ifdef MINKO_TIMER_QUERY_EXTENSION
+    _timerQueriesSupported = supportsExtension(MINKO_TIMER_QUERY_EXTENSION);
+#endif
+
+#ifdef MINKO_VERTEX_ARRAY_EXTENSION
+    _vertexArraysSupported = supportsExtension(MINKO_VERTEX_ARRAY_EXTENSION);
+#endif
+
+#ifdef MINKO_PROGRAM_BINARY_EXTENSION
+    if (supportsExtension(MINKO_PROGRAM_BINARY_EXTENSION))
+    {
+        auto numFormats = GLint();
+
+        glGetIntegerv(MINKO_GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        _programBinariesSupported = numFormats > 0;
+    }
+#endif
+
     // init. viewport x, y, width and height
     std::vector<int> viewportSettings(4);
     glGetIntegerv(GL_VIEWPORT, &viewportSettings[0]);
@@ -333,6 +460,177 @@ OpenGLES2Context::drawTriangles(const uint indexBuffer, const int numTriangles)
     checkForErrors();
 }
 
+void
+OpenGLES2Context::drawInstancedTriangles(const uint indexBuffer, const int numTriangles, const int numInstances)
+{
+    if (!_instancingSupported)
+        throw std::logic_error("instancing is not supported");
+
+#ifdef MINKO_INSTANCED_ARRAYS_EXTENSION
+    if (_currentIndexBuffer != indexBuffer)
+    {
+        _currentIndexBuffer = indexBuffer;
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    }
+
+    // https://www.khronos.org/registry/gles/extensions/ANGLE/ANGLE_instanced_arrays.txt
+    //
+    // void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei primcount);
+    // primcount Specifies the number of instances of the specified range of elements to be rendered.
+    //
+    // behaves as primcount calls to glDrawElements, instanced attributes advancing once every divisor instances
+    glDrawElementsInstancedInstanced(GL_TRIANGLES, numTriangles * 3, GL_UNSIGNED_SHORT, (void*)0, numInstances);
+
+    checkForErrors();
+#endif
+}
+
+uint
+OpenGLES2Context::createTimerQuery()
+{
+    if (!_timerQueriesSupported)
+        throw std::logic_error("timer queries are not supported");
+
+    uint query = 0;
+
+#ifdef MINKO_TIMER_QUERY_EXTENSION
+    glGenQueriesTimer(1, &query);
+
+    checkForErrors();
+#endif
+
+    return query;
+}
+
+void
+OpenGLES2Context::deleteTimerQuery(uint query)
+{
+#ifdef MINKO_TIMER_QUERY_EXTENSION
+    glDeleteQueriesTimer(1, &query);
+
+    checkForErrors();
+#endif
+}
+
+void
+OpenGLES2Context::beginTimerQuery(uint query)
+{
+#ifdef MINKO_TIMER_QUERY_EXTENSION
+    // only one GL_TIME_ELAPSED query can be active at a time: queries cannot be nested
+    glBeginQueryTimer(MINKO_GL_TIME_ELAPSED, query);
+
+    checkForErrors();
+#endif
+}
+
+void
+OpenGLES2Context::endTimerQuery()
+{
+#ifdef MINKO_TIMER_QUERY_EXTENSION
+    glEndQueryTimer(MINKO_GL_TIME_ELAPSED);
+
+    checkForErrors();
+#endif
+}
+
+bool
+OpenGLES2Context::timerQueryAvailable(uint query)
+{
+    GLuint available = GL_FALSE;
+
+#ifdef MINKO_TIMER_QUERY_EXTENSION
+    glGetQueryObjectuivTimer(query, MINKO_GL_QUERY_RESULT_AVAILABLE, &available);
+
+    checkForErrors();
+#endif
+
+    return available != GL_FALSE;
+}
+
+float
+OpenGLES2Context::timerQueryResult(uint query)
+{
+    uint64_t elapsed = 0;
+
+#ifdef MINKO_TIMER_QUERY_EXTENSION
+# ifdef MINKO_TIMER_QUERY_DISJOINT
+    GLint disjoint = GL_FALSE;
+
+    // a disjoint operation (ex: frequency change) happened since the last check: timings are meaningless
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+    if (disjoint)
+        return -1.f;
+# endif
+
+    glGetQueryObjectui64vTimer(query, MINKO_GL_QUERY_RESULT, &elapsed);
+
+    checkForErrors();
+#endif
+
+    return float(elapsed / 1000) / 1000.f;
+}
+
+uint
+OpenGLES2Context::createVertexArray()
+{
+    if (!_vertexArraysSupported)
+        throw std::logic_error("vertex arrays are not supported");
+
+    uint vertexArray = 0;
+
+#ifdef MINKO_VERTEX_ARRAY_EXTENSION
+    glGenVertexArraysObject(1, &vertexArray);
+
+    checkForErrors();
+#endif
+
+    return vertexArray;
+}
+
+void
+OpenGLES2Context::deleteVertexArray(uint vertexArray)
+{
+    if (_currentVertexArray == vertexArray)
+        setVertexArray(0);
+
+#ifdef MINKO_VERTEX_ARRAY_EXTENSION
+    glDeleteVertexArraysObject(1, &vertexArray);
+
+    checkForErrors();
+#endif
+}
+
+void
+OpenGLES2Context::setVertexArray(uint vertexArray)
+{
+    if (_currentVertexArray == vertexArray)
+        return;
+
+    _currentVertexArray = vertexArray;
+
+#ifdef MINKO_VERTEX_ARRAY_EXTENSION
+    glBindVertexArrayObject(vertexArray);
+
+    checkForErrors();
+#endif
+
+    invalidateVertexState();
+}
+
+void
+OpenGLES2Context::invalidateVertexState()
+{
+    // the attribute and index buffer bindings are part of the vertex array state: what was cached
+    // does not hold anymore
+    _currentIndexBuffer = -1;
+    std::fill(_currentVertexBuffer.begin(), _currentVertexBuffer.end(), -1);
+    std::fill(_currentVertexSize.begin(), _currentVertexSize.end(), -1);
+    std::fill(_currentVertexStride.begin(), _currentVertexStride.end(), -1);
+    std::fill(_currentVertexOffset.begin(), _currentVertexOffset.end(), -1);
+    std::fill(_currentVertexDivisor.begin(), _currentVertexDivisor.end(), -1);
+}
+
 const uint
 OpenGLES2Context::createVertexBuffer(const uint size)
 {
@@ -427,14 +725,16 @@ OpenGLES2Context::setVertexBufferAt(const uint    position,
                                     const uint    vertexBuffer,
                                     const uint    size,
                                     const uint    stride,
-                                    const uint    offset)
+                                    const uint    offset,
+                                    const uint    divisor)
 {
     auto currentVertexBuffer = _currentVertexBuffer[position];
 
     if (currentVertexBuffer == vertexBuffer
         && _currentVertexSize[position] == size
         && _currentVertexStride[position] == stride
-        && _currentVertexOffset[position] == position)
+        && _currentVertexOffset[position] == offset
+        && _currentVertexDivisor[position] == divisor)
         return ;
 
     _currentVertexBuffer[position] = vertexBuffer;
@@ -442,6 +742,16 @@ OpenGLES2Context::setVertexBufferAt(const uint    position,
     _currentVertexStride[position] = stride;
     _currentVertexOffset[position] = offset;
 
+#ifdef MINKO_INSTANCED_ARRAYS_EXTENSION
+    if (_instancingSupported && _currentVertexDivisor[position] != divisor)
+    {
+        _currentVertexDivisor[position] = divisor;
+
+        // https://www.khronos.org/registry/gles/extensions/ANGLE/ANGLE_instanced_arrays.txt
+        glVertexAttribDivisorInstanced(position, divisor);
+    }
+#endif
+
     if (vertexBuffer > 0)
         glEnableVertexAttribArray(position);
     else
@@ -980,8 +1290,18 @@ OpenGLES2Context::attachShader(const uint program, const uint shader)
 void
 OpenGLES2Context::linkProgram(const uint program)
 {
+#ifdef MINKO_PROGRAM_BINARY_RETRIEVABLE_HINT
+    // some drivers only keep the binary of the programs flagged before they are linked
+    if (_programBinariesSupported && _programCache != nullptr)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+
     glLinkProgram(program);
 
+    // linking resets all the uniforms of the program to their default values
+    if (_uniformValues.count(program))
+        _uniformValues[program].clear();
+
 #ifdef DEBUG
     auto errors = getProgramInfoLogs(program);
 
@@ -999,6 +1319,12 @@ OpenGLES2Context::deleteProgram(const uint program)
 {
     _programs.erase(std::find(_programs.begin(), _programs.end(), program));
 
+    // the driver may give the same name to the next program: setProgram() must not see it as current
+    if (_currentProgram == program)
+        setProgram(0);
+
+    _uniformValues.erase(program);
+
     glDeleteProgram(program);
 
     checkForErrors();
@@ -1034,6 +1360,7 @@ OpenGLES2Context::setProgram(const uint program)
         return;
 
     _currentProgram = program;
+    _currentUniformValues = &_uniformValues[program];
 
     glUseProgram(program);
 
@@ -1280,6 +1607,67 @@ OpenGLES2Context::getShaderCompilationLogs(const uint shader)
     return std::string();
 }
 
+bool
+OpenGLES2Context::getProgramBinary(const uint program, uint& format, std::vector<unsigned char>& binary)
+{
+#ifdef MINKO_PROGRAM_BINARY_EXTENSION
+    if (!_programBinariesSupported)
+        return false;
+
+    auto linked = GLint();
+    auto length = GLint();
+
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    glGetProgramiv(program, MINKO_GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if (linked != GL_TRUE || length <= 0)
+        return false;
+
+    auto binaryFormat = GLenum();
+
+    binary.resize(length);
+    glGetProgramBinaryProgram(program, length, &length, &binaryFormat, &binary[0]);
+    binary.resize(length);
+    format = binaryFormat;
+
+    checkForErrors();
+
+    return length > 0;
+#else
+    return false;
+#endif
+}
+
+bool
+OpenGLES2Context::loadProgramBinary(const uint program, const uint format, const std::vector<unsigned char>& binary)
+{
+#ifdef MINKO_PROGRAM_BINARY_EXTENSION
+    if (!_programBinariesSupported || binary.empty())
+        return false;
+
+    glProgramBinaryProgram(program, format, &binary[0], binary.size());
+
+    // a format the driver does not know anymore raises an error instead of failing the link
+    while (glGetError() != GL_NO_ERROR)
+        ;
+
+    auto linked = GLint();
+
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+    if (linked != GL_TRUE)
+        return false;
+
+    // loading a binary links the program: its uniforms get back to their default values
+    if (_uniformValues.count(program))
+        _uniformValues[program].clear();
+
+    return true;
+#else
+    return false;
+#endif
+}
+
 std::string
 OpenGLES2Context::getProgramInfoLogs(const uint program)
 {
@@ -1301,6 +1689,11 @@ OpenGLES2Context::getProgramInfoLogs(const uint program)
 void
 OpenGLES2Context::setUniform(uint location, int value)
 {
+    const int values[] = { value };
+
+    if (!uniformValuesChanged(location, values, 1))
+        return;
+
     glUniform1i(location, value);
     checkForErrors();
 }
@@ -1308,6 +1701,11 @@ OpenGLES2Context::setUniform(uint location, int value)
 void
 OpenGLES2Context::setUniform(uint location, int v1, int v2)
 {
+    const int values[] = { v1, v2 };
+
+    if (!uniformValuesChanged(location, values, 2))
+        return;
+
     glUniform2i(location, v1, v2);
     checkForErrors();
 }
@@ -1315,6 +1713,11 @@ OpenGLES2Context::setUniform(uint location, int v1, int v2)
 void
 OpenGLES2Context::setUniform(uint location, int v1, int v2, int v3)
 {
+    const int values[] = { v1, v2, v3 };
+
+    if (!uniformValuesChanged(location, values, 3))
+        return;
+
     glUniform3i(location, v1, v2, v3);
     checkForErrors();
 }
@@ -1322,6 +1725,11 @@ OpenGLES2Context::setUniform(uint location, int v1, int v2, int v3)
 void
 OpenGLES2Context::setUniform(uint location, int v1, int v2, int v3, int v4)
 {
+    const int values[] = { v1, v2, v3, v4 };
+
+    if (!uniformValuesChanged(location, values, 4))
+        return;
+
     glUniform4i(location, v1, v2, v3, v4);
     checkForErrors();
 }
@@ -1329,6 +1737,11 @@ OpenGLES2Context::setUniform(uint location, int v1, int v2, int v3, int v4)
 void
 OpenGLES2Context::setUniform(uint location, float value)
 {
+    const float values[] = { value };
+
+    if (!uniformValuesChanged(location, values, 1))
+        return;
+
     glUniform1f(location, value);
     checkForErrors();
 }
@@ -1336,6 +1749,11 @@ OpenGLES2Context::setUniform(uint location, float value)
 void
 OpenGLES2Context::setUniform(uint location, float v1, float v2)
 {
+    const float values[] = { v1, v2 };
+
+    if (!uniformValuesChanged(location, values, 2))
+        return;
+
     glUniform2f(location, v1, v2);
     checkForErrors();
 }
@@ -1343,6 +1761,11 @@ OpenGLES2Context::setUniform(uint location, float v1, float v2)
 void
 OpenGLES2Context::setUniform(uint location, float v1, float v2, float v3)
 {
+    const float values[] = { v1, v2, v3 };
+
+    if (!uniformValuesChanged(location, values, 3))
+        return;
+
     glUniform3f(location, v1, v2, v3);
     checkForErrors();
 }
@@ -1350,6 +1773,11 @@ OpenGLES2Context::setUniform(uint location, float v1, float v2, float v3)
 void
 OpenGLES2Context::setUniform(uint location, float v1, float v2, float v3, float v4)
 {
+    const float values[] = { v1, v2, v3, v4 };
+
+    if (!uniformValuesChanged(location, values, 4))
+        return;
+
     glUniform4f(location, v1, v2, v3, v4);
     checkForErrors();
 }
@@ -1357,6 +1785,9 @@ OpenGLES2Context::setUniform(uint location, float v1, float v2, float v3, float
 void
 OpenGLES2Context::setUniforms(uint location, uint size, const float* values)
 {
+    if (!uniformValuesChanged(location, values, size))
+        return;
+
     glUniform1fv(location, size, values);
     checkForErrors();
 }
@@ -1364,6 +1795,9 @@ OpenGLES2Context::setUniforms(uint location, uint size, const float* values)
 void
 OpenGLES2Context::setUniforms2(uint location, uint size, const float* values)
 {
+    if (!uniformValuesChanged(location, values, size * 2))
+        return;
+
     glUniform2fv(location, size, values);
     checkForErrors();
 }
@@ -1371,6 +1805,9 @@ OpenGLES2Context::setUniforms2(uint location, uint size, const float* values)
 void
 OpenGLES2Context::setUniforms3(uint location, uint size, const float* values)
 {
+    if (!uniformValuesChanged(location, values, size * 3))
+        return;
+
     glUniform3fv(location, size, values);
     checkForErrors();
 }
@@ -1378,6 +1815,9 @@ OpenGLES2Context::setUniforms3(uint location, uint size, const float* values)
 void
 OpenGLES2Context::setUniforms4(uint location, uint size, const float* values)
 {
+    if (!uniformValuesChanged(location, values, size * 4))
+        return;
+
     glUniform4fv(location, size, values);
     checkForErrors();
 }
@@ -1385,6 +1825,9 @@ OpenGLES2Context::setUniforms4(uint location, uint size, const float* values)
 void
 OpenGLES2Context::setUniforms(uint location, uint size, const int* values)
 {
+    if (!uniformValuesChanged(location, values, size))
+        return;
+
     glUniform1iv(location, size, values);
     checkForErrors();
 }
@@ -1392,6 +1835,9 @@ OpenGLES2Context::setUniforms(uint location, uint size, const int* values)
 void
 OpenGLES2Context::setUniforms2(uint location, uint size, const int* values)
 {
+    if (!uniformValuesChanged(location, values, size * 2))
+        return;
+
     glUniform2iv(location, size, values);
     checkForErrors();
 }
@@ -1399,6 +1845,9 @@ OpenGLES2Context::setUniforms2(uint location, uint size, const int* values)
 void
 OpenGLES2Context::setUniforms3(uint location, uint size, const int* values)
 {
+    if (!uniformValuesChanged(location, values, size * 3))
+        return;
+
     glUniform3iv(location, size, values);
     checkForErrors();
 }
@@ -1406,6 +1855,9 @@ OpenGLES2Context::setUniforms3(uint location, uint size, const int* values)
 void
 OpenGLES2Context::setUniforms4(uint location, uint size, const int* values)
 {
+    if (!uniformValuesChanged(location, values, size * 4))
+        return;
+
     glUniform4iv(location, size, values);
     checkForErrors();
 }
@@ -1413,6 +1865,9 @@ OpenGLES2Context::setUniforms4(uint location, uint size, const int* values)
 void
 OpenGLES2Context::setUniform(const uint& location, const uint& size, bool transpose, const float* values)
 {
+    if (!uniformValuesChanged(location, values, size << 4, transpose))
+        return;
+
 #ifdef GL_ES_VERSION_2_0
 
     if (transpose)
@@ -1741,6 +2196,37 @@ OpenGLES2Context::createRTTBuffers(TextureType    type,
     checkForErrors();
 }
 
+bool
+OpenGLES2Context::uniformValuesChanged(uint         location,
+                                       const void*  values,
+                                       uint         numValues,
+                                       int          tag)
+{
+    if (_currentUniformValues == nullptr)
+        _currentUniformValues = &_uniformValues[_currentProgram];
+
+    // the first slot stores the tag (ie. the transposition flag of matrices)
+    auto&       shadow  = (*_currentUniformValues)[location];
+    const auto  data    = static_cast<const int*>(values);
+
+    if (shadow.size() == numValues + 1
+        && shadow[0] == tag
+        && std::memcmp(shadow.data() + 1, data, numValues * sizeof(int)) == 0)
+    {
+        ++_numSkippedUniformUploads;
+
+        return false;
+    }
+
+    shadow.resize(numValues + 1);
+    shadow[0] = tag;
+    std::memcpy(shadow.data() + 1, data, numValues * sizeof(int));
+
+    ++_numIssuedUniformUploads;
+
+    return true;
+}
+
 uint
 OpenGLES2Context::getError()
 {
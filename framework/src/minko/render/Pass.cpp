@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/DrawCall.hpp"
 #include "minko/render/States.hpp"
 #include "minko/render/ProgramSignature.hpp"
+#include "minko/render/ProgramCache.hpp"
 
 using namespace minko;
 using namespace minko::render;
@@ -47,6 +48,7 @@ Pass::Pass(const std::string&        name,
     _states(states),
     _fallback(fallback),
     _signatureToProgram(),
+    _programToInstancedProgram(),
     _uniformFunctions(),
     _attributeFunctions(),
     _indexFunction(nullptr),
@@ -124,6 +126,62 @@ Pass::selectProgram(FormatNameFunction        formatNameFunc,
     return finalizeProgram(program);
 }
 
+Program::Ptr
+Pass::warmUp(FormatNameFunction    formatNameFunc,
+             Container::Ptr        targetData,
+             Container::Ptr        rendererData,
+             Container::Ptr        rootData)
+{
+    std::list<std::string>    booleanMacros;
+    std::list<std::string>    integerMacros;
+    std::list<std::string>    incorrectIntegerMacros;
+
+    return selectProgram(
+        formatNameFunc,
+        targetData,
+        rendererData,
+        rootData,
+        booleanMacros,
+        integerMacros,
+        incorrectIntegerMacros
+    );
+}
+
+Program::Ptr
+Pass::instancedProgram(Program::Ptr program)
+{
+    const auto foundProgramIt = _programToInstancedProgram.find(program);
+
+    if (foundProgramIt != _programToInstancedProgram.end())
+        return foundProgramIt->second;
+
+    auto vs = Shader::create(
+        program->context(),
+        Shader::Type::VERTEX_SHADER,
+        "#define INSTANCING\n" + program->vertexShader()->source()
+    );
+    auto fs = Shader::create(
+        program->context(),
+        Shader::Type::FRAGMENT_SHADER,
+        "#define INSTANCING\n" + program->fragmentShader()->source()
+    );
+
+    Program::Ptr instancedProgram = Program::create(program->context(), vs, fs);
+
+    try
+    {
+        instancedProgram = finalizeProgram(instancedProgram);
+    }
+    catch (std::exception&)
+    {
+        instancedProgram = nullptr;
+    }
+
+    _programToInstancedProgram[program] = instancedProgram;
+
+    return instancedProgram;
+}
+
 Program::Ptr
 Pass::finalizeProgram(Program::Ptr program)
 {
@@ -131,13 +189,23 @@ Pass::finalizeProgram(Program::Ptr program)
     {
         try
         {
-            if (!program->vertexShader()->isReady())
-                program->vertexShader()->upload();
-            if (!program->fragmentShader()->isReady())
-                program->fragmentShader()->upload();
             if (!program->isReady())
             {
-                program->upload();
+                auto programCache = program->context()->programCache();
+
+                // a cached binary spares compiling the shaders
+                if (programCache == nullptr || !programCache->load(program))
+                {
+                    if (!program->vertexShader()->isReady())
+                        program->vertexShader()->upload();
+                    if (!program->fragmentShader()->isReady())
+                        program->fragmentShader()->upload();
+
+                    program->upload();
+
+                    if (programCache != nullptr)
+                        programCache->store(program);
+                }
 
                 for (auto& func : _uniformFunctions)
                     func(program);
@@ -54,6 +54,24 @@ Program::upload()
     _inputs = _context->getProgramInputs(_id);
 }
 
+bool
+Program::upload(uint binaryFormat, const std::vector<unsigned char>& binary)
+{
+    _id = context()->createProgram();
+
+    if (!_context->loadProgramBinary(_id, binaryFormat, binary))
+    {
+        _context->deleteProgram(_id);
+        _id = -1;
+
+        return false;
+    }
+
+    _inputs = _context->getProgramInputs(_id);
+
+    return true;
+}
+
 void
 Program::dispose()
 {
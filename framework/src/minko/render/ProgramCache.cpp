@@ -0,0 +1,176 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/ProgramCache.hpp"
+
+#include "minko/render/AbstractContext.hpp"
+#include "minko/render/Program.hpp"
+#include "minko/render/Shader.hpp"
+
+#include <iomanip>
+
+using namespace minko;
+using namespace minko::render;
+
+/*static*/ const uint ProgramCache::MAGIC        = 0x42504b4d; // "MKPB"
+/*static*/ const uint ProgramCache::VERSION      = 1;
+/*static*/ const uint64_t ProgramCache::KEY_SEED     = 14695981039346656037ull;
+/*static*/ const uint64_t ProgramCache::CHECK_SEED   = 0x84222325cbf29ce4ull;
+
+ProgramCache::ProgramCache(const std::string& directory) :
+    _directory(directory),
+    _numHits(0),
+    _numMisses(0),
+    _numRejected(0)
+{
+    if (!_directory.empty() && _directory.back() != '/' && _directory.back() != '\\')
+        _directory += '/';
+}
+
+/*static*/
+uint64_t
+ProgramCache::hash(const unsigned char* data, uint size, uint64_t value)
+{
+    for (uint i = 0; i < size; ++i)
+        value = (value ^ data[i]) * 1099511628211ull;
+
+    return value;
+}
+
+uint64_t
+ProgramCache::key(ProgramPtr program, uint64_t seed) const
+{
+    // a binary is only valid for the driver that produced it
+    const std::string* strings[] = {
+        &program->context()->driverInfo(),
+        &program->vertexShader()->source(),
+        &program->fragmentShader()->source()
+    };
+    const unsigned char separator = 0;
+
+    for (auto string : strings)
+    {
+        seed = hash(reinterpret_cast<const unsigned char*>(string->data()), string->size(), seed);
+        seed = hash(&separator, 1, seed);
+    }
+
+    return seed;
+}
+
+std::string
+ProgramCache::filename(ProgramPtr program) const
+{
+    std::stringstream stream;
+
+    stream << _directory << std::hex << std::setw(16) << std::setfill('0') << key(program, KEY_SEED) << ".bin";
+
+    return stream.str();
+}
+
+bool
+ProgramCache::load(ProgramPtr program)
+{
+    if (!program->context()->supportsProgramBinaries())
+        return false;
+
+    const auto      filename    = this->filename(program);
+    std::ifstream   file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+
+    if (!file.is_open())
+    {
+        ++_numMisses;
+
+        return false;
+    }
+
+    const uint64_t              fileSize    = file.tellg();
+    uint                        magic       = 0;
+    uint                        version     = 0;
+    uint64_t                    check       = 0;
+    uint                        format      = 0;
+    uint                        size        = 0;
+    uint64_t                    checksum    = 0;
+    std::vector<unsigned char>  binary;
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&check), sizeof(check));
+    file.read(reinterpret_cast<char*>(&format), sizeof(format));
+    file.read(reinterpret_cast<char*>(&size), sizeof(size));
+    file.read(reinterpret_cast<char*>(&checksum), sizeof(checksum));
+
+    bool valid = file.good()
+        && magic == MAGIC
+        && version == VERSION
+        && check == key(program, CHECK_SEED)
+        && size > 0
+        && size <= fileSize - file.tellg();
+
+    if (valid)
+    {
+        binary.resize(size);
+        file.read(reinterpret_cast<char*>(&binary[0]), size);
+
+        valid = file.good() && hash(&binary[0], size, KEY_SEED) == checksum;
+    }
+
+    file.close();
+
+    if (valid && program->upload(format, binary))
+    {
+        ++_numHits;
+
+        return true;
+    }
+
+    ++_numRejected;
+    std::remove(filename.c_str());
+
+    return false;
+}
+
+void
+ProgramCache::store(ProgramPtr program)
+{
+    auto                        context = program->context();
+    uint                        format  = 0;
+    std::vector<unsigned char>  binary;
+
+    if (!context->supportsProgramBinaries() || !context->getProgramBinary(program->id(), format, binary) || binary.empty())
+        return;
+
+    std::ofstream file(filename(program), std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+        return;
+
+    const uint      size        = binary.size();
+    const uint64_t  check       = key(program, CHECK_SEED);
+    const uint64_t  checksum    = hash(&binary[0], size, KEY_SEED);
+
+    file.write(reinterpret_cast<const char*>(&MAGIC), sizeof(MAGIC));
+    file.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+    file.write(reinterpret_cast<const char*>(&check), sizeof(check));
+    file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    file.write(reinterpret_cast<const char*>(&binary[0]), size);
+}
@@ -62,7 +62,7 @@ ProgramSignature::build(Pass::Ptr                pass,
         const auto&    macroName        = macroBinding.first;
         auto        macroDefault    = macroBinding.second;
 
-        const auto& propertyName    = formatNameFunc(std::get<0>(macroDefault));
+        const data::PropertyName propertyName = formatNameFunc(std::get<0>(macroDefault));
         auto        source            = std::get<1>(macroDefault);
         auto        container        = source == BindingSource::TARGET
             ? targetData
@@ -77,7 +77,7 @@ ProgramSignature::build(Pass::Ptr                pass,
         {
             // no explicit definition
             macroExists        = container->hasProperty(propertyName);
-            isMacroInteger    = macroExists && container->propertyHasType<int>(propertyName, true);
+            isMacroInteger    = macroExists && container->propertyHasType<int>(propertyName);
             defaultMacro    = std::get<2>(macroBinding.second);
         }
         else
@@ -0,0 +1,365 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/RenderGraph.hpp"
+
+#include "minko/render/Texture.hpp"
+#include "minko/component/Renderer.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+RenderGraph::RenderGraph(AbsContextPtr context) :
+    _context(context),
+    _passes(),
+    _targets(),
+    _invalid(true),
+    _schedule(),
+    _targetTextures(),
+    _textures(),
+    _compiled(Signal<Ptr>::create())
+{
+    if (!context)
+        throw std::invalid_argument("context");
+}
+
+RenderGraph::Ptr
+RenderGraph::target(const std::string&  name,
+                    uint                width,
+                    uint                height,
+                    TextureFormat       format)
+{
+    if (name.empty())
+        throw std::invalid_argument("name");
+
+    auto& target = _targets[name];
+
+    target.width = width;
+    target.height = height;
+    target.format = format;
+
+    _invalid = true;
+
+    return shared_from_this();
+}
+
+RenderGraph::Ptr
+RenderGraph::output(const std::string& name)
+{
+    auto targetIt = _targets.find(name);
+
+    if (targetIt == _targets.end())
+        throw std::invalid_argument("name");
+
+    targetIt->second.output = true;
+    _invalid = true;
+
+    return shared_from_this();
+}
+
+RenderGraph::Ptr
+RenderGraph::pass(const std::string&                name,
+                  const std::vector<std::string>&   reads,
+                  const std::string&                write,
+                  const ExecuteFunction&            execute)
+{
+    // a texture cannot be sampled while it is being rendered to
+    if (std::find(reads.begin(), reads.end(), write) != reads.end())
+        throw std::invalid_argument("reads");
+
+    PassDescription pass;
+
+    pass.name = name;
+    pass.reads = reads;
+    pass.write = write;
+    pass.execute = execute;
+
+    _passes.push_back(pass);
+
+    _invalid = true;
+
+    return shared_from_this();
+}
+
+RenderGraph::Ptr
+RenderGraph::pass(RendererPtr                       renderer,
+                  const std::vector<std::string>&   reads,
+                  const std::string&                write)
+{
+    if (!renderer)
+        throw std::invalid_argument("renderer");
+
+    // the target of the renderer would take precedence over the one of the graph
+    if (renderer->target())
+        throw std::invalid_argument("renderer");
+
+    renderer->autoRender(false);
+
+    return pass(renderer->name(), reads, write, [=](AbsContextPtr context, TexturePtr target)
+    {
+        renderer->render(context, target);
+    });
+}
+
+void
+RenderGraph::clear()
+{
+    _passes.clear();
+    _targets.clear();
+    _schedule.clear();
+    _targetTextures.clear();
+    _textures.clear();
+    _invalid = true;
+}
+
+RenderGraph::TexturePtr
+RenderGraph::texture(const std::string& name)
+{
+    if (_invalid)
+        compile();
+
+    auto textureIt = _targetTextures.find(name);
+
+    return textureIt != _targetTextures.end() ? textureIt->second : nullptr;
+}
+
+std::vector<std::string>
+RenderGraph::schedule()
+{
+    if (_invalid)
+        compile();
+
+    std::vector<std::string> names;
+
+    for (auto passIndex : _schedule)
+        names.push_back(_passes[passIndex].name);
+
+    return names;
+}
+
+void
+RenderGraph::compile()
+{
+    for (const auto& pass : _passes)
+    {
+        if (!pass.write.empty() && _targets.count(pass.write) == 0)
+            throw std::invalid_argument("render target '" + pass.write + "' is not declared");
+
+        for (const auto& read : pass.reads)
+        {
+            auto isWritten = std::any_of(_passes.begin(), _passes.end(), [&](const PassDescription& p)
+            {
+                return p.write == read;
+            });
+
+            if (read.empty() || _targets.count(read) == 0 || !isWritten)
+                throw std::logic_error("render target '" + read + "' is read but never written");
+        }
+    }
+
+    const auto order = sortPasses();
+    const auto live = findLivePasses();
+
+    _schedule.clear();
+    for (auto passIndex : order)
+        if (live[passIndex])
+            _schedule.push_back(passIndex);
+
+    assignTextures();
+
+    _invalid = false;
+
+    _compiled->execute(shared_from_this());
+}
+
+void
+RenderGraph::execute()
+{
+    if (_invalid)
+        compile();
+
+    for (auto passIndex : _schedule)
+    {
+        const auto& pass = _passes[passIndex];
+
+        pass.execute(_context, pass.write.empty() ? nullptr : _targetTextures[pass.write]);
+    }
+}
+
+std::vector<uint>
+RenderGraph::sortPasses()
+{
+    const uint numPasses = _passes.size();
+
+    std::vector<std::vector<uint>>  successors(numPasses);
+    std::vector<uint>               numPredecessors(numPasses, 0);
+
+    // a pass depends on the passes writing what it reads, and on the passes declared before it
+    // writing the same target
+    for (uint i = 0; i < numPasses; ++i)
+        for (uint j = 0; j < numPasses; ++j)
+        {
+            if (i == j)
+                continue;
+
+            const auto& write = _passes[i].write;
+            const auto& reads = _passes[j].reads;
+
+            if ((i < j && write == _passes[j].write) || std::find(reads.begin(), reads.end(), write) != reads.end())
+            {
+                successors[i].push_back(j);
+                ++numPredecessors[j];
+            }
+        }
+
+    // topological sort, ties are broken with the declaration order
+    std::set<uint>      ready;
+    std::vector<uint>   order;
+
+    for (uint i = 0; i < numPasses; ++i)
+        if (numPredecessors[i] == 0)
+            ready.insert(i);
+
+    while (!ready.empty())
+    {
+        auto passIndex = *ready.begin();
+
+        ready.erase(ready.begin());
+        order.push_back(passIndex);
+
+        for (auto successor : successors[passIndex])
+            if (--numPredecessors[successor] == 0)
+                ready.insert(successor);
+    }
+
+    if (order.size() != numPasses)
+        throw std::logic_error("render passes have circular dependencies");
+
+    return order;
+}
+
+std::vector<bool>
+RenderGraph::findLivePasses()
+{
+    const uint numPasses = _passes.size();
+
+    std::vector<bool>   live(numPasses, false);
+    std::vector<uint>   toVisit;
+
+    for (uint i = 0; i < numPasses; ++i)
+    {
+        const auto& write = _passes[i].write;
+
+        if (write.empty() || _targets[write].output)
+        {
+            live[i] = true;
+            toVisit.push_back(i);
+        }
+    }
+
+    while (!toVisit.empty())
+    {
+        auto passIndex = toVisit.back();
+
+        toVisit.pop_back();
+
+        for (const auto& read : _passes[passIndex].reads)
+            for (uint i = 0; i < numPasses; ++i)
+                if (!live[i] && _passes[i].write == read)
+                {
+                    live[i] = true;
+                    toVisit.push_back(i);
+                }
+    }
+
+    return live;
+}
+
+void
+RenderGraph::assignTextures()
+{
+    // first and last positions in the schedule where each target is used
+    std::unordered_map<std::string, std::pair<uint, uint>> lifetimes;
+
+    for (uint position = 0; position < _schedule.size(); ++position)
+    {
+        const auto& pass = _passes[_schedule[position]];
+        auto names = pass.reads;
+
+        if (!pass.write.empty())
+            names.push_back(pass.write);
+
+        for (const auto& name : names)
+        {
+            auto lifetimeIt = lifetimes.find(name);
+
+            if (lifetimeIt == lifetimes.end())
+                lifetimes[name] = std::make_pair(position, position);
+            else
+                lifetimeIt->second.second = position;
+        }
+    }
+
+    // the textures of the previous compilation are reused first, the ones left unused are released
+    std::list<TexturePtr>   available(_textures.begin(), _textures.end());
+    std::vector<TexturePtr> textures;
+
+    _targetTextures.clear();
+
+    for (uint position = 0; position < _schedule.size(); ++position)
+    {
+        for (const auto& lifetime : lifetimes)
+        {
+            if (lifetime.second.first != position)
+                continue;
+
+            const auto& target = _targets[lifetime.first];
+            auto textureIt = std::find_if(available.begin(), available.end(), [&](TexturePtr texture)
+            {
+                return texture->originalWidth() == target.width
+                    && texture->originalHeight() == target.height
+                    && texture->format() == target.format;
+            });
+            TexturePtr texture;
+
+            if (textureIt != available.end())
+            {
+                texture = *textureIt;
+                available.erase(textureIt);
+            }
+            else
+            {
+                texture = Texture::create(_context, target.width, target.height, false, true, true, target.format);
+                texture->upload();
+            }
+
+            if (std::find(textures.begin(), textures.end(), texture) == textures.end())
+                textures.push_back(texture);
+
+            _targetTextures[lifetime.first] = texture;
+        }
+
+        for (const auto& lifetime : lifetimes)
+            if (lifetime.second.second == position && !_targets[lifetime.first].output)
+                available.push_back(_targetTextures[lifetime.first]);
+    }
+
+    _textures = textures;
+}
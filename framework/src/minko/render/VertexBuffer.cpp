@@ -82,8 +82,8 @@ VertexBuffer::upload(uint offset, uint numVertices)
     _context->uploadVertexBufferData(
         _id,
         offset * _vertexSize,
-        numVertices == 0 ? _data.size() : numVertices * _vertexSize,
-        &_data[0]
+        numVertices == 0 ? _data.size() - offset * _vertexSize : numVertices * _vertexSize,
+        &_data[offset * _vertexSize]
     );
 
     //updatePositionBounds();
@@ -48,6 +48,7 @@ namespace minko
         SDLOffscreenBackend() = default;
 
     private:
+        // OSMesa only: EGL renders into a pbuffer
         std::shared_ptr<std::vector<float>> _backBuffer;
     };
 }
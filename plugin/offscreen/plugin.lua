@@ -20,11 +20,35 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 -- offscreen plugin
 minko.plugin.offscreen = { }
 
+-- EGL provides the OpenGL 3.3 core profiles the bundled OSMesa lacks (through Mesa's surfaceless
+-- platform, e.g. with llvmpipe): it is used instead of OSMesa when the host has it
+function minko.plugin.offscreen:egl()
+
+	if not os.is("linux") then
+		return false
+	end
+
+	local status = os.execute("pkg-config --exists egl")
+
+	return status == true or status == 0
+end
+
 function minko.plugin.offscreen:enable()
 
 	defines { "MINKO_PLUGIN_OFFSCREEN" }
 
 	minko.plugin.links { "offscreen" }
+
+	if minko.plugin.offscreen:egl() then
+		defines { "MINKO_PLUGIN_OFFSCREEN_EGL" }
+
+		links { "EGL" }
+
+		includedirs { minko.plugin.path("offscreen") .. "/include" }
+
+		return
+	end
+
 	links { "OSMesa" }
 
 	removelinks { 
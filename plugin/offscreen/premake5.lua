@@ -26,10 +26,17 @@ minko.project.library("minko-plugin-" .. PROJECT_NAME)
 	configuration {"linux32 or linux64"}
 		includedirs {
 			"include",
-			minko.plugin.path("sdl") .. "/include",
-			"lib/osmesa/linux/include"
+			minko.plugin.path("sdl") .. "/include"
 		}
 
+	-- the bundled headers would shadow the system EGL and GL ones
+	if minko.plugin.offscreen:egl() then
+		defines { "MINKO_PLUGIN_OFFSCREEN_EGL" }
+	else
+		configuration {"linux32 or linux64"}
+			includedirs { "lib/osmesa/linux/include" }
+	end
+
 	configuration {"windows32 or windows64"}
 		includedirs {
 			"include",
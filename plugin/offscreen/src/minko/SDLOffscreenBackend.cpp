@@ -20,10 +20,85 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Canvas.hpp"
 #include "minko/SDLOffscreenBackend.hpp"
 
-#include <GL/osmesa.h>
+#if defined(MINKO_PLUGIN_OFFSCREEN_EGL)
+# include <EGL/egl.h>
+# include <EGL/eglext.h>
+#else
+# include <GL/osmesa.h>
+#endif
 
 using namespace minko;
 
+#if defined(MINKO_PLUGIN_OFFSCREEN_EGL)
+
+void
+SDLOffscreenBackend::initialize(std::shared_ptr<Canvas> canvas)
+{
+    // Mesa's surfaceless platform needs neither a window system nor a GPU
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT")
+    );
+    auto display = getPlatformDisplay
+        ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+        : EGL_NO_DISPLAY;
+
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+        throw std::runtime_error("Could not initialize offscreen display");
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+        throw std::runtime_error("Could not bind the OpenGL API");
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE,       EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE,    EGL_OPENGL_BIT,
+        EGL_RED_SIZE,           8,
+        EGL_GREEN_SIZE,         8,
+        EGL_BLUE_SIZE,          8,
+        EGL_ALPHA_SIZE,         8,
+        EGL_DEPTH_SIZE,         24,
+        EGL_STENCIL_SIZE,       canvas->flags() & Canvas::STENCIL ? 8 : 0,
+        EGL_NONE
+    };
+    auto config = EGLConfig();
+    auto numConfigs = EGLint();
+
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &numConfigs) || numConfigs == 0)
+        throw std::runtime_error("Could not find an offscreen framebuffer configuration");
+
+    const EGLint surfaceAttributes[] = {
+        EGL_WIDTH,  static_cast<EGLint>(canvas->width()),
+        EGL_HEIGHT, static_cast<EGLint>(canvas->height()),
+        EGL_NONE
+    };
+    auto surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+    if (surface == EGL_NO_SURFACE)
+        throw std::runtime_error("Could not create offscreen backbuffer");
+
+    std::vector<EGLint> contextAttributes;
+
+    if (canvas->flags() & Canvas::OPENGL3)
+        contextAttributes = {
+            EGL_CONTEXT_MAJOR_VERSION,          3,
+            EGL_CONTEXT_MINOR_VERSION,          3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK,    EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT
+        };
+    contextAttributes.push_back(EGL_NONE);
+
+    auto offscreenContext = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes.data());
+
+    if (offscreenContext == EGL_NO_CONTEXT)
+        throw std::runtime_error("Could not create offscreen context");
+
+    if (!eglMakeCurrent(display, surface, surface, offscreenContext))
+        throw std::runtime_error("Could not make offscreen context current");
+}
+
+#else
+
 void
 SDLOffscreenBackend::initialize(std::shared_ptr<Canvas> canvas)
 {
@@ -36,6 +111,10 @@ SDLOffscreenBackend::initialize(std::shared_ptr<Canvas> canvas)
         throw std::runtime_error("Could not create offscreen backbuffer");
     }
 
+    // the bundled OSMesa headers predate core profiles (no OSMesaCreateContextAttribs): they need EGL
+    if (canvas->flags() & Canvas::OPENGL3)
+        throw std::runtime_error("OpenGL 3.3 core contexts are only supported offscreen through EGL");
+
     OSMesaContext offscreenContext = OSMesaCreateContextExt(GL_RGBA, 32, 0, 0, NULL);
 
     if (!offscreenContext)
@@ -45,6 +124,8 @@ SDLOffscreenBackend::initialize(std::shared_ptr<Canvas> canvas)
         throw std::runtime_error("Could not make offscreen context current");
 }
 
+#endif
+
 void
 SDLOffscreenBackend::swapBuffers(std::shared_ptr<Canvas> canvas)
 {
@@ -29,6 +29,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Signal.hpp"
 #include "minko/render/AbstractContext.hpp"
 #include "minko/render/OpenGLES2Context.hpp"
+#include "minko/render/OpenGL3Context.hpp"
 #include "minko/AbstractCanvas.hpp"
 #include "minko/input/Joystick.hpp"
 #include "minko/input/Touch.hpp"
@@ -65,7 +66,8 @@ namespace minko
             RESIZABLE = (1u << 1),
             HIDDEN = (1u << 2),
             CHROMELESS = (1u << 3),
-            STENCIL = (1u << 4)
+            STENCIL = (1u << 4),
+            OPENGL3 = (1u << 5)
         } Flags;
 
     private:
@@ -140,6 +142,13 @@ namespace minko
             return _name;
         }
 
+        inline
+        int
+        flags() const
+        {
+            return _flags;
+        }
+
         uint
         x();
 
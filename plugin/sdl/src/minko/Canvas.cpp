@@ -157,7 +157,16 @@ Canvas::initializeWindow()
     if (_flags & STENCIL)
         SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
 
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+#ifdef MINKO_OPENGL3_CONTEXT
+    if (_flags & OPENGL3)
+    {
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    }
+    else
+#endif
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 
     SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8);
@@ -254,7 +263,12 @@ Canvas::initializeContext()
 #if MINKO_PLATFORM == MINKO_PLATFORM_HTML5
     _context = minko::render::WebGLContext::create();
 #else
-    _context = minko::render::OpenGLES2Context::create();
+# ifdef MINKO_OPENGL3_CONTEXT
+    if (_flags & OPENGL3)
+        _context = minko::render::OpenGL3Context::create();
+    else
+# endif
+        _context = minko::render::OpenGLES2Context::create();
 #endif
 
     if (!_context)
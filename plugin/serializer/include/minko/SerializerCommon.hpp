@@ -23,6 +23,7 @@ namespace minko
     {
         class HalfEdge;
         class HalfEdgeCollection;
+        class QuadricSimplifier;
     }
 
     namespace deserialize
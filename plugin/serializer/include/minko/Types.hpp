@@ -38,6 +38,7 @@ namespace minko
 			BOUNDINGBOX			= 108,
 			ANIMATION			= 109,
 			SKINNING			= 110,
+			LEVEL_OF_DETAIL		= 111,
             PARTICLES           = 60
 		};
 
@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+    namespace data
+    {
+        // Reduces a geometry with half-edge collapses ordered by quadric error. Vertices on a border or on
+        // a UV/normal seam (a position shared by vertices with different attributes) are never moved, so
+        // every vertex of the result keeps its original attributes and seams stay closed.
+        class QuadricSimplifier
+        {
+        public:
+            typedef std::shared_ptr<QuadricSimplifier>          Ptr;
+
+        private:
+            typedef std::shared_ptr<geometry::Geometry>         GeometryPtr;
+            typedef std::array<double, 10>                      Quadric;
+
+            // a distinct position, shared by one or more wedges (vertices of the original geometry)
+            struct Vertex
+            {
+                std::array<double, 3>                           position;
+                Quadric                                         quadric;
+                std::vector<uint>                               triangles;
+                uint                                            numWedges;
+                bool                                            locked;
+                bool                                            removed;
+                uint                                            version;
+            };
+
+            struct Collapse
+            {
+                double                                          cost;
+                uint                                            vertex;
+                uint                                            target;
+                uint                                            version;
+
+                inline
+                bool
+                operator>(const Collapse& other) const
+                {
+                    return cost > other.cost;
+                }
+            };
+
+        private:
+            GeometryPtr                                         _geometry;
+
+            std::vector<Vertex>                                 _vertices;
+            std::vector<uint>                                   _wedgeToVertex;
+            std::vector<uint>                                   _indices; // wedges, 3 per triangle
+            std::vector<bool>                                   _removedTriangles;
+            uint                                                _numTriangles;
+
+            std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> _collapses;
+
+        public:
+            inline static
+            Ptr
+            create(GeometryPtr geometry)
+            {
+                Ptr simplifier = std::shared_ptr<QuadricSimplifier>(new QuadricSimplifier(geometry));
+
+                simplifier->initialize();
+
+                return simplifier;
+            }
+
+            inline
+            uint
+            numTriangles() const
+            {
+                return _numTriangles;
+            }
+
+            // collapses edges until at most numTriangles triangles are left or no collapse is possible
+            // and returns the result as a new geometry with the same vertex attributes, successive calls
+            // carry on from the previous one to build a chain of levels of detail
+            GeometryPtr
+            simplify(uint numTriangles);
+
+        private:
+            QuadricSimplifier(GeometryPtr geometry);
+
+            void
+            initialize();
+
+            void
+            addTriangleQuadric(uint triangle);
+
+            double
+            error(const Quadric& quadric, const std::array<double, 3>& position) const;
+
+            void
+            neighbors(uint vertex, std::vector<uint>& output) const;
+
+            bool
+            evaluate(uint vertex, uint target, double& cost, uint& targetWedge) const;
+
+            void
+            updateCollapse(uint vertex);
+
+            void
+            collapse(uint vertex, uint target, uint targetWedge);
+
+            GeometryPtr
+            buildGeometry() const;
+        };
+    }
+}
@@ -104,6 +104,12 @@ namespace minko
             deserializeBoundingBox(std::string&         serializedBoundingBox,
                                    AssetLibraryPtr      assetLibrary,
                                    DependencyPtr        dependencies);
+
+            static
+            AbsComponentPtr
+            deserializeLevelOfDetail(std::string&       serializedLevelOfDetail,
+                                     AssetLibraryPtr    assetLibrary,
+                                     DependencyPtr      dependencies);
         };
     }
 }
@@ -50,10 +50,14 @@ namespace minko
             typedef std::function<std::string(NodePtr, AbstractComponentPtr, DependencyPtr)>    NodeWriterFunc;
             typedef std::shared_ptr<file::AssetLibrary>                 AssetLibraryPtr;
             typedef std::shared_ptr<Options>                            OptionsPtr;
+            typedef std::shared_ptr<geometry::Geometry>                 GeometryPtr;
+            typedef std::shared_ptr<component::LevelOfDetail>           LevelOfDetailPtr;
 
         private:
             static std::map<const std::type_info*, NodeWriterFunc> _componentIdToWriteFunction;
 
+            std::unordered_map<GeometryPtr, std::vector<GeometryPtr>>   _simplifiedGeometries;
+
         public:
             static
             void
@@ -78,9 +82,15 @@ namespace minko
                       std::vector<std::string>&             serializedControllerList,
                       std::map<AbstractComponentPtr, int>&  controllerMap,
                       AssetLibraryPtr                       assetLibrary,
-                      DependencyPtr                         dependency);
+                      DependencyPtr                         dependency,
+                      std::shared_ptr<WriterOptions>        writerOptions);
 
         private :
+            LevelOfDetailPtr
+            generateLevelOfDetail(GeometryPtr                       geometry,
+                                  AssetLibraryPtr                   assetLibrary,
+                                  std::shared_ptr<WriterOptions>    writerOptions);
+
             inline
             std::shared_ptr<scene::Node>
             getNode()
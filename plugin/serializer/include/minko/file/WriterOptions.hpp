@@ -53,6 +53,10 @@ namespace minko
             render::MipFilter                   _mipFilter;
             bool                                _optimizeForNormalMapping;
 
+            uint                                _numLevelsOfDetail;
+            float                               _levelOfDetailRatio;
+            float                               _levelOfDetailScreenSize;
+
         public:
             inline
             static
@@ -82,6 +86,9 @@ namespace minko
                 instance->_textureMaxResolution = other->_textureMaxResolution;
                 instance->_mipFilter = other->_mipFilter;
                 instance->_optimizeForNormalMapping = other->_optimizeForNormalMapping;
+                instance->_numLevelsOfDetail = other->_numLevelsOfDetail;
+                instance->_levelOfDetailRatio = other->_levelOfDetailRatio;
+                instance->_levelOfDetailScreenSize = other->_levelOfDetailScreenSize;
 
                 return instance;
             }
@@ -262,6 +269,58 @@ namespace minko
                 return shared_from_this();
             }
 
+            // number of simplified geometries generated for each surface, written along with a
+            // LevelOfDetail component
+            inline
+            uint
+            numLevelsOfDetail() const
+            {
+                return _numLevelsOfDetail;
+            }
+
+            inline
+            Ptr
+            numLevelsOfDetail(uint value)
+            {
+                _numLevelsOfDetail = value;
+
+                return shared_from_this();
+            }
+
+            // fraction of the triangles of a level kept in the next one
+            inline
+            float
+            levelOfDetailRatio() const
+            {
+                return _levelOfDetailRatio;
+            }
+
+            inline
+            Ptr
+            levelOfDetailRatio(float value)
+            {
+                _levelOfDetailRatio = value;
+
+                return shared_from_this();
+            }
+
+            // screen size under which the original geometry is replaced by the first simplified one
+            inline
+            float
+            levelOfDetailScreenSize() const
+            {
+                return _levelOfDetailScreenSize;
+            }
+
+            inline
+            Ptr
+            levelOfDetailScreenSize(float value)
+            {
+                _levelOfDetailScreenSize = value;
+
+                return shared_from_this();
+            }
+
         private:
             WriterOptions();
         };
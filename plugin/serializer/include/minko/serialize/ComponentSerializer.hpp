@@ -92,6 +92,12 @@ namespace minko
                                  AbstractComponentPtr   component,
                                  DependencyPtr          dependencies);
 
+            static
+            std::string
+            serializeLevelOfDetail(NodePtr              node,
+                                   AbstractComponentPtr component,
+                                   DependencyPtr        dependencies);
+
             static
             std::string
             getSurfaceExtension(NodePtr, SurfacePtr);
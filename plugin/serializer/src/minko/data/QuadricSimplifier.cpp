@@ -0,0 +1,486 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/data/QuadricSimplifier.hpp"
+
+#include "minko/geometry/Geometry.hpp"
+#include "minko/render/IndexBuffer.hpp"
+#include "minko/render/VertexBuffer.hpp"
+
+using namespace minko;
+using namespace minko::data;
+
+QuadricSimplifier::QuadricSimplifier(GeometryPtr geometry) :
+    _geometry(geometry),
+    _vertices(),
+    _wedgeToVertex(),
+    _indices(),
+    _removedTriangles(),
+    _numTriangles(0),
+    _collapses()
+{
+}
+
+void
+QuadricSimplifier::initialize()
+{
+    auto                        indices         = _geometry->indices();
+    render::VertexBuffer::Ptr   positionBuffer  = nullptr;
+
+    for (auto vertexBuffer : _geometry->vertexBuffers())
+        if (vertexBuffer->hasAttribute("position"))
+            positionBuffer = vertexBuffer;
+
+    if (indices == nullptr || positionBuffer == nullptr)
+        throw std::invalid_argument("geometry");
+
+    const uint          numWedges       = _geometry->numVertices();
+    const uint          positionOffset  = std::get<2>(*positionBuffer->attribute("position"));
+    const uint          positionSize    = positionBuffer->vertexSize();
+    std::vector<uint>   wedgeRemap(numWedges);
+
+    // vertices with the very same attributes are merged first so that an unwelded mesh is not seen
+    // as a seam everywhere
+    std::map<std::vector<float>, uint>      wedgeIds;
+    std::map<std::array<float, 3>, uint>    vertexIds;
+
+    _wedgeToVertex.resize(numWedges, 0);
+
+    for (uint i = 0; i < numWedges; ++i)
+    {
+        std::vector<float> key;
+
+        for (auto vertexBuffer : _geometry->vertexBuffers())
+        {
+            auto vertexSize = vertexBuffer->vertexSize();
+            auto begin      = vertexBuffer->data().begin() + i * vertexSize;
+
+            key.insert(key.end(), begin, begin + vertexSize);
+        }
+
+        auto wedgeIt = wedgeIds.find(key);
+
+        if (wedgeIt != wedgeIds.end())
+        {
+            wedgeRemap[i] = wedgeIt->second;
+            continue;
+        }
+
+        wedgeIds[key] = i;
+        wedgeRemap[i] = i;
+
+        const float*            xyz         = &positionBuffer->data()[i * positionSize + positionOffset];
+        std::array<float, 3>    position    = {{ xyz[0], xyz[1], xyz[2] }};
+        auto                    vertexIt    = vertexIds.find(position);
+        uint                    vertexId;
+
+        if (vertexIt == vertexIds.end())
+        {
+            Vertex vertex;
+
+            vertex.position = {{ xyz[0], xyz[1], xyz[2] }};
+            vertex.quadric.fill(0.);
+            vertex.numWedges = 0;
+            vertex.locked = false;
+            vertex.removed = false;
+            vertex.version = 0;
+
+            vertexId = _vertices.size();
+            vertexIds[position] = vertexId;
+            _vertices.push_back(vertex);
+        }
+        else
+            vertexId = vertexIt->second;
+
+        _wedgeToVertex[i] = vertexId;
+        ++_vertices[vertexId].numWedges;
+    }
+
+    std::unordered_map<uint64_t, uint>  edges;
+    const auto&                         data    = indices->data();
+
+    for (uint i = 0; i + 2 < data.size(); i += 3)
+    {
+        uint wedges[3]      = { wedgeRemap[data[i]], wedgeRemap[data[i + 1]], wedgeRemap[data[i + 2]] };
+        uint vertices[3]    = { _wedgeToVertex[wedges[0]], _wedgeToVertex[wedges[1]], _wedgeToVertex[wedges[2]] };
+
+        if (vertices[0] == vertices[1] || vertices[1] == vertices[2] || vertices[2] == vertices[0])
+            continue;
+
+        uint triangle = _numTriangles++;
+
+        for (uint j = 0; j < 3; ++j)
+        {
+            uint64_t a = std::min(vertices[j], vertices[(j + 1) % 3]);
+            uint64_t b = std::max(vertices[j], vertices[(j + 1) % 3]);
+
+            ++edges[(a << 32) | b];
+
+            _indices.push_back(wedges[j]);
+            _vertices[vertices[j]].triangles.push_back(triangle);
+        }
+    }
+
+    _removedTriangles.resize(_numTriangles, false);
+
+    // border and non-manifold edges
+    for (const auto& edge : edges)
+        if (edge.second != 2)
+        {
+            _vertices[edge.first >> 32].locked = true;
+            _vertices[edge.first & 0xffffffff].locked = true;
+        }
+
+    for (auto& vertex : _vertices)
+        if (vertex.numWedges > 1)
+            vertex.locked = true;
+
+    for (uint triangle = 0; triangle < _numTriangles; ++triangle)
+        addTriangleQuadric(triangle);
+
+    for (uint vertex = 0; vertex < _vertices.size(); ++vertex)
+        updateCollapse(vertex);
+}
+
+void
+QuadricSimplifier::addTriangleQuadric(uint triangle)
+{
+    const auto& p0 = _vertices[_wedgeToVertex[_indices[triangle * 3]]].position;
+    const auto& p1 = _vertices[_wedgeToVertex[_indices[triangle * 3 + 1]]].position;
+    const auto& p2 = _vertices[_wedgeToVertex[_indices[triangle * 3 + 2]]].position;
+
+    double ux = p1[0] - p0[0], uy = p1[1] - p0[1], uz = p1[2] - p0[2];
+    double vx = p2[0] - p0[0], vy = p2[1] - p0[1], vz = p2[2] - p0[2];
+    double a = uy * vz - uz * vy;
+    double b = uz * vx - ux * vz;
+    double c = ux * vy - uy * vx;
+    double length = sqrt(a * a + b * b + c * c);
+
+    if (length == 0.)
+        return;
+
+    a /= length;
+    b /= length;
+    c /= length;
+
+    // plane quadrics are weighted by the area of their triangle
+    double d = -(a * p0[0] + b * p0[1] + c * p0[2]);
+    double w = length * .5;
+    double plane[10] = { a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d };
+
+    for (uint i = 0; i < 3; ++i)
+    {
+        auto& quadric = _vertices[_wedgeToVertex[_indices[triangle * 3 + i]]].quadric;
+
+        for (uint j = 0; j < 10; ++j)
+            quadric[j] += w * plane[j];
+    }
+}
+
+double
+QuadricSimplifier::error(const Quadric& q, const std::array<double, 3>& p) const
+{
+    double x = p[0], y = p[1], z = p[2];
+
+    return q[0] * x * x + 2. * q[1] * x * y + 2. * q[2] * x * z + 2. * q[3] * x
+        + q[4] * y * y + 2. * q[5] * y * z + 2. * q[6] * y
+        + q[7] * z * z + 2. * q[8] * z
+        + q[9];
+}
+
+void
+QuadricSimplifier::neighbors(uint vertex, std::vector<uint>& output) const
+{
+    output.clear();
+
+    for (auto triangle : _vertices[vertex].triangles)
+    {
+        if (_removedTriangles[triangle])
+            continue;
+
+        for (uint i = 0; i < 3; ++i)
+        {
+            uint neighbor = _wedgeToVertex[_indices[triangle * 3 + i]];
+
+            if (neighbor != vertex && std::find(output.begin(), output.end(), neighbor) == output.end())
+                output.push_back(neighbor);
+        }
+    }
+}
+
+bool
+QuadricSimplifier::evaluate(uint vertex, uint target, double& cost, uint& targetWedge) const
+{
+    const auto& source          = _vertices[vertex];
+    const auto& destination     = _vertices[target];
+    uint        numShared       = 0;
+
+    for (auto triangle : source.triangles)
+    {
+        if (_removedTriangles[triangle])
+            continue;
+
+        const std::array<double, 3>* positions[3];
+        int targetCorner = -1;
+        int sourceCorner = -1;
+
+        for (uint i = 0; i < 3; ++i)
+        {
+            uint cornerVertex = _wedgeToVertex[_indices[triangle * 3 + i]];
+
+            positions[i] = &_vertices[cornerVertex].position;
+            if (cornerVertex == target)
+                targetCorner = i;
+            else if (cornerVertex == vertex)
+                sourceCorner = i;
+        }
+
+        if (targetCorner >= 0)
+        {
+            // the triangles around the edge tell which wedge of the target continues the source's
+            // attributes, they must agree when the target is on a seam
+            uint wedge = _indices[triangle * 3 + targetCorner];
+
+            if (numShared != 0 && wedge != targetWedge)
+                return false;
+
+            targetWedge = wedge;
+            ++numShared;
+
+            continue;
+        }
+
+        // the remaining triangles must not flip
+        double normals[2][3];
+
+        for (uint i = 0; i < 2; ++i)
+        {
+            if (i == 1)
+                positions[sourceCorner] = &destination.position;
+
+            const auto& p0 = *positions[0];
+            const auto& p1 = *positions[1];
+            const auto& p2 = *positions[2];
+            double ux = p1[0] - p0[0], uy = p1[1] - p0[1], uz = p1[2] - p0[2];
+            double vx = p2[0] - p0[0], vy = p2[1] - p0[1], vz = p2[2] - p0[2];
+
+            normals[i][0] = uy * vz - uz * vy;
+            normals[i][1] = uz * vx - ux * vz;
+            normals[i][2] = ux * vy - uy * vx;
+        }
+
+        if (normals[0][0] * normals[1][0] + normals[0][1] * normals[1][1] + normals[0][2] * normals[1][2] <= 0.)
+            return false;
+    }
+
+    if (numShared == 0)
+        return false;
+
+    // link condition: the only vertices adjacent to both ends must be the ones of the triangles
+    // around the edge, otherwise the collapse would pinch the surface
+    std::vector<uint> sourceNeighbors;
+    std::vector<uint> targetNeighbors;
+    uint numCommonNeighbors = 0;
+
+    neighbors(vertex, sourceNeighbors);
+    neighbors(target, targetNeighbors);
+
+    for (auto neighbor : sourceNeighbors)
+        if (std::find(targetNeighbors.begin(), targetNeighbors.end(), neighbor) != targetNeighbors.end())
+            ++numCommonNeighbors;
+
+    if (numCommonNeighbors != numShared)
+        return false;
+
+    cost = error(source.quadric, destination.position);
+
+    return true;
+}
+
+void
+QuadricSimplifier::updateCollapse(uint vertex)
+{
+    auto& source = _vertices[vertex];
+
+    ++source.version;
+
+    if (source.locked || source.removed)
+        return;
+
+    std::vector<uint>   candidates;
+    Collapse            best;
+    bool                found       = false;
+
+    neighbors(vertex, candidates);
+
+    for (auto target : candidates)
+    {
+        double  cost;
+        uint    wedge;
+
+        if (evaluate(vertex, target, cost, wedge) && (!found || cost < best.cost))
+        {
+            best.cost = cost;
+            best.target = target;
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        best.vertex = vertex;
+        best.version = source.version;
+        _collapses.push(best);
+    }
+}
+
+void
+QuadricSimplifier::collapse(uint vertex, uint target, uint targetWedge)
+{
+    auto& source        = _vertices[vertex];
+    auto& destination   = _vertices[target];
+
+    for (auto triangle : source.triangles)
+    {
+        if (_removedTriangles[triangle])
+            continue;
+
+        bool shared = false;
+
+        for (uint i = 0; i < 3; ++i)
+            if (_wedgeToVertex[_indices[triangle * 3 + i]] == target)
+                shared = true;
+
+        if (shared)
+        {
+            _removedTriangles[triangle] = true;
+            --_numTriangles;
+            continue;
+        }
+
+        for (uint i = 0; i < 3; ++i)
+            if (_wedgeToVertex[_indices[triangle * 3 + i]] == vertex)
+                _indices[triangle * 3 + i] = targetWedge;
+
+        destination.triangles.push_back(triangle);
+    }
+
+    for (uint i = 0; i < 10; ++i)
+        destination.quadric[i] += source.quadric[i];
+
+    source.removed = true;
+    source.triangles.clear();
+    source.triangles.shrink_to_fit();
+
+    destination.triangles.erase(
+        std::remove_if(destination.triangles.begin(), destination.triangles.end(), [&](uint triangle)
+        {
+            return _removedTriangles[triangle];
+        }),
+        destination.triangles.end()
+    );
+
+    std::vector<uint> adjacentVertices;
+
+    neighbors(target, adjacentVertices);
+
+    updateCollapse(target);
+    for (auto adjacentVertex : adjacentVertices)
+        updateCollapse(adjacentVertex);
+}
+
+QuadricSimplifier::GeometryPtr
+QuadricSimplifier::simplify(uint numTriangles)
+{
+    while (_numTriangles > numTriangles && !_collapses.empty())
+    {
+        Collapse next = _collapses.top();
+
+        _collapses.pop();
+
+        if (_vertices[next.vertex].removed || _vertices[next.vertex].version != next.version)
+            continue;
+
+        double  cost;
+        uint    wedge;
+
+        if (_vertices[next.target].removed || !evaluate(next.vertex, next.target, cost, wedge))
+        {
+            updateCollapse(next.vertex);
+            continue;
+        }
+
+        collapse(next.vertex, next.target, wedge);
+    }
+
+    return buildGeometry();
+}
+
+QuadricSimplifier::GeometryPtr
+QuadricSimplifier::buildGeometry() const
+{
+    auto                        geometry    = geometry::Geometry::create();
+    std::vector<int>            remap(_wedgeToVertex.size(), -1);
+    std::vector<uint>           wedges;
+    std::vector<unsigned short> indices;
+
+    indices.reserve(_numTriangles * 3);
+
+    for (uint triangle = 0; triangle < _removedTriangles.size(); ++triangle)
+    {
+        if (_removedTriangles[triangle])
+            continue;
+
+        for (uint i = 0; i < 3; ++i)
+        {
+            uint wedge = _indices[triangle * 3 + i];
+
+            if (remap[wedge] < 0)
+            {
+                remap[wedge] = wedges.size();
+                wedges.push_back(wedge);
+            }
+
+            indices.push_back(remap[wedge]);
+        }
+    }
+
+    for (auto vertexBuffer : _geometry->vertexBuffers())
+    {
+        auto                vertexSize  = vertexBuffer->vertexSize();
+        const auto&         source      = vertexBuffer->data();
+        std::vector<float>  data;
+
+        data.reserve(wedges.size() * vertexSize);
+        for (auto wedge : wedges)
+            data.insert(data.end(), source.begin() + wedge * vertexSize, source.begin() + (wedge + 1) * vertexSize);
+
+        auto reducedVertexBuffer = render::VertexBuffer::create(vertexBuffer->context(), data);
+
+        for (auto attribute : vertexBuffer->attributes())
+            reducedVertexBuffer->addAttribute(std::get<0>(*attribute), std::get<1>(*attribute), std::get<2>(*attribute));
+
+        geometry->addVertexBuffer(reducedVertexBuffer);
+    }
+
+    geometry->indices(render::IndexBuffer::create(_geometry->indices()->context(), indices));
+
+    return geometry;
+}
@@ -19,6 +19,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/deserialize/ComponentDeserializer.hpp"
 #include "minko/component/BoundingBox.hpp"
+#include "minko/component/LevelOfDetail.hpp"
 #include "minko/component/Transform.hpp"
 #include "minko/component/PerspectiveCamera.hpp"
 #include "minko/component/AmbientLight.hpp"
@@ -386,3 +387,23 @@ ComponentDeserializer::deserializeBoundingBox(std::string&
 
     return component;
 }
+
+std::shared_ptr<component::AbstractComponent>
+ComponentDeserializer::deserializeLevelOfDetail(std::string&                            serializedLevelOfDetail,
+                                                std::shared_ptr<file::AssetLibrary>     assetLibrary,
+                                                std::shared_ptr<file::Dependency>       dependencies)
+{
+    msgpack::zone                                                                           mempool;
+    msgpack::object                                                                         deserialized;
+    msgpack::type::tuple<float, std::vector<msgpack::type::tuple<unsigned short, float>>>   dst;
+
+    msgpack::unpack(serializedLevelOfDetail.data(), serializedLevelOfDetail.size() - 1, NULL, &mempool, &deserialized);
+    deserialized.convert(&dst);
+
+    auto levelOfDetail = component::LevelOfDetail::create(dst.a0);
+
+    for (const auto& level : dst.a1)
+        levelOfDetail->addLevel(dependencies->getGeometryReference(level.a0), level.a1);
+
+    return levelOfDetail;
+}
@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Types.hpp"
 #include "minko/component/Transform.hpp"
 #include "minko/component/JobManager.hpp"
+#include "minko/component/ProgramWarmUpJob.hpp"
 #include "minko/component/Surface.hpp"
 #include "minko/component/BoundingBox.hpp"
 #include "minko/component/MasterAnimation.hpp"
@@ -113,6 +114,12 @@ SceneParser::SceneParser()
         std::placeholders::_1,
         std::placeholders::_2,
         std::placeholders::_3));
+
+    registerComponent(serialize::LEVEL_OF_DETAIL,
+        std::bind(&deserialize::ComponentDeserializer::deserializeLevelOfDetail,
+        std::placeholders::_1,
+        std::placeholders::_2,
+        std::placeholders::_3));
 }
 
 void
@@ -151,6 +158,9 @@ SceneParser::parse(const std::string&                    filename,
 
     assetLibrary->symbol(filename, parseNode(dst.a1, dst.a0, assetLibrary, options));
 
+    if (options->warmUpPrograms())
+        _jobList.push_back(component::ProgramWarmUpJob::create(assetLibrary->symbol(filename)));
+
     if (_jobList.size() > 0)
     {
         auto jobManager = component::JobManager::create(30);
@@ -30,6 +30,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/PointLight.hpp"
 #include "minko/component/Surface.hpp"
 #include "minko/component/Renderer.hpp"
+#include "minko/component/LevelOfDetail.hpp"
+#include "minko/data/QuadricSimplifier.hpp"
+#include "minko/file/AssetLibrary.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/render/IndexBuffer.hpp"
 #include "minko/file/Dependency.hpp"
 #include "minko/file/WriterOptions.hpp"
 #include "minko/serialize/ComponentSerializer.hpp"
@@ -119,6 +124,14 @@ SceneWriter::SceneWriter()
             std::placeholders::_1, std::placeholders::_2, std::placeholders::_3
         )
     );
+
+    registerComponent(
+        &typeid(component::LevelOfDetail),
+        std::bind(
+            &serialize::ComponentSerializer::serializeLevelOfDetail,
+            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3
+        )
+    );
 }
 
 void
@@ -146,7 +159,7 @@ SceneWriter::embed(AssetLibraryPtr                      assetLibrary,
     {
         std::shared_ptr<scene::Node>    currentNode = queue.front();
 
-        nodePack.push_back(writeNode(currentNode, serializedControllerList, controllerMap, assetLibrary, dependency));
+        nodePack.push_back(writeNode(currentNode, serializedControllerList, controllerMap, assetLibrary, dependency, writerOptions));
 
         for (uint i = 0; i < currentNode->children().size(); ++i)
             queue.push(currentNode->children()[i]);
@@ -165,7 +178,8 @@ SceneWriter::writeNode(std::shared_ptr<scene::Node>     node,
                       std::vector<std::string>&         serializedControllerList,
                       std::map<AbstractComponentPtr, int>&  controllerMap,
                       AssetLibraryPtr                   assetLibrary,
-                      DependencyPtr                     dependency)
+                      DependencyPtr                     dependency,
+                      std::shared_ptr<WriterOptions>    writerOptions)
 {
     std::vector<uint>   componentsId;
     int                 componentIndex = 0;
@@ -194,7 +208,85 @@ SceneWriter::writeNode(std::shared_ptr<scene::Node>     node,
         currentComponent = node->component<component::AbstractComponent>(++componentIndex);
     }
 
+    // a single surface whose geometry is replaced by simplified ones as it gets smaller on screen
+    if (writerOptions->numLevelsOfDetail() > 0
+        && node->components<component::Surface>().size() == 1
+        && !node->hasComponent<component::LevelOfDetail>())
+    {
+        auto geometry       = node->component<component::Surface>()->geometry();
+        auto levelOfDetail  = generateLevelOfDetail(geometry, assetLibrary, writerOptions);
+
+        if (levelOfDetail->numLevels() > 1)
+        {
+            componentsId.push_back(serializedControllerList.size());
+            serializedControllerList.push_back(
+                _componentIdToWriteFunction[&typeid(component::LevelOfDetail)](node, levelOfDetail, dependency)
+            );
+        }
+    }
+
     SerializedNode res(node->name(), node->layouts(), node->children().size(), componentsId, node->uuid());
 
     return res;
 }
+
+SceneWriter::LevelOfDetailPtr
+SceneWriter::generateLevelOfDetail(GeometryPtr                      geometry,
+                                   AssetLibraryPtr                  assetLibrary,
+                                   std::shared_ptr<WriterOptions>   writerOptions)
+{
+    auto& levels = _simplifiedGeometries[geometry];
+
+    if (levels.empty() && geometry->indices() != nullptr)
+    {
+        auto        simplifier      = data::QuadricSimplifier::create(geometry);
+        std::string name;
+        float       numTriangles    = geometry->indices()->numIndices() / 3.f;
+
+        try
+        {
+            name = assetLibrary->geometryName(geometry);
+        }
+        catch (const std::logic_error&)
+        {
+            // geometries that are not in the library still need unique names for their levels
+            auto id = _simplifiedGeometries.size();
+
+            do
+                name = "geometry" + std::to_string(id++);
+            while (assetLibrary->geometry(name + "_lod1") != nullptr);
+        }
+
+        for (uint i = 1; i <= writerOptions->numLevelsOfDetail(); ++i)
+        {
+            uint previousNumTriangles = simplifier->numTriangles();
+
+            numTriangles *= writerOptions->levelOfDetailRatio();
+
+            auto level = simplifier->simplify(static_cast<uint>(numTriangles));
+
+            // the mesh is locked by its borders and seams
+            if (simplifier->numTriangles() == previousNumTriangles)
+                break;
+
+            assetLibrary->geometry(name + "_lod" + std::to_string(i), level);
+            levels.push_back(level);
+        }
+    }
+
+    // keeping the on screen triangle density constant: the screen area covered by the mesh, and
+    // thus its number of triangles, scales with the square of the screen size
+    auto    levelOfDetail   = component::LevelOfDetail::create();
+    float   screenSize      = writerOptions->levelOfDetailScreenSize();
+    float   screenSizeRatio = sqrtf(writerOptions->levelOfDetailRatio());
+
+    levelOfDetail->addLevel(geometry, levels.empty() ? 0.f : screenSize);
+
+    for (uint i = 0; i < levels.size(); ++i)
+    {
+        screenSize *= screenSizeRatio;
+        levelOfDetail->addLevel(levels[i], i + 1 < levels.size() ? screenSize : 0.f);
+    }
+
+    return levelOfDetail;
+}
@@ -38,6 +38,9 @@ WriterOptions::WriterOptions() :
     _upscaleTextureWhenProcessedForMipmapping(true),
     _textureMaxResolution(Vector2::create(2048, 2048)),
     _mipFilter(MipFilter::LINEAR),
-    _optimizeForNormalMapping(false)
+    _optimizeForNormalMapping(false),
+    _numLevelsOfDetail(0),
+    _levelOfDetailRatio(.5f),
+    _levelOfDetailScreenSize(.5f)
 {
 }
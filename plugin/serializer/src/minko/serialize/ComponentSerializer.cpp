@@ -32,6 +32,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/Effect.hpp"
 #include "minko/component/Renderer.hpp"
 #include "minko/component/BoundingBox.hpp"
+#include "minko/component/LevelOfDetail.hpp"
 #include "minko/math/Vector3.hpp"
 #include "minko/math/Box.hpp"
 #include "minko/serialize/TypeSerializer.hpp"
@@ -280,3 +281,30 @@ ComponentSerializer::serializeBoundingBox(NodePtr               node,
 
     return buffer.str();
 }
+
+std::string
+ComponentSerializer::serializeLevelOfDetail(NodePtr                 node,
+                                            AbstractComponentPtr    component,
+                                            DependencyPtr           dependencies)
+{
+    auto                levelOfDetail   = std::static_pointer_cast<component::LevelOfDetail>(component);
+    int8_t              type            = serialize::LEVEL_OF_DETAIL;
+    std::stringstream   buffer;
+
+    std::vector<msgpack::type::tuple<unsigned short, float>> levels;
+
+    for (uint i = 0; i < levelOfDetail->numLevels(); ++i)
+        levels.push_back(msgpack::type::tuple<unsigned short, float>(
+            dependencies->registerDependency(levelOfDetail->levelGeometry(i)),
+            levelOfDetail->levelMinScreenSize(i)
+        ));
+
+    msgpack::type::tuple<float, std::vector<msgpack::type::tuple<unsigned short, float>>> src(
+        levelOfDetail->hysteresis(),
+        levels);
+
+    msgpack::pack(buffer, src);
+    msgpack::pack(buffer, type);
+
+    return buffer.str();
+}
@@ -35,6 +35,9 @@ WebGLContext::setUniform(const unsigned int&    location,
                          bool                   transpose,
                          const float*           values)
 {
+    if (!uniformValuesChanged(location, values, size << 4, transpose))
+        return;
+
     if (transpose)
     {
         float* transposed = new float[size << 4];
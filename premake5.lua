@@ -158,6 +158,7 @@ solution "minko"
 		include 'example/clone'
 		include 'example/cube'
 		include 'example/devil'
+		include 'example/draw-calls'
 		include 'example/effect-config'
 		include 'example/flares'
 		include 'example/fog'
@@ -0,0 +1,348 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SignalBenchmarkTest.hpp"
+
+using namespace minko;
+
+namespace minko
+{
+	namespace benchmark
+	{
+		// the list based implementation of minko::Signal, kept as a reference for the benchmarks
+		template <typename... A>
+		class ListSignal :
+			public std::enable_shared_from_this<ListSignal<A...>>
+		{
+		private:
+			typedef std::function<void(A...)>                                        CallbackFunction;
+			typedef std::pair<float, CallbackFunction>                                Callback;
+			typedef typename std::list<Callback>::iterator                            CallbackIterator;
+			typedef typename std::list<std::pair<float, unsigned int>>::iterator    SlotIterator;
+
+			template <typename... B>
+			class ListSignalSlot;
+
+		public:
+			typedef std::shared_ptr<ListSignal<A...>>            Ptr;
+			typedef std::shared_ptr<ListSignalSlot<A...>>        Slot;
+
+		private:
+			std::list<Callback>                                        _callbacks;
+			std::list<std::pair<float, unsigned int>>                _slotIds;
+			unsigned int                                             _nextSlotId;
+
+			bool                                                    _locked;
+			std::list<std::pair<Callback, uint>>                    _toAdd;
+			std::list<std::pair<CallbackIterator, SlotIterator>>    _toRemove;
+			std::list<unsigned int>                                    _toRemoveSlotId;
+			bool                                                    _signalListDirty;
+
+		private:
+			ListSignal() :
+				std::enable_shared_from_this<ListSignal<A...>>(),
+				_nextSlotId(0),
+				_locked(false),
+				_signalListDirty(false)
+			{
+			}
+
+			void
+			removeConnectionById(const unsigned int connectionId)
+			{
+				auto connectionIdIt = _slotIds.begin();
+				auto callbackIt     = _callbacks.begin();
+
+				while ((*connectionIdIt).second != connectionId)
+				{
+					connectionIdIt++;
+					callbackIt++;
+				}
+
+				removeConnectionByIterator(connectionIdIt, callbackIt);
+			}
+
+			void
+			removeConnectionByIterator(SlotIterator         connectionIdIt,
+									   CallbackIterator     callbackIt)
+			{
+				if (_locked)
+				{
+					auto addIt = std::find_if(_toAdd.begin(), _toAdd.end(), [&](std::pair<Callback, unsigned int>& add)
+					{
+						return add.second == (*connectionIdIt).second;
+					});
+
+					if (addIt != _toAdd.end())
+						_toAdd.erase(addIt);
+					else
+					{
+						_toRemove.push_back(std::pair<CallbackIterator, SlotIterator>(callbackIt, connectionIdIt));
+						_toRemoveSlotId.push_back(connectionIdIt->second);
+					}
+				}
+				else
+				{
+					_callbacks.erase(callbackIt);
+					_slotIds.erase(connectionIdIt);
+				}
+			}
+
+		public:
+			static
+			Ptr
+			create()
+			{
+				return std::shared_ptr<ListSignal<A...>>(new ListSignal<A...>());
+			}
+
+			inline
+			uint
+			numCallbacks() const
+			{
+				return _callbacks.size();
+			}
+
+			void
+			sortListSignals()
+			{
+				_callbacks.sort([&](const Callback& callback1, const Callback& callback2) -> bool
+				{
+					return callback1.first > callback2.first;
+				});
+
+				_slotIds.sort([&](const std::pair<float, unsigned int>& slot1, const std::pair<float, unsigned int>& slot2) -> bool
+				{
+					return slot1.first > slot2.first;
+				});
+			}
+
+			Slot
+			connect(CallbackFunction callback, float priority = 0)
+			{
+				auto connection = ListSignalSlot<A...>::create(ListSignal<A...>::shared_from_this(), _nextSlotId++);
+
+				if (_locked)
+					_toAdd.push_back(std::pair<Callback, unsigned int>(std::pair<float, CallbackFunction>(priority, callback), connection->_id));
+				else
+				{
+
+					_callbacks.push_back(std::pair<float, CallbackFunction>(priority, callback));
+					_slotIds.push_back(std::pair<float, unsigned int>(priority, connection->_id));
+
+					if (_callbacks.size() >= 2)
+					{
+						auto prec = std::prev(_callbacks.end(), 2);
+
+						if (priority > prec->first)
+							sortListSignals();
+					}
+				}
+
+				return connection;
+			}
+
+			void
+			execute(A... arguments)
+			{
+
+				_locked = true;
+				for (auto& callback : _callbacks)
+					callback.second(arguments...);
+				_locked = false;
+
+				for (auto& callbackIt : _toRemove)
+				{
+					_callbacks.erase(callbackIt.first);
+					_slotIds.erase(callbackIt.second);
+				}
+
+				for (auto& callbackAndConnectionId : _toAdd)
+				{
+
+					_callbacks.push_back(callbackAndConnectionId.first);
+					_slotIds.push_back(std::pair<float, unsigned int>(callbackAndConnectionId.first.first, callbackAndConnectionId.second));
+
+					if (_callbacks.size() >= 2)
+					{
+						auto prec = std::prev(_callbacks.end(), 2);
+
+						if (callbackAndConnectionId.first.first > prec->first)
+							_signalListDirty = true;
+					}
+				}
+
+				if (_signalListDirty)
+				{
+					_signalListDirty = false;
+					sortListSignals();
+				}
+
+				_toAdd.clear();
+				_toRemove.clear();
+			}
+
+		private:
+			template <typename... T>
+			class ListSignalSlot :
+				public std::enable_shared_from_this<ListSignalSlot<T...>>
+			{
+				friend class ListSignal<T...>;
+
+			public:
+				typedef std::shared_ptr<ListSignalSlot<T...>>    Ptr;
+
+			public:
+				std::shared_ptr<ListSignal<T...>>
+				signal()
+				{
+					return _signal;
+				}
+
+				void
+				disconnect()
+				{
+					if (_signal != nullptr)
+					{
+						_signal->removeConnectionById(_id);
+						_signal = nullptr;
+					}
+				}
+
+				~ListSignalSlot()
+				{
+					disconnect();
+				}
+
+			private:
+				std::shared_ptr<ListSignal<T...>>    _signal;
+				const unsigned int                _id;
+
+			private:
+				inline static
+				Ptr
+				create(std::shared_ptr<ListSignal<T...>> signal, const unsigned int id)
+				{
+					return std::shared_ptr<ListSignalSlot<T...>>(new ListSignalSlot(signal, id));
+				}
+
+				ListSignalSlot(std::shared_ptr<ListSignal<T...>> signal, const unsigned int id) :
+					_signal(signal),
+					_id(id)
+				{
+				}
+			};
+
+		};
+	}
+}
+
+double
+SignalBenchmarkTest::milliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void
+SignalBenchmarkTest::report(const std::string& name, double signalTime, double listSignalTime)
+{
+	std::cout << "[   BENCH  ] " << name << ": Signal " << signalTime << " ms, list based Signal "
+		<< listSignalTime << " ms" << std::endl;
+}
+
+template <typename S>
+double
+SignalBenchmarkTest::connect(uint numCallbacks)
+{
+	auto s = S::create();
+	std::vector<typename S::Slot> slots;
+	auto v = 0;
+
+	slots.reserve(numCallbacks);
+
+	auto start = Clock::now();
+
+	for (uint i = 0; i < numCallbacks; ++i)
+		slots.push_back(s->connect([&](int i) { v += i; }));
+
+	return milliseconds(start);
+}
+
+template <typename S>
+double
+SignalBenchmarkTest::disconnect(uint numCallbacks)
+{
+	auto s = S::create();
+	std::vector<typename S::Slot> slots;
+	auto v = 0;
+
+	for (uint i = 0; i < numCallbacks; ++i)
+		slots.push_back(s->connect([&](int i) { v += i; }));
+
+	auto start = Clock::now();
+
+	// disconnect in a scattered order, 7919 being prime
+	for (uint i = 0; i < numCallbacks; ++i)
+		slots[(i * 7919) % numCallbacks]->disconnect();
+
+	return milliseconds(start);
+}
+
+template <typename S>
+double
+SignalBenchmarkTest::execute(uint numCallbacks, uint numExecutions)
+{
+	auto s = S::create();
+	std::vector<typename S::Slot> slots;
+	auto v = 0;
+
+	for (uint i = 0; i < numCallbacks; ++i)
+		slots.push_back(s->connect([&](int i) { v += i; }));
+
+	auto start = Clock::now();
+
+	for (uint i = 0; i < numExecutions; ++i)
+		s->execute(1);
+
+	auto time = milliseconds(start);
+
+	EXPECT_EQ(v, numCallbacks * numExecutions);
+
+	return time;
+}
+
+TEST_F(SignalBenchmarkTest, DISABLED_Connect)
+{
+	report("connect 100000", connect<Signal<int>>(100000), connect<benchmark::ListSignal<int>>(100000));
+}
+
+TEST_F(SignalBenchmarkTest, DISABLED_Disconnect)
+{
+	report("disconnect 10000", disconnect<Signal<int>>(10000), disconnect<benchmark::ListSignal<int>>(10000));
+}
+
+TEST_F(SignalBenchmarkTest, DISABLED_ExecuteFewCallbacks)
+{
+	report("execute 1000000 x 4 callbacks", execute<Signal<int>>(4, 1000000), execute<benchmark::ListSignal<int>>(4, 1000000));
+}
+
+TEST_F(SignalBenchmarkTest, DISABLED_ExecuteManyCallbacks)
+{
+	report("execute 1000 x 1000 callbacks", execute<Signal<int>>(1000, 1000), execute<benchmark::ListSignal<int>>(1000, 1000));
+}
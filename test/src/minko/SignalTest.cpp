@@ -187,3 +187,57 @@ TEST_F(SignalTest, LockRemove)
 	ASSERT_EQ(v, 42);
 	ASSERT_EQ(w, 42);
 }
+
+TEST_F(SignalTest, Priority)
+{
+	auto s = Signal<>::create();
+	std::vector<int> order;
+	auto slot1 = s->connect([&]() { order.push_back(1); });
+	auto slot2 = s->connect([&]() { order.push_back(2); }, 10.f);
+	auto slot3 = s->connect([&]() { order.push_back(3); });
+	auto slot4 = s->connect([&]() { order.push_back(4); }, 10.f);
+
+	s->execute();
+
+	ASSERT_EQ(order, std::vector<int>({ 2, 4, 1, 3 }));
+}
+
+TEST_F(SignalTest, ReconnectAfterDisconnect)
+{
+	auto s = Signal<int>::create();
+	auto v1 = 0;
+	auto v2 = 0;
+	auto slot1 = s->connect([&](int i) { v1 = i; });
+
+	slot1->disconnect();
+	slot1->disconnect();
+
+	auto slot2 = s->connect([&](int i) { v2 = i; });
+
+	slot1 = nullptr;
+	s->execute(42);
+
+	ASSERT_EQ(s->numCallbacks(), 1);
+	ASSERT_EQ(v1, 0);
+	ASSERT_EQ(v2, 42);
+}
+
+TEST_F(SignalTest, ExecuteAfterException)
+{
+	auto s = Signal<int>::create();
+	auto v = 0;
+	Signal<int>::Slot slot2;
+	auto slot1 = s->connect([&](int i)
+	{
+		if (i == 0)
+			throw std::logic_error("error");
+		v = i;
+	});
+
+	ASSERT_THROW(s->execute(0), std::logic_error);
+
+	slot2 = s->connect([&](int i) { v += i; });
+	s->execute(21);
+
+	ASSERT_EQ(v, 42);
+}
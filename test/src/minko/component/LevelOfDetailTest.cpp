@@ -0,0 +1,177 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "LevelOfDetailTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::math;
+using namespace minko::component;
+using namespace minko::scene;
+
+static
+Node::Ptr
+createScene(Node::Ptr prop)
+{
+	auto root = Node::create("root")->addComponent(SceneManager::create(MinkoTests::canvas()));
+	auto camera = Node::create("camera")
+		->addComponent(Transform::create())
+		->addComponent(PerspectiveCamera::create(1.f, 1.f));
+
+	root->addChild(camera);
+	root->addChild(prop);
+
+	return root;
+}
+
+static
+Node::Ptr
+createProp(geometry::Geometry::Ptr geometry, float z)
+{
+	std::vector<render::Pass::Ptr> passes;
+
+	return Node::create("prop")
+		->addComponent(Transform::create(Matrix4x4::create()->appendTranslation(0.f, 0.f, z)))
+		->addComponent(Surface::create(geometry, material::Material::create(), render::Effect::create(passes)));
+}
+
+TEST_F(LevelOfDetailTest, AddLevelWithOtherAttributes)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto lod = LevelOfDetail::create()->addLevel(geometry::SphereGeometry::create(context), .5f);
+
+	ASSERT_THROW(lod->addLevel(geometry::SphereGeometry::create(context, 10, 10, false), 0.f), std::invalid_argument);
+	ASSERT_EQ(lod->numLevels(), 1);
+}
+
+TEST_F(LevelOfDetailTest, LevelsSortedByScreenSize)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto coarse = geometry::CubeGeometry::create(context);
+	auto fine = geometry::SphereGeometry::create(context, 20);
+	auto lod = LevelOfDetail::create()->addLevel(coarse, 0.f)->addLevel(fine, .5f);
+
+	ASSERT_EQ(lod->numLevels(), 2);
+	ASSERT_EQ(lod->levelGeometry(0), fine);
+	ASSERT_EQ(lod->levelGeometry(1), coarse);
+}
+
+TEST_F(LevelOfDetailTest, SelectFromScreenSize)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto fine = geometry::SphereGeometry::create(context, 20);
+	auto coarse = geometry::CubeGeometry::create(context);
+	auto prop = createProp(fine, -2.f);
+	auto lod = LevelOfDetail::create(.2f)->addLevel(fine, .1f)->addLevel(coarse, 0.f);
+
+	prop->addComponent(lod);
+
+	auto root = createScene(prop);
+	auto geometry = prop->component<Surface>()->geometry();
+
+	root->component<SceneManager>()->nextFrame(0.f, 0.f);
+	ASSERT_EQ(lod->level(), 0);
+	ASSERT_EQ(geometry->indices(), fine->indices());
+
+	prop->component<Transform>()->matrix()->appendTranslation(0.f, 0.f, -100.f);
+	root->component<SceneManager>()->nextFrame(0.f, 0.f);
+	root->component<SceneManager>()->nextFrame(0.f, 0.f);
+	ASSERT_LT(lod->screenSize(), .1f);
+	ASSERT_EQ(lod->level(), 1);
+	// the surface keeps its geometry, only the buffers change
+	ASSERT_EQ(prop->component<Surface>()->geometry(), geometry);
+	ASSERT_EQ(geometry->indices(), coarse->indices());
+	ASSERT_EQ(geometry->vertexBuffer("position"), coarse->vertexBuffer("position"));
+	ASSERT_EQ(geometry->numVertices(), coarse->numVertices());
+
+	prop->removeComponent(lod);
+	ASSERT_EQ(prop->component<Surface>()->geometry(), fine);
+}
+
+TEST_F(LevelOfDetailTest, OtherSurfacesAreUntouched)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto fine = geometry::SphereGeometry::create(context, 20);
+	auto coarse = geometry::CubeGeometry::create(context);
+	auto other = geometry::QuadGeometry::create(context);
+	auto otherIndices = other->indices();
+	auto prop = createProp(fine, -2.f);
+	std::vector<render::Pass::Ptr> passes;
+	auto otherSurface = Surface::create(other, material::Material::create(), render::Effect::create(passes));
+	auto lod = LevelOfDetail::create(.2f)->addLevel(fine, .1f)->addLevel(coarse, 0.f);
+
+	prop->addComponent(otherSurface);
+	prop->addComponent(lod);
+
+	auto root = createScene(prop);
+
+	ASSERT_NE(prop->component<Surface>(0)->geometry(), fine);
+	ASSERT_EQ(otherSurface->geometry(), other);
+
+	prop->component<Transform>()->matrix()->appendTranslation(0.f, 0.f, -100.f);
+	root->component<SceneManager>()->nextFrame(0.f, 0.f);
+	root->component<SceneManager>()->nextFrame(0.f, 0.f);
+	ASSERT_EQ(lod->level(), 1);
+	ASSERT_EQ(prop->component<Surface>(0)->geometry()->indices(), coarse->indices());
+	ASSERT_EQ(otherSurface->geometry(), other);
+	ASSERT_EQ(other->indices(), otherIndices);
+
+	prop->removeComponent(lod);
+	ASSERT_EQ(prop->component<Surface>(0)->geometry(), fine);
+	ASSERT_EQ(otherSurface->geometry(), other);
+}
+
+TEST_F(LevelOfDetailTest, Hysteresis)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto fine = geometry::SphereGeometry::create(context, 20);
+	auto coarse = geometry::CubeGeometry::create(context);
+	auto prop = createProp(fine, -100.f);
+	auto lod = LevelOfDetail::create(.5f)->addLevel(fine, .1f)->addLevel(coarse, 0.f);
+
+	prop->addComponent(lod);
+
+	auto root = createScene(prop);
+	auto sceneManager = root->component<SceneManager>();
+	auto matrix = prop->component<Transform>()->matrix();
+
+	sceneManager->nextFrame(0.f, 0.f);
+	sceneManager->nextFrame(0.f, 0.f);
+	ASSERT_EQ(lod->level(), 1);
+
+	// slightly above the threshold of the finest level, but within the hysteresis margin
+	auto distance = 100.f * lod->screenSize() / .12f;
+
+	matrix->copyFrom(Matrix4x4::create()->appendTranslation(0.f, 0.f, -distance));
+	sceneManager->nextFrame(0.f, 0.f);
+	sceneManager->nextFrame(0.f, 0.f);
+	ASSERT_GT(lod->screenSize(), .1f);
+	ASSERT_EQ(lod->level(), 1);
+
+	matrix->copyFrom(Matrix4x4::create()->appendTranslation(0.f, 0.f, -distance / 2.f));
+	sceneManager->nextFrame(0.f, 0.f);
+	sceneManager->nextFrame(0.f, 0.f);
+	ASSERT_EQ(lod->level(), 0);
+
+	matrix->copyFrom(Matrix4x4::create()->appendTranslation(0.f, 0.f, -distance));
+	sceneManager->nextFrame(0.f, 0.f);
+	sceneManager->nextFrame(0.f, 0.f);
+	ASSERT_EQ(lod->level(), 0);
+}
@@ -0,0 +1,223 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "ProgramWarmUpJobTest.hpp"
+#include "minko/render/RenderTestUtils.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::scene;
+
+static const std::string NORMAL_MAP_FRAGMENT_SOURCE =
+	"void main(void)\n"
+	"{\n"
+	"#ifdef NORMAL_MAP\n"
+	"	gl_FragColor = vec4(1.0);\n"
+	"#else\n"
+	"	gl_FragColor = vec4(0.0);\n"
+	"#endif\n"
+	"}\n";
+
+static
+render::Effect::Ptr
+createEffect(render::AbstractContext::Ptr context)
+{
+	data::MacroBindingMap macroBindings;
+	data::MacroBindingDefault unset;
+
+	unset.semantic = data::MacroBindingDefaultValueSemantic::UNSET;
+	macroBindings["NORMAL_MAP"] = std::make_tuple(
+		std::string("material[${materialId}].normalMap"), data::BindingSource::TARGET, unset, -INT_MAX, INT_MAX, nullptr
+	);
+
+	return render::RenderTestUtils::createEffect(
+		context, "pass", render::RenderTestUtils::VERTEX_SOURCE, NORMAL_MAP_FRAGMENT_SOURCE, data::BindingMap(),
+		data::BindingMap(), macroBindings
+	);
+}
+
+static
+uint
+numLinkedPrograms(render::NullContext::Ptr context)
+{
+	const auto numLinkedPrograms = render::RenderTestUtils::numCalls(context, "linkProgram");
+
+	context->clearCalls();
+
+	return numLinkedPrograms;
+}
+
+static
+void
+runJob(ProgramWarmUpJob::Ptr job)
+{
+	job->beforeFirstStep();
+	while (!job->complete())
+		job->step();
+	job->afterLastStep();
+}
+
+TEST_F(ProgramWarmUpJobTest, WarmUpSurfaces)
+{
+	auto context = render::NullContext::create();
+	auto renderer = Renderer::create();
+	auto material = material::Material::create();
+	auto root = Node::create("root")->addComponent(renderer);
+
+	material->set("normalMap", true);
+
+	auto mesh = Node::create("mesh")
+		->addComponent(Surface::create(geometry::CubeGeometry::create(context), material, createEffect(context)));
+
+	root->addChild(mesh);
+	context->recordCalls(true);
+
+	auto job = ProgramWarmUpJob::create(mesh);
+
+	runJob(job);
+
+	ASSERT_EQ(job->numWarmedUp(), 1);
+	ASSERT_EQ(job->numFailed(), 0);
+	ASSERT_EQ(numLinkedPrograms(context), 1);
+
+	renderer->render(context);
+
+	ASSERT_EQ(renderer->numDrawCalls(), 1);
+	ASSERT_EQ(numLinkedPrograms(context), 0);
+
+	// a permutation the job did not know about is compiled in the middle of the frame
+	material->unset("normalMap");
+	renderer->render(context);
+
+	ASSERT_EQ(numLinkedPrograms(context), 1);
+}
+
+TEST_F(ProgramWarmUpJobTest, WarmUpMaterialVariant)
+{
+	auto context = render::NullContext::create();
+	auto renderer = Renderer::create();
+	auto material = material::Material::create();
+	auto root = Node::create("root")->addComponent(renderer);
+
+	material->set("normalMap", true);
+
+	auto mesh = Node::create("mesh")
+		->addComponent(Surface::create(geometry::CubeGeometry::create(context), material, createEffect(context)));
+
+	root->addChild(mesh);
+	context->recordCalls(true);
+
+	// the normal map will be removed at runtime
+	auto variant = material::Material::create();
+	auto job = ProgramWarmUpJob::create(root)->addMaterialVariant(material, variant);
+
+	runJob(job);
+
+	ASSERT_EQ(job->numWarmedUp(), 2);
+	ASSERT_EQ(numLinkedPrograms(context), 2);
+
+	renderer->render(context);
+	material->unset("normalMap");
+	renderer->render(context);
+
+	ASSERT_EQ(renderer->numDrawCalls(), 1);
+	ASSERT_EQ(numLinkedPrograms(context), 0);
+	// the surface itself still uses its own material
+	ASSERT_EQ(mesh->component<Surface>()->material(), material);
+}
+
+TEST_F(ProgramWarmUpJobTest, NoRenderer)
+{
+	auto context = render::NullContext::create();
+	auto mesh = Node::create("mesh")
+		->addComponent(Surface::create(geometry::CubeGeometry::create(context), material::Material::create(), createEffect(context)));
+	auto job = ProgramWarmUpJob::create(mesh);
+
+	runJob(job);
+
+	ASSERT_EQ(job->numWarmedUp(), 0);
+	ASSERT_TRUE(job->complete());
+}
+
+TEST_F(ProgramWarmUpJobTest, WarmUpInstancingAndDepthPrePass)
+{
+	auto context = render::NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto geometry = geometry::CubeGeometry::create(context);
+	auto material = material::Material::create();
+	auto effect = render::RenderTestUtils::createInstancedEffect(context);
+
+	renderer->instancingEnabled(true);
+	renderer->depthPrePassEnabled(true);
+	root->addChild(Node::create("camera")->addComponent(renderer));
+	for (uint i = 0; i < 4; ++i)
+		root->addChild(Node::create("mesh")
+			->addComponent(Transform::create())
+			->addComponent(Surface::create(geometry, material, effect))
+		);
+	context->recordCalls(true);
+
+	auto job = ProgramWarmUpJob::create(root);
+
+	runJob(job);
+
+	// the regular and instanced programs, and their depth only versions
+	ASSERT_EQ(job->numWarmedUp(), 4);
+	ASSERT_EQ(numLinkedPrograms(context), 4);
+
+	renderer->render(context);
+
+	uint numInstancedDraws = 0;
+
+	for (auto& call : context->calls())
+		if (call.function == "drawInstancedTriangles")
+			++numInstancedDraws;
+
+	// the pre-pass and the main pass both draw the instances at once
+	ASSERT_EQ(numInstancedDraws, 2);
+	ASSERT_EQ(numLinkedPrograms(context), 0);
+}
+
+TEST_F(ProgramWarmUpJobTest, LayoutMask)
+{
+	auto context = render::NullContext::create();
+	auto renderer = Renderer::create();
+	auto material = material::Material::create();
+	auto root = Node::create("root")->addComponent(renderer);
+
+	material->set("normalMap", true);
+	renderer->layoutMask(Layout::Group::REFLECTION);
+
+	auto reflected = Node::create("reflected")
+		->addComponent(Surface::create(geometry::CubeGeometry::create(context), material, createEffect(context)));
+	auto hidden = Node::create("hidden")
+		->addComponent(Surface::create(geometry::CubeGeometry::create(context), material::Material::create(), createEffect(context)));
+
+	reflected->layouts(Layout::Group::DEFAULT | Layout::Group::REFLECTION);
+	root->addChild(reflected)->addChild(hidden);
+	context->recordCalls(true);
+
+	auto job = ProgramWarmUpJob::create(root);
+
+	runJob(job);
+
+	// the renderer never draws the hidden surface
+	ASSERT_EQ(job->numWarmedUp(), 1);
+	ASSERT_EQ(numLinkedPrograms(context), 1);
+}
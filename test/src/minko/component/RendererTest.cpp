@@ -0,0 +1,362 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "RendererTest.hpp"
+#include "minko/render/RenderTestUtils.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::render;
+using namespace minko::scene;
+
+// checks every draw call is measured by exactly one timer query, returns the queries in use
+static
+std::set<double>
+checkTimerQueries(NullContext::Ptr context)
+{
+	std::set<double> queries;
+	auto measuring = false;
+
+	for (auto& call : context->calls())
+		if (call.function == "beginTimerQuery")
+		{
+			EXPECT_FALSE(measuring);
+			measuring = true;
+			queries.insert(call.arguments[0]);
+		}
+		else if (call.function == "endTimerQuery")
+		{
+			EXPECT_TRUE(measuring);
+			measuring = false;
+		}
+		else if (call.function == "drawTriangles")
+			EXPECT_TRUE(measuring);
+
+	EXPECT_FALSE(measuring);
+
+	return queries;
+}
+
+TEST_F(RendererTest, TimerQueries)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(renderer);
+	auto cube = geometry::CubeGeometry::create(context);
+	auto opaque = RenderTestUtils::createEffect(context, "opaque");
+	auto wireframe = RenderTestUtils::createEffect(context, "wireframe");
+
+	root
+		->addChild(Node::create()->addComponent(Surface::create(cube, material::Material::create(), opaque)))
+		->addChild(Node::create()->addComponent(Surface::create(cube, material::Material::create(), wireframe)))
+		->addChild(Node::create()->addComponent(Surface::create(cube, material::Material::create(), opaque)));
+
+	renderer->profilingEnabled(true);
+	context->recordCalls(true);
+	renderer->render(context);
+
+	auto queries = checkTimerQueries(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 3);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "beginTimerQuery"), RenderTestUtils::numCalls(context, "createTimerQuery"));
+	ASSERT_EQ(queries.size(), RenderTestUtils::numCalls(context, "beginTimerQuery"));
+	ASSERT_EQ(renderer->frameStats().passes.size(), 2);
+	ASSERT_GE(queries.size(), 2);
+
+	uint numDrawCalls = 0;
+
+	for (auto& passStats : renderer->frameStats().passes)
+		numDrawCalls += passStats.numDrawCalls;
+	ASSERT_EQ(numDrawCalls, 3);
+
+	// the results were read back: the next frame reuses the same queries
+	context->clearCalls();
+	renderer->render(context);
+
+	ASSERT_EQ(checkTimerQueries(context), queries);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "createTimerQuery"), 0);
+
+	// no query is left behind once profiling stops
+	context->clearCalls();
+	renderer->profilingEnabled(false);
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "beginTimerQuery"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "deleteTimerQuery"), queries.size());
+}
+
+TEST_F(RendererTest, VertexArrays)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(renderer);
+	auto effect = RenderTestUtils::createEffect(context, "effect");
+	auto cube = geometry::CubeGeometry::create(context);
+	auto sphere = geometry::SphereGeometry::create(context);
+	// the buffers are shared with the cube, like the levels of a LevelOfDetail
+	auto geometry = geometry::Geometry::create();
+
+	for (auto& vertexBuffer : cube->vertexBuffers())
+		geometry->addVertexBuffer(vertexBuffer);
+	geometry->indices(cube->indices());
+	root
+		->addChild(Node::create()->addComponent(Surface::create(geometry, material::Material::create(), effect)))
+		->addChild(Node::create()->addComponent(Surface::create(sphere, material::Material::create(), effect)));
+
+	context->recordCalls(true);
+	renderer->render(context);
+
+	// the attributes of each draw call are specified once, in its own vertex array
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "createVertexArray"), 2);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "setVertexBufferAt"), 2);
+
+	std::set<double> vertexArrays;
+
+	for (auto& call : context->calls())
+		if (call.function == "setVertexArray")
+			vertexArrays.insert(call.arguments[0]);
+
+	context->clearCalls();
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 2);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "createVertexArray"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "setVertexBufferAt"), 0);
+
+	std::set<double> boundVertexArrays;
+
+	for (auto& call : context->calls())
+		if (call.function == "setVertexArray")
+			boundVertexArrays.insert(call.arguments[0]);
+
+	ASSERT_EQ(boundVertexArrays, vertexArrays);
+	ASSERT_EQ(boundVertexArrays.size(), 2);
+
+	// only the vertex array of the draw call whose vertex buffer changed is built again
+	auto otherCube = geometry::CubeGeometry::create(context);
+
+	context->clearCalls();
+	geometry->copyBuffers(otherCube);
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "deleteVertexArray"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "createVertexArray"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "setVertexBufferAt"), 1);
+}
+
+// number of uploads of each uniform location, for each program
+static
+std::map<double, std::map<double, uint>>
+uniformUploads(NullContext::Ptr context)
+{
+	std::map<double, std::map<double, uint>> uploads;
+	double program = 0.;
+
+	for (auto& call : context->calls())
+		if (call.function == "setProgram")
+			program = call.arguments[0];
+		else if (call.function == "setUniformMatrix")
+			++uploads[program][call.arguments[0]];
+
+	return uploads;
+}
+
+TEST_F(RendererTest, SharedUniforms)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto camera = Node::create("camera")->addComponent(renderer);
+	auto cameraData = data::StructureProvider::create("camera");
+	auto cube = geometry::CubeGeometry::create(context);
+	auto opaque = RenderTestUtils::createTransformEffect(context, "opaque");
+	auto wireframe = RenderTestUtils::createTransformEffect(context, "wireframe");
+
+	cameraData->set("worldToScreenMatrix", math::Matrix4x4::create());
+	camera->data()->addProvider(cameraData);
+	root->addChild(camera);
+	for (uint i = 0; i < 5; ++i)
+		root->addChild(Node::create()
+			->addComponent(Transform::create())
+			->addComponent(Surface::create(cube, material::Material::create(), i < 3 ? opaque : wireframe))
+		);
+
+	context->recordCalls(true);
+
+	for (uint frame = 0; frame < 2; ++frame)
+	{
+		renderer->render(context);
+
+		auto uploads = uniformUploads(context);
+		std::multiset<uint> counts;
+
+		for (auto& programAndUploads : uploads)
+			for (auto& locationAndCount : programAndUploads.second)
+				counts.insert(locationAndCount.second);
+
+		// the camera matrix is uploaded once per program and frame, the model to world matrix once per
+		// draw call
+		ASSERT_EQ(uploads.size(), 2);
+		ASSERT_EQ(counts, std::multiset<uint>({ 1, 1, 2, 3 }));
+
+		context->clearCalls();
+	}
+}
+
+// surfaces whose effect reads a scale and a color from their material, only the scale is set
+static
+std::vector<material::Material::Ptr>
+createScaledSurfaces(NullContext::Ptr context, Node::Ptr root, uint numSurfaces)
+{
+	data::BindingMap uniformBindings;
+
+	uniformBindings["scale"] = data::Binding("material[${materialId}].scale", data::BindingSource::TARGET);
+	uniformBindings["color"] = data::Binding("material[${materialId}].color", data::BindingSource::TARGET);
+
+	auto effect = RenderTestUtils::createEffect(
+		context,
+		"pass",
+		"attribute vec3 position;\n"
+		"uniform float scale;\n"
+		"void main(void) { gl_Position = vec4(position * scale, 1.0); }\n",
+		"uniform vec4 color;\n"
+		"void main(void) { gl_FragColor = color; }\n",
+		uniformBindings
+	);
+	auto cube = geometry::CubeGeometry::create(context);
+	std::vector<material::Material::Ptr> materials;
+
+	for (uint i = 0; i < numSurfaces; ++i)
+	{
+		auto material = material::Material::create();
+
+		material->set("scale", 1.f + i);
+		root->addChild(Node::create()->addComponent(Surface::create(cube, material, effect)));
+		materials.push_back(material);
+	}
+
+	return materials;
+}
+
+TEST_F(RendererTest, CommandBufferReplayEqualsRender)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(renderer);
+
+	createScaledSurfaces(context, root, 3);
+
+	// the first frame creates the resources
+	renderer->render(context);
+	context->recordCalls(true);
+	renderer->render(context);
+
+	auto direct = RenderTestUtils::callLog(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 3);
+
+	renderer->commandBufferEnabled(true);
+
+	for (uint frame = 0; frame < 3; ++frame)
+	{
+		context->clearCalls();
+		renderer->render(context);
+
+		ASSERT_EQ(RenderTestUtils::callLog(context), direct);
+		// recorded once, then replayed as it is
+		ASSERT_EQ(renderer->numRecordedDrawCalls(), frame == 0 ? 3 : 0);
+	}
+}
+
+TEST_F(RendererTest, CommandBufferRecordsChangedDrawCalls)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(renderer);
+	auto materials = createScaledSurfaces(context, root, 3);
+
+	renderer->commandBufferEnabled(true);
+	renderer->render(context);
+	renderer->render(context);
+
+	ASSERT_EQ(renderer->numRecordedDrawCalls(), 0);
+
+	// only the draw call whose uniform changed is recorded again
+	materials[0]->set("scale", 10.f);
+	renderer->render(context);
+
+	ASSERT_EQ(renderer->numRecordedDrawCalls(), 1);
+
+	// binding the color adds a uniform to the second draw call only
+	materials[1]->set("color", math::Vector4::create(1.f, 0.f, 0.f, 1.f));
+	context->recordCalls(true);
+	renderer->render(context);
+
+	auto replayed = RenderTestUtils::callLog(context);
+
+	ASSERT_EQ(renderer->numRecordedDrawCalls(), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "setUniform"), 4);
+
+	context->clearCalls();
+	renderer->render(context);
+
+	ASSERT_EQ(renderer->numRecordedDrawCalls(), 0);
+	ASSERT_EQ(RenderTestUtils::callLog(context), replayed);
+
+	context->clearCalls();
+	renderer->commandBufferEnabled(false);
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::callLog(context), replayed);
+}
+
+TEST_F(RendererTest, InvalidateCommandBuffer)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(renderer);
+	auto materials = createScaledSurfaces(context, root, 3);
+
+	renderer->commandBufferEnabled(true);
+	renderer->render(context);
+	renderer->render(context);
+
+	ASSERT_EQ(renderer->numRecordedDrawCalls(), 0);
+
+	materials[2]->set("color", math::Vector4::create(0.f, 1.f, 0.f, 1.f));
+	renderer->invalidateCommandBuffer();
+	context->recordCalls(true);
+	renderer->render(context);
+
+	auto replayed = RenderTestUtils::callLog(context);
+
+	// every draw call is recorded again, not only the one the uniform was added to
+	ASSERT_EQ(renderer->numRecordedDrawCalls(), 3);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "setUniform"), 4);
+
+	context->clearCalls();
+	renderer->render(context);
+
+	ASSERT_EQ(renderer->numRecordedDrawCalls(), 0);
+
+	context->clearCalls();
+	renderer->commandBufferEnabled(false);
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::callLog(context), replayed);
+}
@@ -0,0 +1,210 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "StaticBatcherTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::math;
+using namespace minko::component;
+using namespace minko::scene;
+
+static
+Node::Ptr
+createStaticScene(uint numCubes)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto geometry = geometry::CubeGeometry::create(context);
+	auto material = material::Material::create();
+	std::vector<render::Pass::Ptr> passes;
+	auto effect = render::Effect::create(passes);
+	auto level = Node::create("level")->addComponent(Transform::create());
+
+	level->layouts(level->layouts() | Layout::Group::STATIC);
+
+	for (uint i = 0; i < numCubes; ++i)
+	{
+		auto transform = Transform::create();
+
+		transform->matrix()->appendTranslation(float(i) * 2.f, 0.f, 0.f);
+		level->addChild(
+			Node::create("cube" + std::to_string(i))
+				->addComponent(transform)
+				->addComponent(Surface::create(geometry, material, effect))
+		);
+	}
+
+	return level;
+}
+
+TEST_F(StaticBatcherTest, MergeStaticSurfaces)
+{
+	auto level = createStaticScene(3);
+	auto batcher = StaticBatcher::create();
+
+	level->addComponent(batcher);
+
+	ASSERT_EQ(batcher->batches().size(), 1);
+	ASSERT_EQ(batcher->numBatchedSurfaces(), 3);
+
+	auto geometry = level->children()[0]->component<Surface>()->geometry();
+	auto batchGeometry = batcher->batches()[0]->component<Surface>()->geometry();
+
+	ASSERT_EQ(batchGeometry->numVertices(), geometry->numVertices() * 3);
+	ASSERT_EQ(batchGeometry->indices()->data().size(), geometry->indices()->data().size() * 3);
+
+	for (uint i = 0; i < 3; ++i)
+		ASSERT_EQ(level->children()[i]->layouts() & Layout::Group::DEFAULT, 0);
+}
+
+TEST_F(StaticBatcherTest, KeepNonRenderLayouts)
+{
+	auto level = createStaticScene(2);
+	auto batcher = StaticBatcher::create();
+	auto cube = level->children()[0];
+
+	cube->layouts(cube->layouts() | Layout::Group::PICKING);
+	level->addComponent(batcher);
+
+	ASSERT_EQ(cube->layouts(), Layout::Group::PICKING);
+}
+
+TEST_F(StaticBatcherTest, RestoreRenderLayoutOnly)
+{
+	auto level = createStaticScene(2);
+	auto batcher = StaticBatcher::create();
+	auto cube = level->children()[0];
+
+	level->addComponent(batcher);
+	cube->layouts(cube->layouts() | Layout::Group::PICKING);
+	level->removeComponent(batcher);
+
+	ASSERT_EQ(cube->layouts(), Layout::Group::DEFAULT | Layout::Group::PICKING);
+}
+
+TEST_F(StaticBatcherTest, PreTransformPositions)
+{
+	auto level = createStaticScene(2);
+	auto batcher = StaticBatcher::create();
+	auto geometry = level->children()[0]->component<Surface>()->geometry();
+	auto original = geometry->vertexBuffer("position");
+
+	level->addComponent(batcher);
+
+	auto batchVertexBuffer = batcher->batches()[0]->component<Surface>()->geometry()->vertexBuffer("position");
+	auto originalOffset = std::get<2>(*original->attribute("position"));
+	auto batchOffset = std::get<2>(*batchVertexBuffer->attribute("position"));
+	auto vertex = &original->data()[originalOffset];
+	auto batchVertex = &batchVertexBuffer->data()[geometry->numVertices() * batchVertexBuffer->vertexSize() + batchOffset];
+
+	ASSERT_FLOAT_EQ(batchVertex[0], vertex[0] + 2.f);
+	ASSERT_FLOAT_EQ(batchVertex[1], vertex[1]);
+	ASSERT_FLOAT_EQ(batchVertex[2], vertex[2]);
+}
+
+TEST_F(StaticBatcherTest, IgnoreDynamicSurfaces)
+{
+	auto level = createStaticScene(2);
+	auto batcher = StaticBatcher::create();
+
+	level->layouts(Layout::Group::DEFAULT);
+	level->addComponent(batcher);
+
+	ASSERT_TRUE(batcher->batches().empty());
+	ASSERT_EQ(level->children()[0]->layouts(), Layout::Group::DEFAULT);
+}
+
+TEST_F(StaticBatcherTest, SplitAtMaxNumVertices)
+{
+	auto level = createStaticScene(3);
+	auto numVertices = level->children()[0]->component<Surface>()->geometry()->numVertices();
+	auto batcher = StaticBatcher::create(numVertices * 2);
+
+	level->addComponent(batcher);
+
+	ASSERT_EQ(batcher->batches().size(), 2);
+	ASSERT_EQ(batcher->batches()[0]->component<Surface>()->geometry()->numVertices(), numVertices * 2);
+	ASSERT_EQ(batcher->batches()[1]->component<Surface>()->geometry()->numVertices(), numVertices);
+}
+
+TEST_F(StaticBatcherTest, OriginalNode)
+{
+	auto level = createStaticScene(3);
+	auto batcher = StaticBatcher::create();
+
+	level->addComponent(batcher);
+
+	auto batchSurface = batcher->batches()[0]->component<Surface>();
+
+	ASSERT_EQ(batcher->originalNode(batchSurface, 0), level->children()[0]);
+	ASSERT_EQ(batcher->originalNode(batchSurface, 12), level->children()[1]);
+	ASSERT_EQ(batcher->originalNode(batchSurface, 35), level->children()[2]);
+	ASSERT_THROW(batcher->originalNode(batchSurface, 36), std::invalid_argument);
+}
+
+TEST_F(StaticBatcherTest, OriginalNodeOfRemovedSurface)
+{
+	auto level = createStaticScene(2);
+	auto batcher = StaticBatcher::create();
+
+	level->addComponent(batcher);
+
+	auto cube = level->children()[1];
+	auto batchSurface = batcher->batches()[0]->component<Surface>();
+
+	cube->removeComponent(cube->component<Surface>());
+
+	ASSERT_EQ(batcher->originalNode(batchSurface, 12), cube);
+}
+
+TEST_F(StaticBatcherTest, HideOriginalSurface)
+{
+	auto level = createStaticScene(2);
+	auto batcher = StaticBatcher::create();
+
+	level->addComponent(batcher);
+
+	auto surface = level->children()[1]->component<Surface>();
+	auto& indices = batcher->batches()[0]->component<Surface>()->geometry()->indices()->data();
+	auto visibleIndices = indices;
+
+	surface->visible(false);
+
+	for (uint i = 36; i < 72; ++i)
+		ASSERT_EQ(indices[i], indices[36]);
+	ASSERT_TRUE(std::equal(indices.begin(), indices.begin() + 36, visibleIndices.begin()));
+
+	surface->visible(true);
+
+	ASSERT_EQ(indices, visibleIndices);
+}
+
+TEST_F(StaticBatcherTest, RemoveBatcher)
+{
+	auto level = createStaticScene(2);
+	auto batcher = StaticBatcher::create();
+
+	level->addComponent(batcher);
+	level->removeComponent(batcher);
+
+	ASSERT_TRUE(batcher->batches().empty());
+	ASSERT_EQ(level->children().size(), 2);
+	ASSERT_EQ(level->children()[0]->layouts(), Layout::Group::DEFAULT);
+}
@@ -247,3 +247,163 @@ TEST_F(ContainerTest, ArrayRemoveAdd)
 	ASSERT_TRUE(c->hasProvider(array2));
 	ASSERT_FALSE(c->hasProvider(array3));
 }
+
+TEST_F(ContainerTest, GetSetByPropertyName)
+{
+	auto array = ArrayProvider::create("array");
+	auto c = Container::create();
+	PropertyName name(std::string("array[0].foo"));
+
+	array->set("foo", 42);
+	c->addProvider(array);
+
+	ASSERT_TRUE(c->hasProperty(name));
+	ASSERT_EQ(c->get<int>(name), 42);
+	ASSERT_EQ(c->get<int>("array[0].foo"), 42);
+
+	c->set(name, 24);
+
+	ASSERT_EQ(array->get<int>("foo"), 24);
+}
+
+TEST_F(ContainerTest, SetStructureProperty)
+{
+	auto p = StructureProvider::create("material");
+	auto c = Container::create();
+
+	p->set("diffuse", 42);
+	c->addProvider(p);
+	c->set("material.diffuse", 24);
+
+	ASSERT_EQ(p->get<int>("diffuse"), 24);
+	ASSERT_EQ(c->get<int>("material.diffuse"), 24);
+}
+
+TEST_F(ContainerTest, BatchCoalescesChanges)
+{
+	auto c = Container::create();
+	auto p = Provider::create();
+	auto numValueChanged = 0;
+	auto numReferenceChanged = 0;
+	auto v = 0;
+
+	p->set("foo", 0);
+	c->addProvider(p);
+
+	auto _ = c->propertyValueChanged("foo")->connect(
+		[&](Container::Ptr container, const std::string& propertyName)
+		{
+			++numValueChanged;
+			v = container->get<int>("foo");
+		}
+	);
+	auto __ = c->propertyReferenceChanged("foo")->connect(
+		[&](Container::Ptr container, const std::string& propertyName)
+		{
+			++numReferenceChanged;
+		}
+	);
+
+	c->beginBatch();
+	p->set("foo", 1);
+	p->set("foo", 2);
+	c->beginBatch();
+	p->set("foo", 3);
+	c->endBatch();
+
+	ASSERT_TRUE(c->batching());
+	ASSERT_EQ(numValueChanged, 0);
+	ASSERT_EQ(numReferenceChanged, 0);
+
+	c->endBatch();
+
+	ASSERT_FALSE(c->batching());
+	ASSERT_EQ(numValueChanged, 1);
+	ASSERT_EQ(numReferenceChanged, 1);
+	ASSERT_EQ(v, 3);
+
+	p->set("foo", 4);
+
+	ASSERT_EQ(numValueChanged, 2);
+}
+
+TEST_F(ContainerTest, EndBatchWithoutBeginBatch)
+{
+	auto c = Container::create();
+
+	ASSERT_THROW(c->endBatch(), std::logic_error);
+}
+
+TEST_F(ContainerTest, ScopedBatchClosedOnException)
+{
+	auto c = Container::create();
+	auto p = Provider::create();
+	auto numValueChanged = 0;
+
+	p->set("foo", 0);
+	c->addProvider(p);
+
+	auto _ = c->propertyValueChanged("foo")->connect(
+		[&](Container::Ptr container, const std::string& propertyName)
+		{
+			++numValueChanged;
+		}
+	);
+
+	try
+	{
+		Container::ScopedBatch batch(c);
+
+		p->set("foo", 1);
+		p->set("foo", 2);
+
+		ASSERT_TRUE(c->batching());
+
+		throw std::runtime_error("");
+	}
+	catch (const std::runtime_error&)
+	{
+	}
+
+	ASSERT_FALSE(c->batching());
+	ASSERT_EQ(numValueChanged, 1);
+
+	p->set("foo", 3);
+
+	ASSERT_EQ(numValueChanged, 2);
+}
+
+TEST_F(ContainerTest, ScopedBatchEndRethrows)
+{
+	auto c1 = Container::create();
+	auto c2 = Container::create();
+	auto p = Provider::create();
+	auto numValueChanged = 0;
+
+	p->set("foo", 0);
+	c1->addProvider(p);
+	c2->addProvider(p);
+
+	auto _ = c1->propertyValueChanged("foo")->connect(
+		[&](Container::Ptr container, const std::string& propertyName)
+		{
+			throw std::runtime_error("");
+		}
+	);
+	auto __ = c2->propertyValueChanged("foo")->connect(
+		[&](Container::Ptr container, const std::string& propertyName)
+		{
+			++numValueChanged;
+		}
+	);
+
+	Container::ScopedBatch batch(c1);
+
+	batch.add(c2);
+	p->set("foo", 1);
+
+	ASSERT_THROW(batch.end(), std::runtime_error);
+	ASSERT_FALSE(c1->batching());
+	ASSERT_FALSE(c2->batching());
+	ASSERT_EQ(numValueChanged, 1);
+}
@@ -0,0 +1,191 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ContainerViewTest.hpp"
+
+#include "minko/data/ArrayProvider.hpp"
+
+using namespace minko::data;
+
+namespace
+{
+	class RejectFilter :
+		public AbstractFilter
+	{
+	public:
+		std::set<Provider::Ptr> rejected;
+
+		bool
+		operator()(Provider::Ptr provider)
+		{
+			return rejected.count(provider) == 0;
+		}
+	};
+}
+
+TEST_F(ContainerViewTest, Create)
+{
+	try
+	{
+		auto v = ContainerView::create(Container::create(), std::set<AbstractFilter::Ptr>());
+	}
+	catch (...)
+	{
+		ASSERT_TRUE(false);
+	}
+}
+
+TEST_F(ContainerViewTest, FilterProviders)
+{
+	auto c = Container::create();
+	auto p1 = Provider::create();
+	auto p2 = Provider::create();
+	auto f = std::make_shared<RejectFilter>();
+
+	p1->set("foo", 42);
+	p2->set("bar", 23);
+	c->addProvider(p1);
+	c->addProvider(p2);
+	f->rejected.insert(p2);
+
+	auto v = ContainerView::create(c, { f });
+
+	ASSERT_TRUE(v->container()->hasProvider(p1));
+	ASSERT_FALSE(v->container()->hasProvider(p2));
+	ASSERT_EQ(v->container()->get<int>("foo"), 42);
+	ASSERT_FALSE(v->container()->hasProperty("bar"));
+}
+
+TEST_F(ContainerViewTest, AddAndRemoveProviders)
+{
+	auto c = Container::create();
+	auto p1 = Provider::create();
+	auto p2 = Provider::create();
+	auto f = std::make_shared<RejectFilter>();
+	auto v = ContainerView::create(c, { f });
+	auto numChanged = 0;
+
+	auto _ = v->changed()->connect([&](ContainerView::Ptr view)
+	{
+		++numChanged;
+	});
+
+	f->rejected.insert(p2);
+	c->addProvider(p1);
+	c->addProvider(p2);
+
+	ASSERT_TRUE(v->container()->hasProvider(p1));
+	ASSERT_FALSE(v->container()->hasProvider(p2));
+	ASSERT_EQ(numChanged, 1);
+
+	c->removeProvider(p2);
+
+	ASSERT_EQ(numChanged, 1);
+
+	c->removeProvider(p1);
+
+	ASSERT_FALSE(v->container()->hasProvider(p1));
+	ASSERT_EQ(numChanged, 2);
+}
+
+TEST_F(ContainerViewTest, UpdateKeepsContainer)
+{
+	auto c = Container::create();
+	auto p1 = Provider::create();
+	auto p2 = Provider::create();
+	auto f = std::make_shared<RejectFilter>();
+
+	c->addProvider(p1);
+	c->addProvider(p2);
+
+	auto v = ContainerView::create(c, { f });
+	auto container = v->container();
+	auto numChanged = 0;
+
+	auto _ = v->changed()->connect([&](ContainerView::Ptr view)
+	{
+		++numChanged;
+	});
+
+	ASSERT_FALSE(v->update());
+	ASSERT_EQ(numChanged, 0);
+
+	f->rejected.insert(p1);
+
+	ASSERT_TRUE(v->update());
+	ASSERT_EQ(numChanged, 1);
+	ASSERT_EQ(v->container(), container);
+	ASSERT_FALSE(container->hasProvider(p1));
+	ASSERT_TRUE(container->hasProvider(p2));
+
+	// the same number of providers, but not the same ones
+	f->rejected.clear();
+	f->rejected.insert(p2);
+
+	ASSERT_TRUE(v->update());
+	ASSERT_EQ(numChanged, 2);
+	ASSERT_TRUE(container->hasProvider(p1));
+	ASSERT_FALSE(container->hasProvider(p2));
+}
+
+TEST_F(ContainerViewTest, SetFilters)
+{
+	auto c = Container::create();
+	auto p = Provider::create();
+	auto f = std::make_shared<RejectFilter>();
+
+	f->rejected.insert(p);
+	c->addProvider(p);
+
+	auto v = ContainerView::create(c, std::set<AbstractFilter::Ptr>());
+
+	ASSERT_TRUE(v->container()->hasProvider(p));
+
+	v->filters({ f });
+
+	ASSERT_FALSE(v->container()->hasProvider(p));
+
+	v->filters(std::set<AbstractFilter::Ptr>());
+
+	ASSERT_TRUE(v->container()->hasProvider(p));
+}
+
+TEST_F(ContainerViewTest, ArrayProviders)
+{
+	auto c = Container::create();
+	auto a1 = ArrayProvider::create("lights");
+	auto a2 = ArrayProvider::create("lights");
+	auto f = std::make_shared<RejectFilter>();
+	auto v = ContainerView::create(c, { f });
+
+	a1->set("color", 1);
+	a2->set("color", 2);
+	f->rejected.insert(a1);
+	c->addProvider(a1);
+	c->addProvider(a2);
+
+	ASSERT_EQ(c->get<int>("lights.length"), 2);
+	ASSERT_EQ(v->container()->get<int>("lights.length"), 1);
+	ASSERT_EQ(v->container()->get<int>("lights[0].color"), 2);
+
+	f->rejected.clear();
+	v->update();
+
+	ASSERT_EQ(v->container()->get<int>("lights.length"), 2);
+}
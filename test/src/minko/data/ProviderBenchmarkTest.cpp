@@ -0,0 +1,270 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ProviderBenchmarkTest.hpp"
+
+using namespace minko;
+using namespace minko::data;
+
+namespace minko
+{
+	namespace data
+	{
+		namespace benchmark
+		{
+			// the Any based storage Provider used for every value, kept as a reference for the benchmarks
+			class BoxedProvider :
+				public std::enable_shared_from_this<BoxedProvider>
+			{
+			public:
+				typedef std::shared_ptr<BoxedProvider>	Ptr;
+
+			private:
+				std::vector<std::string>								_names;
+				std::unordered_map<PropertyName, Any>					_values;
+
+				std::shared_ptr<Signal<Ptr, const std::string&>>		_propertyAdded;
+				std::shared_ptr<Signal<Ptr, const std::string&>>		_propValueChanged;
+				std::shared_ptr<Signal<Ptr, const std::string&>>		_propReferenceChanged;
+
+			public:
+				static
+				Ptr
+				create()
+				{
+					return std::shared_ptr<BoxedProvider>(new BoxedProvider());
+				}
+
+				template <typename T>
+				T
+				get(const PropertyName& propertyName) const
+				{
+					const auto foundIt = _values.find(formatPropertyName(propertyName));
+
+					if (foundIt == _values.end())
+						throw std::invalid_argument("propertyName");
+
+					return Any::unsafe_cast<T>(foundIt->second);
+				}
+
+				template <typename T>
+				Ptr
+				set(const PropertyName& propertyName, T value)
+				{
+					const auto formattedName	= formatPropertyName(propertyName);
+					const auto foundValueIt		= _values.find(formattedName);
+
+					if (foundValueIt == _values.end())
+					{
+						_values.insert(std::make_pair(formattedName, Any(value)));
+						_names.push_back(formattedName);
+
+						_propertyAdded->execute(shared_from_this(), formattedName);
+					}
+					else
+						foundValueIt->second = value;
+
+					_propReferenceChanged->execute(shared_from_this(), formattedName);
+					_propValueChanged->execute(shared_from_this(), formattedName);
+
+					return shared_from_this();
+				}
+
+				virtual
+				PropertyName
+				formatPropertyName(const PropertyName& propertyName) const
+				{
+					return propertyName;
+				}
+
+			private:
+				BoxedProvider() :
+					_names(),
+					_values(),
+					_propertyAdded(Signal<Ptr, const std::string&>::create()),
+					_propValueChanged(Signal<Ptr, const std::string&>::create()),
+					_propReferenceChanged(Signal<Ptr, const std::string&>::create())
+				{
+				}
+			};
+		}
+	}
+}
+
+/*static*/ const uint ProviderBenchmarkTest::NUM_PROPERTIES		= 1000;
+/*static*/ const uint ProviderBenchmarkTest::NUM_SETS_PER_FRAME	= 100000;
+/*static*/ const uint ProviderBenchmarkTest::NUM_FRAMES			= 60;
+
+typedef std::tuple<int, int, int, int> Int4;
+
+double
+ProviderBenchmarkTest::milliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void
+ProviderBenchmarkTest::report(const std::string& name, double providerTime, double boxedProviderTime)
+{
+	std::cout << "[   BENCH  ] " << name << ": Provider " << providerTime << " ms, boxed Provider "
+		<< boxedProviderTime << " ms" << std::endl;
+}
+
+void
+ProviderBenchmarkTest::report(const std::string& name, double providerTime)
+{
+	std::cout << "[   BENCH  ] " << name << ": " << providerTime << " ms" << std::endl;
+}
+
+std::vector<PropertyName>
+ProviderBenchmarkTest::propertyNames()
+{
+	std::vector<PropertyName> names;
+
+	for (uint i = 0; i < NUM_PROPERTIES; ++i)
+		names.push_back(PropertyName("property" + std::to_string(i)));
+
+	return names;
+}
+
+// each benchmark reports the best frame, a frame setting or getting NUM_SETS_PER_FRAME float,
+// int and Int4 values spread over NUM_PROPERTIES names
+template <typename P>
+double
+ProviderBenchmarkTest::set(const std::vector<PropertyName>& names)
+{
+	auto p = P::create();
+	auto best = std::numeric_limits<double>::max();
+
+	for (uint frame = 0; frame < NUM_FRAMES; ++frame)
+	{
+		auto start = Clock::now();
+
+		for (uint i = 0; i < NUM_SETS_PER_FRAME; i += 3)
+		{
+			p->set(names[i % NUM_PROPERTIES], float(i));
+			p->set(names[(i + 1) % NUM_PROPERTIES], int(i));
+			p->set(names[(i + 2) % NUM_PROPERTIES], Int4(i, i, i, i));
+		}
+
+		best = std::min(best, milliseconds(start));
+	}
+
+	return best;
+}
+
+template <typename P>
+double
+ProviderBenchmarkTest::get(const std::vector<PropertyName>& names)
+{
+	auto p = P::create();
+	auto best = std::numeric_limits<double>::max();
+	auto sum = 0.f;
+
+	for (uint i = 0; i < NUM_PROPERTIES; ++i)
+		p->set(names[i], float(i));
+
+	for (uint frame = 0; frame < NUM_FRAMES; ++frame)
+	{
+		auto start = Clock::now();
+
+		for (uint i = 0; i < NUM_SETS_PER_FRAME; ++i)
+			sum += p->template get<float>(names[i % NUM_PROPERTIES]);
+
+		best = std::min(best, milliseconds(start));
+	}
+
+	EXPECT_GT(sum, 0.f);
+
+	return best;
+}
+
+TEST_F(ProviderBenchmarkTest, DISABLED_Set)
+{
+	auto names = propertyNames();
+
+	report("set 100000 values", set<Provider>(names), set<benchmark::BoxedProvider>(names));
+}
+
+TEST_F(ProviderBenchmarkTest, DISABLED_Get)
+{
+	auto names = propertyNames();
+
+	report("get 100000 values", get<Provider>(names), get<benchmark::BoxedProvider>(names));
+}
+
+TEST_F(ProviderBenchmarkTest, DISABLED_SetThroughContainer)
+{
+	auto names = propertyNames();
+	auto p = Provider::create();
+	auto c = Container::create();
+	auto best = std::numeric_limits<double>::max();
+	auto numChanges = 0;
+	std::vector<Container::PropertyChangedSignal::Slot> slots;
+
+	for (uint i = 0; i < NUM_PROPERTIES; ++i)
+		p->set(names[i], float(i));
+	c->addProvider(p);
+
+	for (uint i = 0; i < 100; ++i)
+		slots.push_back(c->propertyValueChanged(names[i])->connect(
+			[&](Container::Ptr, const std::string&) { ++numChanges; }
+		));
+
+	for (uint frame = 0; frame < NUM_FRAMES; ++frame)
+	{
+		auto start = Clock::now();
+
+		for (uint i = 0; i < NUM_SETS_PER_FRAME; ++i)
+			p->set(names[i % NUM_PROPERTIES], float(i));
+
+		best = std::min(best, milliseconds(start));
+	}
+
+	EXPECT_EQ(numChanges, NUM_FRAMES * NUM_SETS_PER_FRAME / 10);
+
+	report("set 100000 values through a container, 100 listeners", best);
+}
+
+TEST_F(ProviderBenchmarkTest, DISABLED_ContainerGet)
+{
+	auto names = propertyNames();
+	auto p = Provider::create();
+	auto c = Container::create();
+	auto best = std::numeric_limits<double>::max();
+	auto sum = 0.f;
+
+	for (uint i = 0; i < NUM_PROPERTIES; ++i)
+		p->set(names[i], float(i));
+	c->addProvider(p);
+
+	for (uint frame = 0; frame < NUM_FRAMES; ++frame)
+	{
+		auto start = Clock::now();
+
+		for (uint i = 0; i < NUM_SETS_PER_FRAME; ++i)
+			sum += c->get<float>(names[i % NUM_PROPERTIES]);
+
+		best = std::min(best, milliseconds(start));
+	}
+
+	EXPECT_GT(sum, 0.f);
+
+	report("get 100000 values through a container", best);
+}
@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Minko.hpp"
+
+#include "gtest/gtest.h"
+
+namespace minko
+{
+	namespace data
+	{
+		// benchmarks are disabled by default, run them with --gtest_also_run_disabled_tests
+		class ProviderBenchmarkTest :
+			public ::testing::Test
+		{
+		protected:
+			typedef std::chrono::high_resolution_clock Clock;
+
+			static const uint NUM_PROPERTIES;
+			static const uint NUM_SETS_PER_FRAME;
+			static const uint NUM_FRAMES;
+
+			static
+			double
+			milliseconds(Clock::time_point start);
+
+			static
+			void
+			report(const std::string& name, double providerTime, double boxedProviderTime);
+
+			static
+			void
+			report(const std::string& name, double providerTime);
+
+			template <typename P>
+			static
+			double
+			set(const std::vector<PropertyName>& names);
+
+			template <typename P>
+			static
+			double
+			get(const std::vector<PropertyName>& names);
+
+			static
+			std::vector<PropertyName>
+			propertyNames();
+		};
+	}
+}
@@ -177,3 +177,151 @@ TEST_F(ProviderTest, Swap)
 	ASSERT_EQ(vFoo, 24);
 	ASSERT_EQ(vBar, 42);
 }
+
+TEST_F(ProviderTest, PropertyNameInterned)
+{
+	PropertyName a(std::string("foo"));
+	PropertyName b(std::string("foo"));
+	PropertyName c(std::string("bar"));
+
+	ASSERT_TRUE(a == b);
+	ASSERT_EQ(a.hash(), b.hash());
+	ASSERT_TRUE(a != c);
+	ASSERT_EQ(a.str(), "foo");
+	ASSERT_TRUE(PropertyName().empty());
+}
+
+TEST_F(ProviderTest, GetSetByPropertyName)
+{
+	auto p = Provider::create();
+	PropertyName foo(std::string("foo"));
+
+	p->set(foo, 42);
+
+	ASSERT_TRUE(p->hasProperty(foo));
+	ASSERT_TRUE(p->hasProperty("foo"));
+	ASSERT_EQ(p->get<int>(foo), 42);
+	ASSERT_EQ(p->get<int>("foo"), 42);
+	ASSERT_TRUE(p->propertyHasType<int>(foo));
+
+	p->unset(foo);
+
+	ASSERT_FALSE(p->hasProperty("foo"));
+}
+
+TEST_F(ProviderTest, StructurePropertyName)
+{
+	auto p = StructureProvider::create("material");
+	PropertyName diffuse(std::string("diffuse"));
+
+	p->set(diffuse, 42);
+
+	ASSERT_TRUE(p->hasProperty(PropertyName(std::string("material.diffuse")), true));
+	ASSERT_EQ(p->get<int>(diffuse), 42);
+}
+
+TEST_F(ProviderTest, ChangePropertyStorage)
+{
+	auto p = Provider::create();
+	auto numAdded = 0;
+
+	auto _ = p->propertyAdded()->connect(
+		[&](Provider::Ptr provider, const std::string& propertyName)
+		{
+			++numAdded;
+		}
+	);
+
+	p->set("foo", 42);
+	p->set("foo", std::string("bar"));
+
+	ASSERT_EQ(numAdded, 1);
+	ASSERT_TRUE(p->propertyHasType<std::string>("foo"));
+	ASSERT_EQ(p->get<std::string>("foo"), "bar");
+
+	p->set("foo", 24.f);
+
+	ASSERT_EQ(numAdded, 1);
+	ASSERT_TRUE(p->propertyHasType<float>("foo"));
+	ASSERT_FALSE(p->propertyHasType<int>("foo"));
+	ASSERT_EQ(p->get<float>("foo"), 24.f);
+	ASSERT_EQ(p->propertyNames().size(), 1);
+}
+
+TEST_F(ProviderTest, SwapInlineAndBoxed)
+{
+	auto p = Provider::create();
+
+	p->set("foo", 42);
+	p->set("bar", std::string("bar"));
+
+	p->swap("foo", "bar");
+
+	ASSERT_EQ(p->get<std::string>("foo"), "bar");
+	ASSERT_EQ(p->get<int>("bar"), 42);
+
+	p->unset("foo");
+	p->swap("bar", "foo");
+
+	ASSERT_FALSE(p->hasProperty("bar"));
+	ASSERT_EQ(p->get<int>("foo"), 42);
+}
+
+TEST_F(ProviderTest, CloneInlineValues)
+{
+	auto p = Provider::create();
+
+	p->set("foo", 42);
+	p->set("bar", std::make_tuple(1, 2, 3, 4));
+	p->unset("foo");
+	p->set("baz", 24.f);
+
+	auto clone = p->clone();
+
+	ASSERT_FALSE(clone->hasProperty("foo"));
+	ASSERT_EQ(std::get<3>(clone->get<std::tuple<int, int, int, int>>("bar")), 4);
+	ASSERT_EQ(clone->get<float>("baz"), 24.f);
+}
+
+TEST_F(ProviderTest, Values)
+{
+	auto p = Provider::create();
+
+	p->set("foo", 42);
+	p->set("bar", std::string("bar"));
+
+	auto values = p->values();
+
+	ASSERT_EQ(values.size(), 2);
+	ASSERT_EQ(Any::cast<int>(values.at(PropertyName("foo"))), 42);
+	ASSERT_EQ(Any::cast<std::string>(values.at(PropertyName("bar"))), "bar");
+}
+
+TEST_F(ProviderTest, UnsetManyValues)
+{
+	auto p = Provider::create();
+
+	for (auto i = 0; i < 100; ++i)
+		p->set("property" + std::to_string(i), i);
+	for (auto i = 0; i < 100; i += 3)
+		p->set("property" + std::to_string(i), std::to_string(i));
+	for (auto i = 0; i < 100; i += 2)
+		p->unset("property" + std::to_string(i));
+
+	ASSERT_EQ(p->propertyNames().size(), 50);
+	ASSERT_EQ(p->values().size(), 50);
+
+	for (auto i = 0; i < 100; ++i)
+	{
+		const auto name = "property" + std::to_string(i);
+
+		ASSERT_EQ(p->hasProperty(name), i % 2 != 0);
+		if (i % 2 == 0)
+			continue;
+
+		if (i % 3 == 0)
+			ASSERT_EQ(p->get<std::string>(name), std::to_string(i));
+		else
+			ASSERT_EQ(p->get<int>(name), i);
+	}
+}
@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "QuadricSimplifierTest.hpp"
+
+#include "minko/data/QuadricSimplifier.hpp"
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::data;
+
+static
+std::vector<std::array<float, 3>>
+positions(geometry::Geometry::Ptr geometry)
+{
+	auto vertexBuffer = geometry->vertexBuffer("position");
+	auto offset = std::get<2>(*vertexBuffer->attribute("position"));
+	auto& data = vertexBuffer->data();
+	std::vector<std::array<float, 3>> positions;
+
+	for (uint i = 0; i < geometry->numVertices(); ++i)
+	{
+		auto xyz = &data[i * vertexBuffer->vertexSize() + offset];
+		std::array<float, 3> position = {{ xyz[0], xyz[1], xyz[2] }};
+
+		positions.push_back(position);
+	}
+
+	return positions;
+}
+
+TEST_F(QuadricSimplifierTest, TargetNumTriangles)
+{
+	auto geometry = geometry::QuadGeometry::create(MinkoTests::canvas()->context(), 8, 8);
+	auto simplifier = QuadricSimplifier::create(geometry);
+
+	ASSERT_EQ(simplifier->numTriangles(), 128);
+
+	auto simplified = simplifier->simplify(64);
+
+	// every collapse of an inner vertex removes 2 triangles
+	ASSERT_LE(simplifier->numTriangles(), 64);
+	ASSERT_GE(simplifier->numTriangles(), 62);
+	ASSERT_EQ(simplified->indices()->numIndices(), simplifier->numTriangles() * 3);
+	ASSERT_LT(simplified->numVertices(), geometry->numVertices());
+}
+
+TEST_F(QuadricSimplifierTest, SuccessiveLevels)
+{
+	auto geometry = geometry::QuadGeometry::create(MinkoTests::canvas()->context(), 8, 8);
+	auto simplifier = QuadricSimplifier::create(geometry);
+	auto level1 = simplifier->simplify(96);
+	auto level2 = simplifier->simplify(48);
+
+	ASSERT_LE(level1->indices()->numIndices(), 96 * 3);
+	ASSERT_LE(level2->indices()->numIndices(), 48 * 3);
+	ASSERT_LT(level2->indices()->numIndices(), level1->indices()->numIndices());
+}
+
+TEST_F(QuadricSimplifierTest, PreserveBorders)
+{
+	auto geometry = geometry::QuadGeometry::create(MinkoTests::canvas()->context(), 8, 8);
+	auto simplifier = QuadricSimplifier::create(geometry);
+	auto simplified = simplifier->simplify(0);
+	auto original = positions(geometry);
+	auto reduced = positions(simplified);
+
+	// the 32 vertices of the border of the grid cannot move
+	ASSERT_EQ(simplifier->numTriangles(), 30);
+
+	for (auto& position : original)
+	{
+		auto onBorder = fabsf(position[0]) == .5f || fabsf(position[1]) == .5f;
+
+		if (onBorder)
+			ASSERT_NE(std::find(reduced.begin(), reduced.end(), position), reduced.end());
+	}
+
+	for (auto& position : reduced)
+		ASSERT_NE(std::find(original.begin(), original.end(), position), original.end());
+}
+
+TEST_F(QuadricSimplifierTest, LockSeams)
+{
+	auto geometry = geometry::CubeGeometry::create(MinkoTests::canvas()->context());
+	auto simplifier = QuadricSimplifier::create(geometry);
+	auto simplified = simplifier->simplify(0);
+
+	// each corner of the cube is shared by 3 vertices with different normals
+	ASSERT_EQ(simplifier->numTriangles(), 12);
+	ASSERT_EQ(simplified->indices()->numIndices(), geometry->indices()->numIndices());
+}
+
+TEST_F(QuadricSimplifierTest, IgnoreDegenerateTriangles)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto geometry = geometry::Geometry::create();
+	std::vector<float> vertexData = { 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 1.f, 0.f, 0.f };
+	std::vector<unsigned short> indices = { 0, 1, 2, 0, 0, 1, 1, 3, 2, 2, 2, 2 };
+	auto vertexBuffer = render::VertexBuffer::create(context, vertexData);
+
+	vertexBuffer->addAttribute("position", 3, 0);
+	geometry->addVertexBuffer(vertexBuffer);
+	geometry->indices(render::IndexBuffer::create(context, indices));
+
+	auto simplifier = QuadricSimplifier::create(geometry);
+
+	// vertex 3 is welded to vertex 1, which makes the third triangle degenerate too
+	ASSERT_EQ(simplifier->numTriangles(), 1);
+	ASSERT_EQ(simplifier->simplify(0)->indices()->numIndices(), 3);
+}
+
+TEST_F(QuadricSimplifierTest, RequireIndicesAndPositions)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto geometry = geometry::Geometry::create();
+	std::vector<float> vertexData = { 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+	auto vertexBuffer = render::VertexBuffer::create(context, vertexData);
+
+	vertexBuffer->addAttribute("position", 3, 0);
+	geometry->addVertexBuffer(vertexBuffer);
+
+	ASSERT_THROW(QuadricSimplifier::create(geometry), std::invalid_argument);
+}
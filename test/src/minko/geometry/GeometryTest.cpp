@@ -130,3 +130,34 @@ TEST_F(GeometryTest, VertexBufferRemovedFromData)
 
 	ASSERT_FALSE(g->data()->hasProperty("position"));
 }
+
+TEST_F(GeometryTest, CopyBuffers)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto g = CubeGeometry::create(context);
+	auto indices = g->indices();
+	auto other = CubeGeometry::create(context);
+
+	g->copyBuffers(other);
+
+	ASSERT_NE(g->indices(), indices);
+	ASSERT_EQ(g->vertexBuffer("position"), other->vertexBuffer("position"));
+	ASSERT_EQ(g->indices(), other->indices());
+	ASSERT_EQ(g->data()->get<render::VertexBuffer::Ptr>("position"), other->vertexBuffer("position"));
+}
+
+TEST_F(GeometryTest, CopyBuffersWithoutIndices)
+{
+	auto context = MinkoTests::canvas()->context();
+	auto g = CubeGeometry::create(context);
+	auto indices = g->indices();
+	auto positions = g->vertexBuffer("position");
+	auto other = Geometry::create();
+
+	for (auto vertexBuffer : CubeGeometry::create(context)->vertexBuffers())
+		other->addVertexBuffer(vertexBuffer);
+
+	ASSERT_THROW(g->copyBuffers(other), std::invalid_argument);
+	ASSERT_EQ(g->indices(), indices);
+	ASSERT_EQ(g->vertexBuffer("position"), positions);
+}
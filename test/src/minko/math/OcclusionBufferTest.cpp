@@ -0,0 +1,106 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/math/OcclusionBufferTest.hpp"
+
+using namespace minko;
+using namespace minko::math;
+
+namespace
+{
+	// looking down -z from the origin
+	Matrix4x4::Ptr
+	worldToScreen()
+	{
+		return Matrix4x4::create()->perspective(1.f, 1.f, 0.1f, 100.f);
+	}
+
+	Box::Ptr
+	box(float x, float y, float z, float halfSize)
+	{
+		return Box::create(
+			Vector3::create(x + halfSize, y + halfSize, z + halfSize),
+			Vector3::create(x - halfSize, y - halfSize, z - halfSize)
+		);
+	}
+}
+
+TEST_F(OcclusionBufferTest, CreateInvalidTileSize)
+{
+	ASSERT_THROW(OcclusionBuffer::create(100, 64, 8), std::invalid_argument);
+	ASSERT_THROW(OcclusionBuffer::create(64, 64, 0), std::invalid_argument);
+}
+
+TEST_F(OcclusionBufferTest, NoOccluder)
+{
+	auto buffer = OcclusionBuffer::create(128, 128);
+
+	buffer->clear(worldToScreen());
+
+	ASSERT_FALSE(buffer->occluded(box(0.f, 0.f, -10.f, .5f)));
+}
+
+TEST_F(OcclusionBufferTest, BoxHull)
+{
+	auto buffer = OcclusionBuffer::create(128, 128);
+
+	buffer->clear(worldToScreen());
+	buffer->rasterize(Box::create(Vector3::create(1.f, 1.f, -2.9f), Vector3::create(-1.f, -1.f, -3.f)));
+
+	ASSERT_EQ(12u, buffer->numOccluderTriangles());
+	ASSERT_LT(buffer->depth(64, 64), 1.f);
+	ASSERT_EQ(1.f, buffer->depth(0, 0));
+
+	ASSERT_TRUE(buffer->occluded(box(0.f, 0.f, -10.f, .5f)));
+	ASSERT_TRUE(buffer->occluded(box(1.f, -1.f, -10.f, .5f)));
+	// in front of the occluder
+	ASSERT_FALSE(buffer->occluded(box(0.f, 0.f, -2.f, .5f)));
+	// partially hidden
+	ASSERT_FALSE(buffer->occluded(box(2.5f, 0.f, -10.f, 1.f)));
+	// beside the occluder
+	ASSERT_FALSE(buffer->occluded(box(4.f, 0.f, -10.f, .5f)));
+	// crossing the near plane
+	ASSERT_FALSE(buffer->occluded(box(0.f, 0.f, 0.f, 1.f)));
+}
+
+TEST_F(OcclusionBufferTest, Mesh)
+{
+	auto buffer = OcclusionBuffer::create(128, 128);
+	// interleaved position and uv
+	std::vector<float> vertices = {
+		-1.f, -1.f, 0.f, 0.f, 0.f,
+		1.f, -1.f, 0.f, 1.f, 0.f,
+		1.f, 1.f, 0.f, 1.f, 1.f,
+		-1.f, 1.f, 0.f, 0.f, 1.f
+	};
+	std::vector<unsigned short> indices = { 0, 1, 2, 0, 2, 3 };
+
+	buffer->clear(worldToScreen());
+	buffer->rasterize(vertices, 5, 0, indices, Matrix4x4::create()->appendTranslation(0.f, 0.f, -3.f));
+
+	ASSERT_EQ(2u, buffer->numOccluderTriangles());
+	ASSERT_TRUE(buffer->occluded(box(0.f, 0.f, -10.f, .5f)));
+	ASSERT_FALSE(buffer->occluded(box(4.f, 0.f, -10.f, .5f)));
+
+	buffer->clear(worldToScreen());
+	buffer->rasterize(vertices, 5, 0, indices, Matrix4x4::create()->appendTranslation(0.f, 0.f, -20.f));
+
+	ASSERT_FALSE(buffer->occluded(box(0.f, 0.f, -10.f, .5f)));
+	ASSERT_TRUE(buffer->occluded(box(0.f, 0.f, -40.f, .5f)));
+}
@@ -0,0 +1,158 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "CommandBufferTest.hpp"
+#include "minko/render/RenderTestUtils.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+static
+CommandBuffer::UniformValue
+floatUniform(int location, float value)
+{
+	CommandBuffer::UniformValue uniform;
+
+	uniform.type = CommandBuffer::UniformType::FLOAT1;
+	uniform.location = location;
+	uniform.floatValue = value;
+
+	return uniform;
+}
+
+TEST_F(CommandBufferTest, ExecuteEqualsDirectCalls)
+{
+	auto direct = NullContext::create();
+	auto replayed = NullContext::create();
+	auto buffer = CommandBuffer::create();
+	auto scale = floatUniform(2, 1.f);
+
+	direct->recordCalls(true);
+	direct->configureViewport(0, 0, 640, 480);
+	direct->setProgram(1);
+	direct->setUniform(2, 1.f);
+	direct->setVertexBufferAt(0, 3, 3, 6, 0);
+	direct->setBlendMode(Blending::Mode::ALPHA);
+	direct->setDepthTest(true, CompareMode::LESS);
+	direct->setTriangleCulling(TriangleCulling::BACK);
+	direct->drawTriangles(4, 12);
+
+	buffer->configureViewport(0, 0, 640, 480);
+	buffer->setProgram(1);
+	buffer->setUniform(&scale);
+	buffer->setVertexBufferAt(0, 3, 3, 6, 0);
+	buffer->setBlendMode(Blending::Mode::ALPHA);
+	buffer->setDepthTest(true, CompareMode::LESS);
+	buffer->setTriangleCulling(TriangleCulling::BACK);
+	buffer->drawTriangles(4, 12);
+
+	ASSERT_EQ(buffer->size(), 8);
+
+	replayed->recordCalls(true);
+	buffer->execute(replayed);
+
+	ASSERT_EQ(RenderTestUtils::callLog(replayed), RenderTestUtils::callLog(direct));
+
+	// the stream can be replayed as many times as needed
+	replayed->clearCalls();
+	buffer->execute(replayed);
+
+	ASSERT_EQ(RenderTestUtils::callLog(replayed), RenderTestUtils::callLog(direct));
+}
+
+TEST_F(CommandBufferTest, ExecuteRange)
+{
+	auto context = NullContext::create();
+	auto buffer = CommandBuffer::create();
+
+	for (uint i = 0; i < 3; ++i)
+	{
+		buffer->setProgram(i + 1);
+		buffer->drawTriangles(10 + i, 12);
+	}
+
+	context->recordCalls(true);
+	buffer->execute(context, 2, 4);
+
+	ASSERT_EQ(context->calls().size(), 2);
+	ASSERT_EQ(context->calls()[0].function, "setProgram");
+	ASSERT_EQ(context->calls()[0].arguments[0], 2.);
+	ASSERT_EQ(context->calls()[1].function, "drawTriangles");
+	ASSERT_EQ(context->calls()[1].arguments[0], 11.);
+}
+
+TEST_F(CommandBufferTest, AppendRange)
+{
+	auto context = NullContext::create();
+	auto previous = CommandBuffer::create();
+	auto buffer = CommandBuffer::create();
+
+	for (uint i = 0; i < 3; ++i)
+	{
+		previous->setProgram(i + 1);
+		previous->drawTriangles(10 + i, 12);
+	}
+
+	buffer->append(*previous, 4, 6);
+	buffer->append(*previous, 0, 2);
+
+	ASSERT_EQ(buffer->size(), 4);
+
+	context->recordCalls(true);
+	buffer->execute(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 2);
+	ASSERT_EQ(context->calls()[0].arguments[0], 3.);
+	ASSERT_EQ(context->calls()[1].arguments[0], 12.);
+	ASSERT_EQ(context->calls()[2].arguments[0], 1.);
+	ASSERT_EQ(context->calls()[3].arguments[0], 10.);
+}
+
+TEST_F(CommandBufferTest, UniformsAreReadWhenExecuted)
+{
+	auto context = NullContext::create();
+	auto buffer = CommandBuffer::create();
+	std::vector<CommandBuffer::UniformValue> uniforms;
+	std::vector<int> slots;
+
+	CommandBuffer::uniformValue(uniforms, slots, 5) = floatUniform(5, 1.f);
+	CommandBuffer::uniformValue(uniforms, slots, 2) = floatUniform(2, 2.f);
+
+	ASSERT_EQ(uniforms.size(), 2);
+	ASSERT_EQ(&CommandBuffer::uniformValue(uniforms, slots, 5), &uniforms[0]);
+	ASSERT_EQ(&CommandBuffer::uniformValue(uniforms, slots, 2), &uniforms[1]);
+	ASSERT_EQ(uniforms.size(), 2);
+
+	for (auto& uniform : uniforms)
+		buffer->setUniform(&uniform);
+
+	// the commands reference the values: changing one after recording changes the call
+	std::vector<float> matrix(16, 0.f);
+
+	uniforms[1].type = CommandBuffer::UniformType::FLOAT16;
+	uniforms[1].matrix = &matrix[0];
+
+	context->recordCalls(true);
+	buffer->execute(context);
+
+	ASSERT_EQ(context->calls().size(), 2);
+	ASSERT_EQ(context->calls()[0].function, "setUniform");
+	ASSERT_EQ(context->calls()[0].arguments[0], 5.);
+	ASSERT_EQ(context->calls()[1].function, "setUniformMatrix");
+	ASSERT_EQ(context->calls()[1].arguments[0], 2.);
+}
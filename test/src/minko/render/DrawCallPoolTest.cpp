@@ -0,0 +1,756 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "DrawCallPoolTest.hpp"
+#include "minko/render/RenderTestUtils.hpp"
+#include "minko/render/DrawCallPool.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::render;
+using namespace minko::scene;
+
+static
+Node::Ptr
+createCube(geometry::Geometry::Ptr geometry, material::Material::Ptr material, Effect::Ptr effect, float x)
+{
+	auto transform = Transform::create();
+
+	transform->matrix()->appendTranslation(x, 0.f, 0.f);
+
+	return Node::create("cube")->addComponent(transform)->addComponent(Surface::create(geometry, material, effect));
+}
+
+static
+Effect::Ptr
+createTransparentEffect(AbstractContext::Ptr context)
+{
+	data::BindingMap stateBindings;
+
+	stateBindings["zSort"] = data::Binding("material[${materialId}].zSorted", data::BindingSource::TARGET);
+
+	return RenderTestUtils::createEffect(
+		context, "pass", RenderTestUtils::VERTEX_SOURCE, RenderTestUtils::FRAGMENT_SOURCE, data::BindingMap(), stateBindings,
+		data::MacroBindingMap(), States::create(States::SamplerStates(), Priority::TRANSPARENT)
+	);
+}
+
+// index buffers of the draw calls executed since the last call, in order
+static
+std::vector<int>
+drawnIndexBuffers(NullContext::Ptr context)
+{
+	std::vector<int> indexBuffers;
+
+	for (auto& call : context->calls())
+		if (call.function == "drawTriangles" || call.function == "drawInstancedTriangles")
+			indexBuffers.push_back((int)call.arguments[0]);
+
+	context->clearCalls();
+
+	return indexBuffers;
+}
+
+// effect reading its priority, z-sorting and render target from the material, and sampling its
+// diffuseMap texture when textured
+static
+Effect::Ptr
+createSortedEffect(AbstractContext::Ptr context, bool textured, const std::string& color = "1.0")
+{
+	data::BindingMap uniformBindings;
+	data::BindingMap stateBindings;
+
+	if (textured)
+		uniformBindings["diffuseMap"] = data::Binding("material[${materialId}].diffuseMap", data::BindingSource::TARGET);
+	stateBindings["priority"] = data::Binding("material[${materialId}].priority", data::BindingSource::TARGET);
+	stateBindings["zSort"] = data::Binding("material[${materialId}].zSorted", data::BindingSource::TARGET);
+	stateBindings["target"] = data::Binding("material[${materialId}].target", data::BindingSource::TARGET);
+
+	auto fragmentSource = textured
+		? "uniform sampler2D diffuseMap;\n"
+		  "void main(void) { gl_FragColor = texture2D(diffuseMap, vec2(0.0)) * " + color + "; }\n"
+		: "void main(void) { gl_FragColor = vec4(" + color + "); }\n";
+
+	return RenderTestUtils::createEffect(
+		context, "pass", RenderTestUtils::VERTEX_SOURCE, fragmentSource, uniformBindings, stateBindings
+	);
+}
+
+static
+material::Material::Ptr
+createSortedMaterial(float priority, bool zSorted, AbstractTexture::Ptr target = nullptr)
+{
+	auto material = material::Material::create();
+
+	material->set("priority", priority);
+	material->set("zSorted", zSorted);
+	if (target)
+		material->set("target", target);
+
+	return material;
+}
+
+// adds a quad at the given depth, returns the id of its index buffer
+static
+int
+addQuad(AbstractContext::Ptr context, Node::Ptr root, Effect::Ptr effect, material::Material::Ptr material, float z)
+{
+	auto quad = geometry::QuadGeometry::create(context);
+	auto transform = Transform::create();
+
+	transform->matrix()->appendTranslation(0.f, 0.f, z);
+	root->addChild(Node::create("quad")->addComponent(transform)->addComponent(Surface::create(quad, material, effect)));
+	transform->modelToWorldMatrix(true);
+
+	return quad->indices()->id();
+}
+
+// program, first texture and render target of the draw calls executed since the calls were last
+// cleared, in order
+static
+std::vector<std::vector<int>>
+drawnStates(NullContext::Ptr context)
+{
+	std::vector<std::vector<int>> states;
+	int program = -1;
+	int texture = -1;
+	int target = -1;
+
+	for (auto& call : context->calls())
+		if (call.function == "setProgram")
+			program = (int)call.arguments[0];
+		else if (call.function == "setTextureAt" && call.arguments[0] == 0.)
+			texture = (int)call.arguments[1];
+		else if (call.function == "setRenderToTexture")
+			target = (int)call.arguments[0];
+		else if (call.function == "setRenderToBackBuffer")
+			target = -1;
+		else if (call.function == "drawTriangles")
+			states.push_back(std::vector<int>({ program, texture, target }));
+
+	return states;
+}
+
+TEST_F(DrawCallPoolTest, ZSortedChangeMovesDrawCall)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(renderer);
+	auto effect = createTransparentEffect(context);
+	auto cube = geometry::CubeGeometry::create(context);
+	auto quad = geometry::QuadGeometry::create(context);
+	auto cubeMaterial = material::Material::create();
+	auto quadMaterial = material::Material::create();
+
+	cubeMaterial->set("zSorted", false);
+	quadMaterial->set("zSorted", true);
+
+	root->addChild(Node::create("cube")->addComponent(Surface::create(cube, cubeMaterial, effect)));
+	root->addChild(Node::create("quad")->addComponent(Surface::create(quad, quadMaterial, effect)));
+	context->recordCalls(true);
+
+	const auto cubeIndices = cube->indices()->id();
+	const auto quadIndices = quad->indices()->id();
+
+	// at equal priority, opaque draw calls come before z-sorted ones
+	renderer->render(context);
+
+	ASSERT_EQ(drawnIndexBuffers(context), std::vector<int>({ cubeIndices, quadIndices }));
+
+	cubeMaterial->set("zSorted", true);
+	quadMaterial->set("zSorted", false);
+	renderer->render(context);
+
+	ASSERT_EQ(drawnIndexBuffers(context), std::vector<int>({ quadIndices, cubeIndices }));
+
+	quadMaterial->set("zSorted", true);
+	renderer->render(context);
+
+	ASSERT_EQ(renderer->numDrawCalls(), 2);
+	ASSERT_EQ(drawnIndexBuffers(context).size(), 2);
+}
+
+TEST_F(DrawCallPoolTest, LayoutBucketsFollowLayoutsChanges)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto effect = RenderTestUtils::createInstancedEffect(context);
+	auto cube = geometry::CubeGeometry::create(context);
+	auto material = material::Material::create();
+
+	root->addChild(Node::create("camera")->addComponent(renderer));
+	for (uint i = 0; i < 3; ++i)
+		root->addChild(createCube(cube, material, effect, float(i)));
+
+	auto pool = DrawCallPool::create(renderer);
+	auto nodes = std::vector<Node::Ptr>(root->children().begin() + 1, root->children().end());
+
+	for (auto& node : nodes)
+		pool->addSurface(node->component<Surface>());
+
+	auto bucket = [&](Layouts layoutMask)
+	{
+		std::set<Node::Ptr> bucketNodes;
+
+		for (auto drawCall : pool->drawCalls(layoutMask))
+			bucketNodes.insert(pool->surface(drawCall->shared_from_this())->targets()[0]);
+
+		return bucketNodes;
+	};
+	auto defaultLayout = Layout::Group::DEFAULT;
+	auto pickingLayout = Layout::Group::PICKING;
+
+	ASSERT_EQ(bucket(defaultLayout), std::set<Node::Ptr>(nodes.begin(), nodes.end()));
+	ASSERT_TRUE(bucket(pickingLayout).empty());
+
+	// the buckets computed for the previous frame must not be returned as they were
+	nodes[1]->layouts(pickingLayout);
+
+	ASSERT_EQ(bucket(defaultLayout), std::set<Node::Ptr>({ nodes[0], nodes[2] }));
+	ASSERT_EQ(bucket(pickingLayout), std::set<Node::Ptr>({ nodes[1] }));
+	ASSERT_EQ(bucket(defaultLayout | pickingLayout), std::set<Node::Ptr>(nodes.begin(), nodes.end()));
+
+	nodes[1]->layouts(defaultLayout | pickingLayout);
+	nodes[2]->layouts(pickingLayout);
+
+	ASSERT_EQ(bucket(defaultLayout), std::set<Node::Ptr>({ nodes[0], nodes[1] }));
+	ASSERT_EQ(bucket(pickingLayout), std::set<Node::Ptr>({ nodes[1], nodes[2] }));
+
+	nodes[1]->layouts(Layout::Group::REFLECTION);
+	nodes[2]->layouts(defaultLayout);
+
+	ASSERT_EQ(bucket(defaultLayout), std::set<Node::Ptr>({ nodes[0], nodes[2] }));
+	ASSERT_TRUE(bucket(pickingLayout).empty());
+	ASSERT_EQ(bucket(Layout::Group::REFLECTION), std::set<Node::Ptr>({ nodes[1] }));
+}
+
+TEST_F(DrawCallPoolTest, InstancingIsOptIn)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(renderer)->addComponent(Transform::create());
+	auto effect = RenderTestUtils::createInstancedEffect(context);
+	auto cube = geometry::CubeGeometry::create(context);
+	auto material = material::Material::create();
+
+	for (uint i = 0; i < 4; ++i)
+		root->addChild(createCube(cube, material, effect, float(i)));
+
+	context->recordCalls(true);
+	renderer->render(context);
+
+	ASSERT_FALSE(renderer->instancingEnabled());
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 4);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "linkProgram"), 1);
+}
+
+TEST_F(DrawCallPoolTest, InstanceGroupsAreKeptAcrossFrames)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto effect = RenderTestUtils::createInstancedEffect(context);
+	auto cube = geometry::CubeGeometry::create(context);
+	auto material = material::Material::create();
+
+	// the renderer is not an ancestor of the surfaces, as in an actual scene
+	root->addChild(Node::create("camera")->addComponent(renderer));
+	renderer->instancingEnabled(true);
+	for (uint i = 0; i < 4; ++i)
+		root->addChild(createCube(cube, material, effect, float(i)));
+
+	context->recordCalls(true);
+	renderer->render(context);
+
+	// the regular program and its instanced version
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "linkProgram"), 2);
+	context->clearCalls();
+
+	// moving an instance only streams its matrix
+	auto transform = root->children()[2]->component<Transform>();
+
+	transform->matrix()->appendTranslation(0.f, 1.f, 0.f);
+	transform->modelToWorldMatrix(true);
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "linkProgram"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "createVertexBuffer"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "uploadVertexBufferData"), 1);
+	context->clearCalls();
+
+	// a draw call that is not instanced forces a sort, but leaves the group untouched
+	root->addChild(createCube(cube, material::Material::create(), effect, 5.f));
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "linkProgram"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "createVertexBuffer"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "uploadVertexBufferData"), 0);
+}
+
+TEST_F(DrawCallPoolTest, InstanceBuffersAreRecycled)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto effect = RenderTestUtils::createInstancedEffect(context);
+	auto cube = geometry::CubeGeometry::create(context);
+	auto material = material::Material::create();
+
+	// the renderer is not an ancestor of the surfaces, as in an actual scene
+	root->addChild(Node::create("camera")->addComponent(renderer));
+	renderer->instancingEnabled(true);
+	for (uint i = 0; i < 3; ++i)
+		root->addChild(createCube(cube, material, effect, float(i)));
+
+	context->recordCalls(true);
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 1);
+	context->clearCalls();
+
+	// the first instance buffer has room for 4 instances
+	root->addChild(createCube(cube, material, effect, 3.f));
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "createVertexBuffer"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "linkProgram"), 0);
+	context->clearCalls();
+
+	root->removeChild(root->children()[1]);
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "createVertexBuffer"), 0);
+}
+
+TEST_F(DrawCallPoolTest, InstanceBuffersStreamChangedMatrices)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto effect = RenderTestUtils::createInstancedEffect(context);
+	auto cube = geometry::CubeGeometry::create(context);
+	auto material = material::Material::create();
+
+	root->addChild(Node::create("camera")->addComponent(renderer));
+	renderer->instancingEnabled(true);
+	for (uint i = 0; i < 4; ++i)
+		root->addChild(createCube(cube, material, effect, float(i)));
+
+	renderer->render(context);
+	context->recordCalls(true);
+
+	// nothing is streamed as long as no matrix changes
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "uploadVertexBufferData"), 0);
+	context->clearCalls();
+
+	// only the instance whose matrix changed is streamed, once
+	auto transform = root->children()[3]->component<Transform>();
+
+	transform->matrix()->appendTranslation(0.f, 1.f, 0.f);
+	transform->modelToWorldMatrix(true);
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "uploadVertexBufferData"), 1);
+
+	for (auto& call : context->calls())
+		if (call.function == "uploadVertexBufferData")
+			ASSERT_EQ(call.arguments[2], 16.);
+	context->clearCalls();
+
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "uploadVertexBufferData"), 0);
+}
+
+TEST_F(DrawCallPoolTest, InstancesShareTargetUniforms)
+{
+	data::BindingMap uniformBindings;
+
+	uniformBindings["modelToWorldMatrix"] = data::Binding("transform.modelToWorldMatrix", data::BindingSource::TARGET);
+	uniformBindings["pickingColor"] = data::Binding("picking.color", data::BindingSource::TARGET);
+
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto effect = RenderTestUtils::createEffect(
+		context,
+		"pass",
+		RenderTestUtils::INSTANCED_VERTEX_SOURCE,
+		"uniform vec4 pickingColor;\n"
+		"void main(void) { gl_FragColor = pickingColor; }\n",
+		uniformBindings
+	);
+	auto cube = geometry::CubeGeometry::create(context);
+	auto material = material::Material::create();
+	auto sharedPicking = data::StructureProvider::create("picking");
+
+	sharedPicking->set("color", math::Vector4::create(1.f, 0.f, 0.f, 1.f));
+	root->addChild(Node::create("camera")->addComponent(renderer));
+	renderer->instancingEnabled(true);
+
+	// like Picking.effect, each node has its own color: the draw calls cannot be merged
+	std::vector<Node::Ptr> cubes;
+
+	for (uint i = 0; i < 4; ++i)
+	{
+		auto picking = data::StructureProvider::create("picking");
+
+		picking->set("color", math::Vector4::create(0.f, 0.f, float(i) / 255.f, 1.f));
+		cubes.push_back(createCube(cube, material, effect, float(i)));
+		cubes.back()->data()->addProvider(picking);
+		root->addChild(cubes.back());
+	}
+
+	context->recordCalls(true);
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 4);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 0);
+
+	// the draw calls reading the same provider are merged
+	for (uint i = 0; i < 3; ++i)
+	{
+		cubes[i]->data()->removeProvider(cubes[i]->data()->providers().back());
+		cubes[i]->data()->addProvider(sharedPicking);
+	}
+
+	context->clearCalls();
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 1);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 1);
+
+	// and split again when one of them gets its own color
+	auto picking = data::StructureProvider::create("picking");
+
+	picking->set("color", math::Vector4::create(0.f, 1.f, 0.f, 1.f));
+	cubes[0]->data()->removeProvider(sharedPicking);
+	cubes[0]->data()->addProvider(picking);
+	context->clearCalls();
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 2);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawInstancedTriangles"), 1);
+}
+
+TEST_F(DrawCallPoolTest, DepthPrePass)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(renderer)->addComponent(Transform::create());
+	auto cube = geometry::CubeGeometry::create(context);
+	// the discard of the first effect is never compiled
+	auto opaqueEffect = RenderTestUtils::createEffect(context, "pass", RenderTestUtils::VERTEX_SOURCE,
+		"void main(void)\n"
+		"{\n"
+		"#ifdef ALPHA_THRESHOLD\n"
+		"	discard;\n"
+		"#endif\n"
+		"	gl_FragColor = vec4(1.0);\n"
+		"}\n"
+	);
+	auto alphaTestedEffect = RenderTestUtils::createEffect(context, "pass", RenderTestUtils::VERTEX_SOURCE,
+		"uniform float alpha;\n"
+		"void main(void)\n"
+		"{\n"
+		"	if (alpha < 0.5) discard;\n"
+		"	gl_FragColor = vec4(1.0);\n"
+		"}\n"
+	);
+
+	renderer->depthPrePassEnabled(true);
+	root->addChild(createCube(cube, material::Material::create(), opaqueEffect, 0.f));
+	root->addChild(createCube(cube, material::Material::create(), alphaTestedEffect, 1.f));
+	context->recordCalls(true);
+	renderer->render(context);
+
+	// both programs and the depth only version of the opaque one
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "linkProgram"), 3);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 3);
+
+	std::vector<std::vector<double>> depthTests;
+	uint numDepthOnlyDraws = 0;
+	auto colorMask = true;
+
+	for (auto& call : context->calls())
+		if (call.function == "setColorMask")
+			colorMask = call.arguments[0] != 0.;
+		else if (call.function == "setDepthTest")
+			depthTests.push_back(call.arguments);
+		else if (call.function == "drawTriangles")
+		{
+			if (!colorMask)
+				++numDepthOnlyDraws;
+			// the pre-pass comes first
+			else
+				ASSERT_EQ(numDepthOnlyDraws, 1);
+		}
+
+	ASSERT_EQ(numDepthOnlyDraws, 1);
+
+	// the opaque draw call tests depths against the pre-pass without writing them again, the alpha
+	// tested one is drawn as usual
+	const auto equal = double(static_cast<int>(CompareMode::EQUAL));
+	const auto less = double(static_cast<int>(CompareMode::LESS));
+
+	ASSERT_EQ(depthTests.size(), 3);
+	ASSERT_EQ(depthTests[0], std::vector<double>({ 1., less }));
+	ASSERT_EQ(std::count(depthTests.begin() + 1, depthTests.end(), std::vector<double>({ 0., equal })), 1);
+	ASSERT_EQ(std::count(depthTests.begin() + 1, depthTests.end(), std::vector<double>({ 1., less })), 1);
+
+	// the depth programs, and the lack of one for the alpha tested program, are resolved once
+	context->clearCalls();
+	renderer->render(context);
+
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "linkProgram"), 0);
+	ASSERT_EQ(RenderTestUtils::numCalls(context, "drawTriangles"), 3);
+}
+
+TEST_F(DrawCallPoolTest, SortKeyOrdering)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto effect = createSortedEffect(context, false);
+	auto firstTarget = Texture::create(context, 64, 64, false, true);
+	auto secondTarget = Texture::create(context, 64, 64, false, true);
+
+	root->addChild(Node::create("camera")->addComponent(renderer));
+
+	// z-sorted draw calls, which have a priority up to Priority::TRANSPARENT, are added in no particular
+	// order and on both sides of the eye
+	const auto near = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT, true), -7.f);
+	const auto farthest = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT, true), 3.f);
+	const auto opaque = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT, false), -20.f);
+	const auto middle = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT, true), -2.f);
+	const auto first = addQuad(context, root, effect, createSortedMaterial(Priority::OPAQUE, false), 0.f);
+	const auto far = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT, true), .5f);
+	const auto firstTargeted = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT, false, firstTarget), 0.f);
+	const auto secondTargeted = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT, false, secondTarget), 0.f);
+	const auto last = addQuad(context, root, effect, createSortedMaterial(Priority::LAST, false), 0.f);
+
+	context->recordCalls(true);
+	renderer->render(context);
+
+	// highest priority first; at equal priority, draw calls with a render target come first, highest
+	// target id first, then the other opaque draw calls and finally the z-sorted ones, farthest first,
+	// even when an opaque draw call is nearer than all of them
+	ASSERT_EQ(drawnIndexBuffers(context), std::vector<int>({
+		first, secondTargeted, firstTargeted, opaque, farthest, far, middle, near, last
+	}));
+}
+
+TEST_F(DrawCallPoolTest, SortKeyTieBreaks)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	std::vector<Effect::Ptr> effects({ createSortedEffect(context, true, "0.5"), createSortedEffect(context, true, "2.0") });
+	std::vector<AbstractTexture::Ptr> textures;
+
+	for (uint i = 0; i < 3; ++i)
+	{
+		textures.push_back(Texture::create(context, 64, 64));
+		textures.back()->upload();
+	}
+
+	root->addChild(Node::create("camera")->addComponent(renderer));
+	for (uint i = 0; i < 24; ++i)
+	{
+		auto material = createSortedMaterial(Priority::OPAQUE, false);
+
+		material->set("diffuseMap", textures[(i / 2) % textures.size()]);
+		addQuad(context, root, effects[i % effects.size()], material, 0.f);
+	}
+
+	context->recordCalls(true);
+	renderer->render(context);
+
+	auto states = drawnStates(context);
+
+	// the draw calls sharing a program, then a texture, are consecutive
+	ASSERT_EQ(states.size(), 24);
+	ASSERT_TRUE(std::is_sorted(states.begin(), states.end()));
+
+	std::set<int> programs;
+	std::set<int> drawnTextures;
+
+	for (auto& state : states)
+	{
+		programs.insert(state[0]);
+		drawnTextures.insert(state[1]);
+	}
+	ASSERT_EQ(programs.size(), 2);
+	ASSERT_EQ(drawnTextures.size(), 3);
+}
+
+TEST_F(DrawCallPoolTest, ZSortedPrioritiesWithinTolerance)
+{
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto effect = createSortedEffect(context, false);
+
+	root->addChild(Node::create("camera")->addComponent(renderer));
+
+	// priorities closer than 1e-3 are equal: the depth decides
+	auto nearIndices = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT, true), -10.f);
+	auto farIndices = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT - 5e-4f, true), 10.f);
+	auto lastIndices = addQuad(context, root, effect, createSortedMaterial(Priority::TRANSPARENT - 1.f, true), 20.f);
+
+	context->recordCalls(true);
+
+	for (auto sortKeysEnabled : { true, false })
+	{
+		renderer->sortDrawCallsByKey(sortKeysEnabled);
+		renderer->render(context);
+
+		ASSERT_EQ(drawnIndexBuffers(context), std::vector<int>({ farIndices, nearIndices, lastIndices }));
+	}
+}
+
+TEST_F(DrawCallPoolTest, BoundStatesFollowProperties)
+{
+	data::BindingMap stateBindings;
+
+	stateBindings["depthMask"] = data::Binding("material[${materialId}].depthMask", data::BindingSource::TARGET);
+	stateBindings["stencilRef"] = data::Binding("material[${materialId}].stencilRef", data::BindingSource::TARGET);
+
+	auto context = NullContext::create();
+	auto renderer = Renderer::create();
+	auto root = Node::create("root")->addComponent(renderer);
+	auto effect = RenderTestUtils::createEffect(
+		context, "pass", RenderTestUtils::VERTEX_SOURCE, RenderTestUtils::FRAGMENT_SOURCE, data::BindingMap(), stateBindings
+	);
+	auto material = material::Material::create();
+	auto otherMaterial = material::Material::create();
+
+	material->set("depthMask", true);
+	material->set("stencilRef", 1);
+	otherMaterial->set("depthMask", true);
+	otherMaterial->set("stencilRef", 2);
+	root->addChild(Node::create("cube")->addComponent(Surface::create(geometry::CubeGeometry::create(context), material, effect)));
+	root->addChild(Node::create("quad")->addComponent(Surface::create(geometry::QuadGeometry::create(context), otherMaterial, effect)));
+	context->recordCalls(true);
+
+	typedef std::set<std::pair<int, int>> DrawnStates;
+
+	// stencil references and depth masks set for each draw call, sorted by stencil reference
+	auto drawnStates = [&]()
+	{
+		DrawnStates states;
+		auto depthMask = -1;
+		auto stencilRef = -1;
+
+		for (auto& call : context->calls())
+			if (call.function == "setDepthTest")
+				depthMask = (int)call.arguments[0];
+			else if (call.function == "setStencilTest")
+				stencilRef = (int)call.arguments[1];
+			else if (call.function == "drawTriangles")
+				states.insert(std::make_pair(stencilRef, depthMask));
+		context->clearCalls();
+
+		return states;
+	};
+
+	renderer->render(context);
+
+	ASSERT_EQ(drawnStates(), DrawnStates({ std::make_pair(1, 1), std::make_pair(2, 1) }));
+
+	// the slots update the states of their own draw call, not a copy of them
+	material->set("depthMask", false);
+	material->set("stencilRef", 3);
+	renderer->render(context);
+
+	ASSERT_EQ(drawnStates(), DrawnStates({ std::make_pair(3, 0), std::make_pair(2, 1) }));
+
+	otherMaterial->set("stencilRef", 4);
+	renderer->render(context);
+
+	ASSERT_EQ(drawnStates(), DrawnStates({ std::make_pair(3, 0), std::make_pair(4, 1) }));
+}
+
+TEST_F(DrawCallPoolTest, SortKeysMatchComparator)
+{
+	const std::vector<float> opaquePriorities({ Priority::FIRST, Priority::OPAQUE, 2000.5f, Priority::TRANSPARENT, -10.f });
+	const std::vector<float> zSortedPriorities({ Priority::TRANSPARENT, 999.5f, 500.f, 1.f });
+
+	// the sort keys only order the draw calls the comparison-based sort considers equivalent, and the
+	// latter interleaves opaque and z-sorted draw calls of equal priority: each kind is compared alone
+	for (auto zSorted : { false, true })
+	{
+		auto context = NullContext::create();
+		auto renderer = Renderer::create();
+		auto root = Node::create("root")->addComponent(Transform::create());
+		auto effect = createSortedEffect(context, false);
+		const auto& priorities = zSorted ? zSortedPriorities : opaquePriorities;
+		std::vector<AbstractTexture::Ptr> targets;
+		// what the comparison-based sort orders by, for each index buffer
+		std::unordered_map<int, std::pair<float, float>> indexBufferToOrder;
+
+		for (uint i = 0; i < 3; ++i)
+		{
+			targets.push_back(Texture::create(context, 64, 64, false, true));
+			targets.back()->upload();
+		}
+
+		root->addChild(Node::create("camera")->addComponent(renderer));
+		for (uint i = 0; i < 100; ++i)
+		{
+			const auto priority = priorities[rand() % priorities.size()];
+			const auto z = float(rand() % 100) - 50.f;
+			auto target = zSorted || rand() % 2 == 0 ? nullptr : targets[rand() % targets.size()];
+			auto indexBuffer = addQuad(context, root, effect, createSortedMaterial(priority, zSorted, target), z);
+
+			indexBufferToOrder[indexBuffer] = std::make_pair(priority, zSorted ? z : (target ? float(target->id()) : -1.f));
+		}
+
+		context->recordCalls(true);
+
+		std::vector<std::vector<std::pair<float, float>>> orders;
+
+		for (auto sortKeysEnabled : { true, false })
+		{
+			std::vector<std::pair<float, float>> order;
+
+			renderer->sortDrawCallsByKey(sortKeysEnabled);
+			renderer->render(context);
+
+			for (auto indexBuffer : drawnIndexBuffers(context))
+				order.push_back(indexBufferToOrder[indexBuffer]);
+			orders.push_back(order);
+		}
+
+		ASSERT_EQ(orders[0].size(), 100);
+		ASSERT_EQ(orders[0], orders[1]);
+	}
+}
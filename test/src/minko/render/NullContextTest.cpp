@@ -0,0 +1,175 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "NullContextTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+static
+ProgramInputs::Ptr
+linkProgram(NullContext::Ptr context, const std::string& vertexSource, const std::string& fragmentSource)
+{
+	auto vertexShader = context->createVertexShader();
+	auto fragmentShader = context->createFragmentShader();
+	auto program = context->createProgram();
+
+	context->setShaderSource(vertexShader, vertexSource);
+	context->compileShader(vertexShader);
+	context->setShaderSource(fragmentShader, fragmentSource);
+	context->compileShader(fragmentShader);
+	context->attachShader(program, vertexShader);
+	context->attachShader(program, fragmentShader);
+	context->linkProgram(program);
+
+	return context->getProgramInputs(program);
+}
+
+TEST_F(NullContextTest, UniqueResourceIds)
+{
+	auto context = NullContext::create();
+	auto vertexBuffer = context->createVertexBuffer(12);
+	auto indexBuffer = context->createIndexBuffer(3);
+	auto texture = context->createTexture(TextureType::Texture2D, 32, 32, false);
+
+	ASSERT_NE(vertexBuffer, 0);
+	ASSERT_NE(vertexBuffer, indexBuffer);
+	ASSERT_NE(indexBuffer, texture);
+}
+
+TEST_F(NullContextTest, FrameStats)
+{
+	auto context = NullContext::create();
+	auto vertexBuffer = context->createVertexBuffer(12);
+	auto indexBuffer = context->createIndexBuffer(6);
+	std::vector<float> vertices(12);
+	std::vector<unsigned short> indices(6);
+
+	context->uploadVertexBufferData(vertexBuffer, 0, 12, &vertices[0]);
+	context->uploaderIndexBufferData(indexBuffer, 0, 6, &indices[0]);
+	context->setProgram(1);
+	context->setProgram(1);
+	context->setUniform(0, 1.f);
+	context->drawTriangles(indexBuffer, 2);
+	context->drawInstancedTriangles(indexBuffer, 2, 10);
+
+	ASSERT_EQ(context->currentFrameStats().numDrawCalls, 2);
+
+	context->present();
+
+	ASSERT_EQ(context->numFrames(), 1);
+	ASSERT_EQ(context->frameStats().numDrawCalls, 2);
+	ASSERT_EQ(context->frameStats().numTriangles, 22);
+	ASSERT_EQ(context->frameStats().numStateChanges, 1);
+	ASSERT_EQ(context->frameStats().numUniforms, 1);
+	ASSERT_EQ(context->frameStats().numUploadedBytes, 12 * sizeof(float) + 6 * sizeof(unsigned short));
+	ASSERT_EQ(context->currentFrameStats().numDrawCalls, 0);
+}
+
+TEST_F(NullContextTest, RecordCalls)
+{
+	auto context = NullContext::create();
+
+	context->drawTriangles(1, 2);
+
+	ASSERT_TRUE(context->calls().empty());
+
+	context->recordCalls(true);
+	context->drawTriangles(3, 4);
+
+	ASSERT_EQ(context->calls().size(), 1);
+	ASSERT_EQ(context->calls()[0].function, "drawTriangles");
+	ASSERT_EQ(context->calls()[0].arguments, std::vector<double>({ 3., 4. }));
+}
+
+TEST_F(NullContextTest, RenderToTextureViewport)
+{
+	auto context = NullContext::create();
+	auto texture = context->createTexture(TextureType::Texture2D, 256, 128, false, true);
+
+	context->configureViewport(0, 0, 800, 600);
+	context->setRenderToTexture(texture, true);
+
+	ASSERT_EQ(context->renderTarget(), texture);
+	ASSERT_EQ(context->viewportWidth(), 256);
+	ASSERT_EQ(context->viewportHeight(), 128);
+
+	context->setRenderToBackBuffer();
+
+	ASSERT_EQ(context->viewportWidth(), 800);
+	ASSERT_EQ(context->viewportHeight(), 600);
+}
+
+TEST_F(NullContextTest, ProgramInputs)
+{
+	auto context = NullContext::create();
+	auto inputs = linkProgram(
+		context,
+		"#define NUM_LIGHTS 2\n"
+		"#ifdef GL_ES\n"
+		"precision mediump float;\n"
+		"#endif\n"
+		"attribute vec3 position;\n"
+		"attribute vec2 uv;\n"
+		"uniform mat4 modelToWorldMatrix; // comment\n"
+		"#if defined(SKINNING) && NUM_LIGHTS > 0\n"
+		"uniform mat4 boneMatrices[8];\n"
+		"#endif\n"
+		"void main(void) { gl_Position = modelToWorldMatrix * vec4(position, 1.0); }\n",
+		"#define NUM_LIGHTS 2\n"
+		"struct Light { vec3 color; float intensity; };\n"
+		"uniform Light lights[NUM_LIGHTS];\n"
+		"#ifndef DIFFUSE_MAP\n"
+		"uniform vec4 diffuseColor;\n"
+		"#else\n"
+		"uniform sampler2D diffuseMap;\n"
+		"#endif\n"
+		"void main(void) { gl_FragColor = diffuseColor; }\n"
+	);
+
+	ASSERT_EQ(inputs->type("position"), ProgramInputs::Type::attribute);
+	ASSERT_EQ(inputs->type("uv"), ProgramInputs::Type::attribute);
+	ASSERT_NE(inputs->location("position"), inputs->location("uv"));
+	ASSERT_EQ(inputs->type("modelToWorldMatrix"), ProgramInputs::Type::float16);
+	ASSERT_FALSE(inputs->hasName("boneMatrices[0]"));
+	ASSERT_EQ(inputs->type("lights[1].color"), ProgramInputs::Type::float3);
+	ASSERT_EQ(inputs->type("lights[1].intensity"), ProgramInputs::Type::float1);
+	ASSERT_FALSE(inputs->hasName("lights[2].color"));
+	ASSERT_EQ(inputs->type("diffuseColor"), ProgramInputs::Type::float4);
+	ASSERT_FALSE(inputs->hasName("diffuseMap"));
+}
+
+TEST_F(NullContextTest, ProgramInputsArrays)
+{
+	auto context = NullContext::create();
+	auto inputs = linkProgram(
+		context,
+		"#define SKINNING\n"
+		"#define NUM_BONES 4\n"
+		"#if defined(SKINNING) && NUM_BONES > 0\n"
+		"uniform mat4 boneMatrices[NUM_BONES];\n"
+		"#elif NUM_BONES == 0\n"
+		"uniform mat4 noBones;\n"
+		"#endif\n",
+		""
+	);
+
+	ASSERT_EQ(inputs->type("boneMatrices[0]"), ProgramInputs::Type::float16);
+	ASSERT_FALSE(inputs->hasName("noBones"));
+}
@@ -0,0 +1,133 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "OpenGL3ContextTest.hpp"
+
+#if defined(MINKO_OPENGL3_CONTEXT) && defined(MINKO_PLUGIN_OFFSCREEN_EGL)
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::render;
+
+void
+OpenGL3ContextTest::SetUp()
+{
+	_display = eglGetCurrentDisplay();
+	_drawSurface = eglGetCurrentSurface(EGL_DRAW);
+	_readSurface = eglGetCurrentSurface(EGL_READ);
+	_context = eglGetCurrentContext();
+
+	_canvas = Canvas::create("OpenGL3ContextTest", 64, 64, Canvas::OPENGL3);
+}
+
+void
+OpenGL3ContextTest::TearDown()
+{
+	_canvas = nullptr;
+
+	eglMakeCurrent(_display, _drawSurface, _readSurface, _context);
+}
+
+TEST_F(OpenGL3ContextTest, Create)
+{
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<OpenGL3Context>(_canvas->context()));
+}
+
+TEST_F(OpenGL3ContextTest, CompileBundledEffects)
+{
+	auto context = std::dynamic_pointer_cast<OpenGL3Context>(_canvas->context());
+	auto assets = file::AssetLibrary::create(context);
+	auto effects = {
+		"effect/Basic.effect",
+		"effect/Line.effect",
+		"effect/Phong.effect",
+		"effect/Picking.effect",
+		"effect/Sprite.effect",
+		"effect/VertexNormal.effect",
+		"effect/VertexUV.effect"
+	};
+
+	for (auto& filename : effects)
+		assets->loader()->queue(filename);
+	assets->loader()->load();
+
+	auto formatName = [](const std::string& propertyName) { return propertyName; };
+
+	for (auto& filename : effects)
+	{
+		auto effect = assets->effect(filename);
+
+		ASSERT_NE(nullptr, effect) << filename;
+
+		// every pass compiles its variant without macros through OpenGL3Context::setShaderSource
+		for (auto& techniqueNameAndPasses : effect->techniques())
+			for (auto& pass : techniqueNameAndPasses.second)
+			{
+				auto program = pass->warmUp(
+					formatName, data::Container::create(), data::Container::create(), data::Container::create()
+				);
+
+				ASSERT_NE(nullptr, program) << filename;
+				ASSERT_TRUE(program->isReady()) << filename;
+				ASSERT_EQ("", context->getShaderCompilationLogs(program->vertexShader()->id()))
+					<< filename << ", technique " << techniqueNameAndPasses.first;
+				ASSERT_EQ("", context->getShaderCompilationLogs(program->fragmentShader()->id()))
+					<< filename << ", technique " << techniqueNameAndPasses.first;
+			}
+	}
+}
+
+TEST_F(OpenGL3ContextTest, DrawBasicEffect)
+{
+	auto sceneManager = SceneManager::create(_canvas);
+	auto assets = sceneManager->assets();
+
+	assets->loader()->queue("effect/Basic.effect");
+	assets->loader()->load();
+
+	auto root = scene::Node::create("root")->addComponent(sceneManager);
+	auto camera = scene::Node::create("camera")
+		->addComponent(Renderer::create(0x000000ff))
+		->addComponent(Transform::create(
+			math::Matrix4x4::create()->lookAt(math::Vector3::zero(), math::Vector3::create(0.f, 0.f, 3.f))
+		))
+		->addComponent(PerspectiveCamera::create(1.f));
+	auto quad = scene::Node::create("quad")
+		->addComponent(Transform::create())
+		->addComponent(Surface::create(
+			geometry::QuadGeometry::create(_canvas->context()),
+			material::BasicMaterial::create()->diffuseColor(0xff0000ff),
+			assets->effect("effect/Basic.effect")
+		));
+
+	root->addChild(camera);
+	root->addChild(quad);
+
+	sceneManager->nextFrame(0.f, 0.f);
+
+	std::vector<unsigned char> pixel(4);
+
+	_canvas->context()->readPixels(32, 32, 1, 1, &pixel[0]);
+
+	ASSERT_EQ(255, pixel[0]);
+	ASSERT_EQ(0, pixel[1]);
+	ASSERT_EQ(0, pixel[2]);
+	ASSERT_EQ(1, camera->component<Renderer>()->numDrawCalls());
+}
+
+#endif
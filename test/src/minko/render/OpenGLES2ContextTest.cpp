@@ -0,0 +1,172 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "OpenGLES2ContextTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+void
+OpenGLES2ContextTest::SetUp()
+{
+	_context = std::dynamic_pointer_cast<OpenGLES2Context>(MinkoTests::canvas()->context());
+
+	ASSERT_NE(nullptr, _context);
+}
+
+uint
+OpenGLES2ContextTest::createProgram()
+{
+	auto vertexShader = _context->createVertexShader();
+	auto fragmentShader = _context->createFragmentShader();
+	auto program = _context->createProgram();
+
+	_context->setShaderSource(
+		vertexShader,
+		"attribute vec3 position;\n"
+		"void main() { gl_Position = vec4(position, 1.0); }\n"
+	);
+	_context->compileShader(vertexShader);
+	_context->setShaderSource(
+		fragmentShader,
+		"#ifdef GL_ES\n"
+		"precision mediump float;\n"
+		"#endif\n"
+		"uniform vec4 color;\n"
+		"void main() { gl_FragColor = color; }\n"
+	);
+	_context->compileShader(fragmentShader);
+	_context->attachShader(program, vertexShader);
+	_context->attachShader(program, fragmentShader);
+	_context->linkProgram(program);
+	_context->deleteVertexShader(vertexShader);
+	_context->deleteFragmentShader(fragmentShader);
+
+	return program;
+}
+
+TEST_F(OpenGLES2ContextTest, SkipUnchangedUniforms)
+{
+	auto program = createProgram();
+	auto location = _context->getProgramInputs(program)->location("color");
+
+	ASSERT_NE(-1, location);
+
+	_context->setProgram(program);
+	_context->resetUniformUploadCounters();
+
+	_context->setUniform(location, 1.f, 0.f, 0.f, 1.f);
+	_context->setUniform(location, 1.f, 0.f, 0.f, 1.f);
+	_context->setUniform(location, 0.f, 1.f, 0.f, 1.f);
+	_context->setUniform(location, 0.f, 1.f, 0.f, 1.f);
+	_context->setUniform(location, 0.f, 1.f, 0.f, 1.f);
+
+	ASSERT_EQ(2, _context->numIssuedUniformUploads());
+	ASSERT_EQ(3, _context->numSkippedUniformUploads());
+
+	_context->deleteProgram(program);
+}
+
+TEST_F(OpenGLES2ContextTest, UniformsAreShadowedPerProgram)
+{
+	auto program1 = createProgram();
+	auto program2 = createProgram();
+	auto location1 = _context->getProgramInputs(program1)->location("color");
+	auto location2 = _context->getProgramInputs(program2)->location("color");
+
+	_context->setProgram(program1);
+	_context->setUniform(location1, 1.f, 0.f, 0.f, 1.f);
+	_context->setProgram(program2);
+	_context->resetUniformUploadCounters();
+
+	_context->setUniform(location2, 1.f, 0.f, 0.f, 1.f);
+	_context->setProgram(program1);
+	_context->setUniform(location1, 1.f, 0.f, 0.f, 1.f);
+
+	ASSERT_EQ(1, _context->numIssuedUniformUploads());
+	ASSERT_EQ(1, _context->numSkippedUniformUploads());
+
+	_context->deleteProgram(program1);
+	_context->deleteProgram(program2);
+}
+
+TEST_F(OpenGLES2ContextTest, LinkProgramInvalidatesUniforms)
+{
+	auto program = createProgram();
+	auto location = _context->getProgramInputs(program)->location("color");
+
+	_context->setProgram(program);
+	_context->setUniform(location, 1.f, 0.f, 0.f, 1.f);
+	_context->resetUniformUploadCounters();
+
+	// linking resets the uniforms to their default values
+	_context->linkProgram(program);
+	_context->setUniform(location, 1.f, 0.f, 0.f, 1.f);
+
+	ASSERT_EQ(1, _context->numIssuedUniformUploads());
+	ASSERT_EQ(0, _context->numSkippedUniformUploads());
+
+	_context->deleteProgram(program);
+}
+
+TEST_F(OpenGLES2ContextTest, DeleteProgramInvalidatesUniforms)
+{
+	auto program = createProgram();
+	auto location = _context->getProgramInputs(program)->location("color");
+
+	_context->setProgram(program);
+	_context->setUniform(location, 1.f, 0.f, 0.f, 1.f);
+	_context->setProgram(0);
+	_context->deleteProgram(program);
+
+	// the driver is free to give the same name to the next program
+	program = createProgram();
+	location = _context->getProgramInputs(program)->location("color");
+
+	_context->setProgram(program);
+	_context->resetUniformUploadCounters();
+	_context->setUniform(location, 1.f, 0.f, 0.f, 1.f);
+
+	ASSERT_EQ(1, _context->numIssuedUniformUploads());
+	ASSERT_EQ(0, _context->numSkippedUniformUploads());
+
+	_context->deleteProgram(program);
+}
+
+TEST_F(OpenGLES2ContextTest, DeleteCurrentProgramInvalidatesUniforms)
+{
+	auto program = createProgram();
+	auto location = _context->getProgramInputs(program)->location("color");
+
+	_context->setProgram(program);
+	_context->setUniform(location, 1.f, 0.f, 0.f, 1.f);
+	_context->deleteProgram(program);
+
+	program = createProgram();
+	location = _context->getProgramInputs(program)->location("color");
+
+	_context->setProgram(program);
+	_context->resetUniformUploadCounters();
+	_context->setUniform(location, 1.f, 0.f, 0.f, 1.f);
+
+	ASSERT_EQ(1, _context->numIssuedUniformUploads());
+	ASSERT_EQ(0, _context->numSkippedUniformUploads());
+
+	_context->deleteProgram(program);
+	_context->setProgram(0);
+}
@@ -0,0 +1,135 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "ProgramCacheTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+static const std::string VERTEX_SOURCE =
+	"attribute vec3 position;\n"
+	"uniform mat4 modelToWorldMatrix;\n"
+	"void main(void) { gl_Position = modelToWorldMatrix * vec4(position, 1.0); }\n";
+
+static const std::string FRAGMENT_SOURCE =
+	"uniform vec4 diffuseColor;\n"
+	"void main(void) { gl_FragColor = diffuseColor; }\n";
+
+static
+Program::Ptr
+createProgram(AbstractContext::Ptr context, const std::string& defines = "")
+{
+	return Program::create(
+		context,
+		Shader::create(context, Shader::Type::VERTEX_SHADER, defines + VERTEX_SOURCE),
+		Shader::create(context, Shader::Type::FRAGMENT_SHADER, defines + FRAGMENT_SOURCE)
+	);
+}
+
+static
+void
+compile(Program::Ptr program)
+{
+	program->vertexShader()->upload();
+	program->fragmentShader()->upload();
+	program->upload();
+}
+
+TEST_F(ProgramCacheTest, MissThenHit)
+{
+	auto cache = ProgramCache::create("");
+	auto program = createProgram(NullContext::create());
+
+	ASSERT_FALSE(cache->load(program));
+	ASSERT_EQ(cache->numMisses(), 1);
+
+	compile(program);
+	cache->store(program);
+
+	auto cachedProgram = createProgram(NullContext::create());
+
+	ASSERT_TRUE(cache->load(cachedProgram));
+	ASSERT_EQ(cache->numHits(), 1);
+	ASSERT_TRUE(cachedProgram->isReady());
+	ASSERT_FALSE(cachedProgram->vertexShader()->isReady());
+	ASSERT_TRUE(cachedProgram->inputs()->hasName("position"));
+	ASSERT_TRUE(cachedProgram->inputs()->hasName("diffuseColor"));
+
+	std::remove(cache->filename(program).c_str());
+}
+
+TEST_F(ProgramCacheTest, DefinesChangeTheKey)
+{
+	auto cache = ProgramCache::create("");
+	auto context = NullContext::create();
+
+	ASSERT_EQ(cache->filename(createProgram(context)), cache->filename(createProgram(context)));
+	ASSERT_NE(cache->filename(createProgram(context)), cache->filename(createProgram(context, "#define SKINNING\n")));
+}
+
+TEST_F(ProgramCacheTest, CorruptedBinary)
+{
+	auto cache = ProgramCache::create("");
+	auto program = createProgram(NullContext::create());
+
+	compile(program);
+	cache->store(program);
+
+	std::fstream file(cache->filename(program), std::ios::in | std::ios::out | std::ios::binary);
+
+	file.seekp(-1, std::ios::end);
+	file.put('!');
+	file.close();
+
+	auto cachedProgram = createProgram(NullContext::create());
+
+	ASSERT_FALSE(cache->load(cachedProgram));
+	ASSERT_EQ(cache->numRejected(), 1);
+	ASSERT_FALSE(cachedProgram->isReady());
+	ASSERT_FALSE(std::ifstream(cache->filename(program)).is_open());
+}
+
+TEST_F(ProgramCacheTest, RejectedBinary)
+{
+	auto cache = ProgramCache::create("");
+	auto program = createProgram(NullContext::create());
+
+	compile(program);
+	cache->store(program);
+
+	// the binary format stored after the magic number, the version and the check key
+	std::fstream file(cache->filename(program), std::ios::in | std::ios::out | std::ios::binary);
+	uint format = 0;
+
+	file.seekp(16);
+	file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+	file.close();
+
+	auto context = NullContext::create();
+	auto cachedProgram = createProgram(context);
+
+	ASSERT_FALSE(cache->load(cachedProgram));
+	ASSERT_EQ(cache->numRejected(), 1);
+	ASSERT_FALSE(std::ifstream(cache->filename(program)).is_open());
+
+	compile(cachedProgram);
+
+	ASSERT_TRUE(cachedProgram->inputs()->hasName("position"));
+}
@@ -0,0 +1,191 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "RenderGraphTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+static
+RenderGraph::ExecuteFunction
+record(std::vector<std::string>& executed, const std::string& name)
+{
+	return [&executed, name](AbstractContext::Ptr context, Texture::Ptr target)
+	{
+		executed.push_back(name);
+	};
+}
+
+TEST_F(RenderGraphTest, PassesAreSortedByDependencies)
+{
+	std::vector<std::string> executed;
+	auto graph = RenderGraph::create(NullContext::create())
+		->target("scene", 64, 64)
+		->pass("post", { "scene" }, "", record(executed, "post"))
+		->pass("scene", {}, "scene", record(executed, "scene"));
+
+	graph->execute();
+
+	ASSERT_EQ(executed, std::vector<std::string>({ "scene", "post" }));
+}
+
+TEST_F(RenderGraphTest, WritersOfTheSameTargetKeepTheirOrder)
+{
+	auto graph = RenderGraph::create(NullContext::create())
+		->target("scene", 64, 64)
+		->pass("post", { "scene" }, "", nullptr)
+		->pass("opaque", {}, "scene", nullptr)
+		->pass("transparent", {}, "scene", nullptr);
+
+	ASSERT_EQ(graph->schedule(), std::vector<std::string>({ "opaque", "transparent", "post" }));
+}
+
+TEST_F(RenderGraphTest, UnusedPassesAreDropped)
+{
+	std::vector<std::string> executed;
+	auto graph = RenderGraph::create(NullContext::create())
+		->target("scene", 64, 64)
+		->target("unused", 64, 64)
+		->pass("scene", {}, "scene", record(executed, "scene"))
+		->pass("unused", { "scene" }, "unused", record(executed, "unused"))
+		->pass("post", { "scene" }, "", record(executed, "post"));
+
+	graph->execute();
+
+	ASSERT_EQ(executed, std::vector<std::string>({ "scene", "post" }));
+	ASSERT_TRUE(graph->texture("unused") == nullptr);
+}
+
+TEST_F(RenderGraphTest, OutputPassesAreKept)
+{
+	auto graph = RenderGraph::create(NullContext::create())
+		->target("picking", 64, 64)
+		->output("picking")
+		->pass("picking", {}, "picking", nullptr);
+
+	ASSERT_EQ(graph->schedule(), std::vector<std::string>({ "picking" }));
+	ASSERT_TRUE(graph->texture("picking") != nullptr);
+}
+
+TEST_F(RenderGraphTest, TexturesAreShared)
+{
+	auto graph = RenderGraph::create(NullContext::create())
+		->target("scene", 64, 64)
+		->target("blurX", 64, 64)
+		->target("blurY", 64, 64)
+		->pass("scene", {}, "scene", nullptr)
+		->pass("blurX", { "scene" }, "blurX", nullptr)
+		->pass("blurY", { "blurX" }, "blurY", nullptr)
+		->pass("post", { "blurY" }, "", nullptr);
+
+	ASSERT_EQ(graph->texture("scene"), graph->texture("blurY"));
+	ASSERT_NE(graph->texture("scene"), graph->texture("blurX"));
+	ASSERT_EQ(graph->numTextures(), 2u);
+}
+
+TEST_F(RenderGraphTest, TexturesOfDifferentSizesAreNotShared)
+{
+	auto graph = RenderGraph::create(NullContext::create())
+		->target("scene", 64, 64)
+		->target("blurX", 32, 32)
+		->target("blurY", 32, 32)
+		->pass("scene", {}, "scene", nullptr)
+		->pass("blurX", { "scene" }, "blurX", nullptr)
+		->pass("blurY", { "blurX" }, "blurY", nullptr)
+		->pass("post", { "blurY" }, "", nullptr);
+
+	ASSERT_EQ(graph->numTextures(), 0u);
+	graph->compile();
+	ASSERT_EQ(graph->numTextures(), 3u);
+	ASSERT_EQ(graph->texture("blurY")->originalWidth(), 32u);
+}
+
+TEST_F(RenderGraphTest, PassesReceiveTheirTarget)
+{
+	Texture::Ptr sceneTarget;
+	Texture::Ptr postTarget = Texture::create(NullContext::create(), 1, 1);
+	auto graph = RenderGraph::create(NullContext::create());
+
+	graph
+		->target("scene", 64, 64)
+		->pass("scene", {}, "scene", [&](AbstractContext::Ptr context, Texture::Ptr target)
+		{
+			sceneTarget = target;
+		})
+		->pass("post", { "scene" }, "", [&](AbstractContext::Ptr context, Texture::Ptr target)
+		{
+			postTarget = target;
+		});
+
+	graph->execute();
+
+	ASSERT_EQ(sceneTarget, graph->texture("scene"));
+	ASSERT_TRUE(postTarget == nullptr);
+}
+
+TEST_F(RenderGraphTest, CompiledSignal)
+{
+	auto numCompilations = 0;
+	auto graph = RenderGraph::create(NullContext::create())
+		->target("scene", 64, 64)
+		->pass("scene", {}, "scene", nullptr)
+		->pass("post", { "scene" }, "", nullptr);
+	auto compiledSlot = graph->compiled()->connect([&](RenderGraph::Ptr g)
+	{
+		++numCompilations;
+	});
+
+	graph->schedule();
+	graph->schedule();
+	graph->target("scene", 128, 128);
+	graph->schedule();
+
+	ASSERT_EQ(numCompilations, 2);
+	ASSERT_EQ(graph->texture("scene")->originalWidth(), 128u);
+	ASSERT_EQ(graph->numTextures(), 1u);
+}
+
+TEST_F(RenderGraphTest, CircularDependencies)
+{
+	auto graph = RenderGraph::create(NullContext::create())
+		->target("a", 64, 64)
+		->target("b", 64, 64)
+		->pass("a", { "b" }, "a", nullptr)
+		->pass("b", { "a" }, "b", nullptr)
+		->pass("post", { "b" }, "", nullptr);
+
+	ASSERT_THROW(graph->compile(), std::logic_error);
+}
+
+TEST_F(RenderGraphTest, UndeclaredTarget)
+{
+	auto graph = RenderGraph::create(NullContext::create())
+		->pass("scene", {}, "scene", nullptr);
+
+	ASSERT_THROW(graph->compile(), std::invalid_argument);
+}
+
+TEST_F(RenderGraphTest, ReadingTheWrittenTarget)
+{
+	auto graph = RenderGraph::create(NullContext::create())
+		->target("scene", 64, 64);
+
+	ASSERT_THROW(graph->pass("scene", { "scene" }, "scene", nullptr), std::invalid_argument);
+}
@@ -0,0 +1,123 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "RenderTestUtils.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+const std::string RenderTestUtils::VERTEX_SOURCE =
+	"attribute vec3 position;\n"
+	"void main(void) { gl_Position = vec4(position, 1.0); }\n";
+
+const std::string RenderTestUtils::FRAGMENT_SOURCE =
+	"void main(void) { gl_FragColor = vec4(1.0); }\n";
+
+const std::string RenderTestUtils::INSTANCED_VERTEX_SOURCE =
+	"attribute vec3 position;\n"
+	"#ifdef INSTANCING\n"
+	"attribute vec4 instanceModelToWorld0;\n"
+	"attribute vec4 instanceModelToWorld1;\n"
+	"attribute vec4 instanceModelToWorld2;\n"
+	"attribute vec4 instanceModelToWorld3;\n"
+	"#else\n"
+	"uniform mat4 modelToWorldMatrix;\n"
+	"#endif\n"
+	"void main(void)\n"
+	"{\n"
+	"#ifdef INSTANCING\n"
+	"	mat4 modelToWorldMatrix = mat4(instanceModelToWorld0, instanceModelToWorld1, instanceModelToWorld2, instanceModelToWorld3);\n"
+	"#endif\n"
+	"	gl_Position = modelToWorldMatrix * vec4(position, 1.0);\n"
+	"}\n";
+
+const std::string RenderTestUtils::TRANSFORM_VERTEX_SOURCE =
+	"attribute vec3 position;\n"
+	"uniform mat4 modelToWorldMatrix;\n"
+	"uniform mat4 worldToScreenMatrix;\n"
+	"void main(void) { gl_Position = worldToScreenMatrix * modelToWorldMatrix * vec4(position, 1.0); }\n";
+
+Effect::Ptr
+RenderTestUtils::createEffect(AbstractContext::Ptr			context,
+							  const std::string&			name,
+							  const std::string&			vertexSource,
+							  const std::string&			fragmentSource,
+							  const data::BindingMap&		uniformBindings,
+							  const data::BindingMap&		stateBindings,
+							  const data::MacroBindingMap&	macroBindings,
+							  States::Ptr					states)
+{
+	data::BindingMap attributeBindings;
+
+	attributeBindings["position"] = data::Binding("geometry[${geometryId}].position", data::BindingSource::TARGET);
+
+	auto program = Program::create(
+		context,
+		Shader::create(context, Shader::Type::VERTEX_SHADER, vertexSource),
+		Shader::create(context, Shader::Type::FRAGMENT_SHADER, fragmentSource)
+	);
+	std::vector<Pass::Ptr> passes(1, Pass::create(
+		name, program, attributeBindings, uniformBindings, stateBindings, macroBindings, states, ""
+	));
+
+	return Effect::create(passes, name);
+}
+
+Effect::Ptr
+RenderTestUtils::createInstancedEffect(AbstractContext::Ptr context, const std::string& fragmentSource)
+{
+	data::BindingMap uniformBindings;
+
+	uniformBindings["modelToWorldMatrix"] = data::Binding("transform.modelToWorldMatrix", data::BindingSource::TARGET);
+
+	return createEffect(context, "pass", INSTANCED_VERTEX_SOURCE, fragmentSource, uniformBindings);
+}
+
+Effect::Ptr
+RenderTestUtils::createTransformEffect(AbstractContext::Ptr context, const std::string& name)
+{
+	data::BindingMap uniformBindings;
+
+	uniformBindings["modelToWorldMatrix"] = data::Binding("transform.modelToWorldMatrix", data::BindingSource::TARGET);
+	uniformBindings["worldToScreenMatrix"] = data::Binding("camera.worldToScreenMatrix", data::BindingSource::RENDERER);
+
+	return createEffect(context, name, TRANSFORM_VERTEX_SOURCE, FRAGMENT_SOURCE, uniformBindings);
+}
+
+uint
+RenderTestUtils::numCalls(NullContext::Ptr context, const std::string& function)
+{
+	uint numCalls = 0;
+
+	for (auto& call : context->calls())
+		if (call.function == function)
+			++numCalls;
+
+	return numCalls;
+}
+
+std::vector<std::pair<std::string, std::vector<double>>>
+RenderTestUtils::callLog(NullContext::Ptr context)
+{
+	std::vector<std::pair<std::string, std::vector<double>>> log;
+
+	for (auto& call : context->calls())
+		log.push_back(std::make_pair(call.function, call.arguments));
+
+	return log;
+}
@@ -0,0 +1,73 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Minko.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		// effects and call log queries shared by the tests rendering with a NullContext
+		class RenderTestUtils
+		{
+		public:
+			static const std::string VERTEX_SOURCE;
+			static const std::string FRAGMENT_SOURCE;
+			// reads its model to world matrix from the instance attributes when INSTANCING is defined
+			static const std::string INSTANCED_VERTEX_SOURCE;
+			static const std::string TRANSFORM_VERTEX_SOURCE;
+
+		public:
+			// single pass effect reading the position attribute of the target geometry
+			static
+			Effect::Ptr
+			createEffect(AbstractContext::Ptr			context,
+						 const std::string&				name			= "pass",
+						 const std::string&				vertexSource	= VERTEX_SOURCE,
+						 const std::string&				fragmentSource	= FRAGMENT_SOURCE,
+						 const data::BindingMap&		uniformBindings	= data::BindingMap(),
+						 const data::BindingMap&		stateBindings	= data::BindingMap(),
+						 const data::MacroBindingMap&	macroBindings	= data::MacroBindingMap(),
+						 States::Ptr					states			= States::create());
+
+			// binds modelToWorldMatrix to the transform of the target and can be instanced
+			static
+			Effect::Ptr
+			createInstancedEffect(AbstractContext::Ptr context, const std::string& fragmentSource = FRAGMENT_SOURCE);
+
+			// binds modelToWorldMatrix to the transform of the target and worldToScreenMatrix to the
+			// camera of the renderer
+			static
+			Effect::Ptr
+			createTransformEffect(AbstractContext::Ptr context, const std::string& name = "pass");
+
+			// number of calls to the function since the calls were last cleared
+			static
+			uint
+			numCalls(NullContext::Ptr context, const std::string& function);
+
+			// function and arguments of each call since the calls were last cleared, in order
+			static
+			std::vector<std::pair<std::string, std::vector<double>>>
+			callLog(NullContext::Ptr context);
+		};
+	}
+}
@@ -0,0 +1,401 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "UniformBenchmarkTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace minko
+{
+	namespace render
+	{
+		namespace benchmark
+		{
+			// the per-type maps DrawCall stored its uniforms in, kept as a reference for the benchmarks
+			class MappedUniforms
+			{
+			private:
+				typedef std::tuple<int, int>			Int2;
+				typedef std::tuple<int, int, int>		Int3;
+				typedef std::tuple<int, int, int, int>	Int4;
+
+				std::unordered_map<uint, float>									_uniformFloat;
+				std::unordered_map<uint, std::shared_ptr<math::Vector2>>		_uniformFloat2;
+				std::unordered_map<uint, std::shared_ptr<math::Vector3>>		_uniformFloat3;
+				std::unordered_map<uint, std::shared_ptr<math::Vector4>>		_uniformFloat4;
+				std::unordered_map<uint, const float*>							_uniformFloat16;
+				std::unordered_map<uint, int>									_uniformInt;
+				std::unordered_map<uint, Int2>									_uniformInt2;
+				std::unordered_map<uint, Int3>									_uniformInt3;
+				std::unordered_map<uint, Int4>									_uniformInt4;
+				std::unordered_map<uint, data::UniformArrayPtr<float>>			_uniformFloats;
+				std::unordered_map<uint, data::UniformArrayPtr<float>>			_uniformFloats2;
+				std::unordered_map<uint, data::UniformArrayPtr<float>>			_uniformFloats3;
+				std::unordered_map<uint, data::UniformArrayPtr<float>>			_uniformFloats4;
+				std::unordered_map<uint, data::UniformArrayPtr<float>>			_uniformFloats16;
+				std::unordered_map<uint, data::UniformArrayPtr<int>>			_uniformInts;
+				std::unordered_map<uint, data::UniformArrayPtr<int>>			_uniformInts2;
+				std::unordered_map<uint, data::UniformArrayPtr<int>>			_uniformInts3;
+				std::unordered_map<uint, data::UniformArrayPtr<int>>			_uniformInts4;
+
+			public:
+				void
+				clear()
+				{
+					_uniformFloat.clear();
+					_uniformFloat2.clear();
+					_uniformFloat3.clear();
+					_uniformFloat4.clear();
+					_uniformFloat16.clear();
+					_uniformInt.clear();
+					_uniformInt2.clear();
+					_uniformInt3.clear();
+					_uniformInt4.clear();
+					_uniformFloats.clear();
+					_uniformFloats2.clear();
+					_uniformFloats3.clear();
+					_uniformFloats4.clear();
+					_uniformFloats16.clear();
+					_uniformInts.clear();
+					_uniformInts2.clear();
+					_uniformInts3.clear();
+					_uniformInts4.clear();
+				}
+
+				void
+				setInt(int location, int value)
+				{
+					_uniformInt[location] = value;
+				}
+
+				void
+				setFloat(int location, float value)
+				{
+					_uniformFloat[location] = value;
+				}
+
+				void
+				setFloat4(int location, math::Vector4::Ptr value)
+				{
+					_uniformFloat4[location] = value;
+				}
+
+				void
+				setFloat16(int location, math::Matrix4x4::Ptr value)
+				{
+					_uniformFloat16[location] = &(value->data()[0]);
+				}
+
+				void
+				upload(const AbstractContext::Ptr& context) const
+				{
+					for (auto& uniformFloat : _uniformFloat)
+						context->setUniform(uniformFloat.first, uniformFloat.second);
+					for (auto& uniformFloat2 : _uniformFloat2)
+					{
+						auto& float2 = uniformFloat2.second;
+
+						context->setUniform(uniformFloat2.first, float2->x(), float2->y());
+					}
+					for (auto& uniformFloat3 : _uniformFloat3)
+					{
+						auto& float3 = uniformFloat3.second;
+
+						context->setUniform(uniformFloat3.first, float3->x(), float3->y(), float3->z());
+					}
+					for (auto& uniformFloat4 : _uniformFloat4)
+					{
+						auto& float4 = uniformFloat4.second;
+
+						context->setUniform(uniformFloat4.first, float4->x(), float4->y(), float4->z(), float4->w());
+					}
+					for (auto& uniformFloat16 : _uniformFloat16)
+						context->setUniform(uniformFloat16.first, 1, true, uniformFloat16.second);
+
+					for (auto& uniformInt : _uniformInt)
+						context->setUniform(uniformInt.first, uniformInt.second);
+					for (auto& uniformInt2 : _uniformInt2)
+						context->setUniform(uniformInt2.first, std::get<0>(uniformInt2.second), std::get<1>(uniformInt2.second));
+					for (auto& uniformInt3 : _uniformInt3)
+					{
+						const auto& int3 = uniformInt3.second;
+
+						context->setUniform(uniformInt3.first, std::get<0>(int3), std::get<1>(int3), std::get<2>(int3));
+					}
+					for (auto& uniformInt4 : _uniformInt4)
+					{
+						const auto& int4 = uniformInt4.second;
+
+						context->setUniform(uniformInt4.first, std::get<0>(int4), std::get<1>(int4), std::get<2>(int4), std::get<3>(int4));
+					}
+
+					for (auto& uniformFloats : _uniformFloats)
+						context->setUniforms(uniformFloats.first, uniformFloats.second->first, uniformFloats.second->second);
+					for (auto& uniformFloats2 : _uniformFloats2)
+						context->setUniforms2(uniformFloats2.first, uniformFloats2.second->first, uniformFloats2.second->second);
+					for (auto& uniformFloats3 : _uniformFloats3)
+						context->setUniforms3(uniformFloats3.first, uniformFloats3.second->first, uniformFloats3.second->second);
+					for (auto& uniformFloats4 : _uniformFloats4)
+						context->setUniforms4(uniformFloats4.first, uniformFloats4.second->first, uniformFloats4.second->second);
+					for (auto& uniformFloats16 : _uniformFloats16)
+						context->setUniform(uniformFloats16.first, uniformFloats16.second->first, false, uniformFloats16.second->second);
+
+					for (auto& uniformInts : _uniformInts)
+						context->setUniforms(uniformInts.first, uniformInts.second->first, uniformInts.second->second);
+					for (auto& uniformInts2 : _uniformInts2)
+						context->setUniforms2(uniformInts2.first, uniformInts2.second->first, uniformInts2.second->second);
+					for (auto& uniformInts3 : _uniformInts3)
+						context->setUniforms3(uniformInts3.first, uniformInts3.second->first, uniformInts3.second->second);
+					for (auto& uniformInts4 : _uniformInts4)
+						context->setUniforms4(uniformInts4.first, uniformInts4.second->first, uniformInts4.second->second);
+				}
+			};
+
+			// the storage of DrawCall: one block of type-tagged values indexed by location
+			class UniformValues
+			{
+			private:
+				typedef CommandBuffer::UniformValue	UniformValue;
+				typedef CommandBuffer::UniformType	UniformType;
+
+				std::vector<UniformValue>	_uniforms;
+				std::vector<int>			_slots;
+
+			public:
+				void
+				clear()
+				{
+					_uniforms.clear();
+					_slots.assign(_slots.size(), -1);
+				}
+
+				void
+				setInt(int location, int value)
+				{
+					set(location, UniformType::INT1).intValues[0] = value;
+				}
+
+				void
+				setFloat(int location, float value)
+				{
+					set(location, UniformType::FLOAT1).floatValue = value;
+				}
+
+				void
+				setFloat4(int location, math::Vector4::Ptr value)
+				{
+					set(location, UniformType::FLOAT4, value).vector4 = value.get();
+				}
+
+				void
+				setFloat16(int location, math::Matrix4x4::Ptr value)
+				{
+					set(location, UniformType::FLOAT16, value).matrix = &(value->data()[0]);
+				}
+
+				void
+				upload(const AbstractContext::Ptr& context) const
+				{
+					for (const auto& uniform : _uniforms)
+						CommandBuffer::setUniform(context, uniform);
+				}
+
+			private:
+				UniformValue&
+				set(int location, UniformType type, std::shared_ptr<void> owner = nullptr)
+				{
+					auto& uniform = CommandBuffer::uniformValue(_uniforms, _slots, location);
+
+					uniform.type	= type;
+					uniform.owner	= std::move(owner);
+
+					return uniform;
+				}
+			};
+		}
+	}
+}
+
+/*static*/ const uint UniformBenchmarkTest::NUM_DRAW_CALLS	= 10000;
+/*static*/ const uint UniformBenchmarkTest::NUM_FRAMES		= 60;
+
+namespace
+{
+	// the uniforms of a textured and transformed surface, in the order of their binding
+	template <typename U>
+	void
+	setUniforms(U& uniforms, uint i, math::Matrix4x4::Ptr matrix, math::Vector4::Ptr color)
+	{
+		uniforms.setFloat16(3, matrix);
+		uniforms.setFloat4(1, color);
+		uniforms.setFloat(2, float(i));
+		uniforms.setInt(0, int(i));
+	}
+}
+
+std::vector<math::Matrix4x4::Ptr>
+UniformBenchmarkTest::createMatrices()
+{
+	std::vector<math::Matrix4x4::Ptr> matrices;
+
+	for (uint i = 0; i < NUM_DRAW_CALLS; ++i)
+		matrices.push_back(math::Matrix4x4::create()->appendTranslation(float(i), 0.f, 0.f));
+
+	return matrices;
+}
+
+std::vector<math::Vector4::Ptr>
+UniformBenchmarkTest::createColors()
+{
+	std::vector<math::Vector4::Ptr> colors;
+
+	for (uint i = 0; i < NUM_DRAW_CALLS; ++i)
+		colors.push_back(math::Vector4::create(float(i), 1.f, 1.f, 1.f));
+
+	return colors;
+}
+
+double
+UniformBenchmarkTest::milliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void
+UniformBenchmarkTest::report(const std::string& name, double uniformValuesTime, double mappedUniformsTime)
+{
+	std::cout << "[   BENCH  ] " << name << ": uniform values " << uniformValuesTime << " ms, mapped uniforms "
+		<< mappedUniformsTime << " ms" << std::endl;
+}
+
+// each benchmark reports the best frame, a frame handling the 4 uniforms of NUM_DRAW_CALLS draw calls
+
+// what DrawCall::bind() does when the program or the data of a draw call change
+template <typename U>
+double
+UniformBenchmarkTest::bind(const std::vector<math::Matrix4x4::Ptr>& matrices, const std::vector<math::Vector4::Ptr>& colors)
+{
+	std::vector<U> drawCalls(NUM_DRAW_CALLS);
+	auto best = std::numeric_limits<double>::max();
+
+	for (uint frame = 0; frame < NUM_FRAMES; ++frame)
+	{
+		auto start = Clock::now();
+
+		for (uint i = 0; i < NUM_DRAW_CALLS; ++i)
+		{
+			drawCalls[i].clear();
+			setUniforms(drawCalls[i], i, matrices[i], colors[i]);
+		}
+
+		best = std::min(best, milliseconds(start));
+	}
+
+	return best;
+}
+
+// what the property changed handlers of a draw call do when a bound value is replaced
+template <typename U>
+double
+UniformBenchmarkTest::update(const std::vector<math::Matrix4x4::Ptr>& matrices, const std::vector<math::Vector4::Ptr>& colors)
+{
+	std::vector<U> drawCalls(NUM_DRAW_CALLS);
+	auto best = std::numeric_limits<double>::max();
+
+	for (uint i = 0; i < NUM_DRAW_CALLS; ++i)
+		setUniforms(drawCalls[i], i, matrices[i], colors[i]);
+
+	for (uint frame = 0; frame < NUM_FRAMES; ++frame)
+	{
+		auto start = Clock::now();
+
+		for (uint i = 0; i < NUM_DRAW_CALLS; ++i)
+			setUniforms(drawCalls[i], i + frame, matrices[(i + frame) % NUM_DRAW_CALLS], colors[i]);
+
+		best = std::min(best, milliseconds(start));
+	}
+
+	return best;
+}
+
+// what DrawCall::render() does for every draw call, uploading to a NullContext
+template <typename U>
+double
+UniformBenchmarkTest::upload(const std::vector<math::Matrix4x4::Ptr>& matrices, const std::vector<math::Vector4::Ptr>& colors)
+{
+	auto context = NullContext::create();
+	AbstractContext::Ptr abstractContext = context;
+	std::vector<U> drawCalls(NUM_DRAW_CALLS);
+	auto best = std::numeric_limits<double>::max();
+
+	for (uint i = 0; i < NUM_DRAW_CALLS; ++i)
+		setUniforms(drawCalls[i], i, matrices[i], colors[i]);
+
+	for (uint frame = 0; frame < NUM_FRAMES; ++frame)
+	{
+		auto start = Clock::now();
+
+		for (const auto& drawCall : drawCalls)
+			drawCall.upload(abstractContext);
+
+		best = std::min(best, milliseconds(start));
+
+		context->present();
+	}
+
+	EXPECT_EQ(context->frameStats().numUniforms, 4 * NUM_DRAW_CALLS);
+
+	return best;
+}
+
+TEST_F(UniformBenchmarkTest, DISABLED_Bind)
+{
+	auto matrices	= createMatrices();
+	auto colors		= createColors();
+
+	report(
+		"bind 10000 draw calls",
+		bind<benchmark::UniformValues>(matrices, colors),
+		bind<benchmark::MappedUniforms>(matrices, colors)
+	);
+}
+
+TEST_F(UniformBenchmarkTest, DISABLED_Update)
+{
+	auto matrices	= createMatrices();
+	auto colors		= createColors();
+
+	report(
+		"update 10000 draw calls",
+		update<benchmark::UniformValues>(matrices, colors),
+		update<benchmark::MappedUniforms>(matrices, colors)
+	);
+}
+
+TEST_F(UniformBenchmarkTest, DISABLED_Upload)
+{
+	auto matrices	= createMatrices();
+	auto colors		= createColors();
+
+	report(
+		"upload 10000 draw calls",
+		upload<benchmark::UniformValues>(matrices, colors),
+		upload<benchmark::MappedUniforms>(matrices, colors)
+	);
+}
@@ -0,0 +1,72 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Minko.hpp"
+
+#include "gtest/gtest.h"
+
+namespace minko
+{
+	namespace render
+	{
+		// benchmarks are disabled by default, run them with --gtest_also_run_disabled_tests
+		class UniformBenchmarkTest :
+			public ::testing::Test
+		{
+		protected:
+			typedef std::chrono::high_resolution_clock Clock;
+
+			static const uint NUM_DRAW_CALLS;
+			static const uint NUM_FRAMES;
+
+			static
+			std::vector<math::Matrix4x4::Ptr>
+			createMatrices();
+
+			static
+			std::vector<math::Vector4::Ptr>
+			createColors();
+
+			static
+			double
+			milliseconds(Clock::time_point start);
+
+			static
+			void
+			report(const std::string& name, double uniformValuesTime, double mappedUniformsTime);
+
+			template <typename U>
+			static
+			double
+			bind(const std::vector<math::Matrix4x4::Ptr>& matrices, const std::vector<math::Vector4::Ptr>& colors);
+
+			template <typename U>
+			static
+			double
+			update(const std::vector<math::Matrix4x4::Ptr>& matrices, const std::vector<math::Vector4::Ptr>& colors);
+
+			template <typename U>
+			static
+			double
+			upload(const std::vector<math::Matrix4x4::Ptr>& matrices, const std::vector<math::Vector4::Ptr>& colors);
+		};
+	}
+}